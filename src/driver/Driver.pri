@@ -3,6 +3,7 @@ include($$PWD/Driver-include.pri)
 SOURCES += \
     $$PWD/common/fortconf.c \
     $$PWD/common/fortlog.c \
+    $$PWD/common/fortperf.c \
     $$PWD/common/fortprov.c \
     $$PWD/common/fort_wildmatch.c
 
@@ -14,5 +15,6 @@ HEADERS += \
     $$PWD/common/fortguid.h \
     $$PWD/common/fortioctl.h \
     $$PWD/common/fortlog.h \
+    $$PWD/common/fortperf.h \
     $$PWD/common/fortprov.h \
     $$PWD/common/fort_wildmatch.h
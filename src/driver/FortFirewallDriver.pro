@@ -8,6 +8,7 @@ SOURCES += \
     fortbuf.c \
     fortcb.c \
     fortcnf.c \
+    fortcnf_addr.c \
     fortcnf_conf.c \
     fortcnf_rule.c \
     fortcnf_zone.c \
@@ -15,9 +16,11 @@ SOURCES += \
     fortdbg.c \
     fortdev.c \
     fortdrv.c \
+    fortflow.c \
     fortmod.c \
     fortpkt.c \
     fortpool.c \
+    fortprf.c \
     fortps.c \
     fortscb.c \
     fortstat.c \
@@ -49,6 +52,7 @@ HEADERS += \
     fortbuf.h \
     fortcb.h \
     fortcnf.h \
+    fortcnf_addr.h \
     fortcnf_conf.h \
     fortcnf_rule.h \
     fortcnf_zone.h \
@@ -57,9 +61,11 @@ HEADERS += \
     fortdbg.h \
     fortdev.h \
     fortdrv.h \
+    fortflow.h \
     fortmod.h \
     fortpkt.h \
     fortpool.h \
+    fortprf.h \
     fortps.h \
     fortscb.h \
     fortstat.h \
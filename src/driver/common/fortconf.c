@@ -12,6 +12,8 @@ static_assert(sizeof(ip6_addr_t) == 16, "ip6_addr_t size mismatch");
 static_assert(sizeof(FORT_CONF_FLAGS) == sizeof(UINT64), "FORT_CONF_FLAGS size mismatch");
 static_assert(
         sizeof(FORT_CONF_RULE_FILTER) == sizeof(UINT32), "FORT_CONF_RULE_FILTER size mismatch");
+static_assert(sizeof(FORT_CONF_RULE_FILTER_OP) == 3 * sizeof(UINT32),
+        "FORT_CONF_RULE_FILTER_OP size mismatch");
 static_assert(sizeof(FORT_CONF_RULE_ZONES) == sizeof(UINT64), "FORT_CONF_RULE_ZONES size mismatch");
 static_assert(sizeof(FORT_CONF_RULE) == sizeof(UINT16), "FORT_CONF_RULE size mismatch");
 
@@ -226,6 +228,11 @@ static BOOL fort_conf_port_inlist(const UINT16 port, PCFORT_CONF_PORT_LIST port_
                     fort_conf_port_list_pair_ref(port_list), port, port_list->pair_n);
 }
 
+inline static BOOL fort_conf_bitmap_test(const UCHAR *bitmap, const UINT32 index)
+{
+    return (bitmap[index >> 3] & (1 << (index & 7))) != 0;
+}
+
 FORT_API BOOL fort_conf_ip_inlist(PCFORT_CONF_ADDR_LIST addr_list, const ip_addr_t ip, BOOL isIPv6)
 {
     if (isIPv6) {
@@ -365,6 +372,34 @@ FORT_API BOOL fort_conf_app_exe_equal(PCFORT_APP_ENTRY app_entry, PCFORT_APP_PAT
     return fort_mem_eql(path->buffer, app_entry->path, path_len);
 }
 
+FORT_API BOOL fort_conf_app_entries_check(PCFORT_APP_ENTRIES app_entries, UINT32 len)
+{
+    if (len < FORT_CONF_APP_ENTRIES_DATA_OFF)
+        return FALSE;
+
+    const char *data = app_entries->data;
+    UINT32 data_len = len - FORT_CONF_APP_ENTRIES_DATA_OFF;
+
+    const int count = app_entries->count;
+
+    for (int i = 0; i < count; ++i) {
+        PCFORT_APP_ENTRY entry = (PCFORT_APP_ENTRY) data;
+
+        if (data_len < FORT_CONF_APP_ENTRY_PATH_OFF)
+            return FALSE;
+
+        const UINT32 entry_size = FORT_CONF_APP_ENTRY_SIZE(entry->path_len);
+
+        if (data_len < entry_size)
+            return FALSE;
+
+        data += entry_size;
+        data_len -= entry_size;
+    }
+
+    return data_len == 0;
+}
+
 static BOOL fort_conf_app_wild_equal(PCFORT_APP_ENTRY app_entry, PCFORT_APP_PATH path)
 {
     return wildmatch(app_entry->path, path->buffer) == WM_MATCH;
@@ -711,6 +746,25 @@ static BOOL fort_conf_rule_filter_check_port_udp(PFORT_CONF_META_CONN conn, cons
     return fort_conf_rule_filter_check_port_protocol(conn, data, IpProto_UDP);
 }
 
+static BOOL fort_conf_rule_filter_check_bitmap(
+        PFORT_CONF_META_CONN conn, const UCHAR *bitmap, const int filter_type)
+{
+    switch (filter_type) {
+    case FORT_RULE_FILTER_TYPE_PORT:
+        return fort_conf_bitmap_test(bitmap, conn->remote_port);
+    case FORT_RULE_FILTER_TYPE_LOCAL_PORT:
+        return fort_conf_bitmap_test(bitmap, conn->local_port);
+    case FORT_RULE_FILTER_TYPE_PROTOCOL:
+        return fort_conf_bitmap_test(bitmap, conn->ip_proto);
+    case FORT_RULE_FILTER_TYPE_PORT_TCP:
+        return conn->ip_proto == IpProto_TCP && fort_conf_bitmap_test(bitmap, conn->remote_port);
+    case FORT_RULE_FILTER_TYPE_PORT_UDP:
+        return conn->ip_proto == IpProto_UDP && fort_conf_bitmap_test(bitmap, conn->remote_port);
+    default:
+        return FALSE;
+    }
+}
+
 typedef BOOL (*FORT_CONF_RULE_FILTER_CHECK_FUNC)(PFORT_CONF_META_CONN conn, const void *data);
 
 static const FORT_CONF_RULE_FILTER_CHECK_FUNC fort_conf_rule_filter_check_funcList[] = {
@@ -736,10 +790,13 @@ inline static BOOL fort_conf_rule_filter_check_type(
     if (rule_filter->is_empty)
         return TRUE;
 
-    const FORT_CONF_RULE_FILTER_CHECK_FUNC func = fort_conf_rule_filter_check_funcList[filter_type];
-
     const void *data = (const void *) (rule_filter + 1);
 
+    if (rule_filter->is_bitmap)
+        return fort_conf_rule_filter_check_bitmap(conn, data, filter_type);
+
+    const FORT_CONF_RULE_FILTER_CHECK_FUNC func = fort_conf_rule_filter_check_funcList[filter_type];
+
     return func(conn, data);
 }
 
@@ -764,6 +821,44 @@ inline static BOOL fort_conf_rule_filter_check_equal(
     }
 }
 
+static BOOL fort_conf_rule_filter_check_leaf(
+        PCFORT_CONF_RULE_FILTER rule_filter, PFORT_CONF_META_CONN conn, const int filter_type)
+{
+    BOOL filter_res = fort_conf_rule_filter_check_type(rule_filter, conn, filter_type);
+
+    if (filter_res && rule_filter->equal_values) {
+        filter_res = fort_conf_rule_filter_check_equal(conn, filter_type);
+    }
+
+    return filter_res;
+}
+
+static BOOL fort_conf_rule_filter_program_check(
+        PCFORT_CONF_RULE_FILTER rule_filter, PFORT_CONF_META_CONN conn)
+{
+    const char *program = (const char *) (rule_filter + 1);
+    UINT32 jump = 0;
+
+    do {
+        PCFORT_CONF_RULE_FILTER_OP op = (PCFORT_CONF_RULE_FILTER_OP) (program + jump);
+        PCFORT_CONF_RULE_FILTER op_filter = &op->filter;
+
+        const int filter_type = op_filter->type;
+
+        const BOOL filter_res = (filter_type <= FORT_RULE_FILTER_TYPE_PORT_UDP)
+                && fort_conf_rule_filter_check_leaf(op_filter, conn, filter_type);
+
+        jump = filter_res ? op->true_jump : op->false_jump;
+
+        if ((jump & FORT_CONF_RULE_FILTER_JUMP_RESET) != 0) {
+            conn->rule_filter_action = FALSE;
+            jump &= FORT_CONF_RULE_FILTER_JUMP_MASK;
+        }
+    } while (jump < FORT_CONF_RULE_FILTER_JUMP_FALSE);
+
+    return jump == FORT_CONF_RULE_FILTER_JUMP_TRUE;
+}
+
 static BOOL fort_conf_rule_filter_check(
         PCFORT_CONF_RULE_FILTER rule_filter, PFORT_CONF_META_CONN conn)
 {
@@ -771,6 +866,10 @@ static BOOL fort_conf_rule_filter_check(
 
     const int filter_type = rule_filter->type;
 
+    if (filter_type == FORT_RULE_FILTER_TYPE_PROGRAM) {
+        return fort_conf_rule_filter_program_check(rule_filter, conn);
+    }
+
     if (filter_type == FORT_RULE_FILTER_TYPE_LIST_OR) {
         return fort_conf_rule_filter_list_check(rule_filter, conn, /*isAnd=*/FALSE);
     }
@@ -782,11 +881,7 @@ static BOOL fort_conf_rule_filter_check(
     if (filter_type < FORT_RULE_FILTER_TYPE_ADDRESS || filter_type > FORT_RULE_FILTER_TYPE_PORT_UDP)
         return FALSE;
 
-    BOOL filter_res = fort_conf_rule_filter_check_type(rule_filter, conn, filter_type);
-
-    if (filter_res && rule_filter->equal_values) {
-        filter_res = fort_conf_rule_filter_check_equal(conn, filter_type);
-    }
+    BOOL filter_res = fort_conf_rule_filter_check_leaf(rule_filter, conn, filter_type);
 
     if (rule_filter->is_not) {
         filter_res = !filter_res;
@@ -814,6 +909,53 @@ inline static BOOL fort_conf_rules_rt_conn_filtered_filters(
     return FALSE;
 }
 
+inline static UINT64 fort_conf_rules_conn_proto_mask(PCFORT_CONF_META_CONN conn)
+{
+    switch (conn->ip_proto) {
+    case IpProto_TCP:
+        return FORT_CONF_RULE_MASK_PROTO_TCP;
+    case IpProto_UDP:
+        return FORT_CONF_RULE_MASK_PROTO_UDP;
+    case IpProto_ICMP:
+    case IpProto_ICMPV6:
+        return FORT_CONF_RULE_MASK_PROTO_ICMP;
+    default:
+        return FORT_CONF_RULE_MASK_PROTO_OTHER;
+    }
+}
+
+inline static UINT64 fort_conf_rules_conn_area_mask(PCFORT_CONF_META_CONN conn)
+{
+    if (conn->is_loopback) {
+        return conn->is_local_net ? FORT_CONF_RULE_MASK_AREA_LOCAL_LAN
+                                  : FORT_CONF_RULE_MASK_AREA_LOCALHOST;
+    }
+
+    return conn->is_local_net ? FORT_CONF_RULE_MASK_AREA_LAN : FORT_CONF_RULE_MASK_AREA_INET;
+}
+
+inline static UINT64 fort_conf_rules_conn_mask(PCFORT_CONF_META_CONN conn)
+{
+    return (conn->inbound ? FORT_CONF_RULE_MASK_DIR_IN : FORT_CONF_RULE_MASK_DIR_OUT)
+            | (conn->isIPv6 ? FORT_CONF_RULE_MASK_IP_VERSION_6 : FORT_CONF_RULE_MASK_IP_VERSION_4)
+            | fort_conf_rules_conn_area_mask(conn) | fort_conf_rules_conn_proto_mask(conn)
+            | FORT_CONF_RULE_MASK_PORT(conn->remote_port);
+}
+
+inline static BOOL fort_conf_rules_rt_conn_applicable(PCFORT_CONF_RULES_RT rules_rt,
+        PCFORT_CONF_META_CONN conn, UINT16 rule_id, const UINT64 conn_mask)
+{
+    /* The filter action of the previous rules affects the next ones */
+    if (rule_id == 0 || conn->rule_filter_action)
+        return TRUE;
+
+    PCFORT_CONF_RULE rule = fort_conf_rules_rt_rule(rules_rt, rule_id);
+
+    const UINT64 rule_mask = *((const UINT64 *) ((PCCH) rule + FORT_CONF_RULE_MASK_OFFSET(rule)));
+
+    return (rule_mask & conn_mask) == conn_mask;
+}
+
 inline static BOOL fort_conf_rules_rt_conn_filtered_sets(PCFORT_CONF_RULES_RT rules_rt,
         PFORT_CONF_META_CONN conn, PCFORT_CONF_RULE rule, const BOOL empty_res)
 {
@@ -824,9 +966,14 @@ inline static BOOL fort_conf_rules_rt_conn_filtered_sets(PCFORT_CONF_RULES_RT ru
     const UINT16 *rule_ids =
             (const UINT16 *) ((PCCH) rule + FORT_CONF_RULE_SET_INDEXES_OFFSET(rule));
 
+    const UINT64 conn_mask = fort_conf_rules_conn_mask(conn);
+
     for (int i = 0; i < set_count; ++i) {
         const UINT16 rule_id = rule_ids[i];
 
+        if (!fort_conf_rules_rt_conn_applicable(rules_rt, conn, rule_id, conn_mask))
+            continue;
+
         if (fort_conf_rules_rt_conn_filtered(rules_rt, conn, rule_id)) {
             conn->rule_id = rule_id;
             return TRUE;
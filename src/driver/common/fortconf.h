@@ -9,6 +9,9 @@
 #define FORT_CONF_PORT_MAX              255
 #define FORT_CONF_PORT_ARR_SIZE(n)      ((n) * sizeof(UINT16))
 #define FORT_CONF_PORT_RANGE_SIZE(n)    (FORT_CONF_PORT_ARR_SIZE(n) * 2)
+#define FORT_CONF_PROTO_BITMAP_SIZE     (256 / 8)
+#define FORT_CONF_PORT_BITMAP_SIZE      (65536 / 8)
+#define FORT_CONF_PORT_BITMAP_MIN       64
 #define FORT_CONF_IP_MAX                (2 * 1024 * 1024)
 #define FORT_CONF_IP4_ARR_SIZE(n)       ((n) * sizeof(UINT32))
 #define FORT_CONF_IP6_ARR_SIZE(n)       ((n) * sizeof(ip6_addr_t))
@@ -162,6 +165,8 @@ enum FORT_RULE_FILTER_TYPE {
     // List types
     FORT_RULE_FILTER_TYPE_LIST_OR,
     FORT_RULE_FILTER_TYPE_LIST_AND,
+    // Compiled list
+    FORT_RULE_FILTER_TYPE_PROGRAM,
 };
 
 enum {
@@ -199,12 +204,31 @@ typedef struct fort_conf_rule_filter
     UINT32 is_not : 1;
     UINT32 equal_values : 1;
     UINT32 is_empty : 1;
+    UINT32 is_bitmap : 1; /* ports or protocols are stored as a bitmap */
     UINT32 type : 4;
-    UINT32 size : 25;
+    UINT32 size : 24;
 } FORT_CONF_RULE_FILTER, *PFORT_CONF_RULE_FILTER;
 
 typedef const FORT_CONF_RULE_FILTER *PCFORT_CONF_RULE_FILTER;
 
+/* Program jump targets are offsets of the ops from the program data begin */
+#define FORT_CONF_RULE_FILTER_JUMP_RESET 0x80000000 /* reset the filter action (failed AND list) */
+#define FORT_CONF_RULE_FILTER_JUMP_MASK  0x7FFFFFFF
+#define FORT_CONF_RULE_FILTER_JUMP_TRUE  0x7FFFFFFF
+#define FORT_CONF_RULE_FILTER_JUMP_FALSE 0x7FFFFFFE
+
+typedef struct fort_conf_rule_filter_op
+{
+    UINT32 true_jump;
+    UINT32 false_jump;
+
+    FORT_CONF_RULE_FILTER filter; /* leaf filter, is_not is folded into the jumps */
+} FORT_CONF_RULE_FILTER_OP, *PFORT_CONF_RULE_FILTER_OP;
+
+typedef const FORT_CONF_RULE_FILTER_OP *PCFORT_CONF_RULE_FILTER_OP;
+
+#define FORT_CONF_RULE_FILTER_OP_OFF offsetof(FORT_CONF_RULE_FILTER_OP, filter)
+
 typedef struct fort_conf_rule
 {
     UCHAR enabled : 1;
@@ -222,6 +246,30 @@ typedef struct fort_conf_rule
 
 typedef const FORT_CONF_RULE *PCFORT_CONF_RULE;
 
+/* Rule applicability mask: the rule can be matched only when all the connection's bits are set */
+#define FORT_CONF_RULE_MASK_DIR_IN          (1ULL << 0)
+#define FORT_CONF_RULE_MASK_DIR_OUT         (1ULL << 1)
+#define FORT_CONF_RULE_MASK_DIR             (3ULL << 0)
+#define FORT_CONF_RULE_MASK_IP_VERSION_4    (1ULL << 2)
+#define FORT_CONF_RULE_MASK_IP_VERSION_6    (1ULL << 3)
+#define FORT_CONF_RULE_MASK_IP_VERSION      (3ULL << 2)
+#define FORT_CONF_RULE_MASK_AREA_LOCALHOST  (1ULL << 4)
+#define FORT_CONF_RULE_MASK_AREA_LAN        (1ULL << 5)
+#define FORT_CONF_RULE_MASK_AREA_LOCAL_LAN  (1ULL << 6) /* localhost and LAN */
+#define FORT_CONF_RULE_MASK_AREA_INET       (1ULL << 7)
+#define FORT_CONF_RULE_MASK_AREA            (0xFULL << 4)
+#define FORT_CONF_RULE_MASK_PROTO_TCP       (1ULL << 8)
+#define FORT_CONF_RULE_MASK_PROTO_UDP       (1ULL << 9)
+#define FORT_CONF_RULE_MASK_PROTO_ICMP      (1ULL << 10) /* ICMP and ICMPv6 */
+#define FORT_CONF_RULE_MASK_PROTO_OTHER     (1ULL << 11)
+#define FORT_CONF_RULE_MASK_PROTO           (0xFULL << 8)
+#define FORT_CONF_RULE_MASK_PORT_SHIFT      32
+#define FORT_CONF_RULE_MASK_PORT_BLOOM_BITS 32 /* remote port bloom filter */
+#define FORT_CONF_RULE_MASK_PORT(port)                                                             \
+    (1ULL << (FORT_CONF_RULE_MASK_PORT_SHIFT + ((port) % FORT_CONF_RULE_MASK_PORT_BLOOM_BITS)))
+#define FORT_CONF_RULE_MASK_PORTS (0xFFFFFFFFULL << FORT_CONF_RULE_MASK_PORT_SHIFT)
+#define FORT_CONF_RULE_MASK_ALL   ((UINT64) -1)
+
 typedef struct fort_conf_rules_glob
 {
     UINT16 pre_rule_id;
@@ -253,9 +301,11 @@ typedef const FORT_CONF_RULE_FLAG *PCFORT_CONF_RULE_FLAG;
 
 #define FORT_CONF_RULES_SET_INDEXES_SIZE(n) ((n) * sizeof(UINT16))
 
-#define FORT_CONF_RULE_SET_INDEXES_OFFSET(rule)                                                    \
+#define FORT_CONF_RULE_MASK_OFFSET(rule)                                                           \
     (sizeof(FORT_CONF_RULE) + ((rule)->has_zones ? sizeof(FORT_CONF_RULE_ZONES) : 0))
 
+#define FORT_CONF_RULE_SET_INDEXES_OFFSET(rule) (FORT_CONF_RULE_MASK_OFFSET(rule) + sizeof(UINT64))
+
 #define FORT_CONF_RULE_SIZE(rule)                                                                  \
     (FORT_CONF_RULE_SET_INDEXES_OFFSET(rule) + FORT_CONF_RULES_SET_INDEXES_SIZE((rule)->set_count))
 
@@ -354,6 +404,19 @@ typedef const FORT_APP_ENTRY *PCFORT_APP_ENTRY;
 #define FORT_CONF_APP_ENTRY_SIZE(path_len)                                                         \
     (FORT_CONF_APP_ENTRY_PATH_OFF + (path_len) + sizeof(WCHAR)) /* include terminating zero */
 
+/* Packed app entries, applied at once */
+typedef struct fort_app_entries
+{
+    UINT16 count;
+    UINT16 reserved; /* not used */
+
+    char data[4];
+} FORT_APP_ENTRIES, *PFORT_APP_ENTRIES;
+
+typedef const FORT_APP_ENTRIES *PCFORT_APP_ENTRIES;
+
+#define FORT_CONF_APP_ENTRIES_DATA_OFF offsetof(FORT_APP_ENTRIES, data)
+
 typedef struct fort_conf_meta_conn
 {
     UINT16 conn_filled : 1;
@@ -458,10 +521,20 @@ typedef struct fort_conf_version
 
 typedef const FORT_CONF_VERSION *PCFORT_CONF_VERSION;
 
+typedef struct fort_conf_stat_flush
+{
+    UINT16 period_min; /* milliseconds */
+    UINT16 period_max; /* milliseconds */
+} FORT_CONF_STAT_FLUSH, *PFORT_CONF_STAT_FLUSH;
+
+typedef const FORT_CONF_STAT_FLUSH *PCFORT_CONF_STAT_FLUSH;
+
 typedef struct fort_conf_io
 {
     FORT_CONF_GROUP conf_group;
 
+    FORT_CONF_STAT_FLUSH stat_flush;
+
     FORT_CONF conf;
 } FORT_CONF_IO, *PFORT_CONF_IO;
 
@@ -553,6 +626,8 @@ FORT_API BOOL fort_conf_zones_conn_filtered(PCFORT_CONF_ZONES zones, PCFORT_CONF
 
 FORT_API BOOL fort_conf_app_exe_equal(PCFORT_APP_ENTRY app_entry, PCFORT_APP_PATH path);
 
+FORT_API BOOL fort_conf_app_entries_check(PCFORT_APP_ENTRIES app_entries, UINT32 len);
+
 FORT_API FORT_APP_DATA fort_conf_app_exe_find(
         PCFORT_CONF conf, PVOID context, PCFORT_APP_PATH path);
 
@@ -9,6 +9,15 @@ enum FortLogType {
     FORT_LOG_TYPE_PROC_NEW,
     FORT_LOG_TYPE_STAT_TRAF,
     FORT_LOG_TYPE_TIME,
+    FORT_LOG_TYPE_DROPPED,
+};
+
+enum FortLogClass {
+    FORT_LOG_CLASS_STAT = 0, /* traffic statistics and time */
+    FORT_LOG_CLASS_PROC, /* new processes */
+    FORT_LOG_CLASS_APP, /* new applications alerts */
+    FORT_LOG_CLASS_CONN, /* connections */
+    FORT_LOG_CLASS_COUNT,
 };
 
 enum FortLogConnFlag {
@@ -27,6 +27,8 @@ enum {
     FORT_IOCTL_INDEX_SETZONEFLAG,
     FORT_IOCTL_INDEX_SETRULES,
     FORT_IOCTL_INDEX_SETRULEFLAG,
+    FORT_IOCTL_INDEX_ADDAPPS,
+    FORT_IOCTL_INDEX_GETSTATS,
     FORT_IOCTL_INDEX_COUNT,
 };
 
@@ -41,5 +43,7 @@ enum {
 #define FORT_IOCTL_SETZONEFLAG FORT_CTL_CODE(FORT_IOCTL_INDEX_SETZONEFLAG, FILE_WRITE_DATA)
 #define FORT_IOCTL_SETRULES    FORT_CTL_CODE(FORT_IOCTL_INDEX_SETRULES, FILE_WRITE_DATA)
 #define FORT_IOCTL_SETRULEFLAG FORT_CTL_CODE(FORT_IOCTL_INDEX_SETRULEFLAG, FILE_WRITE_DATA)
+#define FORT_IOCTL_ADDAPPS     FORT_CTL_CODE(FORT_IOCTL_INDEX_ADDAPPS, FILE_WRITE_DATA)
+#define FORT_IOCTL_GETSTATS    FORT_CTL_CODE(FORT_IOCTL_INDEX_GETSTATS, FILE_READ_DATA)
 
 #endif // FORTIOCTL_H
@@ -168,3 +168,59 @@ FORT_API void fort_log_time_read(const char *p, BOOL *system_time_changed, INT64
     *system_time_changed = ((UCHAR) *up++ != 0);
     *unix_time = *((INT64 *) up);
 }
+
+FORT_API void fort_log_dropped_write(char *p, const UINT32 *drop_counts)
+{
+    UINT32 *up = (UINT32 *) p;
+
+    *up++ = fort_log_flag_type(FORT_LOG_TYPE_DROPPED);
+    RtlCopyMemory(up, drop_counts, FORT_LOG_CLASS_COUNT * sizeof(UINT32));
+}
+
+FORT_API void fort_log_dropped_read(const char *p, UINT32 *drop_counts)
+{
+    const UINT32 *up = (const UINT32 *) p;
+
+    ++up;
+    RtlCopyMemory(drop_counts, up, FORT_LOG_CLASS_COUNT * sizeof(UINT32));
+}
+
+FORT_API UCHAR fort_log_class(const char *p)
+{
+    switch (fort_log_type(p)) {
+    case FORT_LOG_TYPE_APP:
+        return FORT_LOG_CLASS_APP;
+    case FORT_LOG_TYPE_CONN:
+        return FORT_LOG_CLASS_CONN;
+    case FORT_LOG_TYPE_PROC_NEW:
+        return FORT_LOG_CLASS_PROC;
+    default:
+        return FORT_LOG_CLASS_STAT;
+    }
+}
+
+FORT_API UINT32 fort_log_size(const char *p)
+{
+    const UINT32 *up = (const UINT32 *) p;
+
+    const UINT16 path_len = (UINT16) (*up & ~FORT_LOG_FLAG_EX_MASK);
+
+    switch (fort_log_type(p)) {
+    case FORT_LOG_TYPE_APP:
+        return FORT_LOG_APP_SIZE(path_len);
+    case FORT_LOG_TYPE_CONN: {
+        const BOOL isIPv6 = (up[1] & FORT_LOG_CONN_IP6) != 0;
+        return FORT_LOG_CONN_SIZE(path_len, isIPv6);
+    }
+    case FORT_LOG_TYPE_PROC_NEW:
+        return FORT_LOG_PROC_NEW_SIZE(path_len);
+    case FORT_LOG_TYPE_STAT_TRAF:
+        return FORT_LOG_STAT_SIZE(path_len); /* proc_count */
+    case FORT_LOG_TYPE_TIME:
+        return FORT_LOG_TIME_SIZE;
+    case FORT_LOG_TYPE_DROPPED:
+        return FORT_LOG_DROPPED_SIZE;
+    default:
+        return 0;
+    }
+}
@@ -49,6 +49,8 @@
 
 #define FORT_LOG_TIME_SIZE (sizeof(UINT32) + sizeof(INT64))
 
+#define FORT_LOG_DROPPED_SIZE (sizeof(UINT32) + FORT_LOG_CLASS_COUNT * sizeof(UINT32))
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
@@ -80,6 +82,14 @@ FORT_API void fort_log_time_write(char *p, BOOL system_time_changed, INT64 unix_
 
 FORT_API void fort_log_time_read(const char *p, BOOL *system_time_changed, INT64 *unix_time);
 
+FORT_API void fort_log_dropped_write(char *p, const UINT32 *drop_counts);
+
+FORT_API void fort_log_dropped_read(const char *p, UINT32 *drop_counts);
+
+FORT_API UCHAR fort_log_class(const char *p);
+
+FORT_API UINT32 fort_log_size(const char *p);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,100 @@
+/* Fort Firewall Driver Performance Counters */
+
+#include "fortperf.h"
+
+#include <assert.h>
+
+static_assert(sizeof(FORT_PERF_CALLOUT) % sizeof(UINT64) == 0, "FORT_PERF_CALLOUT size mismatch");
+static_assert(sizeof(FORT_PERF_STATS) % sizeof(UINT64) == 0, "FORT_PERF_STATS size mismatch");
+
+FORT_API UCHAR fort_perf_hist_bucket(UINT32 time_ns)
+{
+    unsigned long index;
+    return _BitScanReverse(&index, time_ns) ? (UCHAR) index : 0;
+}
+
+FORT_API void fort_perf_callout_add_time(PFORT_PERF_CALLOUT callout, UINT32 time_ns)
+{
+    ++callout->count;
+    callout->time_sum += time_ns;
+
+    if (callout->time_max < time_ns) {
+        callout->time_max = time_ns;
+    }
+
+    ++callout->hist[fort_perf_hist_bucket(time_ns)];
+}
+
+FORT_API UINT32 fort_perf_callout_percentile(PCFORT_PERF_CALLOUT callout, UINT16 permille)
+{
+    UINT64 total = 0;
+    for (int i = 0; i < FORT_PERF_HIST_BUCKETS; ++i) {
+        total += callout->hist[i];
+    }
+
+    if (total == 0)
+        return 0;
+
+    const UINT64 rank = (total * permille + 999) / 1000;
+
+    UINT64 count = 0;
+    for (int i = 0; i < FORT_PERF_HIST_BUCKETS - 1; ++i) {
+        count += callout->hist[i];
+
+        if (count >= rank)
+            return (((UINT32) 2) << i) - 1; /* upper bound of the bucket */
+    }
+
+    return MAXUINT32;
+}
+
+static void fort_perf_callout_add(PFORT_PERF_CALLOUT total, PCFORT_PERF_CALLOUT callout)
+{
+    total->count += callout->count;
+    total->time_sum += callout->time_sum;
+
+    if (total->time_max < callout->time_max) {
+        total->time_max = callout->time_max;
+    }
+
+    for (int i = 0; i < FORT_PERF_HIST_BUCKETS; ++i) {
+        total->hist[i] += callout->hist[i];
+    }
+}
+
+FORT_API void fort_perf_stats_add(PFORT_PERF_STATS total, PCFORT_PERF_STATS stats)
+{
+    total->cpu_count += stats->cpu_count;
+
+    if (total->buffer_high_water < stats->buffer_high_water) {
+        total->buffer_high_water = stats->buffer_high_water;
+    }
+    total->buffer_irp_waits += stats->buffer_irp_waits;
+
+    total->reauth_skipped_count += stats->reauth_skipped_count;
+    total->reauth_evaluated_count += stats->reauth_evaluated_count;
+
+    total->addr_cache_hit_count += stats->addr_cache_hit_count;
+    total->addr_cache_miss_count += stats->addr_cache_miss_count;
+
+    for (int i = 0; i < FORT_PERF_CALLOUT_COUNT; ++i) {
+        fort_perf_callout_add(&total->callouts[i], &stats->callouts[i]);
+    }
+
+    for (int i = 0; i < FORT_PERF_LOCK_COUNT; ++i) {
+        PFORT_PERF_LOCK lock = &total->locks[i];
+
+        lock->acquire_count += stats->locks[i].acquire_count;
+        lock->contend_count += stats->locks[i].contend_count;
+    }
+
+    for (int i = 0; i < FORT_PERF_QUEUE_MAX; ++i) {
+        PFORT_PERF_QUEUE queue = &total->queues[i];
+
+        queue->drop_count += stats->queues[i].drop_count;
+
+        if (queue->queued_max < stats->queues[i].queued_max) {
+            queue->queued_max = stats->queues[i].queued_max;
+        }
+    }
+}
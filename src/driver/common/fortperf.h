@@ -0,0 +1,90 @@
+#ifndef FORTPERF_H
+#define FORTPERF_H
+
+#include "common.h"
+
+#include "fortconf.h"
+
+#define FORT_PERF_HIST_BUCKETS 32 /* log2 of nanoseconds */
+#define FORT_PERF_QUEUE_MAX    (FORT_CONF_GROUP_MAX * 2) /* in/out-bound pairs */
+
+enum {
+    FORT_PERF_CALLOUT_CONNECT_V4 = 0,
+    FORT_PERF_CALLOUT_CONNECT_V6,
+    FORT_PERF_CALLOUT_ACCEPT_V4,
+    FORT_PERF_CALLOUT_ACCEPT_V6,
+    FORT_PERF_CALLOUT_TRANSPORT_IN,
+    FORT_PERF_CALLOUT_TRANSPORT_OUT,
+    FORT_PERF_CALLOUT_COUNT,
+};
+
+enum {
+    FORT_PERF_LOCK_STAT = 0,
+    FORT_PERF_LOCK_BUFFER,
+    FORT_PERF_LOCK_SHAPER,
+    FORT_PERF_LOCK_COUNT,
+};
+
+typedef struct fort_perf_callout
+{
+    UINT64 count;
+    UINT64 time_sum; /* nanoseconds */
+    UINT32 time_max; /* nanoseconds */
+    UINT32 reserved;
+
+    UINT32 hist[FORT_PERF_HIST_BUCKETS]; /* [2^i, 2^(i+1)) nanoseconds */
+} FORT_PERF_CALLOUT, *PFORT_PERF_CALLOUT;
+
+typedef const FORT_PERF_CALLOUT *PCFORT_PERF_CALLOUT;
+
+typedef struct fort_perf_lock
+{
+    UINT64 acquire_count;
+    UINT64 contend_count;
+} FORT_PERF_LOCK, *PFORT_PERF_LOCK;
+
+typedef struct fort_perf_queue
+{
+    UINT64 drop_count;
+    UINT32 queued_max; /* bytes */
+    UINT32 reserved;
+} FORT_PERF_QUEUE, *PFORT_PERF_QUEUE;
+
+typedef struct fort_perf_stats
+{
+    UINT16 cpu_count;
+    UINT16 reserved;
+
+    UINT32 buffer_high_water; /* bytes */
+    UINT64 buffer_irp_waits;
+
+    UINT64 reauth_skipped_count;
+    UINT64 reauth_evaluated_count;
+
+    UINT64 addr_cache_hit_count;
+    UINT64 addr_cache_miss_count;
+
+    FORT_PERF_CALLOUT callouts[FORT_PERF_CALLOUT_COUNT];
+    FORT_PERF_LOCK locks[FORT_PERF_LOCK_COUNT];
+    FORT_PERF_QUEUE queues[FORT_PERF_QUEUE_MAX];
+} FORT_PERF_STATS, *PFORT_PERF_STATS;
+
+typedef const FORT_PERF_STATS *PCFORT_PERF_STATS;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+FORT_API UCHAR fort_perf_hist_bucket(UINT32 time_ns);
+
+FORT_API void fort_perf_callout_add_time(PFORT_PERF_CALLOUT callout, UINT32 time_ns);
+
+FORT_API UINT32 fort_perf_callout_percentile(PCFORT_PERF_CALLOUT callout, UINT16 permille);
+
+FORT_API void fort_perf_stats_add(PFORT_PERF_STATS total, PCFORT_PERF_STATS stats);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // FORTPERF_H
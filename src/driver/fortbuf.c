@@ -57,6 +57,8 @@ static PFORT_BUFFER_DATA fort_buffer_data_alloc(PFORT_BUFFER buf, UINT32 len)
         new_data->top = 0;
         new_data->next = NULL;
 
+        RtlZeroMemory(new_data->class_sizes, sizeof(new_data->class_sizes));
+
         if (data == NULL) {
             buf->data_head = new_data;
         } else {
@@ -76,6 +78,11 @@ static void fort_buffer_data_shift(PFORT_BUFFER buf)
     PFORT_BUFFER_DATA data = buf->data_head;
 
     buf->data_head = data->next;
+    buf->data_size -= data->top;
+
+    for (int i = 0; i < FORT_LOG_CLASS_COUNT; ++i) {
+        buf->class_sizes[i] -= data->class_sizes[i];
+    }
 
     if (data->next == NULL) {
         buf->data_tail = NULL;
@@ -85,6 +92,115 @@ static void fort_buffer_data_shift(PFORT_BUFFER buf)
     buf->data_free = data;
 }
 
+static void fort_buffer_data_unlink(
+        PFORT_BUFFER buf, PFORT_BUFFER_DATA prev, PFORT_BUFFER_DATA data)
+{
+    if (prev == NULL) {
+        buf->data_head = data->next;
+    } else {
+        prev->next = data->next;
+    }
+
+    if (buf->data_tail == data) {
+        buf->data_tail = prev;
+    }
+
+    data->next = buf->data_free;
+    buf->data_free = data;
+}
+
+static UINT32 fort_buffer_data_compact(PFORT_BUFFER_DATA data, UCHAR log_class)
+{
+    UINT32 drop_count = 0;
+    UINT32 in_top = 0;
+    UINT32 out_top = 0;
+
+    const UINT32 top = data->top;
+
+    while (in_top < top) {
+        PCHAR p = data->p + in_top;
+
+        const UINT32 len = fort_log_size(p);
+        if (len == 0) {
+            /* Keep the unknown rest as is */
+            RtlMoveMemory(data->p + out_top, p, top - in_top);
+            out_top += top - in_top;
+            break;
+        }
+
+        if (fort_log_class(p) == log_class) {
+            ++drop_count;
+        } else {
+            if (out_top != in_top) {
+                RtlMoveMemory(data->p + out_top, p, len);
+            }
+            out_top += len;
+        }
+
+        in_top += len;
+    }
+
+    data->top = out_top;
+    data->class_sizes[log_class] = 0;
+
+    return drop_count;
+}
+
+static BOOL fort_buffer_drop_oldest(PFORT_BUFFER buf, UINT32 len, UCHAR log_class, UINT32 limit)
+{
+    PFORT_BUFFER_DATA prev = NULL;
+    PFORT_BUFFER_DATA data = buf->data_head;
+
+    while (data != NULL && buf->class_sizes[log_class] + len > limit) {
+        PFORT_BUFFER_DATA next = data->next;
+
+        const UINT32 class_size = data->class_sizes[log_class];
+
+        if (class_size != 0) {
+            buf->drop_counts[log_class] += fort_buffer_data_compact(data, log_class);
+
+            buf->class_sizes[log_class] -= class_size;
+            buf->data_size -= class_size;
+
+            if (data->top == 0) {
+                fort_buffer_data_unlink(buf, prev, data);
+                data = next;
+                continue;
+            }
+        }
+
+        prev = data;
+        data = next;
+    }
+
+    return buf->class_sizes[log_class] + len <= limit;
+}
+
+static UINT32 fort_buffer_class_limit(UCHAR log_class)
+{
+    switch (log_class) {
+    case FORT_LOG_CLASS_STAT:
+        return FORT_BUFFER_STAT_LIMIT;
+    case FORT_LOG_CLASS_PROC:
+        return FORT_BUFFER_PROC_LIMIT;
+    case FORT_LOG_CLASS_APP:
+        return FORT_BUFFER_APP_LIMIT;
+    default:
+        return FORT_BUFFER_CONN_LIMIT;
+    }
+}
+
+static BOOL fort_buffer_class_fits(PFORT_BUFFER buf, UINT32 len, UCHAR log_class)
+{
+    const UINT32 limit = fort_buffer_class_limit(log_class);
+
+    if (buf->class_sizes[log_class] + len <= limit)
+        return TRUE;
+
+    return FORT_BUFFER_DROP_OLDEST(log_class)
+            && fort_buffer_drop_oldest(buf, len, log_class, limit);
+}
+
 FORT_API void fort_buffer_open(PFORT_BUFFER buf)
 {
     KeInitializeSpinLock(&buf->lock);
@@ -106,6 +222,10 @@ FORT_API void fort_buffer_clear(PFORT_BUFFER buf)
     buf->data_head = NULL;
     buf->data_tail = NULL;
     buf->data_free = NULL;
+    buf->data_size = 0;
+
+    RtlZeroMemory(buf->class_sizes, sizeof(buf->class_sizes));
+    RtlZeroMemory(buf->drop_counts, sizeof(buf->drop_counts));
 
     KeReleaseInStackQueuedSpinLock(&lock_queue);
 }
@@ -155,23 +275,36 @@ inline static NTSTATUS fort_buffer_prepare_pending(
     return use_buffer;
 }
 
-inline static NTSTATUS fort_buffer_prepare_new(PFORT_BUFFER buf, UINT32 len, PCHAR *out)
+inline static NTSTATUS fort_buffer_prepare_new(
+        PFORT_BUFFER buf, UINT32 len, UCHAR log_class, PCHAR *out)
 {
+    if (!fort_buffer_class_fits(buf, len, log_class)) {
+        ++buf->drop_counts[log_class];
+        return FORT_STATUS_BUFFER_DROPPED;
+    }
+
     PFORT_BUFFER_DATA data = fort_buffer_data_alloc(buf, len);
     if (data == NULL) {
         LOG("Buffer OOM: len=%d\n", len);
         TRACE(FORT_BUFFER_OOM, STATUS_INSUFFICIENT_RESOURCES, len, 0);
+        ++buf->drop_counts[log_class];
         return STATUS_INSUFFICIENT_RESOURCES;
     }
 
     *out = data->p + data->top;
     data->top += len;
+    data->class_sizes[log_class] += len;
+
+    buf->data_size += len;
+    buf->class_sizes[log_class] += len;
+
+    fort_perf_buffer_size(&fort_device()->perf, buf->data_size);
 
     return STATUS_SUCCESS;
 }
 
 FORT_API NTSTATUS fort_buffer_prepare(
-        PFORT_BUFFER buf, UINT32 len, PCHAR *out, PFORT_IRP_INFO irp_info)
+        PFORT_BUFFER buf, UINT32 len, UCHAR log_class, PCHAR *out, PFORT_IRP_INFO irp_info)
 {
     /* Check a pending buffer */
     if (buf->data_head == NULL) {
@@ -179,7 +312,7 @@ FORT_API NTSTATUS fort_buffer_prepare(
             return STATUS_SUCCESS;
     }
 
-    return fort_buffer_prepare_new(buf, len, out);
+    return fort_buffer_prepare_new(buf, len, log_class, out);
 }
 
 FORT_API NTSTATUS fort_buffer_conn_write(PFORT_BUFFER buf, PCFORT_CONF_META_CONN conn,
@@ -190,23 +323,29 @@ FORT_API NTSTATUS fort_buffer_conn_write(PFORT_BUFFER buf, PCFORT_CONF_META_CONN
     const FORT_APP_PATH log_path = fort_buffer_adjust_log_path(conn);
 
     UINT32 len;
+    UCHAR log_class;
     switch (log_type) {
     case FORT_BUFFER_CONN_WRITE_APP: {
         len = FORT_LOG_APP_SIZE(log_path.len);
+        log_class = FORT_LOG_CLASS_APP;
     } break;
     case FORT_BUFFER_CONN_WRITE_CONN: {
         len = FORT_LOG_CONN_SIZE(log_path.len, conn->isIPv6);
+        log_class = FORT_LOG_CLASS_CONN;
     } break;
     case FORT_BUFFER_CONN_WRITE_PROC_NEW: {
         len = FORT_LOG_PROC_NEW_SIZE(log_path.len);
+        log_class = FORT_LOG_CLASS_PROC;
     } break;
     }
 
+    fort_perf_lock_acquire(&fort_device()->perf, FORT_PERF_LOCK_BUFFER, &buf->lock);
+
     KLOCK_QUEUE_HANDLE lock_queue;
     KeAcquireInStackQueuedSpinLock(&buf->lock, &lock_queue);
     {
         PCHAR out;
-        status = fort_buffer_prepare(buf, len, &out, irp_info);
+        status = fort_buffer_prepare(buf, len, log_class, &out, irp_info);
 
         if (NT_SUCCESS(status)) {
             switch (log_type) {
@@ -268,6 +407,8 @@ static NTSTATUS fort_buffer_xmove_locked(
 FORT_API NTSTATUS fort_buffer_xmove(
         PFORT_BUFFER buf, PFORT_IRP_INFO irp_info, PVOID out, ULONG out_len)
 {
+    fort_perf_lock_acquire(&fort_device()->perf, FORT_PERF_LOCK_BUFFER, &buf->lock);
+
     KLOCK_QUEUE_HANDLE lock_queue;
     KeAcquireInStackQueuedSpinLock(&buf->lock, &lock_queue);
 
@@ -344,6 +485,8 @@ FORT_API void fort_buffer_irp_clear_pending(PFORT_IRP_INFO irp_info)
 
 FORT_API void fort_buffer_dpc_begin(PFORT_BUFFER buf, PKLOCK_QUEUE_HANDLE lock_queue)
 {
+    fort_perf_lock_acquire(&fort_device()->perf, FORT_PERF_LOCK_BUFFER, &buf->lock);
+
     KeAcquireInStackQueuedSpinLockAtDpcLevel(&buf->lock, lock_queue);
 }
 
@@ -373,3 +516,26 @@ FORT_API void fort_buffer_flush_pending(PFORT_BUFFER buf, PFORT_IRP_INFO irp_inf
         fort_buffer_flush_pending_out(buf, irp_info, out_top);
     }
 }
+
+FORT_API void fort_buffer_flush_dropped(PFORT_BUFFER buf, PFORT_IRP_INFO irp_info)
+{
+    UINT32 drop_flags = 0;
+    for (int i = 0; i < FORT_LOG_CLASS_COUNT; ++i) {
+        drop_flags |= buf->drop_counts[i];
+    }
+
+    if (drop_flags == 0)
+        return;
+
+    /* Keep the counts till the next flush */
+    if (!fort_buffer_class_fits(buf, FORT_LOG_DROPPED_SIZE, FORT_LOG_CLASS_STAT))
+        return;
+
+    PCHAR out;
+    if (NT_SUCCESS(fort_buffer_prepare(
+                buf, FORT_LOG_DROPPED_SIZE, FORT_LOG_CLASS_STAT, &out, irp_info))) {
+        fort_log_dropped_write(out, buf->drop_counts);
+
+        RtlZeroMemory(buf->drop_counts, sizeof(buf->drop_counts));
+    }
+}
@@ -4,8 +4,20 @@
 #include "fortdrv.h"
 
 #include "common/fortconf.h"
+#include "common/fortdef.h"
 #include "common/fortlog.h"
 
+#define FORT_STATUS_BUFFER_DROPPED STATUS_QUOTA_EXCEEDED
+
+/* Limits of queued bytes per log class */
+#define FORT_BUFFER_STAT_LIMIT (4 * 1024 * 1024)
+#define FORT_BUFFER_PROC_LIMIT (2 * 1024 * 1024)
+#define FORT_BUFFER_APP_LIMIT  (1 * 1024 * 1024)
+#define FORT_BUFFER_CONN_LIMIT (2 * 1024 * 1024)
+
+/* Drop the oldest records of the class instead of the new ones */
+#define FORT_BUFFER_DROP_OLDEST(log_class) ((log_class) == FORT_LOG_CLASS_CONN)
+
 typedef enum FORT_BUFFER_CONN_WRITE_TYPE {
     FORT_BUFFER_CONN_WRITE_APP = 0,
     FORT_BUFFER_CONN_WRITE_CONN,
@@ -17,6 +29,8 @@ typedef struct fort_buffer_data
     struct fort_buffer_data *next;
 
     UINT32 top;
+    UINT32 class_sizes[FORT_LOG_CLASS_COUNT]; /* bytes per log class */
+
     CHAR p[FORT_BUFFER_SIZE];
 } FORT_BUFFER_DATA, *PFORT_BUFFER_DATA;
 
@@ -26,6 +40,11 @@ typedef struct fort_buffer
     PFORT_BUFFER_DATA data_tail; /* last is current */
     PFORT_BUFFER_DATA data_free;
 
+    UINT32 data_size; /* bytes in the data list */
+    UINT32 class_sizes[FORT_LOG_CLASS_COUNT]; /* bytes per log class in the data list */
+
+    UINT32 drop_counts[FORT_LOG_CLASS_COUNT]; /* not reported dropped records */
+
     PIRP irp; /* pending */
     PCHAR out;
     ULONG out_len;
@@ -45,7 +64,7 @@ FORT_API void fort_buffer_close(PFORT_BUFFER buf);
 FORT_API void fort_buffer_clear(PFORT_BUFFER buf);
 
 FORT_API NTSTATUS fort_buffer_prepare(
-        PFORT_BUFFER buf, UINT32 len, PCHAR *out, PFORT_IRP_INFO irp_info);
+        PFORT_BUFFER buf, UINT32 len, UCHAR log_class, PCHAR *out, PFORT_IRP_INFO irp_info);
 
 FORT_API NTSTATUS fort_buffer_conn_write(PFORT_BUFFER buf, PCFORT_CONF_META_CONN conn,
         PFORT_IRP_INFO irp_info, FORT_BUFFER_CONN_WRITE_TYPE log_type);
@@ -63,6 +82,8 @@ FORT_API void fort_buffer_dpc_end(PKLOCK_QUEUE_HANDLE lock_queue);
 
 FORT_API void fort_buffer_flush_pending(PFORT_BUFFER buf, PFORT_IRP_INFO irp_info);
 
+FORT_API void fort_buffer_flush_dropped(PFORT_BUFFER buf, PFORT_IRP_INFO irp_info);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -40,3 +40,107 @@ FORT_API UINT16 fort_device_flag(PFORT_DEVICE_CONF device_conf, UINT16 flag)
 {
     return fort_device_flags(device_conf) & flag;
 }
+
+inline static UINT64 fort_conf_reauth_app_bit(tommy_key_t path_hash, int *index)
+{
+    const UINT32 bit_index = path_hash % FORT_CONF_REAUTH_APPS_BITS;
+
+    *index = bit_index / 64;
+
+    return 1ULL << (bit_index % 64);
+}
+
+FORT_API tommy_key_t fort_conf_reauth_path_hash(PCFORT_APP_PATH path)
+{
+    return (tommy_key_t) tommy_hash_u64(0, path->buffer, path->len);
+}
+
+static void fort_conf_reauth_all_locked(PFORT_CONF_REAUTH reauth)
+{
+    reauth->all_gen = ++reauth->gen;
+
+    reauth->apps_count = 0;
+    RtlZeroMemory(reauth->apps_bits, sizeof(reauth->apps_bits));
+}
+
+FORT_API void fort_conf_reauth_all(PFORT_CONF_REAUTH reauth)
+{
+    KIRQL oldIrql = ExAcquireSpinLockExclusive(&reauth->lock);
+    {
+        fort_conf_reauth_all_locked(reauth);
+    }
+    ExReleaseSpinLockExclusive(&reauth->lock, oldIrql);
+}
+
+FORT_API void fort_conf_reauth_app(PFORT_CONF_REAUTH reauth, tommy_key_t path_hash)
+{
+    KIRQL oldIrql = ExAcquireSpinLockExclusive(&reauth->lock);
+
+    if (reauth->apps_count >= FORT_CONF_REAUTH_APPS_MAX) {
+        /* Too many changed apps: re-evaluate all flows */
+        fort_conf_reauth_all_locked(reauth);
+    } else {
+        int index;
+        const UINT64 bit = fort_conf_reauth_app_bit(path_hash, &index);
+
+        reauth->apps_bits[index] |= bit;
+        ++reauth->apps_count;
+        ++reauth->gen;
+    }
+
+    ExReleaseSpinLockExclusive(&reauth->lock, oldIrql);
+}
+
+FORT_API UINT32 fort_conf_reauth_gen(PFORT_CONF_REAUTH reauth)
+{
+    UINT32 gen;
+
+    KIRQL oldIrql = ExAcquireSpinLockShared(&reauth->lock);
+    {
+        gen = reauth->gen;
+    }
+    ExReleaseSpinLockShared(&reauth->lock, oldIrql);
+
+    return gen;
+}
+
+FORT_API UINT32 fort_conf_reauth_all_gen(PFORT_CONF_REAUTH reauth)
+{
+    UINT32 all_gen;
+
+    KIRQL oldIrql = ExAcquireSpinLockShared(&reauth->lock);
+    {
+        all_gen = reauth->all_gen;
+    }
+    ExReleaseSpinLockShared(&reauth->lock, oldIrql);
+
+    return all_gen;
+}
+
+FORT_API BOOL fort_conf_reauth_app_changed(
+        PFORT_CONF_REAUTH reauth, UINT32 *gen, tommy_key_t path_hash)
+{
+    BOOL changed;
+
+    KIRQL oldIrql = ExAcquireSpinLockShared(&reauth->lock);
+
+    if ((INT32) (*gen - reauth->all_gen) < 0) {
+        changed = TRUE; /* evaluated before the last change of all flows */
+    } else if (*gen == reauth->gen) {
+        changed = FALSE; /* evaluated with the current conf */
+    } else {
+        int index;
+        const UINT64 bit = fort_conf_reauth_app_bit(path_hash, &index);
+
+        changed = (reauth->apps_bits[index] & bit) != 0;
+    }
+
+    /* The previous evaluation is valid for the current conf */
+    if (!changed) {
+        *gen = reauth->gen;
+    }
+
+    ExReleaseSpinLockShared(&reauth->lock, oldIrql);
+
+    return changed;
+}
@@ -26,6 +26,57 @@ typedef struct fort_conf_ref
     FORT_CONF conf;
 } FORT_CONF_REF, *PFORT_CONF_REF;
 
+#define FORT_CONF_REAUTH_APPS_BITS 256
+#define FORT_CONF_REAUTH_APPS_MAX  64
+
+/* Scope of changes since the last change of all flows */
+typedef struct fort_conf_reauth
+{
+    UINT32 gen; /* current generation of the conf */
+    UINT32 all_gen; /* generation of the last change of all flows */
+
+    UINT16 apps_count; /* number of changed apps since the all_gen */
+    UINT64 apps_bits[FORT_CONF_REAUTH_APPS_BITS / 64]; /* changed apps' path hashes */
+
+    LONG volatile skipped_count;
+    LONG volatile evaluated_count;
+
+    EX_SPIN_LOCK lock;
+} FORT_CONF_REAUTH, *PFORT_CONF_REAUTH;
+
+#define FORT_CONF_ADDR_CACHE_SETS 256
+#define FORT_CONF_ADDR_CACHE_WAYS 4
+
+#define FORT_CONF_ADDR_CACHE_LAN_FILLED    0x01
+#define FORT_CONF_ADDR_CACHE_LAN_INCLUDED  0x02
+#define FORT_CONF_ADDR_CACHE_INET_FILLED   0x04
+#define FORT_CONF_ADDR_CACHE_INET_INCLUDED 0x08
+
+typedef struct fort_conf_addr_cache_entry
+{
+    LONG volatile seq; /* odd, while the entry is being written */
+
+    UINT32 gen; /* generation of all flows' changes */
+
+    ip_addr_t ip;
+
+    UCHAR is_ipv6;
+    UCHAR flags;
+    UCHAR lan_zone_id;
+    UCHAR inet_zone_id;
+} FORT_CONF_ADDR_CACHE_ENTRY, *PFORT_CONF_ADDR_CACHE_ENTRY;
+
+/* Set-associative cache of remote addresses' address groups */
+typedef struct fort_conf_addr_cache
+{
+    LONG volatile hit_count;
+    LONG volatile miss_count;
+
+    LONG volatile victim_index;
+
+    FORT_CONF_ADDR_CACHE_ENTRY entries[FORT_CONF_ADDR_CACHE_SETS * FORT_CONF_ADDR_CACHE_WAYS];
+} FORT_CONF_ADDR_CACHE, *PFORT_CONF_ADDR_CACHE;
+
 #define FORT_DEVICE_BOOT_FILTER   0x01
 #define FORT_DEVICE_STEALTH_MODE  0x02
 #define FORT_DEVICE_FILTER_LOCALS 0x04
@@ -51,6 +102,9 @@ typedef struct fort_device_conf
     PFORT_CONF_ZONES zones;
     PFORT_CONF_RULES rules;
 
+    FORT_CONF_REAUTH reauth;
+    FORT_CONF_ADDR_CACHE addr_cache;
+
     EX_SPIN_LOCK lock;
 } FORT_DEVICE_CONF, *PFORT_DEVICE_CONF;
 
@@ -70,6 +124,19 @@ FORT_API UINT16 fort_device_flags(PFORT_DEVICE_CONF device_conf);
 
 FORT_API UINT16 fort_device_flag(PFORT_DEVICE_CONF device_conf, UINT16 flag);
 
+FORT_API tommy_key_t fort_conf_reauth_path_hash(PCFORT_APP_PATH path);
+
+FORT_API void fort_conf_reauth_all(PFORT_CONF_REAUTH reauth);
+
+FORT_API void fort_conf_reauth_app(PFORT_CONF_REAUTH reauth, tommy_key_t path_hash);
+
+FORT_API UINT32 fort_conf_reauth_gen(PFORT_CONF_REAUTH reauth);
+
+FORT_API UINT32 fort_conf_reauth_all_gen(PFORT_CONF_REAUTH reauth);
+
+FORT_API BOOL fort_conf_reauth_app_changed(
+        PFORT_CONF_REAUTH reauth, UINT32 *gen, tommy_key_t path_hash);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
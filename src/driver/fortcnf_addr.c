@@ -0,0 +1,172 @@
+/* Fort Firewall Configuration: Address Groups Cache */
+
+#include "fortcnf_addr.h"
+
+typedef const FORT_CONF_ADDR_CACHE_ENTRY *PCFORT_CONF_ADDR_CACHE_ENTRY;
+
+static PFORT_CONF_ADDR_CACHE_ENTRY fort_conf_addr_cache_set(
+        PFORT_CONF_ADDR_CACHE addr_cache, PCFORT_CONF_META_CONN conn)
+{
+    const tommy_key_t ip_hash = conn->isIPv6
+            ? (tommy_key_t) tommy_hash_u32(0, conn->remote_ip.data, sizeof(ip6_addr_t))
+            : tommy_inthash_u32(conn->remote_ip.v4);
+
+    const UINT32 set_index = ip_hash % FORT_CONF_ADDR_CACHE_SETS;
+
+    return &addr_cache->entries[set_index * FORT_CONF_ADDR_CACHE_WAYS];
+}
+
+static BOOL fort_conf_addr_cache_entry_equal(
+        PCFORT_CONF_ADDR_CACHE_ENTRY entry, PCFORT_CONF_META_CONN conn, UINT32 gen)
+{
+    if (entry->gen != gen || entry->is_ipv6 != conn->isIPv6)
+        return FALSE;
+
+    if (conn->isIPv6) {
+        return entry->ip.v6.lo64 == conn->remote_ip.v6.lo64
+                && entry->ip.v6.hi64 == conn->remote_ip.v6.hi64;
+    }
+
+    return entry->ip.v4 == conn->remote_ip.v4;
+}
+
+static BOOL fort_conf_addr_cache_entry_read(
+        PFORT_CONF_ADDR_CACHE_ENTRY entry, PFORT_CONF_ADDR_CACHE_ENTRY value)
+{
+    const LONG seq = InterlockedOr(&entry->seq, 0);
+
+    if ((seq & 1) != 0)
+        return FALSE; /* being written */
+
+    value->gen = entry->gen;
+    value->ip = entry->ip;
+    value->is_ipv6 = entry->is_ipv6;
+    value->flags = entry->flags;
+    value->lan_zone_id = entry->lan_zone_id;
+    value->inet_zone_id = entry->inet_zone_id;
+
+    /* Check that the entry was not changed while reading */
+    return InterlockedOr(&entry->seq, 0) == seq;
+}
+
+static int fort_conf_addr_cache_find(PFORT_CONF_ADDR_CACHE_ENTRY set, PCFORT_CONF_META_CONN conn,
+        UINT32 gen, PFORT_CONF_ADDR_CACHE_ENTRY value, int *stale_way)
+{
+    *stale_way = -1;
+
+    for (int way = 0; way < FORT_CONF_ADDR_CACHE_WAYS; ++way) {
+        if (!fort_conf_addr_cache_entry_read(&set[way], value))
+            continue;
+
+        if (fort_conf_addr_cache_entry_equal(value, conn, gen))
+            return way;
+
+        if (*stale_way == -1 && (value->gen != gen || value->flags == 0)) {
+            *stale_way = way;
+        }
+    }
+
+    return -1;
+}
+
+static void fort_conf_addr_cache_write(
+        PFORT_CONF_ADDR_CACHE_ENTRY entry, PCFORT_CONF_ADDR_CACHE_ENTRY value)
+{
+    const LONG seq = InterlockedOr(&entry->seq, 0);
+
+    if ((seq & 1) != 0 || InterlockedCompareExchange(&entry->seq, seq + 1, seq) != seq)
+        return; /* being written by another classify */
+
+    entry->gen = value->gen;
+    entry->ip = value->ip;
+    entry->is_ipv6 = value->is_ipv6;
+    entry->flags = value->flags;
+    entry->lan_zone_id = value->lan_zone_id;
+    entry->inet_zone_id = value->inet_zone_id;
+
+    InterlockedIncrement(&entry->seq);
+}
+
+static int fort_conf_addr_cache_victim_way(
+        PFORT_CONF_ADDR_CACHE addr_cache, int found_way, int stale_way)
+{
+    if (found_way != -1)
+        return found_way; /* update the same entry */
+
+    if (stale_way != -1)
+        return stale_way; /* replace the stale entry */
+
+    const ULONG victim_index = (ULONG) InterlockedIncrement(&addr_cache->victim_index);
+
+    return victim_index % FORT_CONF_ADDR_CACHE_WAYS;
+}
+
+FORT_API BOOL fort_conf_addr_cache_ip_included(PFORT_CONF_ADDR_CACHE addr_cache, UINT32 gen,
+        PCFORT_CONF conf, PCFORT_CONF_META_CONN conn, PCFORT_CONF_ADDR_GROUP_IP_INCLUDED_OPT opt)
+{
+    const int addr_group_index = opt->addr_group_index;
+
+    /* Only LAN and INET address groups are cached */
+    if (addr_group_index > 1)
+        return fort_conf_addr_group_ip_included(conf, conn, opt);
+
+    const BOOL is_lan = (addr_group_index == 0);
+    const UCHAR filled_flag =
+            is_lan ? FORT_CONF_ADDR_CACHE_LAN_FILLED : FORT_CONF_ADDR_CACHE_INET_FILLED;
+    const UCHAR included_flag =
+            is_lan ? FORT_CONF_ADDR_CACHE_LAN_INCLUDED : FORT_CONF_ADDR_CACHE_INET_INCLUDED;
+
+    PFORT_CONF_ADDR_CACHE_ENTRY set = fort_conf_addr_cache_set(addr_cache, conn);
+
+    FORT_CONF_ADDR_CACHE_ENTRY value;
+    int stale_way;
+    const int found_way = fort_conf_addr_cache_find(set, conn, gen, &value, &stale_way);
+
+    if (found_way != -1) {
+        if ((value.flags & filled_flag) != 0) {
+            InterlockedIncrement(&addr_cache->hit_count);
+
+            const UCHAR zone_id = is_lan ? value.lan_zone_id : value.inet_zone_id;
+            if (zone_id != 0) {
+                *opt->zone_id = zone_id;
+            }
+
+            return (value.flags & included_flag) != 0;
+        }
+    } else {
+        RtlZeroMemory(&value, sizeof(value));
+
+        value.gen = gen;
+        value.ip = conn->remote_ip;
+        value.is_ipv6 = (UCHAR) conn->isIPv6;
+    }
+
+    InterlockedIncrement(&addr_cache->miss_count);
+
+    /* Uncached lookup */
+    UCHAR zone_id = 0;
+
+    FORT_CONF_ADDR_GROUP_IP_INCLUDED_OPT uncached_opt = *opt;
+    uncached_opt.zone_id = &zone_id;
+
+    const BOOL included = fort_conf_addr_group_ip_included(conf, conn, &uncached_opt);
+
+    if (zone_id != 0) {
+        *opt->zone_id = zone_id;
+    }
+
+    /* Fill the cache */
+    value.flags |= filled_flag | (included ? included_flag : 0);
+
+    if (is_lan) {
+        value.lan_zone_id = zone_id;
+    } else {
+        value.inet_zone_id = zone_id;
+    }
+
+    const int way = fort_conf_addr_cache_victim_way(addr_cache, found_way, stale_way);
+
+    fort_conf_addr_cache_write(&set[way], &value);
+
+    return included;
+}
@@ -0,0 +1,17 @@
+#ifndef FORTCNF_ADDR_H
+#define FORTCNF_ADDR_H
+
+#include "fortcnf.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+FORT_API BOOL fort_conf_addr_cache_ip_included(PFORT_CONF_ADDR_CACHE addr_cache, UINT32 gen,
+        PCFORT_CONF conf, PCFORT_CONF_META_CONN conn, PCFORT_CONF_ADDR_GROUP_IP_INCLUDED_OPT opt);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // FORTCNF_ADDR_H
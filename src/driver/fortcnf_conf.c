@@ -158,6 +158,35 @@ FORT_API NTSTATUS fort_conf_ref_exe_add_entry(
     }
 }
 
+FORT_API NTSTATUS fort_conf_ref_exe_add_entries(
+        PFORT_CONF_REF conf_ref, PCFORT_APP_ENTRIES app_entries)
+{
+    NTSTATUS status = STATUS_SUCCESS;
+
+    const char *data = app_entries->data;
+
+    const int count = app_entries->count;
+
+    KIRQL oldIrql = ExAcquireSpinLockExclusive(&conf_ref->conf_lock);
+    {
+        for (int i = 0; i < count; ++i) {
+            PCFORT_APP_ENTRY entry = (PCFORT_APP_ENTRY) data;
+
+            const NTSTATUS entry_status = fort_conf_ref_exe_add_entry(conf_ref, entry, TRUE);
+
+            /* Keep the first error and continue with the rest of entries */
+            if (NT_SUCCESS(status) && !NT_SUCCESS(entry_status)) {
+                status = entry_status;
+            }
+
+            data += FORT_CONF_APP_ENTRY_SIZE(entry->path_len);
+        }
+    }
+    ExReleaseSpinLockExclusive(&conf_ref->conf_lock, oldIrql);
+
+    return status;
+}
+
 static void fort_conf_ref_exe_fill(PFORT_CONF_REF conf_ref, PCFORT_CONF conf)
 {
     const char *app_entries = (const char *) (conf->data + conf->exe_apps_off);
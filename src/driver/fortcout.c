@@ -6,6 +6,7 @@
 #include "common/fortguid.h"
 #include "common/fortprov.h"
 
+#include "fortcnf_addr.h"
 #include "fortcnf_conf.h"
 #include "fortcnf_rule.h"
 #include "fortcnf_zone.h"
@@ -137,7 +138,14 @@ inline static BOOL fort_callout_ale_associate_flow(
 {
     BOOL proc_stat = FALSE;
 
-    const NTSTATUS status = fort_flow_associate(&fort_device()->stat, conn, &proc_stat);
+    const FORT_FLOW_REAUTH flow_reauth = {
+        .gen = cx->reauth_gen,
+        .app_hash = fort_conf_reauth_path_hash(&conn->path),
+        .profile_id = conn->profile_id,
+    };
+
+    const NTSTATUS status =
+            fort_flow_associate(&fort_device()->stat, conn, &flow_reauth, &proc_stat);
 
     if (!NT_SUCCESS(status)) {
         if (status != FORT_STATUS_FLOW_BLOCK) {
@@ -188,6 +196,8 @@ inline static void fort_callout_ale_log_app_path(PFORT_CALLOUT_ALE_EXTRA cx,
     if (!NT_SUCCESS(fort_conf_ref_exe_add_path(conf_ref, &app_entry, &conn->path)))
         return;
 
+    fort_conf_reauth_app(&fort_device()->conf.reauth, fort_conf_reauth_path_hash(&conn->path));
+
     fort_callout_ale_set_app_flags(conn, app_data);
 
     fort_buffer_conn_write(&fort_device()->buffer, conn, &cx->irp_info, FORT_BUFFER_CONN_WRITE_APP);
@@ -451,8 +461,11 @@ inline static BOOL fort_callout_ale_check_filter_net_flags(
 }
 
 inline static BOOL fort_callout_ale_check_filter_flags(PCFORT_CALLOUT_ARG ca,
-        PFORT_CONF_META_CONN conn, PFORT_CONF_REF conf_ref, const FORT_CONF_FLAGS conf_flags)
+        PFORT_CALLOUT_ALE_EXTRA cx, PFORT_CONF_REF conf_ref, const FORT_CONF_FLAGS conf_flags)
 {
+    PFORT_CONF_META_CONN conn = &cx->conn;
+    PFORT_CONF_ADDR_CACHE addr_cache = &fort_device()->conf.addr_cache;
+
     if (conf_flags.block_traffic) {
         return TRUE; /* block all */
     }
@@ -468,7 +481,8 @@ inline static BOOL fort_callout_ale_check_filter_flags(PCFORT_CALLOUT_ARG ca,
             .addr_group_index = 0, /* LAN */
             .zone_id = &local_zone_id,
         };
-        conn->is_local_net = !fort_conf_addr_group_ip_included(&conf_ref->conf, conn, &opt);
+        conn->is_local_net = !fort_conf_addr_cache_ip_included(
+                addr_cache, cx->addr_gen, &conf_ref->conf, conn, &opt);
 
         if (fort_callout_ale_check_filter_net_flags(conn, conf_flags)) {
             return TRUE; /* block net */
@@ -484,7 +498,8 @@ inline static BOOL fort_callout_ale_check_filter_flags(PCFORT_CALLOUT_ARG ca,
             .zone_id = &conn->zone_id,
         };
 
-        if (!fort_conf_addr_group_ip_included(&conf_ref->conf, conn, &opt)) {
+        if (!fort_conf_addr_cache_ip_included(
+                    addr_cache, cx->addr_gen, &conf_ref->conf, conn, &opt)) {
             conn->reason = FORT_CONN_REASON_IP_INET;
             return TRUE; /* block address */
         }
@@ -493,11 +508,13 @@ inline static BOOL fort_callout_ale_check_filter_flags(PCFORT_CALLOUT_ARG ca,
     return FALSE;
 }
 
-inline static BOOL fort_callout_ale_check_flags(PCFORT_CALLOUT_ARG ca, PFORT_CONF_META_CONN conn,
-        PFORT_CONF_REF conf_ref, const FORT_CONF_FLAGS conf_flags)
+inline static BOOL fort_callout_ale_check_flags(PCFORT_CALLOUT_ARG ca,
+        PFORT_CALLOUT_ALE_EXTRA cx, PFORT_CONF_REF conf_ref, const FORT_CONF_FLAGS conf_flags)
 {
+    PFORT_CONF_META_CONN conn = &cx->conn;
+
     if (conf_flags.filter_enabled) {
-        return fort_callout_ale_check_filter_flags(ca, conn, conf_ref, conf_flags);
+        return fort_callout_ale_check_filter_flags(ca, cx, conf_ref, conf_flags);
     }
 
     conn->blocked = FALSE;
@@ -553,7 +570,7 @@ inline static void fort_callout_ale_check_conf(PCFORT_CALLOUT_ARG ca, PFORT_CALL
     conn->blocked = TRUE;
     conn->reason = FORT_CONN_REASON_UNKNOWN;
 
-    if (!fort_callout_ale_check_flags(ca, conn, conf_ref, conf_flags)) {
+    if (!fort_callout_ale_check_flags(ca, cx, conf_ref, conf_flags)) {
         fort_callout_ale_fill_meta_conn(ca, conn);
 
         fort_callout_ale_check_app(ca, cx, conf_ref, conf_flags);
@@ -573,6 +590,10 @@ inline static void fort_callout_ale_check_conf(PCFORT_CALLOUT_ARG ca, PFORT_CALL
 inline static void fort_callout_ale_by_conf(PCFORT_CALLOUT_ARG ca, PFORT_CALLOUT_ALE_EXTRA cx,
         PFORT_DEVICE_CONF device_conf, const FORT_CONF_FLAGS conf_flags)
 {
+    /* Take the generations before the conf, they are incremented after the conf changes */
+    cx->reauth_gen = fort_conf_reauth_gen(&device_conf->reauth);
+    cx->addr_gen = fort_conf_reauth_all_gen(&device_conf->reauth);
+
     PFORT_CONF_REF conf_ref = fort_conf_ref_take(device_conf);
 
     if (conf_ref == NULL) {
@@ -628,6 +649,23 @@ inline static BOOL fort_callout_ale_is_local_address(PFORT_CALLOUT_ARG ca,
     return FALSE;
 }
 
+inline static BOOL fort_callout_ale_reauth_skip(
+        PCFORT_CALLOUT_ARG ca, PFORT_DEVICE_CONF device_conf)
+{
+    PFORT_CONF_REAUTH reauth = &device_conf->reauth;
+
+    const UINT64 flow_id = ca->inMetaValues->flowHandle;
+    const UCHAR profile_id = ca->inFixedValues->incomingValue[ca->fi->profileId].value.uint8;
+
+    if (fort_flow_reauth_unchanged(&fort_device()->stat, flow_id, profile_id, reauth)) {
+        InterlockedIncrement(&reauth->skipped_count);
+        return TRUE; /* the app, conf and profile are not changed since the flow was permitted */
+    }
+
+    InterlockedIncrement(&reauth->evaluated_count);
+    return FALSE;
+}
+
 static void fort_callout_ale_classify(PFORT_CALLOUT_ARG ca)
 {
     FORT_CHECK_STACK(FORT_CALLOUT_ALE_CLASSIFY);
@@ -652,6 +690,8 @@ static void fort_callout_ale_classify(PFORT_CALLOUT_ARG ca)
 
     if (fort_callout_ale_is_local_address(ca, &cx, conf_flags, classify_flags)) {
         fort_callout_classify_permit(ca->filter, ca->classifyOut);
+    } else if (is_reauth && fort_callout_ale_reauth_skip(ca, device_conf)) {
+        fort_callout_classify_permit(ca->filter, ca->classifyOut); /* previous verdict */
     } else {
         fort_callout_ale_by_conf(ca, &cx, device_conf, conf_flags);
     }
@@ -674,7 +714,14 @@ inline static void fort_callout_ale_classify_v(const FWPS_INCOMING_VALUES0 *inFi
         .isIPv6 = isIPv6,
     };
 
+    const LARGE_INTEGER start = KeQueryPerformanceCounter(NULL);
+
     fort_callout_ale_classify(&ca);
+
+    const UCHAR callout_id = (inbound ? FORT_PERF_CALLOUT_ACCEPT_V4 : FORT_PERF_CALLOUT_CONNECT_V4)
+            + (isIPv6 ? 1 : 0); /* V6 follows V4 */
+
+    fort_perf_callout_time(&fort_device()->perf, callout_id, start);
 }
 
 static void NTAPI fort_callout_connect_v4(const FWPS_INCOMING_VALUES0 *inFixedValues,
@@ -832,16 +879,24 @@ static void NTAPI fort_callout_transport_classify_in(const FWPS_INCOMING_VALUES0
         const FWPS_INCOMING_METADATA_VALUES0 *inMetaValues, PVOID layerData,
         const FWPS_FILTER0 *filter, UINT64 flowContext, FWPS_CLASSIFY_OUT0 *classifyOut)
 {
+    const LARGE_INTEGER start = KeQueryPerformanceCounter(NULL);
+
     fort_callout_transport_classify(inFixedValues, inMetaValues, layerData, filter, flowContext,
             classifyOut, /*inbound=*/TRUE);
+
+    fort_perf_callout_time(&fort_device()->perf, FORT_PERF_CALLOUT_TRANSPORT_IN, start);
 }
 
 static void NTAPI fort_callout_transport_classify_out(const FWPS_INCOMING_VALUES0 *inFixedValues,
         const FWPS_INCOMING_METADATA_VALUES0 *inMetaValues, PVOID layerData,
         const FWPS_FILTER0 *filter, UINT64 flowContext, FWPS_CLASSIFY_OUT0 *classifyOut)
 {
+    const LARGE_INTEGER start = KeQueryPerformanceCounter(NULL);
+
     fort_callout_transport_classify(inFixedValues, inMetaValues, layerData, filter, flowContext,
             classifyOut, /*inbound=*/FALSE);
+
+    fort_perf_callout_time(&fort_device()->perf, FORT_PERF_CALLOUT_TRANSPORT_OUT, start);
 }
 
 static void NTAPI fort_callout_flow_delete(UINT16 layerId, UINT32 calloutId, UINT64 flowContext)
@@ -1196,15 +1251,18 @@ inline static void fort_callout_update_system_time(
     LARGE_INTEGER system_time;
     KeQuerySystemTime(&system_time);
 
-    if (stat->system_time.QuadPart == system_time.QuadPart)
+    const INT64 unix_time = fort_system_to_unix_time(system_time.QuadPart);
+
+    /* The Unix time has seconds resolution */
+    if (fort_system_to_unix_time(stat->system_time.QuadPart) == unix_time
+            && (fort_stat_flags(stat) & FORT_STAT_SYSTEM_TIME_CHANGED) == 0)
         return;
 
     stat->system_time = system_time;
 
     PCHAR out;
-    if (NT_SUCCESS(fort_buffer_prepare(buf, FORT_LOG_TIME_SIZE, &out, irp_info))) {
-        const INT64 unix_time = fort_system_to_unix_time(system_time.QuadPart);
-
+    if (NT_SUCCESS(fort_buffer_prepare(
+                buf, FORT_LOG_TIME_SIZE, FORT_LOG_CLASS_STAT, &out, irp_info))) {
         const UCHAR old_stat_flags =
                 fort_stat_flags_set(stat, FORT_STAT_SYSTEM_TIME_CHANGED, FALSE);
         const BOOL system_time_changed = (old_stat_flags & FORT_STAT_SYSTEM_TIME_CHANGED) != 0;
@@ -1223,8 +1281,11 @@ inline static void fort_callout_flush_stat_traf(
         const UINT32 len = FORT_LOG_STAT_SIZE(proc_count);
         PCHAR out;
 
-        const NTSTATUS status = fort_buffer_prepare(buf, len, &out, irp_info);
+        const NTSTATUS status = fort_buffer_prepare(buf, len, FORT_LOG_CLASS_STAT, &out, irp_info);
         if (!NT_SUCCESS(status)) {
+            if (status == FORT_STATUS_BUFFER_DROPPED)
+                break; /* keep the traffic till the next flush */
+
             LOG("Callout Timer: Error: %x\n", status);
             TRACE(FORT_CALLOUT_CALLOUT_TIMER_ERROR, status, 0, 0);
             break;
@@ -1246,6 +1307,9 @@ FORT_API void fort_callout_timer(void)
 
     FORT_IRP_INFO irp_info = { .irp = NULL };
 
+    /* Reserve the flows map's growth */
+    fort_stat_dpc_flows_reserve(stat);
+
     /* Lock buffer */
     KLOCK_QUEUE_HANDLE buf_lock_queue;
     fort_buffer_dpc_begin(buf, &buf_lock_queue);
@@ -1257,12 +1321,20 @@ FORT_API void fort_callout_timer(void)
     /* Get current Unix time */
     fort_callout_update_system_time(stat, buf, &irp_info);
 
+    /* Report dropped log records */
+    fort_buffer_flush_dropped(buf, &irp_info);
+
+    /* Adapt the flush period to the traffic */
+    const UINT16 period = fort_stat_flush_period_next(&stat->flush, stat->proc_active_count);
+
     /* Flush traffic statistics */
     fort_callout_flush_stat_traf(stat, buf, &irp_info);
 
     /* Unlock stat */
     fort_stat_dpc_end(&stat_lock_queue);
 
+    fort_timer_update_period(&fort_device()->log_timer, period);
+
     /* Flush pending buffer */
     if (irp_info.irp == NULL) {
         fort_buffer_flush_pending(buf, &irp_info);
@@ -45,6 +45,9 @@ typedef struct fort_callout_ale_extra
 {
     FORT_CONF_META_CONN conn;
 
+    UINT32 reauth_gen; /* generation of the conf on classify */
+    UINT32 addr_gen; /* generation of all flows' changes on classify */
+
     FORT_IRP_INFO irp_info;
 } FORT_CALLOUT_ALE_EXTRA, *PFORT_CALLOUT_ALE_EXTRA;
 
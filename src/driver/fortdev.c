@@ -63,11 +63,38 @@ static void fort_device_reauth_queue(void)
 
 static void fort_device_conf_reauth_queue(PFORT_DEVICE_CONF device_conf)
 {
+    fort_conf_reauth_all(&device_conf->reauth);
+
     if (device_conf->ref != NULL) {
         fort_device_reauth_queue();
     }
 }
 
+static void fort_device_app_reauth(PCFORT_APP_ENTRY app_entry)
+{
+    const FORT_APP_PATH path = {
+        .len = app_entry->path_len,
+        .buffer = app_entry->path,
+    };
+
+    fort_conf_reauth_app(&fort_device()->conf.reauth, fort_conf_reauth_path_hash(&path));
+}
+
+static void fort_device_app_entries_reauth(PCFORT_APP_ENTRIES app_entries)
+{
+    const char *data = app_entries->data;
+
+    const int count = app_entries->count;
+
+    for (int i = 0; i < count; ++i) {
+        PCFORT_APP_ENTRY app_entry = (PCFORT_APP_ENTRY) data;
+
+        fort_device_app_reauth(app_entry);
+
+        data += FORT_CONF_APP_ENTRY_SIZE(app_entry->path_len);
+    }
+}
+
 FORT_API NTSTATUS fort_device_create(PDEVICE_OBJECT device, PIRP irp)
 {
     UNUSED(device);
@@ -123,6 +150,8 @@ FORT_API NTSTATUS fort_device_cleanup(PDEVICE_OBJECT device, PIRP irp)
 
         fort_stat_conf_flags_update(&fort_device()->stat, conf_flags);
 
+        fort_conf_reauth_all(&fort_device()->conf.reauth);
+
         fort_device_reauth_force(old_conf_flags);
     }
 
@@ -161,6 +190,9 @@ static NTSTATUS fort_device_control_setservices(PFORT_DEVICE_CONTROL_ARG dca)
         fort_pstree_update_services(&fort_device()->ps_tree, services,
                 /*data_len=*/len - FORT_SERVICE_INFO_LIST_DATA_OFF);
 
+        /* Apps' paths may be changed */
+        fort_conf_reauth_all(&fort_device()->conf.reauth);
+
         return STATUS_SUCCESS;
     }
 
@@ -183,6 +215,8 @@ inline static NTSTATUS fort_device_control_setconf_ref(
         fort_pstree_enum_processes(&fort_device()->ps_tree);
     }
 
+    fort_conf_reauth_all(&device_conf->reauth);
+
     return fort_device_reauth_force(old_conf_flags);
 }
 
@@ -219,6 +253,8 @@ static NTSTATUS fort_device_control_setflags(PFORT_DEVICE_CONTROL_ARG dca)
         fort_stat_conf_flags_update(&fort_device()->stat, conf_flags);
         fort_shaper_conf_flags_update(&fort_device()->shaper, conf_flags);
 
+        fort_conf_reauth_all(&fort_device()->conf.reauth);
+
         return fort_device_reauth_force(old_conf_flags);
     }
 
@@ -239,11 +275,36 @@ static NTSTATUS fort_device_control_getlog(PFORT_DEVICE_CONTROL_ARG dca)
 
     if (status == STATUS_PENDING) {
         fort_buffer_irp_mark_pending(irp_info);
+
+        fort_perf_buffer_irp_wait(&fort_device()->perf);
     }
 
     return status;
 }
 
+static NTSTATUS fort_device_control_getstats(PFORT_DEVICE_CONTROL_ARG dca)
+{
+    PFORT_PERF_STATS stats = dca->buffer;
+    const ULONG out_len = dca->out_len;
+
+    if (out_len < sizeof(FORT_PERF_STATS))
+        return STATUS_BUFFER_TOO_SMALL;
+
+    fort_perf_stats_get(&fort_device()->perf, stats);
+
+    PFORT_DEVICE_CONF device_conf = &fort_device()->conf;
+
+    stats->reauth_skipped_count = (ULONG) InterlockedOr(&device_conf->reauth.skipped_count, 0);
+    stats->reauth_evaluated_count = (ULONG) InterlockedOr(&device_conf->reauth.evaluated_count, 0);
+
+    stats->addr_cache_hit_count = (ULONG) InterlockedOr(&device_conf->addr_cache.hit_count, 0);
+    stats->addr_cache_miss_count = (ULONG) InterlockedOr(&device_conf->addr_cache.miss_count, 0);
+
+    dca->irp_info->info = sizeof(FORT_PERF_STATS);
+
+    return STATUS_SUCCESS;
+}
+
 inline static NTSTATUS fort_device_control_app_conf(
         PFORT_CONF_REF conf_ref, PCFORT_APP_ENTRY app_entry, BOOL is_adding)
 {
@@ -277,6 +338,8 @@ static NTSTATUS fort_device_control_app(PFORT_DEVICE_CONTROL_ARG dca, BOOL is_ad
     fort_conf_ref_put(&fort_device()->conf, conf_ref);
 
     if (NT_SUCCESS(status)) {
+        fort_device_app_reauth(app_entry);
+
         fort_device_reauth_queue();
     }
 
@@ -293,6 +356,33 @@ static NTSTATUS fort_device_control_delapp(PFORT_DEVICE_CONTROL_ARG dca)
     return fort_device_control_app(dca, /*is_adding=*/FALSE);
 }
 
+static NTSTATUS fort_device_control_addapps(PFORT_DEVICE_CONTROL_ARG dca)
+{
+    PCFORT_APP_ENTRIES app_entries = dca->buffer;
+    const ULONG len = dca->in_len;
+
+    if (!fort_conf_app_entries_check(app_entries, len))
+        return STATUS_UNSUCCESSFUL;
+
+    PFORT_CONF_REF conf_ref = fort_conf_ref_take(&fort_device()->conf);
+
+    if (conf_ref == NULL)
+        return STATUS_INVALID_PARAMETER;
+
+    const NTSTATUS status = fort_conf_ref_exe_add_entries(conf_ref, app_entries);
+
+    fort_conf_ref_put(&fort_device()->conf, conf_ref);
+
+    /* Some entries may be added even on error */
+    if (app_entries->count != 0) {
+        fort_device_app_entries_reauth(app_entries);
+
+        fort_device_reauth_queue();
+    }
+
+    return status;
+}
+
 static NTSTATUS fort_device_control_setzones(PFORT_DEVICE_CONTROL_ARG dca)
 {
     PCFORT_CONF_ZONES zones = dca->buffer;
@@ -377,7 +467,7 @@ static NTSTATUS fort_device_control_setruleflag(PFORT_DEVICE_CONTROL_ARG dca)
     return STATUS_UNSUCCESSFUL;
 }
 
-static_assert(FORT_CTL_INDEX_FROM_CODE(FORT_IOCTL_SETRULEFLAG) == FORT_IOCTL_INDEX_SETRULEFLAG,
+static_assert(FORT_CTL_INDEX_FROM_CODE(FORT_IOCTL_GETSTATS) == FORT_IOCTL_INDEX_GETSTATS,
         "Invalid FORT_CTL_INDEX_FROM_CODE()");
 
 typedef NTSTATUS(FORT_DEVICE_CONTROL_PROCESS_FUNC)(PFORT_DEVICE_CONTROL_ARG dca);
@@ -395,6 +485,8 @@ static PFORT_DEVICE_CONTROL_PROCESS_FUNC fortDeviceControlProcess_funcList[] = {
     &fort_device_control_setzoneflag, // FORT_IOCTL_SETZONEFLAG
     &fort_device_control_setrules, // FORT_IOCTL_SETRULES
     &fort_device_control_setruleflag, // FORT_IOCTL_SETRULEFLAG
+    &fort_device_control_addapps, // FORT_IOCTL_ADDAPPS
+    &fort_device_control_getstats, // FORT_IOCTL_GETSTATS
 };
 
 static NTSTATUS fort_device_control_process(PFORT_DEVICE_CONTROL_ARG dca)
@@ -507,12 +599,14 @@ FORT_API NTSTATUS fort_device_load(PVOID device_param)
 
     fort_worker_func_set(&fort_device()->worker, FORT_WORKER_REAUTH, &fort_device_reauth);
 
+    fort_perf_open(&fort_device()->perf);
     fort_device_conf_open(&fort_device()->conf);
     fort_buffer_open(&fort_device()->buffer);
     fort_stat_open(&fort_device()->stat);
     fort_pending_open(&fort_device()->pending);
     fort_shaper_open(&fort_device()->shaper);
-    fort_timer_open(&fort_device()->log_timer, 500, /*flags=*/0, &fort_callout_timer);
+    fort_timer_open(&fort_device()->log_timer, FORT_STAT_FLUSH_PERIOD_MIN, /*flags=*/0,
+            &fort_callout_timer);
     fort_pstree_open(&fort_device()->ps_tree);
 
     /* Register filters provider */
@@ -571,6 +665,12 @@ FORT_API void fort_device_unload(void)
     /* Uninstall callouts */
     fort_callout_remove();
 
+    /* Wait for the timer DPCs expedited by the last classifies */
+    KeFlushQueuedDpcs();
+
+    /* Free performance counters */
+    fort_perf_close(&fort_device()->perf);
+
     /* Unregister filters provider */
     if (fort_device_flag(&fort_device()->conf, FORT_DEVICE_BOOT_FILTER) == 0) {
         fort_prov_trans_unregister();
@@ -6,6 +6,7 @@
 #include "fortbuf.h"
 #include "fortcnf.h"
 #include "fortpkt.h"
+#include "fortprf.h"
 #include "fortps.h"
 #include "fortstat.h"
 #include "forttmr.h"
@@ -31,6 +32,7 @@ typedef struct fort_device
     FORT_PSTREE ps_tree;
     FORT_TIMER log_timer;
     FORT_WORKER worker;
+    FORT_PERF perf;
 } FORT_DEVICE, *PFORT_DEVICE;
 
 #if defined(__cplusplus)
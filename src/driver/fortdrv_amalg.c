@@ -10,6 +10,7 @@
 
 #include "common/fortconf.c"
 #include "common/fortlog.c"
+#include "common/fortperf.c"
 #include "common/fortprov.c"
 #include "common/fort_wildmatch.c"
 
@@ -22,13 +23,16 @@
 #include "fortbuf.c"
 #include "fortcb.c"
 #include "fortcnf.c"
+#include "fortcnf_addr.c"
 #include "fortcnf_conf.c"
 #include "fortcnf_rule.c"
 #include "fortcnf_zone.c"
 #include "fortdbg.c"
+#include "fortflow.c"
 #include "fortmod.c"
 #include "fortpkt.c"
 #include "fortpool.c"
+#include "fortprf.c"
 #include "fortps.c"
 #include "fortstat.c"
 #include "fortscb.c"
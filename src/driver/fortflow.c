@@ -0,0 +1,290 @@
+/* Fort Firewall Flows Map */
+
+#include "fortflow.h"
+
+#include "forttds.h"
+
+#define FORT_FLOW_MAP_POOL_TAG 'FwfF'
+
+#define FORT_FLOW_MAP_SIZE_MIN     1024
+#define FORT_FLOW_MAP_MIGRATE_STEP 8 /* old slots to migrate per update */
+
+#define fort_flow_map_hash(id)       tommy_inthash_u64(id)
+#define fort_flow_map_home(id, mask) ((UINT32) fort_flow_map_hash(id) & (mask))
+
+/* Load factor is above 3/4 */
+#define fort_flow_map_overload(count, mask) ((UINT64) (count) * 4 > ((UINT64) (mask) + 1) * 3)
+
+/* Load factor is above 1/2: time to reserve the spare table */
+#define fort_flow_map_halfload(count, mask) ((UINT64) (count) * 2 > ((UINT64) (mask) + 1))
+
+#define fort_flow_map_next_size(map)                                                               \
+    (((map)->slots != NULL) ? ((map)->mask + 1) * 2 : FORT_FLOW_MAP_SIZE_MIN)
+
+static PFORT_FLOW_MAP_SLOT fort_flow_map_slots_new(UINT32 size)
+{
+    const SIZE_T slots_size = size * sizeof(FORT_FLOW_MAP_SLOT);
+
+    PFORT_FLOW_MAP_SLOT slots = fort_mem_alloc(slots_size, FORT_FLOW_MAP_POOL_TAG);
+    if (slots != NULL) {
+        RtlZeroMemory(slots, slots_size);
+    }
+
+    return slots;
+}
+
+static void fort_flow_map_slots_del(PFORT_FLOW_MAP_SLOT slots)
+{
+    if (slots != NULL) {
+        fort_mem_free(slots, FORT_FLOW_MAP_POOL_TAG);
+    }
+}
+
+static PFORT_FLOW_MAP_SLOT fort_flow_map_slots_find(
+        PFORT_FLOW_MAP_SLOT slots, UINT32 mask, UINT64 id)
+{
+    if (slots == NULL)
+        return NULL;
+
+    UINT32 i = fort_flow_map_home(id, mask);
+
+    for (;;) {
+        PFORT_FLOW_MAP_SLOT slot = &slots[i];
+
+        if (slot->value == NULL)
+            return NULL;
+
+        if (slot->id == id)
+            return slot;
+
+        i = (i + 1) & mask;
+    }
+}
+
+static void fort_flow_map_slots_put(PFORT_FLOW_MAP_SLOT slots, UINT32 mask, UINT64 id, PVOID value)
+{
+    UINT32 i = fort_flow_map_home(id, mask);
+
+    while (slots[i].value != NULL) {
+        i = (i + 1) & mask;
+    }
+
+    slots[i].id = id;
+    slots[i].value = value;
+}
+
+static void fort_flow_map_slots_erase(PFORT_FLOW_MAP_SLOT slots, UINT32 mask, UINT32 i)
+{
+    /* Shift back the following slots of the cluster, which may take the hole */
+    UINT32 j = i;
+
+    for (;;) {
+        j = (j + 1) & mask;
+
+        PFORT_FLOW_MAP_SLOT slot = &slots[j];
+        if (slot->value == NULL)
+            break;
+
+        const UINT32 home = fort_flow_map_home(slot->id, mask);
+
+        /* Is the hole between the slot's home and the slot? */
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            slots[i] = *slot;
+            i = j;
+        }
+    }
+
+    slots[i].value = NULL;
+}
+
+static void fort_flow_map_migrate(PFORT_FLOW_MAP map, UINT32 steps)
+{
+    PFORT_FLOW_MAP_SLOT old_slots = map->old_slots;
+    if (old_slots == NULL)
+        return;
+
+    const UINT32 old_mask = map->old_mask;
+
+    while (steps-- != 0 && map->old_index <= old_mask) {
+        PFORT_FLOW_MAP_SLOT slot = &old_slots[map->old_index];
+
+        if (slot->value == NULL) {
+            ++map->old_index;
+            continue;
+        }
+
+        fort_flow_map_slots_put(map->slots, map->mask, slot->id, slot->value);
+
+        /* The erasing may shift the next slot back to the cursor */
+        fort_flow_map_slots_erase(old_slots, old_mask, map->old_index);
+    }
+
+    if (map->old_index > old_mask) {
+        map->old_slots = NULL;
+
+        fort_flow_map_slots_del(old_slots);
+    }
+}
+
+static NTSTATUS fort_flow_map_grow(PFORT_FLOW_MAP map)
+{
+    /* Finish the previous migration */
+    fort_flow_map_migrate(map, MAXUINT32);
+
+    const UINT32 size = fort_flow_map_next_size(map);
+
+    PFORT_FLOW_MAP_SLOT slots;
+
+    if (map->spare_slots != NULL && map->spare_mask == size - 1) {
+        slots = map->spare_slots;
+        map->spare_slots = NULL;
+    } else {
+        /* The spare table is not reserved yet */
+        slots = (size != 0) ? fort_flow_map_slots_new(size) : NULL;
+        if (slots == NULL)
+            return STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    map->old_slots = map->slots;
+    map->old_mask = map->mask;
+    map->old_index = 0;
+
+    map->slots = slots;
+    map->mask = size - 1;
+
+    return STATUS_SUCCESS;
+}
+
+FORT_API void fort_flow_map_init(PFORT_FLOW_MAP map)
+{
+    RtlZeroMemory(map, sizeof(FORT_FLOW_MAP));
+}
+
+FORT_API void fort_flow_map_done(PFORT_FLOW_MAP map)
+{
+    fort_flow_map_slots_del(map->spare_slots);
+    fort_flow_map_slots_del(map->old_slots);
+    fort_flow_map_slots_del(map->slots);
+
+    fort_flow_map_init(map);
+}
+
+FORT_API PVOID fort_flow_map_get(PFORT_FLOW_MAP map, UINT64 id)
+{
+    PFORT_FLOW_MAP_SLOT slot = fort_flow_map_slots_find(map->slots, map->mask, id);
+
+    if (slot == NULL) {
+        slot = fort_flow_map_slots_find(map->old_slots, map->old_mask, id);
+    }
+
+    return (slot != NULL) ? slot->value : NULL;
+}
+
+FORT_API NTSTATUS fort_flow_map_insert(PFORT_FLOW_MAP map, UINT64 id, PVOID value)
+{
+    NT_ASSERT(value != NULL);
+
+    fort_flow_map_migrate(map, FORT_FLOW_MAP_MIGRATE_STEP);
+
+    const UINT32 count = map->count + 1;
+
+    if (map->slots == NULL || fort_flow_map_overload(count, map->mask)) {
+        const NTSTATUS status = fort_flow_map_grow(map);
+
+        /* Keep at least one empty slot to stop the probing */
+        if (!NT_SUCCESS(status) && (map->slots == NULL || count > map->mask))
+            return status;
+    }
+
+    fort_flow_map_slots_put(map->slots, map->mask, id, value);
+
+    map->count = count;
+
+    return STATUS_SUCCESS;
+}
+
+FORT_API PVOID fort_flow_map_remove(PFORT_FLOW_MAP map, UINT64 id)
+{
+    fort_flow_map_migrate(map, FORT_FLOW_MAP_MIGRATE_STEP);
+
+    PFORT_FLOW_MAP_SLOT slots = map->slots;
+    UINT32 mask = map->mask;
+
+    PFORT_FLOW_MAP_SLOT slot = fort_flow_map_slots_find(slots, mask, id);
+
+    if (slot == NULL) {
+        slots = map->old_slots;
+        mask = map->old_mask;
+
+        slot = fort_flow_map_slots_find(slots, mask, id);
+        if (slot == NULL)
+            return NULL;
+    }
+
+    PVOID value = slot->value;
+
+    fort_flow_map_slots_erase(slots, mask, (UINT32) (slot - slots));
+
+    --map->count;
+
+    return value;
+}
+
+static void fort_flow_map_slots_foreach(
+        PFORT_FLOW_MAP_SLOT slots, UINT32 mask, fort_flow_map_func *func, PVOID arg)
+{
+    if (slots == NULL)
+        return;
+
+    for (UINT32 i = 0; i <= mask; ++i) {
+        PVOID value = slots[i].value;
+
+        if (value != NULL) {
+            func(arg, value);
+        }
+    }
+}
+
+FORT_API void fort_flow_map_foreach(PFORT_FLOW_MAP map, fort_flow_map_func *func, PVOID arg)
+{
+    fort_flow_map_slots_foreach(map->slots, map->mask, func, arg);
+    fort_flow_map_slots_foreach(map->old_slots, map->old_mask, func, arg);
+}
+
+FORT_API UINT32 fort_flow_map_spare_size(PFORT_FLOW_MAP map)
+{
+    const UINT32 size = fort_flow_map_next_size(map);
+
+    if (size == 0 || (map->spare_slots != NULL && map->spare_mask == size - 1))
+        return 0;
+
+    if (map->slots != NULL && !fort_flow_map_halfload(map->count, map->mask))
+        return 0;
+
+    return size;
+}
+
+FORT_API PFORT_FLOW_MAP_SLOT fort_flow_map_spare_new(UINT32 size)
+{
+    return fort_flow_map_slots_new(size);
+}
+
+FORT_API PFORT_FLOW_MAP_SLOT fort_flow_map_spare_set(
+        PFORT_FLOW_MAP map, PFORT_FLOW_MAP_SLOT slots, UINT32 size)
+{
+    /* The map may have grown meanwhile */
+    if (slots == NULL || size != fort_flow_map_next_size(map))
+        return slots;
+
+    PFORT_FLOW_MAP_SLOT old_spare_slots = map->spare_slots;
+
+    map->spare_slots = slots;
+    map->spare_mask = size - 1;
+
+    return old_spare_slots;
+}
+
+FORT_API void fort_flow_map_spare_del(PFORT_FLOW_MAP_SLOT slots)
+{
+    fort_flow_map_slots_del(slots);
+}
@@ -0,0 +1,64 @@
+#ifndef FORTFLOW_H
+#define FORTFLOW_H
+
+#include "fortdrv.h"
+
+/* Open addressing map of 64-bit flow ids to flow pointers:
+ * linear probing, backward shift deletion (no tombstones) and
+ * incremental migration to a doubled table, spread over the following updates.
+ * The doubled table is pre-allocated out of the caller's lock as a spare one. */
+typedef struct fort_flow_map_slot
+{
+    UINT64 id;
+    PVOID value; /* NULL for an empty slot */
+} FORT_FLOW_MAP_SLOT, *PFORT_FLOW_MAP_SLOT;
+
+typedef struct fort_flow_map
+{
+    UINT32 count;
+
+    UINT32 mask;
+    PFORT_FLOW_MAP_SLOT slots;
+
+    UINT32 old_mask;
+    UINT32 old_index; /* migration cursor */
+    PFORT_FLOW_MAP_SLOT old_slots; /* being migrated to the slots */
+
+    UINT32 spare_mask;
+    PFORT_FLOW_MAP_SLOT spare_slots; /* for the next growth */
+} FORT_FLOW_MAP, *PFORT_FLOW_MAP;
+
+typedef void fort_flow_map_func(PVOID arg, PVOID value);
+
+#define fort_flow_map_count(map) ((map)->count)
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+FORT_API void fort_flow_map_init(PFORT_FLOW_MAP map);
+
+FORT_API void fort_flow_map_done(PFORT_FLOW_MAP map);
+
+FORT_API PVOID fort_flow_map_get(PFORT_FLOW_MAP map, UINT64 id);
+
+FORT_API NTSTATUS fort_flow_map_insert(PFORT_FLOW_MAP map, UINT64 id, PVOID value);
+
+FORT_API PVOID fort_flow_map_remove(PFORT_FLOW_MAP map, UINT64 id);
+
+FORT_API void fort_flow_map_foreach(PFORT_FLOW_MAP map, fort_flow_map_func *func, PVOID arg);
+
+FORT_API UINT32 fort_flow_map_spare_size(PFORT_FLOW_MAP map);
+
+FORT_API PFORT_FLOW_MAP_SLOT fort_flow_map_spare_new(UINT32 size);
+
+FORT_API PFORT_FLOW_MAP_SLOT fort_flow_map_spare_set(
+        PFORT_FLOW_MAP map, PFORT_FLOW_MAP_SLOT slots, UINT32 size);
+
+FORT_API void fort_flow_map_spare_del(PFORT_FLOW_MAP_SLOT slots);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // FORTFLOW_H
@@ -912,13 +912,19 @@ void fort_shaper_conf_flags_update(PFORT_SHAPER shaper, const FORT_CONF_FLAGS co
 }
 
 static void fort_shaper_packet_queue_add_packet(
-        PFORT_SHAPER shaper, PFORT_PACKET_QUEUE queue, PFORT_FLOW_PACKET pkt, UINT32 queue_bit)
+        PFORT_SHAPER shaper, PFORT_PACKET_QUEUE queue, PFORT_FLOW_PACKET pkt, UINT16 queue_index)
 {
+    const UINT32 queue_bit = (1 << queue_index);
+
+    fort_perf_lock_acquire(&fort_device()->perf, FORT_PERF_LOCK_SHAPER, &queue->lock);
+
     KLOCK_QUEUE_HANDLE lock_queue;
     KeAcquireInStackQueuedSpinLock(&queue->lock, &lock_queue);
     {
         queue->queued_bytes += pkt->data_length;
 
+        fort_perf_queue_bytes(&fort_device()->perf, queue_index, queue->queued_bytes);
+
         fort_shaper_packet_list_add_chain(&queue->bandwidth_list, pkt, pkt);
 
         fort_shaper_io_bits_set(&shaper->active_io_bits, queue_bit, TRUE);
@@ -950,6 +956,8 @@ static BOOL fort_shaper_packet_queue_check_packet(
 {
     BOOL res;
 
+    fort_perf_lock_acquire(&fort_device()->perf, FORT_PERF_LOCK_SHAPER, &queue->lock);
+
     KLOCK_QUEUE_HANDLE lock_queue;
     KeAcquireInStackQueuedSpinLock(&queue->lock, &lock_queue);
     {
@@ -978,6 +986,7 @@ inline static NTSTATUS fort_shaper_packet_queue(
 
     /* Check the Queue for new Packet */
     if (!fort_shaper_packet_queue_check_packet(shaper, queue, ca->dataSize)) {
+        fort_perf_queue_drop(&fort_device()->perf, queue_index);
         return STATUS_SUCCESS; /* drop the packet */
     }
 
@@ -998,7 +1007,7 @@ inline static NTSTATUS fort_shaper_packet_queue(
     pkt->data_length = ca->dataSize;
 
     /* Add the Packet to Queue */
-    fort_shaper_packet_queue_add_packet(shaper, queue, pkt, queue_bit);
+    fort_shaper_packet_queue_add_packet(shaper, queue, pkt, queue_index);
 
     /* Packets in transport layer must be re-injected in DCP/thread due to locking */
     fort_shaper_thread_set_event(shaper);
@@ -0,0 +1,168 @@
+/* Fort Firewall Driver Performance Counters */
+
+#include "fortprf.h"
+
+#define FORT_PERF_POOL_TAG 'PwfF'
+
+/* Keep the thread on the CPU while updating its counters */
+static PFORT_PERF_STATS fort_perf_cpu_begin(PFORT_PERF perf, PKIRQL old_irql)
+{
+    PFORT_PERF_STATS cpus = perf->cpus;
+    if (cpus == NULL)
+        return NULL;
+
+    KeRaiseIrql(DISPATCH_LEVEL, old_irql);
+
+    const ULONG cpu_index = KeGetCurrentProcessorNumberEx(NULL);
+
+    return &cpus[cpu_index % perf->cpu_count];
+}
+
+static void fort_perf_cpu_end(KIRQL old_irql)
+{
+    KeLowerIrql(old_irql);
+}
+
+FORT_API void fort_perf_open(PFORT_PERF perf)
+{
+    const ULONG cpu_count = KeQueryMaximumProcessorCountEx(ALL_PROCESSOR_GROUPS);
+
+    KeQueryPerformanceCounter(&perf->qpc_frequency);
+
+    perf->cpu_count = (UINT16) (cpu_count < 0xFFFF ? cpu_count : 0xFFFF);
+
+    if (perf->cpu_count == 0)
+        return;
+
+    const SIZE_T size = perf->cpu_count * sizeof(FORT_PERF_STATS);
+
+    perf->cpus = fort_mem_alloc(size, FORT_PERF_POOL_TAG);
+
+    if (perf->cpus != NULL) {
+        RtlZeroMemory(perf->cpus, size);
+    }
+}
+
+FORT_API void fort_perf_close(PFORT_PERF perf)
+{
+    PFORT_PERF_STATS cpus = perf->cpus;
+    if (cpus == NULL)
+        return;
+
+    perf->cpus = NULL;
+
+    fort_mem_free(cpus, FORT_PERF_POOL_TAG);
+}
+
+FORT_API void fort_perf_callout_time(PFORT_PERF perf, UCHAR callout_id, LARGE_INTEGER start)
+{
+    const INT64 frequency = perf->qpc_frequency.QuadPart;
+    if (frequency == 0)
+        return;
+
+    const LARGE_INTEGER now = KeQueryPerformanceCounter(NULL);
+    const INT64 ticks = now.QuadPart - start.QuadPart;
+
+    const UINT64 time_ns = (ticks > 0) ? (UINT64) ticks * 1000000000 / frequency : 0;
+
+    KIRQL old_irql;
+    PFORT_PERF_STATS stats = fort_perf_cpu_begin(perf, &old_irql);
+    if (stats == NULL)
+        return;
+
+    fort_perf_callout_add_time(&stats->callouts[callout_id],
+            (time_ns < MAXUINT32) ? (UINT32) time_ns : MAXUINT32);
+
+    fort_perf_cpu_end(old_irql);
+}
+
+FORT_API void fort_perf_lock_acquire(PFORT_PERF perf, UCHAR lock_id, PKSPIN_LOCK lock)
+{
+    KIRQL old_irql;
+    PFORT_PERF_STATS stats = fort_perf_cpu_begin(perf, &old_irql);
+    if (stats == NULL)
+        return;
+
+    PFORT_PERF_LOCK perf_lock = &stats->locks[lock_id];
+
+    ++perf_lock->acquire_count;
+
+    if (!KeTestSpinLock(lock)) {
+        ++perf_lock->contend_count;
+    }
+
+    fort_perf_cpu_end(old_irql);
+}
+
+FORT_API void fort_perf_queue_drop(PFORT_PERF perf, UINT16 queue_index)
+{
+    KIRQL old_irql;
+    PFORT_PERF_STATS stats = fort_perf_cpu_begin(perf, &old_irql);
+    if (stats == NULL)
+        return;
+
+    ++stats->queues[queue_index].drop_count;
+
+    fort_perf_cpu_end(old_irql);
+}
+
+FORT_API void fort_perf_queue_bytes(PFORT_PERF perf, UINT16 queue_index, UINT64 queued_bytes)
+{
+    const UINT32 bytes = (queued_bytes < MAXUINT32) ? (UINT32) queued_bytes : MAXUINT32;
+
+    KIRQL old_irql;
+    PFORT_PERF_STATS stats = fort_perf_cpu_begin(perf, &old_irql);
+    if (stats == NULL)
+        return;
+
+    PFORT_PERF_QUEUE queue = &stats->queues[queue_index];
+
+    if (queue->queued_max < bytes) {
+        queue->queued_max = bytes;
+    }
+
+    fort_perf_cpu_end(old_irql);
+}
+
+FORT_API void fort_perf_buffer_size(PFORT_PERF perf, UINT32 size)
+{
+    KIRQL old_irql;
+    PFORT_PERF_STATS stats = fort_perf_cpu_begin(perf, &old_irql);
+    if (stats == NULL)
+        return;
+
+    if (stats->buffer_high_water < size) {
+        stats->buffer_high_water = size;
+    }
+
+    fort_perf_cpu_end(old_irql);
+}
+
+FORT_API void fort_perf_buffer_irp_wait(PFORT_PERF perf)
+{
+    KIRQL old_irql;
+    PFORT_PERF_STATS stats = fort_perf_cpu_begin(perf, &old_irql);
+    if (stats == NULL)
+        return;
+
+    ++stats->buffer_irp_waits;
+
+    fort_perf_cpu_end(old_irql);
+}
+
+FORT_API void fort_perf_stats_get(PFORT_PERF perf, PFORT_PERF_STATS stats)
+{
+    RtlZeroMemory(stats, sizeof(FORT_PERF_STATS));
+
+    PFORT_PERF_STATS cpus = perf->cpus;
+    if (cpus == NULL)
+        return;
+
+    const UINT16 cpu_count = perf->cpu_count;
+
+    for (UINT16 i = 0; i < cpu_count; ++i) {
+        fort_perf_stats_add(stats, &cpus[i]);
+    }
+
+    stats->cpu_count = cpu_count;
+}
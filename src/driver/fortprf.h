@@ -0,0 +1,45 @@
+#ifndef FORTPRF_H
+#define FORTPRF_H
+
+#include "fortdrv.h"
+
+#include "common/fortperf.h"
+
+/* Per-CPU counters are updated at DISPATCH_LEVEL without interlocked operations:
+ * only the current CPU writes its counters. */
+typedef struct fort_perf
+{
+    UINT16 cpu_count;
+
+    LARGE_INTEGER qpc_frequency;
+
+    PFORT_PERF_STATS cpus;
+} FORT_PERF, *PFORT_PERF;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+FORT_API void fort_perf_open(PFORT_PERF perf);
+
+FORT_API void fort_perf_close(PFORT_PERF perf);
+
+FORT_API void fort_perf_callout_time(PFORT_PERF perf, UCHAR callout_id, LARGE_INTEGER start);
+
+FORT_API void fort_perf_lock_acquire(PFORT_PERF perf, UCHAR lock_id, PKSPIN_LOCK lock);
+
+FORT_API void fort_perf_queue_drop(PFORT_PERF perf, UINT16 queue_index);
+
+FORT_API void fort_perf_queue_bytes(PFORT_PERF perf, UINT16 queue_index, UINT64 queued_bytes);
+
+FORT_API void fort_perf_buffer_size(PFORT_PERF perf, UINT32 size);
+
+FORT_API void fort_perf_buffer_irp_wait(PFORT_PERF perf);
+
+FORT_API void fort_perf_stats_get(PFORT_PERF perf, PFORT_PERF_STATS stats);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // FORTPRF_H
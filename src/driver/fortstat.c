@@ -2,13 +2,14 @@
 
 #include "fortstat.h"
 
+#include "fortdev.h"
+
 #define FORT_STAT_POOL_TAG 'SwfF'
 
 #define FORT_PROC_BAD_INDEX ((UINT16) - 1)
 #define FORT_PROC_COUNT_MAX 0xFFFF
 
 #define fort_stat_proc_hash(process_id) tommy_inthash_u32((UINT32) (process_id))
-#define fort_flow_hash(flow_id)         tommy_inthash_u32((UINT32) (flow_id))
 
 static void fort_stat_proc_active_add(PFORT_STAT stat, PFORT_STAT_PROC proc)
 {
@@ -224,32 +225,23 @@ static void fort_flow_context_remove(PVOID stat_arg, PVOID flow_node)
     }
 }
 
-static PFORT_FLOW fort_flow_get(PFORT_STAT stat, UINT64 flow_id, tommy_key_t flow_hash)
+static PFORT_FLOW fort_flow_get(PFORT_STAT stat, UINT64 flow_id)
 {
-    PFORT_FLOW flow = (PFORT_FLOW) tommy_hashdyn_bucket(&stat->flows_map, flow_hash);
-
-    while (flow != NULL) {
-        if (flow->flow_id == flow_id)
-            return flow;
-
-        flow = flow->next;
-    }
-
-    return NULL;
+    return fort_flow_map_get(&stat->flows_map, flow_id);
 }
 
 static void fort_flow_free(PFORT_STAT stat, PFORT_FLOW flow)
 {
     fort_stat_proc_dec(stat, flow->opt.proc_index);
 
-    tommy_hashdyn_remove_existing(&stat->flows_map, (tommy_hashdyn_node *) flow);
+    fort_flow_map_remove(&stat->flows_map, flow->flow_id);
 
     /* Add to free list */
     flow->next = stat->flow_free;
     stat->flow_free = flow;
 }
 
-static PFORT_FLOW fort_flow_new(PFORT_STAT stat, UINT64 flow_id, const tommy_key_t flow_hash)
+static PFORT_FLOW fort_flow_new(PFORT_STAT stat, UINT64 flow_id)
 {
     PFORT_FLOW flow;
 
@@ -266,7 +258,12 @@ static PFORT_FLOW fort_flow_new(PFORT_STAT stat, UINT64 flow_id, const tommy_key
         flow = tommy_arrayof_ref(&stat->flows, size);
     }
 
-    tommy_hashdyn_insert(&stat->flows_map, (tommy_hashdyn_node *) flow, NULL, flow_hash);
+    if (!NT_SUCCESS(fort_flow_map_insert(&stat->flows_map, flow_id, flow))) {
+        /* Return to free list */
+        flow->next = stat->flow_free;
+        stat->flow_free = flow;
+        return NULL;
+    }
 
     flow->flow_id = flow_id;
 
@@ -282,9 +279,9 @@ inline static UCHAR fort_stat_group_speed_limit(PFORT_CONF_GROUP conf_group, UCH
 }
 
 inline static NTSTATUS fort_flow_add_new(
-        PFORT_STAT stat, PFORT_FLOW *flow, tommy_key_t flow_hash, PCFORT_CONF_META_CONN conn)
+        PFORT_STAT stat, PFORT_FLOW *flow, PCFORT_CONF_META_CONN conn)
 {
-    *flow = fort_flow_new(stat, conn->flow_id, flow_hash);
+    *flow = fort_flow_new(stat, conn->flow_id);
     if (*flow == NULL)
         return STATUS_INSUFFICIENT_RESOURCES;
 
@@ -299,15 +296,15 @@ inline static NTSTATUS fort_flow_add_new(
     return status;
 }
 
-static NTSTATUS fort_flow_add(PFORT_STAT stat, PCFORT_CONF_META_CONN conn, PFORT_STAT_PROC proc)
+static NTSTATUS fort_flow_add(PFORT_STAT stat, PCFORT_CONF_META_CONN conn,
+        PCFORT_FLOW_REAUTH flow_reauth, PFORT_STAT_PROC proc)
 {
     const UINT64 flow_id = conn->flow_id;
 
-    const tommy_key_t flow_hash = fort_flow_hash(flow_id);
-    PFORT_FLOW flow = fort_flow_get(stat, flow_id, flow_hash);
+    PFORT_FLOW flow = fort_flow_get(stat, flow_id);
 
     if (flow == NULL) {
-        const NTSTATUS status = fort_flow_add_new(stat, &flow, flow_hash, conn);
+        const NTSTATUS status = fort_flow_add_new(stat, &flow, conn);
 
         if (!NT_SUCCESS(status))
             return status;
@@ -325,6 +322,8 @@ static NTSTATUS fort_flow_add(PFORT_STAT stat, PCFORT_CONF_META_CONN conn, PFORT
     flow->opt.group_index = group_index;
     flow->opt.proc_index = proc->proc_index;
 
+    flow->reauth = *flow_reauth;
+
     return STATUS_SUCCESS;
 }
 
@@ -334,7 +333,10 @@ FORT_API void fort_stat_open(PFORT_STAT stat)
     tommy_hashdyn_init(&stat->procs_map);
 
     tommy_arrayof_init(&stat->flows, sizeof(FORT_FLOW));
-    tommy_hashdyn_init(&stat->flows_map);
+    fort_flow_map_init(&stat->flows_map);
+
+    const FORT_CONF_STAT_FLUSH conf_flush = { 0 };
+    fort_stat_flush_conf_set(&stat->flush, &conf_flush);
 
     KeInitializeSpinLock(&stat->lock);
 }
@@ -349,7 +351,7 @@ FORT_API void fort_stat_close_flows(PFORT_STAT stat)
         if ((flags & FORT_STAT_CLOSED) == 0) {
             fort_stat_flags_set(stat, FORT_STAT_CLOSED, TRUE);
 
-            InterlockedAdd(&stat->flow_closing_count, (LONG) tommy_hashdyn_count(&stat->flows_map));
+            InterlockedAdd(&stat->flow_closing_count, (LONG) fort_flow_map_count(&stat->flows_map));
         }
     }
     KeReleaseInStackQueuedSpinLock(&lock_queue);
@@ -357,7 +359,7 @@ FORT_API void fort_stat_close_flows(PFORT_STAT stat)
     while (InterlockedAdd(&stat->flow_closing_count, 0) > 0) {
         KeAcquireInStackQueuedSpinLock(&stat->lock, &lock_queue);
         {
-            tommy_hashdyn_foreach_node_arg(&stat->flows_map, &fort_flow_context_remove, stat);
+            fort_flow_map_foreach(&stat->flows_map, &fort_flow_context_remove, stat);
         }
         KeReleaseInStackQueuedSpinLock(&lock_queue);
 
@@ -381,7 +383,7 @@ FORT_API void fort_stat_close(PFORT_STAT stat)
     tommy_hashdyn_done(&stat->procs_map);
 
     tommy_arrayof_done(&stat->flows);
-    tommy_hashdyn_done(&stat->flows_map);
+    fort_flow_map_done(&stat->flows_map);
 
     KeReleaseInStackQueuedSpinLock(&lock_queue);
 }
@@ -411,6 +413,8 @@ FORT_API void fort_stat_conf_update(PFORT_STAT stat, PCFORT_CONF_IO conf_io)
     KeAcquireInStackQueuedSpinLock(&stat->lock, &lock_queue);
     {
         stat->conf_group = conf_io->conf_group;
+
+        fort_stat_flush_conf_set(&stat->flush, &conf_io->stat_flush);
     }
     KeReleaseInStackQueuedSpinLock(&lock_queue);
 }
@@ -425,6 +429,84 @@ FORT_API void fort_stat_conf_flags_update(PFORT_STAT stat, const FORT_CONF_FLAGS
     KeReleaseInStackQueuedSpinLock(&lock_queue);
 }
 
+FORT_API void fort_stat_flush_conf_set(PFORT_STAT_FLUSH flush, PCFORT_CONF_STAT_FLUSH conf_flush)
+{
+    const UINT16 period_min =
+            (conf_flush->period_min != 0) ? conf_flush->period_min : FORT_STAT_FLUSH_PERIOD_MIN;
+    UINT16 period_max =
+            (conf_flush->period_max != 0) ? conf_flush->period_max : FORT_STAT_FLUSH_PERIOD_MAX;
+
+    if (period_max < period_min) {
+        period_max = period_min;
+    }
+
+    flush->period_min = period_min;
+    flush->period_max = period_max;
+
+    if (flush->period < period_min) {
+        flush->period = period_min;
+    } else if (flush->period > period_max) {
+        flush->period = period_max;
+    }
+}
+
+FORT_API BOOL fort_stat_flush_add(PFORT_STAT_FLUSH flush, UINT32 bytes, UINT16 proc_active_count)
+{
+    flush->bytes = (flush->bytes < MAXUINT32 - bytes) ? flush->bytes + bytes : MAXUINT32;
+
+    if (flush->now_requested)
+        return FALSE;
+
+    if (flush->bytes < FORT_STAT_FLUSH_NOW_BYTES && proc_active_count < FORT_STAT_FLUSH_NOW_PROCS)
+        return FALSE;
+
+    flush->now_requested = TRUE;
+
+    return TRUE;
+}
+
+FORT_API UINT16 fort_stat_flush_period_next(PFORT_STAT_FLUSH flush, UINT16 proc_active_count)
+{
+    const UINT16 period_min = flush->period_min;
+    const UINT16 period_max = flush->period_max;
+    const UINT16 period = flush->period;
+    const UINT32 bytes = flush->bytes;
+
+    flush->bytes = 0;
+    flush->now_requested = FALSE;
+
+    UINT32 next;
+
+    if (bytes == 0 && proc_active_count == 0) {
+        /* Back off while idle */
+        next = (UINT32) period * 2;
+    } else {
+        /* Load in permilles of the busy thresholds */
+        const UINT32 bytes_load = (UINT32) ((UINT64) bytes * 1000 / FORT_STAT_FLUSH_BUSY_BYTES);
+        const UINT32 procs_load = (UINT32) proc_active_count * 1000 / FORT_STAT_FLUSH_BUSY_PROCS;
+
+        UINT32 load = (bytes_load > procs_load) ? bytes_load : procs_load;
+        if (load > 1000) {
+            load = 1000;
+        }
+
+        const UINT32 target = period_max - (period_max - period_min) * load / 1000;
+
+        /* Speed up at once, slow down gradually */
+        next = (target < period) ? target : ((UINT32) period + target) / 2;
+    }
+
+    if (next < period_min) {
+        next = period_min;
+    } else if (next > period_max) {
+        next = period_max;
+    }
+
+    flush->period = (UINT16) next;
+
+    return flush->period;
+}
+
 static NTSTATUS fort_flow_associate_proc(
         PFORT_STAT stat, UINT32 process_id, BOOL *is_new_proc, PFORT_STAT_PROC *proc)
 {
@@ -447,10 +529,13 @@ static NTSTATUS fort_flow_associate_proc(
     return STATUS_SUCCESS;
 }
 
-FORT_API NTSTATUS fort_flow_associate(PFORT_STAT stat, PCFORT_CONF_META_CONN conn, BOOL *proc_stat)
+FORT_API NTSTATUS fort_flow_associate(PFORT_STAT stat, PCFORT_CONF_META_CONN conn,
+        PCFORT_FLOW_REAUTH flow_reauth, BOOL *proc_stat)
 {
     NTSTATUS status;
 
+    fort_perf_lock_acquire(&fort_device()->perf, FORT_PERF_LOCK_STAT, &stat->lock);
+
     KLOCK_QUEUE_HANDLE lock_queue;
     KeAcquireInStackQueuedSpinLock(&stat->lock, &lock_queue);
 
@@ -460,7 +545,7 @@ FORT_API NTSTATUS fort_flow_associate(PFORT_STAT stat, PCFORT_CONF_META_CONN con
 
     /* Add flow */
     if (NT_SUCCESS(status)) {
-        status = fort_flow_add(stat, conn, proc);
+        status = fort_flow_add(stat, conn, flow_reauth, proc);
 
         if (NT_SUCCESS(status)) {
             *proc_stat = proc->log_stat;
@@ -475,6 +560,32 @@ FORT_API NTSTATUS fort_flow_associate(PFORT_STAT stat, PCFORT_CONF_META_CONN con
     return status;
 }
 
+FORT_API BOOL fort_flow_reauth_unchanged(
+        PFORT_STAT stat, UINT64 flow_id, UCHAR profile_id, PFORT_CONF_REAUTH conf_reauth)
+{
+    BOOL unchanged = FALSE;
+
+    fort_perf_lock_acquire(&fort_device()->perf, FORT_PERF_LOCK_STAT, &stat->lock);
+
+    KLOCK_QUEUE_HANDLE lock_queue;
+    KeAcquireInStackQueuedSpinLock(&stat->lock, &lock_queue);
+
+    PFORT_FLOW flow = fort_flow_get(stat, flow_id);
+
+    if (flow != NULL) {
+        PFORT_FLOW_REAUTH flow_reauth = &flow->reauth;
+
+        /* The network profile may be changed without a conf change */
+        unchanged = (flow_reauth->profile_id == profile_id)
+                && !fort_conf_reauth_app_changed(
+                        conf_reauth, &flow_reauth->gen, flow_reauth->app_hash);
+    }
+
+    KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+    return unchanged;
+}
+
 static BOOL fort_flow_delete_closing(PFORT_STAT stat)
 {
     if ((fort_stat_flags(stat) & FORT_STAT_CLOSED) != 0) {
@@ -509,11 +620,15 @@ FORT_API void fort_flow_classify(PFORT_STAT stat, UINT64 flowContext, UINT32 dat
 
     PFORT_FLOW flow = (PFORT_FLOW) flowContext;
 
+    fort_perf_lock_acquire(&fort_device()->perf, FORT_PERF_LOCK_STAT, &stat->lock);
+
     KLOCK_QUEUE_HANDLE lock_queue;
     KeAcquireInStackQueuedSpinLock(&stat->lock, &lock_queue);
 
     PFORT_STAT_PROC proc = tommy_arrayof_ref(&stat->procs, flow->opt.proc_index);
 
+    BOOL flush_now = FALSE;
+
     if (proc->log_stat) {
         UINT32 *proc_bytes = inbound ? &proc->traf.in_bytes : &proc->traf.out_bytes;
 
@@ -521,13 +636,21 @@ FORT_API void fort_flow_classify(PFORT_STAT stat, UINT64 flowContext, UINT32 dat
         *proc_bytes += data_len;
 
         fort_stat_proc_active_add(stat, proc);
+
+        flush_now = fort_stat_flush_add(&stat->flush, data_len, stat->proc_active_count);
     }
 
     KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+    if (flush_now) {
+        fort_timer_expedite(&fort_device()->log_timer);
+    }
 }
 
 FORT_API void fort_stat_dpc_begin(PFORT_STAT stat, PKLOCK_QUEUE_HANDLE lock_queue)
 {
+    fort_perf_lock_acquire(&fort_device()->perf, FORT_PERF_LOCK_STAT, &stat->lock);
+
     KeAcquireInStackQueuedSpinLockAtDpcLevel(&stat->lock, lock_queue);
 }
 
@@ -536,6 +659,34 @@ FORT_API void fort_stat_dpc_end(PKLOCK_QUEUE_HANDLE lock_queue)
     KeReleaseInStackQueuedSpinLockFromDpcLevel(lock_queue);
 }
 
+FORT_API void fort_stat_dpc_flows_reserve(PFORT_STAT stat)
+{
+    KLOCK_QUEUE_HANDLE lock_queue;
+    UINT32 size;
+
+    fort_stat_dpc_begin(stat, &lock_queue);
+    {
+        size = fort_flow_map_spare_size(&stat->flows_map);
+    }
+    fort_stat_dpc_end(&lock_queue);
+
+    if (size == 0)
+        return;
+
+    /* Allocate the flows map's next table out of the lock */
+    PFORT_FLOW_MAP_SLOT slots = fort_flow_map_spare_new(size);
+    if (slots == NULL)
+        return;
+
+    fort_stat_dpc_begin(stat, &lock_queue);
+    {
+        slots = fort_flow_map_spare_set(&stat->flows_map, slots, size);
+    }
+    fort_stat_dpc_end(&lock_queue);
+
+    fort_flow_map_spare_del(slots);
+}
+
 static void fort_stat_traf_flush_proc(PFORT_STAT stat, PFORT_STAT_PROC proc, PCHAR *out)
 {
     PUINT32 out_proc = (PUINT32) *out;
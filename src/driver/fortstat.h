@@ -4,6 +4,9 @@
 #include "fortdrv.h"
 
 #include "common/fortconf.h"
+#include "common/fortlog.h"
+#include "fortcnf.h"
+#include "fortflow.h"
 #include "forttds.h"
 
 #define FORT_STATUS_FLOW_BLOCK STATUS_NOT_SAME_DEVICE
@@ -64,30 +67,48 @@ typedef struct fort_flow_opt
     };
 } FORT_FLOW_OPT, *PFORT_FLOW_OPT;
 
-/* Synchronize with tommy_hashdyn_node! */
-typedef struct fort_flow
+typedef struct fort_flow_reauth
 {
-    struct fort_flow *next;
-    struct fort_flow *prev;
+    UINT32 gen; /* generation of the conf, which permitted the flow */
+    tommy_key_t app_hash; /* hash of the app's path */
+    UCHAR profile_id; /* network profile, which the rules filter by */
+} FORT_FLOW_REAUTH, *PFORT_FLOW_REAUTH;
 
-    union {
-#if defined(_WIN64)
-        UINT64 flow_id;
-#else
-        FORT_FLOW_OPT opt;
-#endif
-        void *data; /* tommy_hashdyn_node::data */
-    };
+typedef const FORT_FLOW_REAUTH *PCFORT_FLOW_REAUTH;
 
-    tommy_key_t flow_hash; /* tommy_hashdyn_node::index */
+/* Stored in the stable pages of flows: the address is associated with the WFP flow context */
+typedef struct fort_flow
+{
+    struct fort_flow *next; /* in the free list */
 
-#if defined(_WIN64)
-    FORT_FLOW_OPT opt;
-#else
     UINT64 flow_id;
-#endif
+
+    FORT_FLOW_OPT opt;
+
+    FORT_FLOW_REAUTH reauth;
 } FORT_FLOW, *PFORT_FLOW;
 
+#define FORT_STAT_FLUSH_PERIOD_MIN 500 /* milliseconds */
+#define FORT_STAT_FLUSH_PERIOD_MAX 2000 /* milliseconds */
+
+#define FORT_STAT_FLUSH_BUSY_BYTES (1024 * 1024) /* per flush for the minimal period */
+#define FORT_STAT_FLUSH_BUSY_PROCS 64 /* per flush for the minimal period */
+
+#define FORT_STAT_FLUSH_NOW_BYTES (64 * 1024 * 1024) /* flush immediately */
+#define FORT_STAT_FLUSH_NOW_PROCS FORT_LOG_STAT_BUFFER_PROC_COUNT /* flush immediately */
+
+/* Adaptive flush period of the traffic statistics */
+typedef struct fort_stat_flush
+{
+    UINT16 period_min; /* milliseconds */
+    UINT16 period_max; /* milliseconds */
+    UINT16 period; /* milliseconds */
+
+    UCHAR now_requested : 1;
+
+    UINT32 bytes; /* since the last flush */
+} FORT_STAT_FLUSH, *PFORT_STAT_FLUSH;
+
 #define FORT_STAT_LOG                 0x01
 #define FORT_STAT_SYSTEM_TIME_CHANGED 0x02
 #define FORT_STAT_CLOSED              0x10 /* used on driver unloading */
@@ -139,10 +160,12 @@ typedef struct fort_stat
     tommy_hashdyn procs_map;
 
     tommy_arrayof flows;
-    tommy_hashdyn flows_map;
+    FORT_FLOW_MAP flows_map;
 
     FORT_CONF_GROUP conf_group;
 
+    FORT_STAT_FLUSH flush;
+
     LARGE_INTEGER system_time;
 
     KSPIN_LOCK lock;
@@ -172,7 +195,17 @@ FORT_API void fort_stat_conf_update(PFORT_STAT stat, PCFORT_CONF_IO conf_io);
 
 FORT_API void fort_stat_conf_flags_update(PFORT_STAT stat, const FORT_CONF_FLAGS conf_flags);
 
-FORT_API NTSTATUS fort_flow_associate(PFORT_STAT stat, PCFORT_CONF_META_CONN conn, BOOL *proc_stat);
+FORT_API void fort_stat_flush_conf_set(PFORT_STAT_FLUSH flush, PCFORT_CONF_STAT_FLUSH conf_flush);
+
+FORT_API BOOL fort_stat_flush_add(PFORT_STAT_FLUSH flush, UINT32 bytes, UINT16 proc_active_count);
+
+FORT_API UINT16 fort_stat_flush_period_next(PFORT_STAT_FLUSH flush, UINT16 proc_active_count);
+
+FORT_API NTSTATUS fort_flow_associate(PFORT_STAT stat, PCFORT_CONF_META_CONN conn,
+        PCFORT_FLOW_REAUTH flow_reauth, BOOL *proc_stat);
+
+FORT_API BOOL fort_flow_reauth_unchanged(
+        PFORT_STAT stat, UINT64 flow_id, UCHAR profile_id, PFORT_CONF_REAUTH conf_reauth);
 
 FORT_API void fort_flow_delete(PFORT_STAT stat, UINT64 flowContext);
 
@@ -183,6 +216,8 @@ FORT_API void fort_stat_dpc_begin(PFORT_STAT stat, PKLOCK_QUEUE_HANDLE lock_queu
 
 FORT_API void fort_stat_dpc_end(PKLOCK_QUEUE_HANDLE lock_queue);
 
+FORT_API void fort_stat_dpc_flows_reserve(PFORT_STAT stat);
+
 FORT_API void fort_stat_traf_flush(PFORT_STAT stat, UINT16 proc_count, PCHAR out);
 
 #ifdef __cplusplus
@@ -23,11 +23,15 @@ static void NTAPI fort_timer_callback(PKDPC dpc, PFORT_TIMER timer, PVOID arg1,
 
     FORT_CHECK_STACK(FORT_TIMER_CALLBACK);
 
-    const UCHAR flags = fort_timer_flags(timer);
+    UCHAR flags = fort_timer_flags(timer);
     if ((flags & FORT_TIMER_ONESHOT) != 0) {
-        fort_timer_flags_set(timer, FORT_TIMER_RUNNING, FALSE);
+        flags = fort_timer_flags_set(timer, FORT_TIMER_RUNNING, FALSE);
     }
 
+    /* The DPC may be queued by fort_timer_expedite() after the timer is stopped */
+    if ((flags & FORT_TIMER_RUNNING) == 0)
+        return;
+
     if (timer->callback != NULL) {
         timer->callback();
     }
@@ -62,6 +66,19 @@ FORT_API BOOL fort_timer_is_running(PFORT_TIMER timer)
     return (flags & FORT_TIMER_RUNNING) != 0;
 }
 
+static void fort_timer_set(PFORT_TIMER timer, UCHAR flags)
+{
+    const ULONG period = timer->period;
+    const ULONG interval = (flags & FORT_TIMER_ONESHOT) != 0 ? 0 : period;
+    const ULONG delay = (flags & FORT_TIMER_COALESCABLE) != 0 ? 500 : 0;
+
+    const LARGE_INTEGER due = {
+        .QuadPart = (INT64) period * -10000LL /* ms -> us */
+    };
+
+    KeSetCoalescableTimer(&timer->id, due, interval, delay, &timer->dpc);
+}
+
 void fort_timer_set_running(PFORT_TIMER timer, BOOL run)
 {
     const UCHAR flags = fort_timer_flags_set(timer, FORT_TIMER_RUNNING, run);
@@ -71,16 +88,37 @@ void fort_timer_set_running(PFORT_TIMER timer, BOOL run)
         return;
 
     if (run) {
-        const ULONG period = timer->period;
-        const ULONG interval = (flags & FORT_TIMER_ONESHOT) != 0 ? 0 : period;
-        const ULONG delay = (flags & FORT_TIMER_COALESCABLE) != 0 ? 500 : 0;
+        fort_timer_set(timer, flags);
+    } else {
+        KeCancelTimer(&timer->id);
+    }
+}
+
+FORT_API void fort_timer_update_period(PFORT_TIMER timer, ULONG period)
+{
+    if (timer->period == period)
+        return;
 
-        const LARGE_INTEGER due = {
-            .QuadPart = (INT64) period * -10000LL /* ms -> us */
-        };
+    timer->period = period;
 
-        KeSetCoalescableTimer(&timer->id, due, interval, delay, &timer->dpc);
-    } else {
+    const UCHAR flags = fort_timer_flags(timer);
+    if ((flags & FORT_TIMER_RUNNING) == 0)
+        return;
+
+    /* Re-arm the running timer with the new period */
+    fort_timer_set(timer, flags);
+
+    /* Double check for the concurrently stopped timer */
+    if (!fort_timer_is_running(timer)) {
         KeCancelTimer(&timer->id);
     }
 }
+
+FORT_API void fort_timer_expedite(PFORT_TIMER timer)
+{
+    if (!fort_timer_is_running(timer))
+        return;
+
+    /* Run the callback as soon as possible, does nothing if it's already queued */
+    KeInsertQueueDpc(&timer->dpc, NULL, NULL);
+}
@@ -6,8 +6,16 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
 
 #include "../fortcb.h"
+#include "../fortcnf_addr.h"
+#include "../fortcnf_conf.h"
+#include "../fortdev.h"
+#include "../fortflow.h"
+#include "../fortprf.h"
 #include "../fortutl.h"
 #include "../proxycb/fortpcb_drv.h"
 #include "../proxycb/fortpcb_src.h"
@@ -96,15 +104,936 @@ static void test_utl_bits(void)
     assert(v == 0x33333333);
 }
 
+static char *test_app_entries_add(char *p, const WCHAR *path, UINT32 app_id)
+{
+    const UINT16 path_len = (UINT16) (wcslen(path) * sizeof(WCHAR));
+
+    PFORT_APP_ENTRY entry = (PFORT_APP_ENTRY) p;
+    RtlZeroMemory(entry, FORT_CONF_APP_ENTRY_PATH_OFF);
+
+    entry->app_data.app_id = app_id;
+    entry->app_data.flags.found = TRUE;
+    entry->path_len = path_len;
+
+    RtlCopyMemory(entry->path, path, path_len + sizeof(WCHAR));
+
+    return p + FORT_CONF_APP_ENTRY_SIZE(path_len);
+}
+
+static UINT32 test_app_entries_app_id(PFORT_CONF_REF conf_ref, const WCHAR *path)
+{
+    const FORT_APP_PATH app_path = {
+        .len = (UINT16) (wcslen(path) * sizeof(WCHAR)),
+        .buffer = path,
+    };
+
+    return fort_conf_exe_find(&conf_ref->conf, conf_ref, &app_path).app_id;
+}
+
+static void test_app_entries(void)
+{
+#define TEST_PATH1 L"\\device\\harddiskvolume1\\app1.exe"
+#define TEST_PATH2 L"\\device\\harddiskvolume1\\app2.exe"
+
+    UINT64 buffer[64];
+
+    PFORT_APP_ENTRIES app_entries = (PFORT_APP_ENTRIES) buffer;
+    app_entries->count = 3;
+    app_entries->reserved = 0;
+
+    char *p = app_entries->data;
+    p = test_app_entries_add(p, TEST_PATH1, 1);
+    p = test_app_entries_add(p, TEST_PATH2, 2);
+    p = test_app_entries_add(p, TEST_PATH1, 3); /* replaces the first one */
+
+    const UINT32 len = (UINT32) (p - (char *) buffer);
+
+    /* Parser */
+    assert(fort_conf_app_entries_check(app_entries, len));
+    assert(!fort_conf_app_entries_check(app_entries, len - 1));
+    assert(!fort_conf_app_entries_check(app_entries, len + 1));
+    assert(!fort_conf_app_entries_check(app_entries, FORT_CONF_APP_ENTRIES_DATA_OFF - 1));
+
+    /* Application */
+    FORT_CONF conf;
+    RtlZeroMemory(&conf, sizeof(conf));
+
+    PFORT_CONF_REF conf_ref = fort_conf_ref_new(&conf, FORT_CONF_DATA_OFF);
+    assert(conf_ref != NULL);
+
+    const NTSTATUS status = fort_conf_ref_exe_add_entries(conf_ref, app_entries);
+    printf("test_app_entries: status=%x exe_apps_n=%d\n", status, conf_ref->conf.exe_apps_n);
+
+    assert(NT_SUCCESS(status));
+    assert(conf_ref->conf.exe_apps_n == 2);
+    assert(test_app_entries_app_id(conf_ref, TEST_PATH1) == 3);
+    assert(test_app_entries_app_id(conf_ref, TEST_PATH2) == 2);
+
+    /* Delete the unreferenced conf */
+    {
+        FORT_DEVICE_CONF device_conf;
+        RtlZeroMemory(&device_conf, sizeof(device_conf));
+
+        conf_ref->refcount = 1;
+        fort_conf_ref_put(&device_conf, conf_ref);
+    }
+
+#undef TEST_PATH1
+#undef TEST_PATH2
+}
+
+static void test_conf_reauth(void)
+{
+    FORT_CONF_REAUTH reauth;
+    RtlZeroMemory(&reauth, sizeof(reauth));
+
+    const tommy_key_t app1_hash = 1;
+    const tommy_key_t app2_hash = 2;
+
+    /* Flows permitted by the initial conf */
+    UINT32 flow1_gen = fort_conf_reauth_gen(&reauth);
+    UINT32 flow2_gen = flow1_gen;
+
+    assert(!fort_conf_reauth_app_changed(&reauth, &flow1_gen, app1_hash));
+
+    /* Change of the app1 */
+    fort_conf_reauth_app(&reauth, app1_hash);
+
+    assert(fort_conf_reauth_app_changed(&reauth, &flow1_gen, app1_hash));
+    assert(!fort_conf_reauth_app_changed(&reauth, &flow2_gen, app2_hash));
+    assert(flow2_gen == fort_conf_reauth_gen(&reauth));
+
+    /* Re-evaluated flow1 */
+    flow1_gen = fort_conf_reauth_gen(&reauth);
+    assert(!fort_conf_reauth_app_changed(&reauth, &flow1_gen, app1_hash));
+
+    /* Change of all flows */
+    fort_conf_reauth_all(&reauth);
+
+    assert(fort_conf_reauth_app_changed(&reauth, &flow1_gen, app1_hash));
+    assert(fort_conf_reauth_app_changed(&reauth, &flow2_gen, app2_hash));
+
+    /* Too many changed apps */
+    flow2_gen = fort_conf_reauth_gen(&reauth);
+
+    for (int i = 0; i <= FORT_CONF_REAUTH_APPS_MAX; ++i) {
+        fort_conf_reauth_app(&reauth, app1_hash);
+    }
+
+    printf("test_conf_reauth: gen=%u all_gen=%u apps_count=%d\n", reauth.gen, reauth.all_gen,
+            reauth.apps_count);
+
+    assert(reauth.apps_count == 0);
+    assert(fort_conf_reauth_app_changed(&reauth, &flow2_gen, app2_hash));
+}
+
+static PFORT_CONF test_addr_cache_conf(UINT64 *buffer)
+{
+    PFORT_CONF conf = (PFORT_CONF) buffer;
+    RtlZeroMemory(conf, FORT_CONF_DATA_OFF);
+
+    conf->addr_groups_off = 0;
+
+    /* LAN and INET address groups share the same data */
+    UINT32 *addr_group_offsets = (UINT32 *) conf->data;
+    addr_group_offsets[0] = 2 * sizeof(UINT32);
+    addr_group_offsets[1] = 2 * sizeof(UINT32);
+
+    PFORT_CONF_ADDR_GROUP addr_group = (PFORT_CONF_ADDR_GROUP) (addr_group_offsets + 2);
+    RtlZeroMemory(addr_group, FORT_CONF_ADDR_GROUP_OFF);
+
+    addr_group->exclude_is_empty = TRUE;
+
+    PFORT_CONF_ADDR_LIST addr_list = fort_conf_addr_group_include_list_ref(addr_group);
+    addr_list->ip_n = 2;
+    addr_list->pair_n = 1;
+
+    UINT32 *ip = addr_list->ip;
+    *ip++ = 0x0A000001; /* 10.0.0.1 */
+    *ip++ = 0x0A000005; /* 10.0.0.5 */
+    *ip++ = 0xC0A80000; /* 192.168.0.0 */
+    *ip++ = 0xC0A8FFFF; /* 192.168.255.255 */
+
+    /* Empty IPv6 list */
+    *ip++ = 0;
+    *ip++ = 0;
+
+    return conf;
+}
+
+static void test_addr_cache(void)
+{
+    static FORT_CONF_ADDR_CACHE addr_cache;
+
+    UINT64 buffer[64];
+    PCFORT_CONF conf = test_addr_cache_conf(buffer);
+
+    UINT32 gen = 0;
+
+    for (int i = 0; i < 100000; ++i) {
+        FORT_CONF_META_CONN conn;
+        RtlZeroMemory(&conn, sizeof(conn));
+
+        conn.isIPv6 = (rand() % 8) == 0;
+
+        switch (rand() % 3) {
+        case 0:
+            conn.remote_ip.v4 = 0x0A000000 | (rand() % 8);
+            break;
+        case 1:
+            conn.remote_ip.v4 = 0xC0A7FF00 + (rand() % 0x200); /* around 192.168.0.0 */
+            break;
+        default:
+            conn.remote_ip.v4 = (UINT32) (rand() % 256);
+        }
+
+        /* Changed conf */
+        if ((i % 10000) == 0) {
+            ++gen;
+        }
+
+        UCHAR zone_id = 0;
+        UCHAR cached_zone_id = 0;
+
+        const FORT_CONF_ADDR_GROUP_IP_INCLUDED_OPT opt = {
+            .addr_group_index = rand() % 2,
+            .zone_id = &zone_id,
+        };
+        FORT_CONF_ADDR_GROUP_IP_INCLUDED_OPT cached_opt = opt;
+        cached_opt.zone_id = &cached_zone_id;
+
+        const BOOL included = fort_conf_addr_group_ip_included(conf, &conn, &opt);
+        const BOOL cached_included =
+                fort_conf_addr_cache_ip_included(&addr_cache, gen, conf, &conn, &cached_opt);
+
+        assert(included == cached_included);
+        assert(zone_id == cached_zone_id);
+    }
+
+    printf("test_addr_cache: hits=%d misses=%d\n", addr_cache.hit_count, addr_cache.miss_count);
+
+    assert(addr_cache.hit_count > 0);
+}
+
+static void test_perf_stats(void)
+{
+    assert(fort_perf_hist_bucket(0) == 0);
+    assert(fort_perf_hist_bucket(1) == 0);
+    assert(fort_perf_hist_bucket(100) == 6);
+    assert(fort_perf_hist_bucket(MAXUINT32) == 31);
+
+    static FORT_PERF_STATS cpus[2];
+
+    for (int i = 0; i < 90; ++i) {
+        fort_perf_callout_add_time(&cpus[i % 2].callouts[FORT_PERF_CALLOUT_CONNECT_V4], 100);
+    }
+    for (int i = 0; i < 10; ++i) {
+        fort_perf_callout_add_time(&cpus[i % 2].callouts[FORT_PERF_CALLOUT_CONNECT_V4], 5000);
+    }
+
+    cpus[0].locks[FORT_PERF_LOCK_STAT].acquire_count = 3;
+    cpus[1].locks[FORT_PERF_LOCK_STAT].acquire_count = 4;
+    cpus[1].locks[FORT_PERF_LOCK_STAT].contend_count = 1;
+
+    cpus[0].queues[1].queued_max = 1500;
+    cpus[1].queues[1].queued_max = 3000;
+    cpus[1].queues[1].drop_count = 2;
+
+    cpus[0].buffer_high_water = 200;
+    cpus[1].buffer_high_water = 100;
+
+    FORT_PERF_STATS total;
+    RtlZeroMemory(&total, sizeof(total));
+
+    fort_perf_stats_add(&total, &cpus[0]);
+    fort_perf_stats_add(&total, &cpus[1]);
+
+    PCFORT_PERF_CALLOUT callout = &total.callouts[FORT_PERF_CALLOUT_CONNECT_V4];
+
+    assert(callout->count == 100);
+    assert(callout->time_sum == 90 * 100 + 10 * 5000);
+    assert(callout->time_max == 5000);
+    assert(callout->hist[6] == 90);
+    assert(callout->hist[12] == 10);
+
+    assert(fort_perf_callout_percentile(callout, 500) == 127);
+    assert(fort_perf_callout_percentile(callout, 900) == 127);
+    assert(fort_perf_callout_percentile(callout, 990) == 8191);
+    assert(fort_perf_callout_percentile(&total.callouts[FORT_PERF_CALLOUT_ACCEPT_V4], 500) == 0);
+
+    assert(total.locks[FORT_PERF_LOCK_STAT].acquire_count == 7);
+    assert(total.locks[FORT_PERF_LOCK_STAT].contend_count == 1);
+
+    assert(total.queues[1].queued_max == 3000);
+    assert(total.queues[1].drop_count == 2);
+
+    assert(total.buffer_high_water == 200);
+
+    /* Per-CPU blocks of the driver */
+    {
+        FORT_PERF perf;
+        RtlZeroMemory(&perf, sizeof(perf));
+
+        fort_perf_open(&perf);
+        assert(perf.cpus != NULL);
+
+        KSPIN_LOCK lock;
+        KeInitializeSpinLock(&lock);
+
+        fort_perf_lock_acquire(&perf, FORT_PERF_LOCK_BUFFER, &lock);
+        fort_perf_queue_drop(&perf, 3);
+        fort_perf_buffer_size(&perf, 64);
+
+        FORT_PERF_STATS stats;
+        fort_perf_stats_get(&perf, &stats);
+
+        assert(stats.cpu_count == perf.cpu_count);
+        assert(stats.locks[FORT_PERF_LOCK_BUFFER].acquire_count == 1);
+        assert(stats.queues[3].drop_count == 1);
+        assert(stats.buffer_high_water == 64);
+
+        fort_perf_close(&perf);
+    }
+}
+
+#define TEST_FLOW_KEYS_COUNT 50000
+
+static UINT64 test_flow_id(int key)
+{
+    /* Same low bits for all ids */
+    return 0xFFFF000000000000ULL + (UINT64) key * 4096;
+}
+
+static void test_flow_map(void)
+{
+    static BOOL present[TEST_FLOW_KEYS_COUNT];
+
+    FORT_FLOW_MAP map;
+    fort_flow_map_init(&map);
+
+    UINT32 seed = 1;
+    UINT32 count = 0;
+
+    /* Insert/delete churn */
+    for (int i = 0; i < 2000000; ++i) {
+        seed = seed * 1103515245 + 12345;
+
+        const int key = (seed >> 8) % TEST_FLOW_KEYS_COUNT;
+        const UINT64 id = test_flow_id(key);
+        const PVOID value = (PVOID) (ULONG_PTR) (key + 1);
+
+        if (present[key]) {
+            assert(fort_flow_map_get(&map, id) == value);
+
+            if ((seed & 0x10) != 0) {
+                assert(fort_flow_map_remove(&map, id) == value);
+                present[key] = FALSE;
+                --count;
+            }
+        } else {
+            assert(fort_flow_map_get(&map, id) == NULL);
+
+            if (count < TEST_FLOW_KEYS_COUNT * 3 / 4 || (seed & 0x60) == 0) {
+                assert(NT_SUCCESS(fort_flow_map_insert(&map, id, value)));
+                present[key] = TRUE;
+                ++count;
+            } else {
+                assert(fort_flow_map_remove(&map, id) == NULL);
+            }
+        }
+
+        assert(fort_flow_map_count(&map) == count);
+    }
+
+    for (int key = 0; key < TEST_FLOW_KEYS_COUNT; ++key) {
+        const PVOID value = fort_flow_map_get(&map, test_flow_id(key));
+
+        assert(present[key] ? value == (PVOID) (ULONG_PTR) (key + 1) : value == NULL);
+    }
+
+    printf("test_flow_map: count=%u size=%u\n", count, map.mask + 1);
+
+    fort_flow_map_done(&map);
+}
+
+static void test_flow_map_spare(void)
+{
+    FORT_FLOW_MAP map;
+    fort_flow_map_init(&map);
+
+    /* The first table */
+    UINT32 size = fort_flow_map_spare_size(&map);
+    assert(size != 0);
+
+    PFORT_FLOW_MAP_SLOT spare_slots = fort_flow_map_spare_new(size);
+    assert(fort_flow_map_spare_set(&map, spare_slots, size) == NULL);
+    assert(fort_flow_map_spare_size(&map) == 0);
+
+    int key = 0;
+
+    assert(NT_SUCCESS(fort_flow_map_insert(&map, test_flow_id(key++), (PVOID) 1)));
+    assert(map.slots == spare_slots);
+    assert(map.spare_slots == NULL);
+
+    /* Not needed until the load factor is above 1/2 */
+    while (fort_flow_map_spare_size(&map) == 0) {
+        assert(NT_SUCCESS(fort_flow_map_insert(&map, test_flow_id(key++), (PVOID) 1)));
+    }
+    assert(fort_flow_map_count(&map) * 2 > map.mask + 1);
+
+    size = fort_flow_map_spare_size(&map);
+    assert(size == (map.mask + 1) * 2);
+
+    /* Stale size is refused */
+    PFORT_FLOW_MAP_SLOT stale_slots = fort_flow_map_spare_new(size / 2);
+    assert(fort_flow_map_spare_set(&map, stale_slots, size / 2) == stale_slots);
+    fort_flow_map_spare_del(stale_slots);
+
+    spare_slots = fort_flow_map_spare_new(size);
+    assert(fort_flow_map_spare_set(&map, spare_slots, size) == NULL);
+
+    /* The growth takes the spare table */
+    while (map.mask + 1 != size) {
+        assert(NT_SUCCESS(fort_flow_map_insert(&map, test_flow_id(key++), (PVOID) 1)));
+    }
+    assert(map.slots == spare_slots);
+    assert(map.spare_slots == NULL);
+
+    for (int i = 0; i < key; ++i) {
+        assert(fort_flow_map_get(&map, test_flow_id(i)) == (PVOID) 1);
+    }
+
+    fort_flow_map_done(&map);
+}
+
+static void test_stat_flows(void)
+{
+    static FORT_DEVICE device;
+    fort_device_set(&device);
+
+    PFORT_STAT stat = &device.stat;
+
+    fort_stat_open(stat);
+    fort_stat_log_update(stat, TRUE);
+
+    UINT32 seed = 2;
+
+    /* Associate and delete flows, as by WFP */
+    for (int i = 0; i < 200000; ++i) {
+        seed = seed * 1103515245 + 12345;
+
+        const int key = (seed >> 8) % TEST_FLOW_KEYS_COUNT;
+        const UINT64 flow_id = test_flow_id(key);
+
+        PFORT_FLOW flow = fort_flow_map_get(&stat->flows_map, flow_id);
+
+        if (flow != NULL && (seed & 0x10) != 0) {
+            assert(flow->flow_id == flow_id);
+
+            fort_flow_delete(stat, (UINT64) flow);
+        } else {
+            const FORT_CONF_META_CONN conn = {
+                .ip_proto = IPPROTO_UDP,
+                .process_id = 4 + (key % 64) * 4,
+                .flow_id = flow_id,
+            };
+            const FORT_FLOW_REAUTH flow_reauth = { .gen = i };
+
+            BOOL proc_stat;
+            assert(NT_SUCCESS(fort_flow_associate(stat, &conn, &flow_reauth, &proc_stat)));
+
+            flow = fort_flow_map_get(&stat->flows_map, flow_id);
+
+            assert(flow != NULL && flow->flow_id == flow_id);
+            assert(flow->reauth.gen == (UINT32) i);
+        }
+    }
+
+    /* Delete the rest of flows, fort_stat_close() waits for them */
+    for (int key = 0; key < TEST_FLOW_KEYS_COUNT; ++key) {
+        PFORT_FLOW flow = fort_flow_map_get(&stat->flows_map, test_flow_id(key));
+
+        if (flow != NULL) {
+            fort_flow_delete(stat, (UINT64) flow);
+        }
+    }
+
+    assert(fort_flow_map_count(&stat->flows_map) == 0);
+
+    fort_stat_close(stat);
+
+    fort_device_set(NULL);
+}
+
+static void test_flow_reauth(void)
+{
+    static FORT_DEVICE device;
+    fort_device_set(&device);
+
+    PFORT_STAT stat = &device.stat;
+
+    fort_stat_open(stat);
+    fort_stat_log_update(stat, TRUE);
+
+    FORT_CONF_REAUTH reauth;
+    RtlZeroMemory(&reauth, sizeof(reauth));
+
+    const UINT64 flow_id = test_flow_id(1);
+    const tommy_key_t app_hash = 0x1234;
+
+    const FORT_CONF_META_CONN conn = {
+        .ip_proto = IPPROTO_TCP,
+        .process_id = 4,
+        .flow_id = flow_id,
+    };
+    const FORT_FLOW_REAUTH flow_reauth = {
+        .gen = fort_conf_reauth_gen(&reauth),
+        .app_hash = app_hash,
+        .profile_id = 1,
+    };
+
+    BOOL proc_stat;
+    assert(NT_SUCCESS(fort_flow_associate(stat, &conn, &flow_reauth, &proc_stat)));
+
+    /* Unknown flow */
+    assert(!fort_flow_reauth_unchanged(stat, test_flow_id(2), 1, &reauth));
+
+    /* Same conf and profile */
+    assert(fort_flow_reauth_unchanged(stat, flow_id, 1, &reauth));
+
+    /* Network profile is changed */
+    assert(!fort_flow_reauth_unchanged(stat, flow_id, 2, &reauth));
+
+    /* App's conf is changed */
+    fort_conf_reauth_app(&reauth, app_hash);
+    assert(!fort_flow_reauth_unchanged(stat, flow_id, 1, &reauth));
+
+    fort_flow_delete(stat, (UINT64) fort_flow_map_get(&stat->flows_map, flow_id));
+
+    fort_stat_close(stat);
+
+    fort_device_set(NULL);
+}
+
+static void test_stat_flush(void)
+{
+    FORT_STAT_FLUSH flush;
+    RtlZeroMemory(&flush, sizeof(flush));
+
+    /* Default bounds */
+    {
+        const FORT_CONF_STAT_FLUSH conf_flush = { 0 };
+        fort_stat_flush_conf_set(&flush, &conf_flush);
+    }
+
+    assert(flush.period_min == FORT_STAT_FLUSH_PERIOD_MIN);
+    assert(flush.period_max == FORT_STAT_FLUSH_PERIOD_MAX);
+    assert(flush.period == FORT_STAT_FLUSH_PERIOD_MIN);
+
+    /* Back off while idle */
+    assert(fort_stat_flush_period_next(&flush, 0) == 1000);
+    assert(fort_stat_flush_period_next(&flush, 0) == 2000);
+    assert(fort_stat_flush_period_next(&flush, 0) == 2000);
+
+    /* Light traffic: speed up at once */
+    assert(!fort_stat_flush_add(&flush, 10 * 1024, 1));
+    assert(fort_stat_flush_period_next(&flush, 1) == 1978);
+    assert(flush.bytes == 0);
+
+    /* Busy */
+    assert(!fort_stat_flush_add(&flush, 2 * 1024 * 1024, 3));
+    assert(fort_stat_flush_period_next(&flush, 3) == FORT_STAT_FLUSH_PERIOD_MIN);
+
+    assert(!fort_stat_flush_add(&flush, 100, FORT_STAT_FLUSH_BUSY_PROCS));
+    assert(fort_stat_flush_period_next(&flush, FORT_STAT_FLUSH_BUSY_PROCS) == 500);
+
+    /* Slow down gradually */
+    assert(!fort_stat_flush_add(&flush, 100, 1));
+    assert(fort_stat_flush_period_next(&flush, 1) == 1239);
+
+    /* Immediate flush is requested once per period */
+    assert(!fort_stat_flush_add(&flush, FORT_STAT_FLUSH_NOW_BYTES - 1, 1));
+    assert(fort_stat_flush_add(&flush, 1, 1));
+    assert(!fort_stat_flush_add(&flush, MAXUINT32, 1));
+    assert(flush.bytes == MAXUINT32);
+    assert(fort_stat_flush_period_next(&flush, 1) == FORT_STAT_FLUSH_PERIOD_MIN);
+
+    assert(fort_stat_flush_add(&flush, 1, FORT_STAT_FLUSH_NOW_PROCS));
+    fort_stat_flush_period_next(&flush, FORT_STAT_FLUSH_NOW_PROCS);
+
+    /* Custom bounds */
+    {
+        const FORT_CONF_STAT_FLUSH conf_flush = { .period_min = 100, .period_max = 50 };
+        fort_stat_flush_conf_set(&flush, &conf_flush);
+    }
+
+    assert(flush.period_min == 100 && flush.period_max == 100 && flush.period == 100);
+    assert(fort_stat_flush_period_next(&flush, 0) == 100);
+
+    /* Simulate an hour: mostly idle with a busy minute */
+    {
+        const FORT_CONF_STAT_FLUSH conf_flush = { 0 };
+        fort_stat_flush_conf_set(&flush, &conf_flush);
+    }
+
+    UINT32 wakeups = 0;
+    UINT32 busy_period_max = 0;
+
+    for (UINT32 time_ms = 0; time_ms < 60 * 60 * 1000;) {
+        const BOOL busy = (time_ms >= 30 * 60 * 1000 && time_ms < 31 * 60 * 1000);
+        const BOOL light = ((time_ms / 1000) % 60 == 0);
+
+        const UINT16 procs = busy ? 100 : (light ? 1 : 0);
+        const UINT32 bytes = busy ? 50 * 1024 * flush.period : (light ? 1500 : 0);
+
+        if (bytes != 0) {
+            fort_stat_flush_add(&flush, bytes, procs);
+        }
+
+        const UINT16 period = fort_stat_flush_period_next(&flush, procs);
+
+        assert(period >= FORT_STAT_FLUSH_PERIOD_MIN && period <= FORT_STAT_FLUSH_PERIOD_MAX);
+
+        if (busy && busy_period_max < period) {
+            busy_period_max = period;
+        }
+
+        time_ms += period;
+        ++wakeups;
+    }
+
+    printf("test_stat_flush: wakeups=%u (fixed=%u) busy_period_max=%u\n", wakeups,
+            60 * 60 * 1000 / FORT_STAT_FLUSH_PERIOD_MIN, busy_period_max);
+
+    assert(wakeups < 60 * 60 * 1000 / FORT_STAT_FLUSH_PERIOD_MAX * 2);
+    assert(busy_period_max == FORT_STAT_FLUSH_PERIOD_MIN);
+}
+
+static void test_buffer_check_sizes(PFORT_BUFFER buf)
+{
+    UINT32 data_size = 0;
+    UINT32 class_sizes[FORT_LOG_CLASS_COUNT] = { 0 };
+
+    for (PFORT_BUFFER_DATA data = buf->data_head; data != NULL; data = data->next) {
+        UINT32 data_class_sizes[FORT_LOG_CLASS_COUNT] = { 0 };
+
+        for (UINT32 top = 0; top < data->top;) {
+            const PCHAR p = data->p + top;
+            const UINT32 len = fort_log_size(p);
+            assert(len != 0);
+
+            data_class_sizes[fort_log_class(p)] += len;
+            top += len;
+        }
+
+        for (int i = 0; i < FORT_LOG_CLASS_COUNT; ++i) {
+            assert(data_class_sizes[i] == data->class_sizes[i]);
+            class_sizes[i] += data_class_sizes[i];
+        }
+
+        data_size += data->top;
+    }
+
+    assert(data_size == buf->data_size);
+    assert(memcmp(class_sizes, buf->class_sizes, sizeof(class_sizes)) == 0);
+}
+
+static void test_buffer_drain(PFORT_BUFFER buf, UCHAR log_class, UINT32 limit)
+{
+    static CHAR out[FORT_BUFFER_SIZE];
+
+    while (buf->class_sizes[log_class] > limit) {
+        FORT_IRP_INFO irp_info = { .irp = NULL };
+
+        const NTSTATUS status = fort_buffer_xmove(buf, &irp_info, out, sizeof(out));
+        assert(status == STATUS_SUCCESS);
+    }
+}
+
+static void test_buffer_classes(void)
+{
+    static FORT_DEVICE device;
+    fort_device_set(&device);
+
+    PFORT_BUFFER buf = &device.buffer;
+
+    fort_buffer_open(buf);
+
+    static WCHAR path[500];
+    wmemset(path, L'a', sizeof(path) / sizeof(WCHAR));
+
+    FORT_IRP_INFO irp_info = { .irp = NULL };
+    FORT_CONF_META_CONN conn = { .real_path = { .len = sizeof(path), .buffer = path } };
+
+    const UINT32 conn_size = FORT_LOG_CONN_SIZE(sizeof(path), FALSE);
+    const UINT32 conn_count = 2 * FORT_BUFFER_CONN_LIMIT / conn_size;
+
+    /* Connections: drop the oldest */
+    for (UINT32 i = 0; i < conn_count; ++i) {
+        conn.process_id = i;
+
+        const NTSTATUS status =
+                fort_buffer_conn_write(buf, &conn, &irp_info, FORT_BUFFER_CONN_WRITE_CONN);
+        assert(status == STATUS_SUCCESS);
+    }
+
+    assert(buf->class_sizes[FORT_LOG_CLASS_CONN] <= FORT_BUFFER_CONN_LIMIT);
+    assert(buf->drop_counts[FORT_LOG_CLASS_CONN] >= conn_count / 2);
+    assert(buf->drop_counts[FORT_LOG_CLASS_CONN] * conn_size
+                    + buf->class_sizes[FORT_LOG_CLASS_CONN]
+            == conn_count * conn_size);
+
+    {
+        FORT_CONF_META_CONN first_conn;
+        UINT16 path_len;
+        fort_log_conn_header_read(buf->data_head->p, &first_conn, &path_len);
+
+        assert(first_conn.process_id == buf->drop_counts[FORT_LOG_CLASS_CONN]);
+    }
+
+    test_buffer_check_sizes(buf);
+
+    /* Processes are not affected by the connections */
+    const UINT32 proc_count = 100;
+
+    for (UINT32 i = 0; i < proc_count; ++i) {
+        conn.process_id = i;
+
+        const NTSTATUS status =
+                fort_buffer_conn_write(buf, &conn, &irp_info, FORT_BUFFER_CONN_WRITE_PROC_NEW);
+        assert(status == STATUS_SUCCESS);
+    }
+
+    assert(buf->drop_counts[FORT_LOG_CLASS_PROC] == 0);
+
+    /* Applications alerts: drop the new ones */
+    UINT32 app_count = 0;
+
+    for (;; ++app_count) {
+        conn.process_id = app_count;
+
+        const NTSTATUS status =
+                fort_buffer_conn_write(buf, &conn, &irp_info, FORT_BUFFER_CONN_WRITE_APP);
+        if (status != STATUS_SUCCESS) {
+            assert(status == FORT_STATUS_BUFFER_DROPPED);
+            break;
+        }
+    }
+
+    assert(app_count == FORT_BUFFER_APP_LIMIT / FORT_LOG_APP_SIZE(sizeof(path)));
+    assert(buf->drop_counts[FORT_LOG_CLASS_APP] == 1);
+
+    /* Statistics: drop the new ones */
+    const UINT16 stat_proc_count = 100;
+    UINT32 stat_count = 0;
+
+    for (;; ++stat_count) {
+        PCHAR out;
+        const NTSTATUS status = fort_buffer_prepare(buf, FORT_LOG_STAT_SIZE(stat_proc_count),
+                FORT_LOG_CLASS_STAT, &out, &irp_info);
+        if (status != STATUS_SUCCESS) {
+            assert(status == FORT_STATUS_BUFFER_DROPPED);
+            break;
+        }
+
+        fort_log_stat_traf_header_write(out, stat_proc_count);
+    }
+
+    assert(stat_count == FORT_BUFFER_STAT_LIMIT / FORT_LOG_STAT_SIZE(stat_proc_count));
+    assert(buf->drop_counts[FORT_LOG_CLASS_STAT] == 1);
+
+    for (;;) {
+        PCHAR out;
+        const NTSTATUS status = fort_buffer_prepare(
+                buf, FORT_LOG_TIME_SIZE, FORT_LOG_CLASS_STAT, &out, &irp_info);
+        if (status != STATUS_SUCCESS)
+            break;
+
+        fort_log_time_write(out, FALSE, 1);
+    }
+
+    assert(buf->class_sizes[FORT_LOG_CLASS_STAT] + FORT_LOG_TIME_SIZE > FORT_BUFFER_STAT_LIMIT);
+    assert(buf->drop_counts[FORT_LOG_CLASS_STAT] == 2);
+
+    /* Connections still drop their own oldest records only */
+    {
+        conn.process_id = conn_count;
+
+        const NTSTATUS status =
+                fort_buffer_conn_write(buf, &conn, &irp_info, FORT_BUFFER_CONN_WRITE_CONN);
+        assert(status == STATUS_SUCCESS);
+    }
+
+    assert(buf->drop_counts[FORT_LOG_CLASS_PROC] == 0);
+    assert(buf->class_sizes[FORT_LOG_CLASS_PROC]
+            == proc_count * FORT_LOG_PROC_NEW_SIZE(sizeof(path)));
+
+    test_buffer_check_sizes(buf);
+
+    /* Dropped summary waits for the room */
+    UINT32 drop_counts[FORT_LOG_CLASS_COUNT];
+    RtlCopyMemory(drop_counts, buf->drop_counts, sizeof(drop_counts));
+
+    fort_buffer_flush_dropped(buf, &irp_info);
+    assert(memcmp(drop_counts, buf->drop_counts, sizeof(drop_counts)) == 0);
+
+    test_buffer_drain(buf, FORT_LOG_CLASS_STAT, FORT_BUFFER_STAT_LIMIT - FORT_LOG_DROPPED_SIZE);
+
+    fort_buffer_flush_dropped(buf, &irp_info);
+
+    {
+        PFORT_BUFFER_DATA data = buf->data_tail;
+        const PCHAR p = data->p + data->top - FORT_LOG_DROPPED_SIZE;
+
+        assert(fort_log_type(p) == FORT_LOG_TYPE_DROPPED);
+
+        UINT32 log_drop_counts[FORT_LOG_CLASS_COUNT];
+        fort_log_dropped_read(p, log_drop_counts);
+
+        assert(memcmp(drop_counts, log_drop_counts, sizeof(drop_counts)) == 0);
+    }
+
+    for (int i = 0; i < FORT_LOG_CLASS_COUNT; ++i) {
+        assert(buf->drop_counts[i] == 0);
+    }
+
+    test_buffer_check_sizes(buf);
+
+    /* Drain all */
+    test_buffer_drain(buf, FORT_LOG_CLASS_STAT, 0);
+    test_buffer_drain(buf, FORT_LOG_CLASS_CONN, 0);
+    test_buffer_drain(buf, FORT_LOG_CLASS_PROC, 0);
+    test_buffer_drain(buf, FORT_LOG_CLASS_APP, 0);
+
+    assert(buf->data_head == NULL && buf->data_size == 0);
+
+    test_buffer_check_sizes(buf);
+
+    fort_buffer_close(buf);
+
+    fort_device_set(NULL);
+}
+
+/* Timed by batches: the performance counter's resolution is too coarse for one call */
+#define BENCH_BATCH_SIZE 64
+
+static void bench_report(const char *name, PCFORT_PERF_CALLOUT callout)
+{
+    const UINT64 ops = callout->count * BENCH_BATCH_SIZE;
+    const double ns_per_op = callout->count ? (double) callout->time_sum / callout->count : 0;
+
+    printf("{\"bench\":\"%s\",\"ops\":%llu,\"ns_per_op\":%.1f"
+           ",\"p50\":%u,\"p90\":%u,\"p99\":%u}\n",
+            name, (unsigned long long) ops, ns_per_op, fort_perf_callout_percentile(callout, 500),
+            fort_perf_callout_percentile(callout, 900), fort_perf_callout_percentile(callout, 990));
+}
+
+static void bench_flow_classify(void)
+{
+    enum {
+        BENCH_FLOWS_COUNT = 100000,
+        BENCH_PROCS_COUNT = 256,
+        BENCH_OPS_COUNT = 4 * 1024 * 1024,
+    };
+
+    static FORT_DEVICE device;
+    fort_device_set(&device);
+
+    fort_perf_open(&device.perf);
+
+    PFORT_STAT stat = &device.stat;
+
+    fort_stat_open(stat);
+    fort_stat_log_update(stat, TRUE);
+
+    for (int i = 0; i < BENCH_FLOWS_COUNT; ++i) {
+        const FORT_CONF_META_CONN conn = {
+            .inbound = (i % 3) == 0,
+            .ip_proto = IPPROTO_TCP,
+            .process_id = 4 + (i % BENCH_PROCS_COUNT) * 4,
+            .flow_id = 0x10000 + (UINT64) i * 7,
+        };
+        const FORT_FLOW_REAUTH flow_reauth = { 0 };
+
+        BOOL proc_stat;
+        const NTSTATUS status = fort_flow_associate(stat, &conn, &flow_reauth, &proc_stat);
+
+        assert(NT_SUCCESS(status));
+    }
+
+    assert(fort_flow_map_count(&stat->flows_map) == BENCH_FLOWS_COUNT);
+
+    UINT64 *flow_contexts = malloc(BENCH_FLOWS_COUNT * sizeof(UINT64));
+    assert(flow_contexts != NULL);
+
+    for (int i = 0; i < BENCH_FLOWS_COUNT; ++i) {
+        const UINT64 flow_id = 0x10000 + (UINT64) i * 7;
+
+        flow_contexts[i] = (UINT64) fort_flow_map_get(&stat->flows_map, flow_id);
+    }
+
+    LARGE_INTEGER frequency;
+    KeQueryPerformanceCounter(&frequency);
+
+    FORT_PERF_CALLOUT callout;
+    RtlZeroMemory(&callout, sizeof(callout));
+
+    UINT32 seed = BENCH_FLOWS_COUNT;
+
+    for (int op = 0; op < BENCH_OPS_COUNT; op += BENCH_BATCH_SIZE) {
+        const LARGE_INTEGER start = KeQueryPerformanceCounter(NULL);
+
+        for (int j = 0; j < BENCH_BATCH_SIZE; ++j) {
+            seed = seed * 1103515245 + 12345;
+
+            const UINT64 flowContext = flow_contexts[(seed >> 8) % BENCH_FLOWS_COUNT];
+
+            fort_flow_classify(stat, flowContext, /*data_len=*/1500, /*inbound=*/(j & 1));
+        }
+
+        const LARGE_INTEGER end = KeQueryPerformanceCounter(NULL);
+
+        const UINT64 time_ns =
+                (UINT64) (end.QuadPart - start.QuadPart) * 1000000000 / frequency.QuadPart;
+
+        fort_perf_callout_add_time(&callout, (UINT32) (time_ns / BENCH_BATCH_SIZE));
+    }
+
+    bench_report("flow_classify", &callout);
+
+    for (int i = 0; i < BENCH_FLOWS_COUNT; ++i) {
+        fort_flow_delete(stat, flow_contexts[i]);
+    }
+
+    free(flow_contexts);
+
+    fort_stat_close(stat);
+    fort_perf_close(&device.perf);
+
+    fort_device_set(NULL);
+}
+
 int main(int argc, char *argv[])
 {
-    (void) argc;
-    (void) argv;
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        bench_flow_classify();
+        return 0;
+    }
 
     test_proxycb();
     test_major();
     test_utl_ascii();
     test_utl_bits();
+    test_app_entries();
+    test_conf_reauth();
+    test_addr_cache();
+    test_perf_stats();
+    test_flow_map();
+    test_flow_map_spare();
+    test_stat_flows();
+    test_flow_reauth();
+    test_stat_flush();
+    test_buffer_classes();
 
     return 0;
 }
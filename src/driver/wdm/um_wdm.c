@@ -69,6 +69,14 @@ void KeInitializeDpc(PRKDPC dpc, PKDEFERRED_ROUTINE routine, PVOID context)
     UNUSED(context);
 }
 
+BOOLEAN KeInsertQueueDpc(PRKDPC dpc, PVOID arg1, PVOID arg2)
+{
+    UNUSED(dpc);
+    UNUSED(arg1);
+    UNUSED(arg2);
+    return TRUE;
+}
+
 void KeFlushQueuedDpcs(void) { }
 
 void ExInitializeDriverRuntime(ULONG runtimeFlags)
@@ -178,6 +186,12 @@ void KeReleaseInStackQueuedSpinLockFromDpcLevel(PKLOCK_QUEUE_HANDLE handle)
     UNUSED(handle);
 }
 
+BOOLEAN KeTestSpinLock(PKSPIN_LOCK lock)
+{
+    UNUSED(lock);
+    return TRUE;
+}
+
 void IoAcquireCancelSpinLock(PKIRQL irql)
 {
     UNUSED(irql);
@@ -217,6 +231,29 @@ KIRQL KeGetCurrentIrql(void)
     return 0;
 }
 
+void KeRaiseIrql(KIRQL newIrql, PKIRQL oldIrql)
+{
+    UNUSED(newIrql);
+    *oldIrql = 0;
+}
+
+void KeLowerIrql(KIRQL newIrql)
+{
+    UNUSED(newIrql);
+}
+
+ULONG KeGetCurrentProcessorNumberEx(PPROCESSOR_NUMBER procNumber)
+{
+    UNUSED(procNumber);
+    return 0;
+}
+
+ULONG KeQueryMaximumProcessorCountEx(USHORT groupNumber)
+{
+    UNUSED(groupNumber);
+    return 1;
+}
+
 void IoCompleteRequest(PIRP irp, CCHAR priorityBoost)
 {
     UNUSED(irp);
@@ -337,8 +374,12 @@ NTSTATUS PsCreateSystemThread(PHANDLE threadHandle, ULONG desiredAccess,
 
 LARGE_INTEGER KeQueryPerformanceCounter(PLARGE_INTEGER performanceFrequency)
 {
-    UNUSED(performanceFrequency);
-    const LARGE_INTEGER res = { 0 };
+    if (performanceFrequency != NULL) {
+        QueryPerformanceFrequency(performanceFrequency);
+    }
+
+    LARGE_INTEGER res;
+    QueryPerformanceCounter(&res);
     return res;
 }
 
@@ -327,6 +327,7 @@ FORT_API void IoMarkIrpPending(PIRP irp);
 FORT_API PDRIVER_CANCEL IoSetCancelRoutine(PIRP irp, PDRIVER_CANCEL routine);
 
 FORT_API void KeInitializeDpc(PRKDPC dpc, PKDEFERRED_ROUTINE routine, PVOID context);
+FORT_API BOOLEAN KeInsertQueueDpc(PRKDPC dpc, PVOID arg1, PVOID arg2);
 FORT_API void KeFlushQueuedDpcs(void);
 
 #define DrvRtPoolNxOptIn 0x00000001
@@ -363,6 +364,7 @@ FORT_API void KeReleaseInStackQueuedSpinLock(PKLOCK_QUEUE_HANDLE handle);
 FORT_API void KeAcquireInStackQueuedSpinLockAtDpcLevel(
         PKSPIN_LOCK lock, PKLOCK_QUEUE_HANDLE handle);
 FORT_API void KeReleaseInStackQueuedSpinLockFromDpcLevel(PKLOCK_QUEUE_HANDLE handle);
+FORT_API BOOLEAN KeTestSpinLock(PKSPIN_LOCK lock);
 
 FORT_API void IoAcquireCancelSpinLock(PKIRQL irql);
 FORT_API void IoReleaseCancelSpinLock(KIRQL irql);
@@ -373,6 +375,11 @@ FORT_API void ExReleaseSpinLockShared(PEX_SPIN_LOCK lock, KIRQL oldIrql);
 FORT_API void ExReleaseSpinLockExclusive(PEX_SPIN_LOCK lock, KIRQL oldIrql);
 
 FORT_API KIRQL KeGetCurrentIrql(void);
+FORT_API void KeRaiseIrql(KIRQL newIrql, PKIRQL oldIrql);
+FORT_API void KeLowerIrql(KIRQL newIrql);
+
+FORT_API ULONG KeGetCurrentProcessorNumberEx(PPROCESSOR_NUMBER procNumber);
+FORT_API ULONG KeQueryMaximumProcessorCountEx(USHORT groupNumber);
 
 #define IO_NO_INCREMENT 0
 FORT_API void IoCompleteRequest(PIRP irp, CCHAR priorityBoost);
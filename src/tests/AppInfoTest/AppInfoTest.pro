@@ -0,0 +1,8 @@
+include(../Common/Common.pri)
+
+HEADERS += \
+    tst_appinfocache.h \
+    tst_appinfomanager.h
+
+SOURCES += \
+    tst_main.cpp
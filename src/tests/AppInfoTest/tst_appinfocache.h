@@ -0,0 +1,111 @@
+#pragma once
+
+#include <QSignalSpy>
+#include <QTest>
+
+#include <googletest.h>
+
+#include <appinfo/appinfocache.h>
+#include <appinfo/appinfomanager.h>
+#include <util/ioc/ioccontainer.h>
+
+namespace {
+
+// Records the requested lookups instead of extracting the infos
+class StubAppInfoManager : public AppInfoManager
+{
+public:
+    explicit StubAppInfoManager() : AppInfoManager(":memory:") { }
+
+    const QList<QStringList> &lookups() const { return m_lookups; }
+
+    void lookupAppInfos(const QStringList &appPaths) override { m_lookups.append(appPaths); }
+
+private:
+    QList<QStringList> m_lookups;
+};
+
+}
+
+class AppInfoCacheTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    bool waitLookups(int count) const;
+
+protected:
+    IocContainer m_container;
+
+    StubAppInfoManager *m_manager = nullptr;
+    AppInfoCache *m_cache = nullptr;
+};
+
+void AppInfoCacheTest::SetUp()
+{
+    m_manager = new StubAppInfoManager();
+
+    m_container.setService<AppInfoManager>(m_manager);
+    m_container.pinToThread();
+
+    m_cache = new AppInfoCache();
+    m_cache->setUp();
+}
+
+void AppInfoCacheTest::TearDown()
+{
+    m_cache->tearDown();
+    delete m_cache;
+}
+
+bool AppInfoCacheTest::waitLookups(int count) const
+{
+    return QTest::qWaitFor([&] { return m_manager->lookups().size() >= count; });
+}
+
+TEST_F(AppInfoCacheTest, coalesceLookups)
+{
+    // Apps of the painted rows are looked up in a batch
+    ASSERT_FALSE(m_cache->appInfo("C:\\a.exe").isValid());
+    ASSERT_FALSE(m_cache->appInfo("C:\\b.exe").isValid());
+    ASSERT_FALSE(m_cache->appInfo("C:\\a.exe").isValid());
+
+    ASSERT_TRUE(waitLookups(1));
+    ASSERT_EQ(m_manager->lookups(), QList<QStringList>({ { "C:\\a.exe", "C:\\b.exe" } }));
+
+    // Finished lookups are reported in a batch
+    QSignalSpy spy(m_cache, &AppInfoCache::cacheChanged);
+
+    AppInfo appInfo;
+    appInfo.fileDescription = "App A";
+
+    emit m_manager->lookupInfoFinished("C:\\a.exe", appInfo);
+    emit m_manager->lookupInfoFinished("C:\\b.exe", AppInfo());
+    emit m_manager->lookupInfoFinished("C:\\a.exe", appInfo);
+
+    ASSERT_TRUE(spy.wait());
+    ASSERT_EQ(spy.count(), 1);
+
+    QStringList appPaths = spy.at(0).at(0).toStringList();
+    appPaths.sort();
+    ASSERT_EQ(appPaths, QStringList({ "C:\\a.exe", "C:\\b.exe" }));
+
+    ASSERT_EQ(m_cache->appInfo("C:\\a.exe").fileDescription, "App A");
+}
+
+TEST_F(AppInfoCacheTest, droppedLookup)
+{
+    ASSERT_FALSE(m_cache->appInfo("C:\\a.exe").isValid());
+
+    ASSERT_TRUE(waitLookups(1));
+
+    // Dropped lookup is requested again
+    emit m_manager->lookupInfoDropped("C:\\a.exe");
+
+    ASSERT_FALSE(m_cache->appInfo("C:\\a.exe").isValid());
+
+    ASSERT_TRUE(waitLookups(2));
+    ASSERT_EQ(m_manager->lookups().at(1), QStringList({ "C:\\a.exe" }));
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QTemporaryDir>
+
+#include <googletest.h>
+
+#include <appinfo/appinfo.h>
+#include <appinfo/appinfomanager.h>
+#include <appinfo/appinfoutil.h>
+
+namespace {
+
+bool writeFile(const QString &filePath, const QByteArray &data)
+{
+    QFile file(filePath);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+
+    return file.write(data) == data.size();
+}
+
+bool setFileModTime(const QString &filePath, const QDateTime &modTime)
+{
+    QFile file(filePath);
+    if (!file.open(QFile::ReadWrite))
+        return false;
+
+    return file.setFileTime(modTime, QFileDevice::FileModificationTime);
+}
+
+AppInfo fileAppInfo(const QString &filePath)
+{
+    AppInfo appInfo;
+    appInfo.iconId = 1;
+    appInfo.fileModTime = AppInfoUtil::fileModTime(filePath, appInfo.fileExists, appInfo.fileSize);
+    appInfo.fileDescription = "Test App";
+
+    return appInfo;
+}
+
+QImage testImage()
+{
+    QImage image(16, 16, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+
+    return image;
+}
+
+}
+
+class AppInfoManagerTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+protected:
+    QTemporaryDir m_tempDir;
+    QString m_appPath;
+
+    AppInfoManager *m_manager = nullptr;
+};
+
+void AppInfoManagerTest::SetUp()
+{
+    ASSERT_TRUE(m_tempDir.isValid());
+
+    m_appPath = QDir::toNativeSeparators(m_tempDir.filePath("app.exe"));
+    ASSERT_TRUE(writeFile(m_appPath, "MZ-1"));
+    ASSERT_TRUE(setFileModTime(m_appPath, QDateTime(QDate(2024, 1, 1), QTime(12, 0))));
+
+    m_manager = new AppInfoManager(":memory:");
+    m_manager->setUp();
+}
+
+void AppInfoManagerTest::TearDown()
+{
+    delete m_manager;
+}
+
+TEST_F(AppInfoManagerTest, fileNotModified)
+{
+    AppInfo appInfo = fileAppInfo(m_appPath);
+
+    ASSERT_TRUE(appInfo.fileExists);
+    ASSERT_EQ(appInfo.fileSize, 4);
+
+    ASSERT_FALSE(appInfo.checkFileModified(m_appPath));
+}
+
+TEST_F(AppInfoManagerTest, fileSizeModified)
+{
+    AppInfo appInfo = fileAppInfo(m_appPath);
+
+    // Same modification time, another size
+    ASSERT_TRUE(writeFile(m_appPath, "MZ-22"));
+    ASSERT_TRUE(setFileModTime(m_appPath, appInfo.fileModTime));
+
+    ASSERT_TRUE(appInfo.checkFileModified(m_appPath));
+}
+
+TEST_F(AppInfoManagerTest, fileModTimeModified)
+{
+    AppInfo appInfo = fileAppInfo(m_appPath);
+
+    // Same size, another modification time
+    ASSERT_TRUE(writeFile(m_appPath, "MZ-2"));
+    ASSERT_TRUE(setFileModTime(m_appPath, appInfo.fileModTime.addSecs(60)));
+
+    ASSERT_TRUE(appInfo.checkFileModified(m_appPath));
+}
+
+TEST_F(AppInfoManagerTest, fileRemoved)
+{
+    AppInfo appInfo = fileAppInfo(m_appPath);
+
+    ASSERT_TRUE(QFile::remove(m_appPath));
+
+    // Keep the info of removed file
+    ASSERT_FALSE(appInfo.checkFileModified(m_appPath));
+    ASSERT_FALSE(appInfo.fileExists);
+}
+
+TEST_F(AppInfoManagerTest, dbFileMetadata)
+{
+    AppInfo appInfo = fileAppInfo(m_appPath);
+
+    ASSERT_TRUE(m_manager->saveToDb(m_appPath, appInfo, testImage()));
+
+    AppInfo dbAppInfo;
+    ASSERT_TRUE(m_manager->loadInfoFromDb(m_appPath, dbAppInfo));
+
+    ASSERT_EQ(dbAppInfo.iconId, appInfo.iconId);
+    ASSERT_EQ(dbAppInfo.fileModTime, appInfo.fileModTime);
+    ASSERT_EQ(dbAppInfo.fileSize, appInfo.fileSize);
+    ASSERT_EQ(dbAppInfo.fileDescription, appInfo.fileDescription);
+
+    ASSERT_FALSE(dbAppInfo.checkFileModified(m_appPath));
+
+    // Stale info after the file update
+    ASSERT_TRUE(writeFile(m_appPath, "MZ-22"));
+    ASSERT_TRUE(setFileModTime(m_appPath, appInfo.fileModTime));
+
+    ASSERT_TRUE(dbAppInfo.checkFileModified(m_appPath));
+
+    m_manager->deleteAppInfo(m_appPath, dbAppInfo);
+    ASSERT_FALSE(m_manager->loadInfoFromDb(m_appPath, dbAppInfo));
+}
+
+TEST_F(AppInfoManagerTest, dbIconData)
+{
+    const QImage image = testImage();
+
+    AppInfo appInfo = fileAppInfo(m_appPath);
+    ASSERT_TRUE(m_manager->saveToDb(m_appPath, appInfo, image));
+
+    // The icon is stored compressed
+    const QByteArray iconData = m_manager->loadIconFromDb(appInfo.iconId);
+    ASSERT_FALSE(iconData.isEmpty());
+    ASSERT_LT(iconData.size(), image.sizeInBytes());
+
+    const QImage dbImage = QImage::fromData(iconData);
+    ASSERT_EQ(dbImage.convertToFormat(image.format()), image);
+
+    // The same icon is shared
+    const QString otherAppPath = m_tempDir.filePath("other.exe");
+    AppInfo otherAppInfo = appInfo;
+    ASSERT_TRUE(m_manager->saveToDb(otherAppPath, otherAppInfo, image));
+    ASSERT_EQ(otherAppInfo.iconId, appInfo.iconId);
+}
@@ -0,0 +1,10 @@
+include(../Common/Common.pri)
+
+HEADERS += \
+    tst_bench.h \
+    tst_classify.h \
+    tst_graphseries.h \
+    tst_workermanager.h
+
+SOURCES += \
+    tst_main.cpp
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <googletest.h>
+
+// Results are printed as JSON lines, one per benchmark, to stdout or appended to the file
+// from the FORT_BENCH_OUTPUT environment variable.
+class BenchTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    static int benchScale();
+
+    template<typename Func>
+    static void runBench(const char *name, int opsCount, Func func);
+
+    static void reportBench(const char *name, int opsCount, QVector<double> &batchNsPerOp,
+            qint64 elapsedNs);
+};
+
+namespace {
+
+constexpr int benchBatchesCount = 100;
+
+}
+
+void BenchTest::SetUp() { }
+
+void BenchTest::TearDown() { }
+
+int BenchTest::benchScale()
+{
+    bool ok;
+    const int scale = qEnvironmentVariableIntValue("FORT_BENCH_SCALE", &ok);
+
+    return (ok && scale > 0) ? scale : 1;
+}
+
+template<typename Func>
+void BenchTest::runBench(const char *name, int opsCount, Func func)
+{
+    const int batchSize = qMax(opsCount / benchBatchesCount, 1);
+
+    QVector<double> batchNsPerOp;
+    batchNsPerOp.reserve(benchBatchesCount);
+
+    QElapsedTimer timer;
+    qint64 elapsedNs = 0;
+
+    for (int i = 0; i < opsCount;) {
+        const int n = qMin(batchSize, opsCount - i);
+
+        timer.start();
+
+        for (const int end = i + n; i < end; ++i) {
+            func(i);
+        }
+
+        const qint64 batchNs = timer.nsecsElapsed();
+
+        elapsedNs += batchNs;
+        batchNsPerOp.append(double(batchNs) / n);
+    }
+
+    reportBench(name, opsCount, batchNsPerOp, elapsedNs);
+}
+
+void BenchTest::reportBench(
+        const char *name, int opsCount, QVector<double> &batchNsPerOp, qint64 elapsedNs)
+{
+    std::sort(batchNsPerOp.begin(), batchNsPerOp.end());
+
+    const auto percentile = [&](int percent) -> double {
+        const int index = (batchNsPerOp.size() - 1) * percent / 100;
+        return batchNsPerOp.at(index);
+    };
+
+    const QJsonObject obj = {
+        { "bench", name },
+        { "ops", opsCount },
+        { "ns_per_op", double(elapsedNs) / opsCount },
+        { "p50", percentile(50) },
+        { "p90", percentile(90) },
+        { "p99", percentile(99) },
+    };
+
+    const QByteArray line = QJsonDocument(obj).toJson(QJsonDocument::Compact) + '\n';
+
+    const QString outputPath = qEnvironmentVariable("FORT_BENCH_OUTPUT");
+
+    QFile file(outputPath);
+    if (!outputPath.isEmpty() && file.open(QFile::WriteOnly | QFile::Append)) {
+        file.write(line);
+    } else {
+        fputs(line.constData(), stdout);
+    }
+}
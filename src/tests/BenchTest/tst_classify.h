@@ -0,0 +1,353 @@
+#pragma once
+
+#include <QRandomGenerator>
+
+#include "tst_bench.h"
+
+#include <conf/appgroup.h>
+#include <conf/firewallconf.h>
+#include <conf/rule.h>
+#include <driver/drivercommon.h>
+#include <manager/envmanager.h>
+#include <util/conf/confbuffer.h>
+#include <util/conf/confruleswalker.h>
+#include <util/fileutil.h>
+#include <util/net/iprange.h>
+#include <util/net/netutil.h>
+
+// Classify benchmarks: synthetic configurations are written by the real ConfBuffer writer and
+// looked up by the driver's common code.
+class ClassifyBenchTest : public BenchTest
+{
+protected:
+    static QVector<FORT_CONF_META_CONN> randomConns(QRandomGenerator &rand, int count);
+};
+
+QVector<FORT_CONF_META_CONN> ClassifyBenchTest::randomConns(QRandomGenerator &rand, int count)
+{
+    static const quint16 ports[] = { 22, 25, 53, 67, 80, 123, 138, 443, 445, 3389, 5050, 8443 };
+    static const quint8 protos[] = { IpProto_TCP, IpProto_UDP, IpProto_ICMP, IpProto_ICMPV6, 47 };
+
+    QVector<FORT_CONF_META_CONN> conns;
+    conns.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        const bool isIPv6 = rand.bounded(5) == 0;
+        const bool isLoopback = rand.bounded(8) == 0;
+
+        FORT_CONF_META_CONN conn = {
+            .inbound = rand.bounded(3) == 0,
+            .isIPv6 = isIPv6,
+            .is_loopback = isLoopback,
+            .is_local_net = isLoopback || rand.bounded(3) == 0,
+            .ip_proto = protos[rand.bounded(int(std::size(protos)))],
+            .local_port = ports[rand.bounded(int(std::size(ports)))],
+            .remote_port = ports[rand.bounded(int(std::size(ports)))],
+        };
+
+        if (isIPv6) {
+            for (int j = 0; j < 4; ++j) {
+                conn.remote_ip.v6.addr32[j] = rand.generate();
+            }
+        } else {
+            conn.remote_ip.v4 = rand.generate();
+        }
+
+        conns.append(conn);
+    }
+
+    return conns;
+}
+
+TEST_F(ClassifyBenchTest, appFind)
+{
+    // Exe paths are hashed, prefixes and wildcards are matched in order
+    const int exeCount = 20000 * benchScale();
+    const int prefixCount = 2000 * benchScale();
+    const int wildCount = 200 * benchScale();
+    const int opsCount = 200000;
+
+    QStringList allowLines;
+    QStringList appPaths;
+
+    for (int i = 0; i < exeCount; ++i) {
+        const QString path = QString("C:\\Bench\\Exe%1\\app%1.exe").arg(i);
+        allowLines << path;
+        appPaths << path;
+    }
+
+    for (int i = 0; i < prefixCount; ++i) {
+        allowLines << QString("C:\\Bench\\Prefix%1\\**").arg(i);
+        appPaths << QString("C:\\Bench\\Prefix%1\\Sub\\app.exe").arg(i);
+    }
+
+    for (int i = 0; i < wildCount; ++i) {
+        allowLines << QString("C:\\Bench\\Wild%1\\*\\app%1.exe").arg(i);
+        appPaths << QString("C:\\Bench\\Wild%1\\Sub\\app%1.exe").arg(i);
+    }
+
+    // Not found
+    for (int i = 0, n = appPaths.size() / 10; i < n; ++i) {
+        appPaths << QString("C:\\Bench\\Miss%1\\app.exe").arg(i);
+    }
+
+    EnvManager envManager;
+    FirewallConf conf;
+
+    AppGroup *appGroup = new AppGroup();
+    appGroup->setName("Bench");
+    appGroup->setEnabled(true);
+    appGroup->setAllowText(allowLines.join('\n'));
+
+    conf.addAppGroup(appGroup);
+
+    conf.resetEdited(FirewallConf::AllEdited);
+    conf.prepareToSave();
+
+    ConfBuffer confBuf;
+
+    if (!confBuf.writeConf(conf, nullptr, envManager)) {
+        qCritical() << "Error:" << confBuf.errorMessage();
+        Q_UNREACHABLE();
+    }
+
+    const char *data = confBuf.data() + DriverCommon::confIoConfOff();
+
+    QStringList kernelPaths;
+    kernelPaths.reserve(appPaths.size());
+
+    for (const QString &appPath : std::as_const(appPaths)) {
+        kernelPaths << FileUtil::pathToKernelPath(appPath);
+    }
+
+    QRandomGenerator rand(exeCount);
+    QVector<int> pathIndexes(opsCount);
+
+    for (int &index : pathIndexes) {
+        index = rand.bounded(kernelPaths.size());
+    }
+
+    int foundCount = 0;
+
+    runBench("app_find", opsCount, [&](int i) {
+        const QString &kernelPath = kernelPaths[pathIndexes[i]];
+
+        if (DriverCommon::confAppFind(data, kernelPath).flags.found) {
+            ++foundCount;
+        }
+    });
+
+    ASSERT_GT(foundCount, 0);
+}
+
+TEST_F(ClassifyBenchTest, zonesIpIncluded)
+{
+    // Zones with millions of addresses in total
+    const int zonesCount = 8;
+    const int zoneIp4Count = 250000 * benchScale();
+    const int zoneIp6Count = 25000 * benchScale();
+    const int opsCount = 1000000;
+
+    QRandomGenerator rand(zonesCount);
+
+    quint32 zonesMask = 0;
+    quint32 dataSize = 0;
+    QList<QByteArray> zonesData;
+    QVector<ip4_arr_t> zonesIp4;
+
+    for (int zoneIndex = 0; zoneIndex < zonesCount; ++zoneIndex) {
+        IpRange ipRange;
+
+        ip4_arr_t &ip4Array = ipRange.ip4Array();
+        ip4Array.resize(zoneIp4Count);
+        rand.fillRange(ip4Array.data(), ip4Array.size());
+
+        std::sort(ip4Array.begin(), ip4Array.end());
+        ip4Array.erase(std::unique(ip4Array.begin(), ip4Array.end()), ip4Array.end());
+
+        ip6_arr_t &ip6Array = ipRange.ip6Array();
+        ip6Array.resize(zoneIp6Count);
+        rand.fillRange(ip6Array.data()->addr32, ip6Array.size() * 4);
+
+        std::sort(ip6Array.begin(), ip6Array.end(), [](const ip6_addr_t &l, const ip6_addr_t &r) {
+            return fort_ip6_cmp(&l, &r) < 0;
+        });
+
+        ConfBuffer zoneBuf;
+        zoneBuf.writeZone(ipRange);
+
+        zonesMask |= (quint32(1) << zoneIndex);
+        dataSize += zoneBuf.buffer().size();
+        zonesData.append(zoneBuf.buffer());
+        zonesIp4.append(ip4Array);
+    }
+
+    ConfBuffer confBuf;
+    confBuf.writeZones(zonesMask, /*enabledMask=*/zonesMask, dataSize, zonesData);
+
+    PCFORT_CONF_ZONES zones = PCFORT_CONF_ZONES(confBuf.data());
+
+    QVector<FORT_CONF_META_CONN> conns = randomConns(rand, opsCount);
+
+    // Half of the addresses are found in the zones
+    for (int i = 0; i < opsCount; i += 2) {
+        const ip4_arr_t &ip4Array = zonesIp4.at(rand.bounded(zonesCount));
+
+        FORT_CONF_META_CONN &conn = conns[i];
+        conn.isIPv6 = false;
+        conn.remote_ip.v4 = ip4Array.at(rand.bounded(ip4Array.size()));
+    }
+
+    int includedCount = 0;
+
+    runBench("zones_ip_included", opsCount, [&](int i) {
+        UCHAR zoneId = 0;
+
+        if (fort_conf_zones_ip_included(zones, &conns[i], &zoneId, zonesMask)) {
+            ++includedCount;
+        }
+    });
+
+    ASSERT_GE(includedCount, opsCount / 2);
+}
+
+TEST_F(ClassifyBenchTest, rulesConnFiltered)
+{
+    // Root rule -> chain of nested presets and wide presets of plain rules
+    constexpr int chainDepth = FORT_CONF_RULE_SET_DEPTH_MAX - 2;
+    constexpr int presetsCount = 24;
+    constexpr int presetRulesCount = 24;
+    const int opsCount = 200000;
+
+    static const char *const ruleTexts[] = {
+        "tcp(80, 443)",
+        "udp(53)",
+        "dir(IN):tcp(22)",
+        "dir(OUT):udp(123)",
+        "ip_ver(6):tcp(443)",
+        "area(LAN):udp(137-139)",
+        "area(LOCALHOST):tcp(5000-5100)",
+        "proto(1, 58)",
+        "10.0.0.0/8:tcp(3389)",
+        "[fe80::]/10:udp(546, 547)",
+        "192.168.0.0/16:445",
+        "!dir(IN):udp(500, 4500)",
+        "act(BLOCK):tcp(25)",
+        "1.1.1.1:53\n8.8.8.8:53",
+        "dir(OUT):tcp(8000-8999)",
+        "area(LAN):{udp(67, 68)\n{dir(OUT):{udp(1900)\ntcp(2869)}}}",
+    };
+
+    static QVector<Rule> g_rules;
+    static WalkRulesArgs g_wra;
+
+    g_rules.clear();
+    g_wra = {};
+
+    const auto addRule = [&](Rule::RuleType ruleType, const QString &ruleText) -> quint16 {
+        Rule rule;
+        rule.ruleType = ruleType;
+        rule.ruleId = g_rules.size() + 1;
+        rule.blocked = (rule.ruleId % 3) == 0;
+        rule.ruleText = ruleText;
+        g_rules.append(rule);
+        return rule.ruleId;
+    };
+
+    const auto addRuleSet = [&](quint16 ruleId, const QVector<quint16> &ruleIds) {
+        g_wra.ruleSetMap.insert(ruleId,
+                { .index = quint32(g_wra.ruleSetIds.size()), .count = quint32(ruleIds.size()) });
+
+        for (const quint16 id : ruleIds) {
+            g_wra.ruleSetIds.append(id);
+        }
+    };
+
+    const auto addPresetRules = [&](int presetIndex) -> QVector<quint16> {
+        QVector<quint16> ruleIds;
+        for (int j = 0; j < presetRulesCount; ++j) {
+            const char *ruleText = ruleTexts[(presetIndex * 7 + j) % std::size(ruleTexts)];
+            ruleIds.append(addRule(Rule::PresetRule, ruleText));
+        }
+        return ruleIds;
+    };
+
+    const quint16 rootRuleId = addRule(Rule::GlobalBeforeAppsRule, {});
+
+    QVector<quint16> rootRuleIds;
+
+    // Chain of nested presets
+    QVector<quint16> *parentRuleIds = &rootRuleIds;
+
+    QVector<QVector<quint16>> chainRuleIds(chainDepth);
+    QVector<quint16> chainPresetIds(chainDepth);
+
+    for (int depth = 0; depth < chainDepth; ++depth) {
+        const quint16 presetRuleId = addRule(Rule::PresetRule, {});
+
+        parentRuleIds->append(presetRuleId);
+
+        chainPresetIds[depth] = presetRuleId;
+        chainRuleIds[depth] = addPresetRules(depth);
+
+        parentRuleIds = &chainRuleIds[depth];
+    }
+
+    // Wide presets
+    for (int i = 0; i < presetsCount; ++i) {
+        const quint16 presetRuleId = addRule(Rule::PresetRule, {});
+
+        rootRuleIds.append(presetRuleId);
+
+        addRuleSet(presetRuleId, addPresetRules(chainDepth + i));
+    }
+
+    addRuleSet(rootRuleId, rootRuleIds);
+
+    for (int depth = 0; depth < chainDepth; ++depth) {
+        addRuleSet(chainPresetIds[depth], chainRuleIds[depth]);
+    }
+
+    g_wra.maxRuleId = g_rules.size();
+
+    class TestRules : public ConfRulesWalker
+    {
+    public:
+        bool walkRules(
+                WalkRulesArgs &wra, const std::function<walkRulesCallback> &func) const override
+        {
+            wra = g_wra;
+
+            for (const auto &rule : g_rules) {
+                if (!func(rule))
+                    return false;
+            }
+
+            return true;
+        }
+    };
+
+    TestRules testRules;
+
+    ConfBuffer confBuf;
+
+    if (!confBuf.writeRules(testRules)) {
+        qCritical() << "Error:" << confBuf.errorMessage();
+        Q_UNREACHABLE();
+    }
+
+    QRandomGenerator rand(g_wra.maxRuleId);
+    const QVector<FORT_CONF_META_CONN> conns = randomConns(rand, opsCount);
+
+    int filteredCount = 0;
+
+    runBench("rules_conn_filtered", opsCount, [&](int i) {
+        FORT_CONF_META_CONN conn = conns[i];
+
+        if (DriverCommon::confRulesConnFiltered(confBuf.data(), &conn, rootRuleId)) {
+            ++filteredCount;
+        }
+    });
+
+    ASSERT_GT(filteredCount, 0);
+}
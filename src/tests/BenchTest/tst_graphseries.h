@@ -0,0 +1,91 @@
+#pragma once
+
+#include <qcustomplot.h>
+
+#include <form/graph/graphseries.h>
+
+#include "tst_bench.h"
+
+// Graph benchmarks: a stat tick adds a sample and feeds the plot with the bars to draw.
+// The plot of 400 px width shows the retained duration by 100 bars.
+class GraphBenchTest : public BenchTest
+{
+protected:
+    static constexpr int barCount = 100;
+
+    static double walkData(const QCPBarsDataContainer &data);
+};
+
+double GraphBenchTest::walkData(const QCPBarsDataContainer &data)
+{
+    double maxValue = 0;
+
+    for (auto it = data.constBegin(); it != data.constEnd(); ++it) {
+        maxValue = qMax(maxValue, it->value);
+    }
+
+    return maxValue;
+}
+
+TEST_F(GraphBenchTest, graphTick)
+{
+    const int durations[] = { 60, 600, 3600, 36000 };
+    const int opsCount = 2000;
+
+    for (const int duration : durations) {
+        const qint64 timeStart = 1700000000;
+
+        // Decimated buckets of the visible width
+        {
+            GraphSeries series(duration);
+            QCPBarsDataContainer data;
+
+            qint64 unixTime = timeStart;
+            for (int i = 0; i < duration; ++i) {
+                series.addValue(++unixTime, i % 1000);
+            }
+
+            const int level = GraphSeries::levelForWidth(duration, barCount);
+
+            runBench(qPrintable(QString("graph_tick_%1s").arg(duration)), opsCount, [&](int i) {
+                series.addValue(++unixTime, i % 1000);
+
+                const QVector<GraphBucket> buckets =
+                        series.buckets(level, unixTime - duration);
+
+                QVector<QCPBarsData> dataList;
+                dataList.reserve(buckets.size());
+
+                for (const GraphBucket &bucket : buckets) {
+                    dataList.append(QCPBarsData(double(bucket.time), bucket.maxValue));
+                }
+
+                data.set(dataList, /*alreadySorted=*/true);
+
+                walkData(data);
+            });
+
+            ASSERT_LE(data.size(), barCount + 2);
+        }
+
+        // All retained samples
+        {
+            QCPBarsDataContainer data;
+
+            qint64 unixTime = timeStart;
+            for (int i = 0; i < duration; ++i) {
+                data.add(QCPBarsData(double(++unixTime), i % 1000));
+            }
+
+            runBench(qPrintable(QString("graph_tick_raw_%1s").arg(duration)), opsCount,
+                    [&](int i) {
+                        data.add(QCPBarsData(double(++unixTime), i % 1000));
+                        data.removeBefore(double(unixTime - duration));
+
+                        walkData(data);
+                    });
+
+            ASSERT_EQ(data.size(), duration + 1);
+        }
+    }
+}
@@ -0,0 +1,18 @@
+#include "tst_classify.h"
+#include "tst_graphseries.h"
+#include "tst_workermanager.h"
+
+#include <QCoreApplication>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+
+    QCoreApplication app(argc, argv);
+
+    return RUN_ALL_TESTS();
+}
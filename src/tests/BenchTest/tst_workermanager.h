@@ -0,0 +1,120 @@
+#pragma once
+
+#include <QSemaphore>
+
+#include <util/worker/workerjob.h>
+#include <util/worker/workermanager.h>
+
+#include "tst_bench.h"
+
+// Worker benchmarks: bursts of tiny jobs as of the app info, host info and stat conn pipelines.
+class WorkerBenchTest : public BenchTest
+{
+protected:
+    static constexpr int burstJobsCount = 100;
+};
+
+namespace {
+
+class CountJob : public WorkerJob
+{
+public:
+    explicit CountJob(QSemaphore &done, const QString &text = {}) :
+        WorkerJob(text), m_done(done)
+    {
+    }
+
+    QString mergeKey() const override { return text(); }
+
+    void doJob(WorkerObject & /*worker*/) override { m_done.release(); }
+
+private:
+    QSemaphore &m_done;
+};
+
+class WaitJob : public WorkerJob
+{
+public:
+    explicit WaitJob(QSemaphore &started, QSemaphore &finish) :
+        m_started(started), m_finish(finish)
+    {
+    }
+
+    void doJob(WorkerObject & /*worker*/) override
+    {
+        m_started.release();
+        m_finish.acquire();
+    }
+
+private:
+    QSemaphore &m_started;
+    QSemaphore &m_finish;
+};
+
+}
+
+TEST_F(WorkerBenchTest, burstThroughput)
+{
+    const int workersCounts[] = { 1, 4 };
+    const int opsCount = 1000 * benchScale();
+
+    for (const int workersCount : workersCounts) {
+        WorkerManager manager;
+        manager.setMaxWorkersCount(workersCount);
+
+        QSemaphore done;
+
+        // A job per enqueue
+        runBench(qPrintable(QString("worker_burst_single_%1w").arg(workersCount)), opsCount,
+                [&](int /*i*/) {
+                    for (int j = 0; j < burstJobsCount; ++j) {
+                        manager.enqueueJob(WorkerJobPtr(new CountJob(done)));
+                    }
+                    done.acquire(burstJobsCount);
+                });
+
+        // A burst per enqueue
+        runBench(qPrintable(QString("worker_burst_batch_%1w").arg(workersCount)), opsCount,
+                [&](int /*i*/) {
+                    QList<WorkerJobPtr> jobs;
+                    jobs.reserve(burstJobsCount);
+
+                    for (int j = 0; j < burstJobsCount; ++j) {
+                        jobs.append(WorkerJobPtr(new CountJob(done)));
+                    }
+
+                    manager.enqueueJobs(jobs);
+                    done.acquire(burstJobsCount);
+                });
+    }
+}
+
+TEST_F(WorkerBenchTest, enqueueFirstKeyed)
+{
+    const int keysCount = 10000;
+    const int opsCount = 100000 * benchScale();
+
+    WorkerManager manager;
+    manager.setMaxWorkersCount(1);
+
+    QSemaphore started;
+    QSemaphore finish;
+    QSemaphore done;
+
+    // Occupy the only worker to keep the jobs queued
+    manager.enqueueJob(WorkerJobPtr(new WaitJob(started, finish)));
+    started.acquire();
+
+    QStringList keys;
+    for (int i = 0; i < keysCount; ++i) {
+        keys.append(QString("192.168.%1.%2").arg(i / 256).arg(i % 256));
+    }
+
+    // Repainted rows move their queued lookups to the front
+    runBench("worker_enqueue_first_keyed", opsCount, [&](int i) {
+        manager.enqueueJobFirst(WorkerJobPtr(new CountJob(done, keys.at(i % keysCount))));
+    });
+
+    manager.clear();
+    finish.release();
+}
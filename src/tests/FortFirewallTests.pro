@@ -1,13 +1,23 @@
 TEMPLATE = subdirs
 
 SUBDIRS = \
+    AppInfoTest \
+    BenchTest \
     Common \
+    HostInfoTest \
     LogBufferTest \
     LogReaderTest \
+    ModelTest \
+    RpcTest \
     StatTest \
     UtilTest
 
+AppInfoTest.depends = Common
+BenchTest.depends = Common
+HostInfoTest.depends = Common
 LogBufferTest.depends = Common
 LogReaderTest.depends = Common
+ModelTest.depends = Common
+RpcTest.depends = Common
 StatTest.depends = Common
 UtilTest.depends = Common
@@ -0,0 +1,8 @@
+include(../Common/Common.pri)
+
+HEADERS += \
+    tst_hostinfocache.h \
+    tst_hostinfomanager.h
+
+SOURCES += \
+    tst_main.cpp
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QSignalSpy>
+#include <QTest>
+
+#include <googletest.h>
+
+#include <hostinfo/hostinfocache.h>
+#include <hostinfo/hostinfomanager.h>
+#include <util/ioc/ioccontainer.h>
+
+namespace {
+
+// Records the requested lookups instead of resolving them
+class StubHostInfoManager : public HostInfoManager
+{
+public:
+    explicit StubHostInfoManager() : HostInfoManager(":memory:") { }
+
+    const QList<QStringList> &lookups() const { return m_lookups; }
+
+    void lookupHosts(const QStringList &addresses) override { m_lookups.append(addresses); }
+
+private:
+    QList<QStringList> m_lookups;
+};
+
+}
+
+class HostInfoCacheTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    bool waitLookups(int count) const;
+
+protected:
+    IocContainer m_container;
+
+    StubHostInfoManager *m_manager = nullptr;
+    HostInfoCache *m_cache = nullptr;
+};
+
+void HostInfoCacheTest::SetUp()
+{
+    m_manager = new StubHostInfoManager();
+
+    m_container.setService<HostInfoManager>(m_manager);
+    m_container.pinToThread();
+
+    m_cache = new HostInfoCache();
+    m_cache->setUp();
+}
+
+void HostInfoCacheTest::TearDown()
+{
+    m_cache->tearDown();
+    delete m_cache;
+}
+
+bool HostInfoCacheTest::waitLookups(int count) const
+{
+    return QTest::qWaitFor([&] { return m_manager->lookups().size() >= count; });
+}
+
+TEST_F(HostInfoCacheTest, coalesceLookups)
+{
+    // Addresses of the painted rows are looked up in a batch
+    ASSERT_EQ(m_cache->hostName("1.1.1.1"), QString());
+    ASSERT_EQ(m_cache->hostName("2.2.2.2"), QString());
+    ASSERT_EQ(m_cache->hostName("1.1.1.1"), QString());
+
+    ASSERT_TRUE(waitLookups(1));
+    ASSERT_EQ(m_manager->lookups(), QList<QStringList>({ { "1.1.1.1", "2.2.2.2" } }));
+
+    // Finished lookups are reported in a batch
+    QSignalSpy spy(m_cache, &HostInfoCache::cacheChanged);
+
+    emit m_manager->lookupFinished("1.1.1.1", "host-1");
+    emit m_manager->lookupFinished("2.2.2.2", "host-2");
+    emit m_manager->lookupFinished("1.1.1.1", "host-1");
+
+    ASSERT_TRUE(spy.wait());
+    ASSERT_EQ(spy.count(), 1);
+
+    QStringList addresses = spy.at(0).at(0).toStringList();
+    addresses.sort();
+    ASSERT_EQ(addresses, QStringList({ "1.1.1.1", "2.2.2.2" }));
+
+    ASSERT_EQ(m_cache->hostName("1.1.1.1"), "host-1");
+    ASSERT_EQ(m_cache->hostName("2.2.2.2"), "host-2");
+}
+
+TEST_F(HostInfoCacheTest, droppedLookup)
+{
+    ASSERT_EQ(m_cache->hostName("1.1.1.1"), QString());
+
+    ASSERT_TRUE(waitLookups(1));
+
+    // Dropped lookup is requested again
+    emit m_manager->lookupDropped("1.1.1.1");
+
+    ASSERT_EQ(m_cache->hostName("1.1.1.1"), QString());
+
+    ASSERT_TRUE(waitLookups(2));
+    ASSERT_EQ(m_manager->lookups().at(1), QStringList({ "1.1.1.1" }));
+}
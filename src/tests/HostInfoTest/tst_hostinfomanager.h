@@ -0,0 +1,221 @@
+#pragma once
+
+#include <QMutex>
+#include <QSemaphore>
+#include <QTest>
+#include <QThread>
+
+#include <googletest.h>
+
+#include <sqlite/sqlitedb.h>
+
+#include <hostinfo/hostinfomanager.h>
+
+namespace {
+
+// Fake resolver: no network, counts the resolutions
+class FakeResolver
+{
+public:
+    QString resolve(const QString &address)
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+
+            m_addresses.append(address);
+            m_maxActiveCount = qMax(m_maxActiveCount, ++m_activeCount);
+        }
+
+        if (address == blockingAddress) {
+            m_blockingStarted.release();
+            m_blockingFinish.acquire();
+        } else if (m_latencyMsecs > 0) {
+            QThread::msleep(m_latencyMsecs);
+        }
+
+        {
+            QMutexLocker locker(&m_mutex);
+
+            --m_activeCount;
+        }
+
+        // Numeric address is returned for not found names
+        return address.startsWith("10.") ? address : "host-" + address;
+    }
+
+    QStringList addresses() const
+    {
+        QMutexLocker locker(&m_mutex);
+
+        return m_addresses;
+    }
+
+    int maxActiveCount() const
+    {
+        QMutexLocker locker(&m_mutex);
+
+        return m_maxActiveCount;
+    }
+
+    void setLatencyMsecs(int v) { m_latencyMsecs = v; }
+
+    void waitBlockingStarted() { m_blockingStarted.acquire(); }
+    void finishBlocking() { m_blockingFinish.release(); }
+
+public:
+    static constexpr const char *blockingAddress = "0.0.0.0";
+
+private:
+    int m_latencyMsecs = 0;
+
+    int m_activeCount = 0;
+    int m_maxActiveCount = 0;
+
+    QStringList m_addresses;
+
+    mutable QMutex m_mutex;
+
+    QSemaphore m_blockingStarted;
+    QSemaphore m_blockingFinish;
+};
+
+}
+
+class HostInfoManagerTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    bool lookupHosts(const QStringList &addresses);
+
+protected:
+    FakeResolver m_resolver;
+
+    HostInfoManager *m_manager = nullptr;
+
+    QHash<QString, QString> m_hostNames;
+};
+
+void HostInfoManagerTest::SetUp()
+{
+    m_manager = new HostInfoManager(":memory:");
+    m_manager->setUp();
+
+    m_manager->setResolver([&](const QString &address) { return m_resolver.resolve(address); });
+
+    QObject::connect(m_manager, &HostInfoManager::lookupFinished,
+            [&](const QString &address, const QString &hostName) {
+                m_hostNames.insert(address, hostName);
+            });
+}
+
+void HostInfoManagerTest::TearDown()
+{
+    delete m_manager;
+}
+
+bool HostInfoManagerTest::lookupHosts(const QStringList &addresses)
+{
+    m_manager->lookupHosts(addresses);
+
+    return QTest::qWaitFor([&] {
+        for (const QString &address : addresses) {
+            if (!m_hostNames.contains(address))
+                return false;
+        }
+        return true;
+    });
+}
+
+TEST_F(HostInfoManagerTest, persistResults)
+{
+    ASSERT_TRUE(lookupHosts({ "1.1.1.1", "10.0.0.1" }));
+
+    ASSERT_EQ(m_hostNames.value("1.1.1.1"), "host-1.1.1.1");
+    ASSERT_EQ(m_hostNames.value("10.0.0.1"), QString());
+
+    QString hostName;
+    ASSERT_TRUE(m_manager->loadHostFromDb("1.1.1.1", hostName));
+    ASSERT_EQ(hostName, "host-1.1.1.1");
+
+    // Not found name is cached too
+    ASSERT_TRUE(m_manager->loadHostFromDb("10.0.0.1", hostName));
+    ASSERT_TRUE(hostName.isEmpty());
+
+    ASSERT_FALSE(m_manager->loadHostFromDb("2.2.2.2", hostName));
+
+    // Cached addresses are not resolved again
+    m_hostNames.clear();
+    ASSERT_TRUE(lookupHosts({ "1.1.1.1", "10.0.0.1" }));
+
+    ASSERT_EQ(m_resolver.addresses().size(), 2);
+}
+
+TEST_F(HostInfoManagerTest, expiredResults)
+{
+    ASSERT_TRUE(m_manager->sqliteDb()->execute(
+            "INSERT INTO host(address, host_name, lookup_time) VALUES"
+            "  ('1.1.1.1', 'old-name', 0), ('10.0.0.1', NULL, 0);"));
+
+    QString hostName;
+    ASSERT_FALSE(m_manager->loadHostFromDb("1.1.1.1", hostName));
+    ASSERT_FALSE(m_manager->loadHostFromDb("10.0.0.1", hostName));
+
+    ASSERT_TRUE(lookupHosts({ "1.1.1.1" }));
+
+    ASSERT_EQ(m_hostNames.value("1.1.1.1"), "host-1.1.1.1");
+    ASSERT_EQ(m_resolver.addresses(), QStringList({ "1.1.1.1" }));
+}
+
+TEST_F(HostInfoManagerTest, dedupAndPrioritize)
+{
+    m_manager->setMaxWorkersCount(1);
+
+    // Occupy the only worker
+    m_manager->lookupHosts({ FakeResolver::blockingAddress });
+    m_resolver.waitBlockingStarted();
+
+    m_manager->lookupHosts({ "1.1.1.1", "2.2.2.2", "3.3.3.3" });
+
+    // Newly painted rows go first, queued duplicates are moved
+    m_manager->lookupHosts({ "4.4.4.4", "2.2.2.2" });
+    m_manager->lookupHosts({ "3.3.3.3" });
+
+    m_resolver.finishBlocking();
+
+    ASSERT_TRUE(QTest::qWaitFor([&] { return m_hostNames.size() == 5; }));
+
+    ASSERT_EQ(m_resolver.addresses(),
+            QStringList({ FakeResolver::blockingAddress, "3.3.3.3", "4.4.4.4", "2.2.2.2",
+                    "1.1.1.1" }));
+}
+
+TEST_F(HostInfoManagerTest, boundedConcurrency)
+{
+    m_resolver.setLatencyMsecs(20);
+
+    QStringList addresses;
+    for (int i = 1; i <= 40; ++i) {
+        addresses.append(QString("192.168.0.%1").arg(i));
+    }
+
+    ASSERT_TRUE(lookupHosts(addresses));
+
+    ASSERT_EQ(m_resolver.addresses().size(), addresses.size());
+    ASSERT_LE(m_resolver.maxActiveCount(), m_manager->maxWorkersCount());
+}
+
+TEST_F(HostInfoManagerTest, batchedNotifications)
+{
+    QList<QStringList> batches;
+    QObject::connect(m_manager, &HostInfoManager::lookupsFinished,
+            [&](const QStringList &addresses) { batches.append(addresses); });
+
+    ASSERT_TRUE(lookupHosts({ "1.1.1.1", "2.2.2.2", "3.3.3.3" }));
+    ASSERT_TRUE(QTest::qWaitFor([&] { return !batches.isEmpty(); }));
+
+    // Finished lookups are coalesced for the clients
+    ASSERT_LT(batches.size(), 3);
+}
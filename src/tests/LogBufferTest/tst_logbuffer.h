@@ -8,6 +8,7 @@
 #include <log/logbuffer.h>
 #include <log/logentryapp.h>
 #include <log/logentryconn.h>
+#include <log/logentrydropped.h>
 #include <log/logentrytime.h>
 #include <util/dateutil.h>
 
@@ -200,3 +201,29 @@ TEST_F(LogBufferTest, timeWriteRead)
     buf.readEntryTime(&entry);
     ASSERT_EQ(entry.unixTime(), unixTime);
 }
+
+TEST_F(LogBufferTest, droppedWriteRead)
+{
+    const int entrySize = DriverCommon::logDroppedSize();
+
+    LogBuffer buf(entrySize);
+
+    LogEntryDropped entry;
+    entry.setDroppedCount(FORT_LOG_CLASS_STAT, 1);
+    entry.setDroppedCount(FORT_LOG_CLASS_CONN, 1000);
+
+    // Write
+    buf.writeEntryDropped(&entry);
+
+    // Read
+    LogEntryDropped readEntry;
+
+    ASSERT_EQ(buf.peekEntryType(), FORT_LOG_TYPE_DROPPED);
+    buf.readEntryDropped(&readEntry);
+    ASSERT_EQ(buf.peekEntryType(), FORT_LOG_TYPE_NONE);
+
+    ASSERT_EQ(readEntry.droppedCount(FORT_LOG_CLASS_STAT), 1);
+    ASSERT_EQ(readEntry.droppedCount(FORT_LOG_CLASS_PROC), 0);
+    ASSERT_EQ(readEntry.droppedCount(FORT_LOG_CLASS_APP), 0);
+    ASSERT_EQ(readEntry.droppedCount(FORT_LOG_CLASS_CONN), 1000);
+}
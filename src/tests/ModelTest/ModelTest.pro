@@ -0,0 +1,12 @@
+include(../Common/Common.pri)
+
+HEADERS += \
+    tst_applistmodel.h \
+    tst_connlistmodel.h \
+    tst_tablesqlmodel.h
+
+SOURCES += \
+    tst_main.cpp
+
+# Conf DB schema
+RESOURCES += $$PWD/../../ui/conf/conf_migrations.qrc
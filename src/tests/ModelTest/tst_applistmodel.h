@@ -0,0 +1,135 @@
+#pragma once
+
+#include <googletest.h>
+
+#include <sqlite/sqlitedb.h>
+
+#include <conf/confmanager.h>
+#include <model/applistmodel.h>
+
+namespace {
+
+constexpr int testAppListCount = 1000;
+
+class TestAppListModel : public AppListModel
+{
+public:
+    explicit TestAppListModel(SqliteDb *sqliteDb) : m_sqliteDb(sqliteDb) { }
+
+    SqliteDb *sqliteDb() const override { return m_sqliteDb; }
+
+    using AppListModel::updateAppPaths;
+
+private:
+    SqliteDb *m_sqliteDb = nullptr;
+};
+
+}
+
+class AppListModelTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+protected:
+    SqliteDb m_sqliteDb; // temporary database
+};
+
+void AppListModelTest::SetUp()
+{
+    ASSERT_TRUE(m_sqliteDb.open());
+
+    ASSERT_TRUE(ConfManager::migrateDb(&m_sqliteDb));
+
+    ASSERT_TRUE(m_sqliteDb.execute("INSERT INTO app_group(app_group_id, order_index, enabled,"
+                                   "    period_enabled, limit_in_enabled, limit_out_enabled,"
+                                   "    speed_limit_in, speed_limit_out, name, block_text,"
+                                   "    allow_text, period_from, period_to)"
+                                   "  VALUES(1, 0, 1, 0, 0, 0, 0, 0, 'Main', '', '', '', '');"));
+    ASSERT_TRUE(m_sqliteDb.executeStr(QString("INSERT INTO app(app_id, app_group_id, path, name,"
+                                              "    blocked, creat_time)"
+                                              "  WITH RECURSIVE c(x) AS ("
+                                              "    SELECT 1 UNION ALL SELECT x + 1 FROM c"
+                                              "      WHERE x < %1"
+                                              "  )"
+                                              "  SELECT x, 1, 'app' || x, 'App' || x, x % 2, x"
+                                              "  FROM c;")
+                    .arg(testAppListCount)));
+}
+
+void AppListModelTest::TearDown()
+{
+    m_sqliteDb.close();
+}
+
+TEST_F(AppListModelTest, updateAppPaths)
+{
+    TestAppListModel model(&m_sqliteDb);
+    model.sort(int(AppListColumn::CreationTime), Qt::AscendingOrder);
+
+    ASSERT_EQ(model.rowCount(), testAppListCount);
+
+    // Paint the visible rows
+    for (int row = 0; row < 40; ++row) {
+        ASSERT_EQ(model.appRowAt(row).appPath, QString("app%1").arg(row + 1));
+    }
+
+    const int fetchCount = model.rowBlockFetchCount();
+
+    int resetCount = 0;
+    QList<QPair<QModelIndex, QModelIndex>> changedRanges;
+
+    QObject::connect(&model, &QAbstractItemModel::modelReset, [&] { ++resetCount; });
+    QObject::connect(&model, &QAbstractItemModel::dataChanged,
+            [&](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+                changedRanges.append({ topLeft, bottomRight });
+            });
+
+    // Paths of the cached rows and of a row, which isn't loaded
+    model.updateAppPaths({ "app3", "app5", "app4", "app10", "app900" });
+
+    ASSERT_EQ(resetCount, 0);
+    ASSERT_EQ(model.rowBlockFetchCount(), fetchCount);
+
+    // Only the changed cells: a signal per contiguous range
+    ASSERT_EQ(changedRanges.size(), 2);
+
+    ASSERT_EQ(changedRanges[0].first, model.index(2, int(AppListColumn::Name)));
+    ASSERT_EQ(changedRanges[0].second, model.index(4, int(AppListColumn::Name)));
+
+    ASSERT_EQ(changedRanges[1].first, model.index(9, int(AppListColumn::Name)));
+    ASSERT_EQ(changedRanges[1].second, model.index(9, int(AppListColumn::Name)));
+
+    // Unknown paths
+    changedRanges.clear();
+    model.updateAppPaths({ "unknown" });
+
+    ASSERT_TRUE(changedRanges.isEmpty());
+}
+
+TEST_F(AppListModelTest, sortByName)
+{
+    // The lower_name column follows the renames
+    ASSERT_TRUE(m_sqliteDb.execute("UPDATE app SET name = 'aaa' WHERE app_id = 500;"
+                                   "UPDATE app SET name = 'AAB' WHERE app_id = 7;"));
+
+    TestAppListModel model(&m_sqliteDb);
+    model.sort(int(AppListColumn::Name), Qt::AscendingOrder);
+
+    ASSERT_EQ(model.rowCount(), testAppListCount);
+
+    // Case-insensitive order
+    ASSERT_EQ(model.appRowAt(0).appPath, "app500");
+    ASSERT_EQ(model.appRowAt(1).appPath, "app7");
+    ASSERT_EQ(model.appRowAt(2).appPath, "app1");
+    ASSERT_EQ(model.appRowAt(3).appPath, "app10");
+    ASSERT_EQ(model.appRowAt(4).appPath, "app100");
+    ASSERT_EQ(model.appRowAt(5).appPath, "app1000");
+
+    model.sort(int(AppListColumn::Name), Qt::DescendingOrder);
+
+    ASSERT_EQ(model.appRowAt(0).appPath, "app999");
+    ASSERT_EQ(model.appRowAt(testAppListCount - 1).appPath, "app500");
+}
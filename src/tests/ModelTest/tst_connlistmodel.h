@@ -0,0 +1,294 @@
+#pragma once
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include <googletest.h>
+
+#include <sqlite/sqlitedb.h>
+
+#include <model/connlistmodel.h>
+
+namespace {
+
+constexpr int testConnCount = 1000;
+constexpr int testAppCount = 10;
+
+constexpr int viewportRowCount = 60;
+
+class TestConnListModel : public ConnListModel
+{
+public:
+    explicit TestConnListModel(SqliteDb *sqliteDb) : m_sqliteDb(sqliteDb) { }
+
+    SqliteDb *sqliteDb() const override { return m_sqliteDb; }
+
+    using ConnListModel::updateAddresses;
+    using ConnListModel::updateAppPaths;
+    using ConnListModel::updateConnIdRange;
+    using ConnListModel::updateRuleId;
+    using ConnListModel::updateZoneId;
+
+    void setNamesVersion(int v) { m_namesVersion = v; }
+
+    int takeLookupCount() const
+    {
+        const int count = m_lookupCount;
+        m_lookupCount = 0;
+        return count;
+    }
+
+protected:
+    void fillConnIdRange(qint64 &idMin, qint64 &idMax) override
+    {
+        idMin = 1;
+        idMax = testConnCount;
+    }
+
+    QString appNameByPath(const QString &appPath) const override
+    {
+        ++m_lookupCount;
+        return QString("%1 v%2").arg(appPath).arg(m_namesVersion);
+    }
+
+    QString hostNameByAddress(const QString &address) const override
+    {
+        ++m_lookupCount;
+        return "host-" + address;
+    }
+
+    QString ruleNameById(quint16 ruleId) const override
+    {
+        ++m_lookupCount;
+        return QString("Rule%1 v%2").arg(ruleId).arg(m_namesVersion);
+    }
+
+    QString zoneNameById(quint8 zoneId) const override
+    {
+        ++m_lookupCount;
+        return QString("Zone%1 v%2").arg(zoneId).arg(m_namesVersion);
+    }
+
+private:
+    int m_namesVersion = 1;
+    mutable int m_lookupCount = 0;
+
+    SqliteDb *m_sqliteDb = nullptr;
+};
+
+}
+
+class ConnListModelTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    static void repaint(const ConnListModel &model, int firstRow = 0);
+
+protected:
+    SqliteDb m_sqliteDb; // temporary database
+};
+
+void ConnListModelTest::SetUp()
+{
+    ASSERT_TRUE(m_sqliteDb.open());
+
+    ASSERT_TRUE(m_sqliteDb.execute("CREATE TABLE app(app_id INTEGER PRIMARY KEY,"
+                                   "  conf_app_id INTEGER, path TEXT);"));
+    ASSERT_TRUE(m_sqliteDb.execute("CREATE TABLE conn(conn_id INTEGER PRIMARY KEY,"
+                                   "  app_id INTEGER, conn_time INTEGER, process_id INTEGER,"
+                                   "  reason INTEGER, blocked INTEGER, inherited INTEGER,"
+                                   "  inbound INTEGER, ip_proto INTEGER,"
+                                   "  local_port INTEGER, remote_port INTEGER,"
+                                   "  local_ip INTEGER, remote_ip INTEGER,"
+                                   "  local_ip6 BLOB, remote_ip6 BLOB,"
+                                   "  zone_id INTEGER, rule_id INTEGER);"));
+
+    ASSERT_TRUE(m_sqliteDb.executeStr(QString("INSERT INTO app(app_id, conf_app_id, path)"
+                                              "  WITH RECURSIVE c(x) AS ("
+                                              "    SELECT 1 UNION ALL SELECT x + 1 FROM c"
+                                              "      WHERE x < %1"
+                                              "  )"
+                                              "  SELECT x, 0, 'app' || x FROM c;")
+                    .arg(testAppCount)));
+
+    // Rules and zones are set for some connections only
+    ASSERT_TRUE(m_sqliteDb.executeStr(
+            QString("INSERT INTO conn(conn_id, app_id, conn_time, process_id, reason, blocked,"
+                    "    inherited, inbound, ip_proto, local_port, remote_port,"
+                    "    local_ip, remote_ip, zone_id, rule_id)"
+                    "  WITH RECURSIVE c(x) AS ("
+                    "    SELECT 1 UNION ALL SELECT x + 1 FROM c"
+                    "      WHERE x < %1"
+                    "  )"
+                    "  SELECT x, x % %2 + 1, 1700000000 + x, 100 + x, 1, x % 2, 0,"
+                    "    0, 6, 50000 + x, 443, 2130706433, 167772160 + x % 50,"
+                    "    x % 3, x % 5"
+                    "  FROM c;")
+                    .arg(testConnCount)
+                    .arg(testAppCount)));
+}
+
+void ConnListModelTest::TearDown()
+{
+    m_sqliteDb.close();
+}
+
+void ConnListModelTest::repaint(const ConnListModel &model, int firstRow)
+{
+    for (int row = firstRow; row < firstRow + viewportRowCount; ++row) {
+        for (int column = 0; column < model.columnCount(); ++column) {
+            model.data(model.index(row, column));
+        }
+    }
+}
+
+TEST_F(ConnListModelTest, repaintLookups)
+{
+    TestConnListModel model(&m_sqliteDb);
+    model.setResolveAddress(true);
+    model.updateConnIdRange();
+
+    ASSERT_EQ(model.rowCount(), testConnCount);
+
+    // The first paint loads the rows: app name, 2 host names, rule and zone names
+    repaint(model);
+
+    const int firstLookupCount = model.takeLookupCount();
+    ASSERT_GT(firstLookupCount, 0);
+    ASSERT_LE(firstLookupCount, viewportRowCount * 5);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int repaintCount = 100;
+    for (int i = 0; i < repaintCount; ++i) {
+        repaint(model);
+    }
+
+    const int lookupCount = model.takeLookupCount();
+
+    qDebug() << "repaintLookups:" << timer.elapsed() << "msec" << repaintCount << "repaints"
+             << firstLookupCount << "lookups on first paint" << lookupCount << "lookups after";
+
+    // The presentation of loaded rows is cached
+    ASSERT_EQ(lookupCount, 0);
+
+    const QModelIndex index = model.index(2, int(ConnListColumn::RemoteHostName));
+    ASSERT_EQ(model.data(index).toString(), "host-10.0.0.3");
+
+    ASSERT_EQ(model.data(model.index(2, int(ConnListColumn::RemoteIp))).toString(), "10.0.0.3");
+    ASSERT_EQ(model.data(model.index(2, int(ConnListColumn::Program))).toString(), "app4 v1");
+}
+
+TEST_F(ConnListModelTest, updateIds)
+{
+    TestConnListModel model(&m_sqliteDb);
+    model.updateConnIdRange();
+
+    repaint(model);
+    model.takeLookupCount();
+
+    QList<QPair<QModelIndex, QModelIndex>> changedRanges;
+
+    QObject::connect(&model, &QAbstractItemModel::dataChanged,
+            [&](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+                changedRanges.append({ topLeft, bottomRight });
+            });
+
+    model.setNamesVersion(2);
+
+    // Only the rows of the changed rule: conn_id = row + 1
+    model.updateRuleId(3);
+
+    const int ruleRowCount = viewportRowCount / 5;
+    ASSERT_EQ(model.takeLookupCount(), ruleRowCount);
+    ASSERT_EQ(changedRanges.size(), ruleRowCount);
+
+    for (const auto &range : changedRanges) {
+        ASSERT_EQ(range.first.column(), int(ConnListColumn::Reason));
+        ASSERT_EQ((range.first.row() + 1) % 5, 3);
+    }
+
+    const QModelIndex ruleIndex = model.index(2, int(ConnListColumn::Reason));
+    ASSERT_TRUE(model.data(ruleIndex, Qt::ToolTipRole).toString().contains("Rule3 v2"));
+    ASSERT_EQ(model.takeLookupCount(), 0);
+
+    // Zone
+    changedRanges.clear();
+    model.updateZoneId(1);
+
+    ASSERT_EQ(model.takeLookupCount(), viewportRowCount / 3);
+    ASSERT_EQ(changedRanges.size(), viewportRowCount / 3);
+
+    // App
+    changedRanges.clear();
+    model.updateAppPaths({ "app1" });
+
+    ASSERT_EQ(model.takeLookupCount(), viewportRowCount / testAppCount);
+    ASSERT_EQ(model.data(model.index(9, int(ConnListColumn::Program))).toString(), "app1 v2");
+    ASSERT_EQ(model.data(model.index(0, int(ConnListColumn::Program))).toString(), "app2 v1");
+
+    // Unknown ids
+    changedRanges.clear();
+    model.updateRuleId(100);
+
+    ASSERT_EQ(model.takeLookupCount(), 0);
+    ASSERT_TRUE(changedRanges.isEmpty());
+
+    // Full refresh looks up the names again
+    model.refresh();
+    repaint(model);
+
+    ASSERT_GT(model.takeLookupCount(), 0);
+    ASSERT_EQ(model.data(model.index(0, int(ConnListColumn::Program))).toString(), "app2 v2");
+}
+
+TEST_F(ConnListModelTest, updateAddresses)
+{
+    TestConnListModel model(&m_sqliteDb);
+    model.setResolveAddress(true);
+    model.updateConnIdRange();
+
+    repaint(model);
+    model.takeLookupCount();
+
+    QList<QPair<QModelIndex, QModelIndex>> changedRanges;
+
+    QObject::connect(&model, &QAbstractItemModel::dataChanged,
+            [&](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+                changedRanges.append({ topLeft, bottomRight });
+            });
+
+    // Only the rows of the resolved remote address: conn_id = row + 1
+    model.updateAddresses({ "10.0.0.3" });
+
+    ASSERT_EQ(model.takeLookupCount(), 2);
+    ASSERT_EQ(changedRanges.size(), 2);
+
+    ASSERT_EQ(changedRanges[0].first, model.index(2, int(ConnListColumn::RemoteHostName)));
+    ASSERT_EQ(changedRanges[0].second, model.index(2, int(ConnListColumn::RemoteHostName)));
+
+    ASSERT_EQ(changedRanges[1].first, model.index(52, int(ConnListColumn::RemoteHostName)));
+    ASSERT_EQ(changedRanges[1].second, model.index(52, int(ConnListColumn::RemoteHostName)));
+
+    // Local address of all rows: a signal for the contiguous range
+    changedRanges.clear();
+    model.updateAddresses({ "127.0.0.1" });
+
+    ASSERT_EQ(model.takeLookupCount(), viewportRowCount);
+    ASSERT_EQ(changedRanges.size(), 1);
+
+    ASSERT_EQ(changedRanges[0].first, model.index(0, int(ConnListColumn::LocalHostName)));
+    ASSERT_EQ(changedRanges[0].second,
+            model.index(viewportRowCount - 1, int(ConnListColumn::LocalHostName)));
+
+    // Unknown addresses
+    changedRanges.clear();
+    model.updateAddresses({ "10.0.0.100" });
+
+    ASSERT_EQ(model.takeLookupCount(), 0);
+    ASSERT_TRUE(changedRanges.isEmpty());
+}
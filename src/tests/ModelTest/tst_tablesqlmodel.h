@@ -0,0 +1,220 @@
+#pragma once
+
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include <googletest.h>
+
+#include <sqlite/sqlitedb.h>
+#include <sqlite/sqlitestmt.h>
+
+#include <util/model/tablesqlmodel.h>
+
+namespace {
+
+constexpr int testRowCount = 200000;
+
+struct TestRow : TableRow
+{
+    qint64 id = 0;
+    QString name;
+};
+
+class TestTableModel : public TableSqlModel
+{
+public:
+    explicit TestTableModel(SqliteDb *sqliteDb) : m_sqliteDb(sqliteDb) { }
+
+    SqliteDb *sqliteDb() const override { return m_sqliteDb; }
+
+    int columnCount(const QModelIndex & /*parent*/ = QModelIndex()) const override { return 2; }
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
+    {
+        if (!index.isValid() || role != Qt::DisplayRole)
+            return {};
+
+        const TestRow &row = testRowAt(index.row());
+
+        return index.column() == 0 ? QVariant(row.id) : QVariant(row.name);
+    }
+
+    const TestRow &testRowAt(int row) const
+    {
+        updateRowCache(row);
+
+        return m_testRow;
+    }
+
+    int takeStmtCount() const
+    {
+        const int count = m_countStmtCount + rowBlockFetchCount() - m_blockStmtCount;
+
+        m_countStmtCount = 0;
+        m_blockStmtCount = rowBlockFetchCount();
+
+        return count;
+    }
+
+protected:
+    int doSqlCount() const override
+    {
+        ++m_countStmtCount;
+        return TableSqlModel::doSqlCount();
+    }
+
+    TableRowPtr createTableRow() const override { return std::make_shared<TestRow>(); }
+
+    void fillTableRow(SqliteStmt &stmt, TableRow &tableRow) const override
+    {
+        TestRow &testRow = static_cast<TestRow &>(tableRow);
+
+        testRow.id = stmt.columnInt64(0);
+        testRow.name = stmt.columnText(1);
+    }
+
+    void setTableRow(const TableRow &tableRow) const override
+    {
+        m_testRow = static_cast<const TestRow &>(tableRow);
+    }
+
+    TableRow &tableRow() const override { return m_testRow; }
+
+    QString sqlBase() const override { return "SELECT t.id, t.name FROM item t"; }
+
+    QString sqlOrderColumn() const override { return "t.id" + sqlOrderAsc(); }
+
+private:
+    mutable int m_countStmtCount = 0;
+    mutable int m_blockStmtCount = 0;
+
+    SqliteDb *m_sqliteDb = nullptr;
+
+    mutable TestRow m_testRow;
+};
+
+}
+
+class TableSqlModelTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+protected:
+    SqliteDb m_sqliteDb; // temporary database
+};
+
+void TableSqlModelTest::SetUp()
+{
+    ASSERT_TRUE(m_sqliteDb.open());
+
+    ASSERT_TRUE(m_sqliteDb.execute("CREATE TABLE item(id INTEGER PRIMARY KEY, name TEXT);"));
+    ASSERT_TRUE(m_sqliteDb.executeStr(QString("INSERT INTO item(id, name)"
+                                              "  WITH RECURSIVE c(x) AS ("
+                                              "    SELECT 1 UNION ALL SELECT x + 1 FROM c"
+                                              "      WHERE x < %1"
+                                              "  )"
+                                              "  SELECT x, 'name' || x FROM c;")
+                    .arg(testRowCount)));
+}
+
+void TableSqlModelTest::TearDown()
+{
+    m_sqliteDb.close();
+}
+
+TEST_F(TableSqlModelTest, scrollDown)
+{
+    TestTableModel model(&m_sqliteDb);
+    model.sort(0, Qt::AscendingOrder);
+
+    ASSERT_EQ(model.rowCount(), testRowCount);
+    ASSERT_EQ(model.takeStmtCount(), 1);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int row = 0; row < testRowCount; ++row) {
+        const TestRow &testRow = model.testRowAt(row);
+
+        ASSERT_EQ(testRow.id, row + 1);
+    }
+
+    const int stmtCount = model.takeStmtCount();
+
+    qDebug() << "scrollDown:" << timer.elapsed() << "msec" << stmtCount << "statements";
+
+    // The next block is prefetched with the current one
+    ASSERT_LE(stmtCount, testRowCount / 128 + 1);
+}
+
+TEST_F(TableSqlModelTest, scrollUp)
+{
+    TestTableModel model(&m_sqliteDb);
+    model.sort(0, Qt::DescendingOrder);
+
+    ASSERT_EQ(model.rowCount(), testRowCount);
+    model.takeStmtCount();
+
+    for (int row = testRowCount; --row >= 0;) {
+        const TestRow &testRow = model.testRowAt(row);
+
+        ASSERT_EQ(testRow.id, testRowCount - row);
+    }
+
+    // The previous block is prefetched with the current one
+    ASSERT_LE(model.takeStmtCount(), testRowCount / 128 + 2);
+}
+
+TEST_F(TableSqlModelTest, visibleRowsRepaint)
+{
+    TestTableModel model(&m_sqliteDb);
+    model.sort(0, Qt::AscendingOrder);
+
+    ASSERT_EQ(model.rowCount(), testRowCount);
+
+    // Jump to the middle and repaint the visible cells many times
+    const int firstRow = testRowCount / 2;
+    const int visibleRowCount = 40;
+
+    model.takeStmtCount();
+
+    for (int i = 0; i < 10; ++i) {
+        for (int row = firstRow; row < firstRow + visibleRowCount; ++row) {
+            for (int column = 0; column < model.columnCount(); ++column) {
+                ASSERT_TRUE(model.data(model.index(row, column)).isValid());
+            }
+        }
+    }
+
+    ASSERT_LE(model.takeStmtCount(), 2);
+}
+
+TEST_F(TableSqlModelTest, refresh)
+{
+    TestTableModel model(&m_sqliteDb);
+    model.sort(0, Qt::AscendingOrder);
+
+    ASSERT_EQ(model.rowCount(), testRowCount);
+
+    // Fetch the first blocks
+    ASSERT_EQ(model.testRowAt(0).id, 1);
+    ASSERT_EQ(model.testRowAt(100).id, 101);
+    ASSERT_EQ(model.takeStmtCount(), 2); // count and blocks
+
+    ASSERT_TRUE(m_sqliteDb.execute("UPDATE item SET name = 'edited' WHERE id = 101;"));
+    model.takeStmtCount();
+
+    // Cached rows are kept until refreshed
+    ASSERT_EQ(model.testRowAt(100).name, "name101");
+    ASSERT_EQ(model.takeStmtCount(), 0);
+
+    // All blocks are fetched again
+    model.refresh();
+
+    ASSERT_EQ(model.testRowAt(0).name, "name1");
+    ASSERT_EQ(model.testRowAt(100).name, "edited");
+    ASSERT_EQ(model.takeStmtCount(), 2); // count and blocks
+}
@@ -0,0 +1,8 @@
+include(../Common/Common.pri)
+
+HEADERS += \
+    tst_controlworker.h \
+    tst_rpcmanager.h
+
+SOURCES += \
+    tst_main.cpp
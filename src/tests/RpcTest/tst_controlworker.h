@@ -0,0 +1,328 @@
+#pragma once
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QRandomGenerator>
+
+#include <googletest.h>
+
+#include <control/controlargs.h>
+#include <control/controlworker.h>
+
+namespace {
+
+struct ReceivedRequest
+{
+    Control::Command command = Control::CommandNone;
+    QVariantList args;
+    quint32 requestId = 0;
+};
+
+class TestControlWorker : public ControlWorker
+{
+public:
+    using ControlWorker::ControlWorker;
+    using ControlWorker::RequestHeader;
+};
+
+QVariantList sampleArgs(int index)
+{
+    const QVariantMap map = {
+        { "name", "Fort" },
+        { "ids", QVariantList { 1, 2, 3 } },
+    };
+
+    return {
+        index,
+        -Q_INT64_C(5000000000) * index,
+        uint(index) << 20,
+        (index % 2 == 0),
+        QString("Программа %1").arg(index),
+        QStringList { "a", "b", QString::number(index) },
+        QVariantList { QVariant::fromValue(quint16(index)), 0.25 * index, map },
+        QDateTime::fromMSecsSinceEpoch(Q_INT64_C(1700000000000) + index),
+        QByteArray(index, 'x'),
+        QVariant(),
+    };
+}
+
+QByteArray randomBytes(int size)
+{
+    QByteArray data(size, '\0');
+
+    QRandomGenerator rand(size);
+    rand.fillRange(reinterpret_cast<quint32 *>(data.data()), size / int(sizeof(quint32)));
+
+    return data;
+}
+
+}
+
+class ControlWorkerTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    bool waitReceived(int count, int msecs = 5000);
+    bool waitServerDisconnected(int msecs = 5000);
+
+protected:
+    QLocalServer *m_server = nullptr;
+
+    TestControlWorker *m_client = nullptr;
+    ControlWorker *m_serverWorker = nullptr;
+
+    bool m_serverDisconnected = false;
+    QList<ReceivedRequest> m_received;
+};
+
+void ControlWorkerTest::SetUp()
+{
+    const QString serverName =
+            QString("FortControlTest_%1").arg(QCoreApplication::applicationPid());
+
+    m_server = new QLocalServer();
+    ASSERT_TRUE(m_server->listen(serverName));
+
+    auto socket = new QLocalSocket();
+    m_client = new TestControlWorker(socket);
+    socket->setParent(m_client);
+    m_client->setupForAsync();
+    m_client->setServerName(serverName);
+
+    ASSERT_TRUE(m_client->connectToServer());
+    ASSERT_TRUE(m_server->waitForNewConnection(3000));
+
+    QLocalSocket *serverSocket = m_server->nextPendingConnection();
+    ASSERT_NE(serverSocket, nullptr);
+
+    m_serverWorker = new ControlWorker(serverSocket, m_server);
+    serverSocket->setParent(m_serverWorker);
+    m_serverWorker->setupForAsync();
+
+    QObject::connect(m_serverWorker, &ControlWorker::requestReady, m_server,
+            [&](Control::Command command, const QVariantList &args, quint32 requestId) {
+                m_received.append({ .command = command, .args = args, .requestId = requestId });
+            });
+    QObject::connect(m_serverWorker, &ControlWorker::disconnected, m_server,
+            [&] { m_serverDisconnected = true; });
+}
+
+void ControlWorkerTest::TearDown()
+{
+    delete m_client;
+    delete m_server;
+}
+
+bool ControlWorkerTest::waitReceived(int count, int msecs)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (m_received.size() < count) {
+        if (timer.hasExpired(msecs))
+            return false;
+
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+
+    return true;
+}
+
+bool ControlWorkerTest::waitServerDisconnected(int msecs)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (!m_serverDisconnected) {
+        if (timer.hasExpired(msecs))
+            return false;
+
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+
+    return true;
+}
+
+TEST_F(ControlWorkerTest, roundTripAllCommands)
+{
+    const int firstCommand = Control::CommandHome;
+    const int lastCommand = Control::Rpc_TaskManager_zonesDownloaded;
+
+    for (int i = firstCommand; i <= lastCommand; ++i) {
+        const auto command = Control::Command(i);
+
+        ASSERT_TRUE(m_client->sendCommand(command, sampleArgs(i), /*requestId=*/i * 1000));
+    }
+
+    // Command without arguments
+    ASSERT_TRUE(m_client->sendCommand(Control::Rpc_Result_Ok));
+
+    const int commandsCount = lastCommand - firstCommand + 1;
+
+    ASSERT_TRUE(waitReceived(commandsCount + 1));
+
+    for (int i = 0; i < commandsCount; ++i) {
+        const ReceivedRequest &r = m_received[i];
+        const int index = firstCommand + i;
+
+        ASSERT_EQ(r.command, Control::Command(index));
+        ASSERT_EQ(r.requestId, quint32(index * 1000));
+        ASSERT_EQ(r.args, sampleArgs(index));
+
+        // Types are kept
+        ASSERT_EQ(r.args[1].typeId(), QMetaType::LongLong);
+        ASSERT_EQ(r.args[2].typeId(), QMetaType::UInt);
+        ASSERT_EQ(r.args[6].toList()[0].typeId(), QMetaType::UShort);
+    }
+
+    const ReceivedRequest &last = m_received.last();
+    ASSERT_EQ(last.command, Control::Rpc_Result_Ok);
+    ASSERT_TRUE(last.args.isEmpty());
+    ASSERT_EQ(last.requestId, 0u);
+}
+
+TEST_F(ControlWorkerTest, compactEncoding)
+{
+    QByteArray data;
+    int textSize = 0;
+    ASSERT_TRUE(ControlArgs::write(data, { 1, true, "abc", Q_INT64_C(-1) }, textSize));
+
+    // count + (tag + varint) + tag + (tag + size + text) + (tag + zigzag varint)
+    ASSERT_EQ(data.size(), 1 + 2 + 1 + 5 + 2);
+    ASSERT_EQ(textSize, 3);
+
+    QVariantList args;
+    ASSERT_TRUE(ControlArgs::read(data, args));
+    ASSERT_EQ(args, QVariantList({ 1, true, "abc", Q_INT64_C(-1) }));
+
+    // Truncated data
+    args.clear();
+    ASSERT_FALSE(ControlArgs::read(data.left(data.size() - 1), args));
+
+    // Trailing data
+    args.clear();
+    ASSERT_FALSE(ControlArgs::read(data + '\0', args));
+}
+
+TEST_F(ControlWorkerTest, compressByType)
+{
+    // Text
+    {
+        const QString text = QString("C:\\Program Files\\App\\app.exe;").repeated(100);
+
+        QByteArray data;
+        int textSize = 0;
+        ASSERT_TRUE(ControlArgs::write(data, { text }, textSize));
+        ASSERT_TRUE(ControlArgs::isCompressible(data.size(), textSize));
+
+        bool compressed = false;
+        const QByteArray buffer = ControlArgs::compress(data, compressed);
+        ASSERT_TRUE(compressed);
+        ASSERT_LT(buffer.size(), data.size() / 4);
+        ASSERT_EQ(ControlArgs::uncompress(buffer, compressed), data);
+    }
+
+    // Small text
+    {
+        QByteArray data;
+        int textSize = 0;
+        ASSERT_TRUE(ControlArgs::write(data, { QString(200, 'a') }, textSize));
+        ASSERT_FALSE(ControlArgs::isCompressible(data.size(), textSize));
+    }
+
+    // Binary
+    {
+        QByteArray data;
+        int textSize = 0;
+        ASSERT_TRUE(ControlArgs::write(data, { randomBytes(64 * 1024) }, textSize));
+        ASSERT_FALSE(ControlArgs::isCompressible(data.size(), textSize));
+    }
+
+    // Incompressible data is kept as is
+    {
+        const QByteArray data = randomBytes(4 * 1024);
+
+        bool compressed = true;
+        ASSERT_EQ(ControlArgs::compress(data, compressed), data);
+        ASSERT_FALSE(compressed);
+    }
+}
+
+TEST_F(ControlWorkerTest, chunkedPayload)
+{
+    const QByteArray bigData = randomBytes(5 * ControlWorker::chunkMaxSize + 123);
+
+    QStringList bigList;
+    for (int i = 0; i < 200000; ++i) {
+        bigList.append(QString("C:\\Program Files\\App%1\\app.exe").arg(i));
+    }
+
+    const QByteArray commandData =
+            ControlWorker::buildCommandData(Control::Rpc_Result_Ok, { bigData }, 7);
+    ASSERT_EQ(commandData.size(),
+            bigData.size() + 6 * int(sizeof(TestControlWorker::RequestHeader)) + 1 + 1 + 4);
+
+    ASSERT_TRUE(m_client->sendCommand(Control::Rpc_Result_Ok, { bigData }, 7));
+    ASSERT_TRUE(m_client->sendCommand(Control::Rpc_Result_Error, { bigList }, 8));
+    ASSERT_TRUE(m_client->sendCommand(Control::Rpc_Result_Ok, { 1 }, 9));
+
+    ASSERT_TRUE(waitReceived(3, 30000));
+
+    ASSERT_EQ(m_received[0].requestId, 7u);
+    ASSERT_EQ(m_received[0].args.value(0).toByteArray(), bigData);
+
+    ASSERT_EQ(m_received[1].requestId, 8u);
+    ASSERT_EQ(m_received[1].args.value(0).toStringList(), bigList);
+
+    ASSERT_EQ(m_received[2].requestId, 9u);
+    ASSERT_EQ(m_received[2].args, QVariantList({ 1 }));
+}
+
+TEST_F(ControlWorkerTest, dataSizeLimit)
+{
+    const QByteArray tooBigData(ControlWorker::dataMaxSize, '\0');
+
+    ASSERT_TRUE(ControlWorker::buildCommandData(Control::Rpc_Result_Ok, { tooBigData }).isEmpty());
+    ASSERT_FALSE(m_client->sendCommand(Control::Rpc_Result_Ok, { tooBigData }));
+
+    // Too many arguments
+    const QVariantList tooManyArgs(33, 1);
+    ASSERT_TRUE(ControlWorker::buildCommandData(Control::Rpc_Result_Ok, tooManyArgs).isEmpty());
+}
+
+TEST_F(ControlWorkerTest, badChunkSize)
+{
+    const TestControlWorker::RequestHeader header(
+            Control::Rpc_Result_Ok, false, ControlWorker::chunkMaxSize + 1);
+
+    QByteArray data((const char *) &header, sizeof(header));
+    data.append(ControlWorker::chunkMaxSize + 1, '\0');
+
+    ASSERT_TRUE(m_client->sendCommandData(data));
+
+    ASSERT_TRUE(waitServerDisconnected());
+    ASSERT_TRUE(m_received.isEmpty());
+}
+
+TEST_F(ControlWorkerTest, badChunkSequence)
+{
+    // The next chunk must continue the same request
+    const TestControlWorker::RequestHeader header1(
+            Control::Rpc_Result_Ok, false, 0, /*requestId=*/1, /*hasNextChunk=*/true);
+    const TestControlWorker::RequestHeader header2(
+            Control::Rpc_Result_Ok, false, 0, /*requestId=*/2);
+
+    QByteArray data((const char *) &header1, sizeof(header1));
+    data.append((const char *) &header2, sizeof(header2));
+
+    ASSERT_TRUE(m_client->sendCommandData(data));
+
+    ASSERT_TRUE(waitServerDisconnected());
+    ASSERT_TRUE(m_received.isEmpty());
+}
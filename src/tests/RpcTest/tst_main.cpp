@@ -0,0 +1,17 @@
+#include "tst_controlworker.h"
+#include "tst_rpcmanager.h"
+
+#include <QCoreApplication>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::InitGoogleMock(&argc, argv);
+
+    QCoreApplication app(argc, argv);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QSignalSpy>
+#include <QTest>
+#include <QThread>
+#include <QTimer>
+
+#include <googletest.h>
+
+#include <control/controlworker.h>
+#include <hostinfo/hostinfocache.h>
+#include <rpc/hostinfomanagerrpc.h>
+#include <rpc/rpcmanager.h>
+#include <util/ioc/ioccontainer.h>
+
+namespace {
+
+constexpr int closeConnectionLatency = -1;
+
+// Fake service: replies to every request after the latency from the request's first argument,
+// so replies come out of order
+void setupFakeServer(QLocalServer *server)
+{
+    QObject::connect(server, &QLocalServer::newConnection, server, [server] {
+        while (QLocalSocket *socket = server->nextPendingConnection()) {
+            auto w = new ControlWorker(socket, server);
+            socket->setParent(w);
+            w->setupForAsync();
+
+            QObject::connect(w, &ControlWorker::requestReady, w,
+                    [w](Control::Command command, const QVariantList &args, quint32 requestId) {
+                        if (command == Control::Rpc_RpcManager_initClient)
+                            return;
+
+                        // The service's lookups queue is full: report the lookups as dropped
+                        if (command == Control::Rpc_HostInfoManager_lookupHosts) {
+                            const QStringList addresses = args.value(0).toStringList();
+                            for (const QString &address : addresses) {
+                                w->sendCommand(Control::Rpc_HostInfoManager_lookupDropped,
+                                        { address });
+                            }
+                            return;
+                        }
+
+                        const int latency = args.value(0).toInt();
+                        const QVariant value = args.value(1);
+
+                        if (latency == closeConnectionLatency) {
+                            w->close();
+                            return;
+                        }
+
+                        QTimer::singleShot(latency, w, [=] {
+                            w->sendResult(value.isValid(), { value }, requestId);
+                        });
+                    });
+        }
+    });
+}
+
+// Counts the lookups requested from the service
+class TestHostInfoManagerRpc : public HostInfoManagerRpc
+{
+public:
+    explicit TestHostInfoManagerRpc() : HostInfoManagerRpc(":memory:", /*noCache=*/true) { }
+
+    int lookupsCount() const { return m_lookupsCount; }
+
+    void lookupHosts(const QStringList &addresses) override
+    {
+        ++m_lookupsCount;
+
+        HostInfoManagerRpc::lookupHosts(addresses);
+    }
+
+private:
+    int m_lookupsCount = 0;
+};
+
+}
+
+class RpcManagerTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    bool invokeAsync(int latency, const QVariant &value);
+
+protected:
+    QThread m_serverThread;
+    QObject *m_serverContext = nullptr;
+
+    QLocalSocket *m_socket = nullptr;
+    ControlWorker *m_client = nullptr;
+    RpcManager *m_rpcManager = nullptr;
+
+    QList<QVariant> m_results;
+    int m_errorsCount = 0;
+};
+
+void RpcManagerTest::SetUp()
+{
+    const QString serverName = QString("FortRpcTest_%1").arg(QCoreApplication::applicationPid());
+
+    // Run the fake service in its own thread: blocking calls don't spin the client's event loop
+    m_serverContext = new QObject();
+    m_serverContext->moveToThread(&m_serverThread);
+    m_serverThread.start();
+
+    bool listening = false;
+    QMetaObject::invokeMethod(
+            m_serverContext,
+            [&] {
+                auto server = new QLocalServer(m_serverContext);
+                setupFakeServer(server);
+
+                listening = server->listen(serverName);
+            },
+            Qt::BlockingQueuedConnection);
+
+    ASSERT_TRUE(listening);
+
+    m_socket = new QLocalSocket();
+    m_client = new ControlWorker(m_socket);
+    m_socket->setParent(m_client);
+    m_client->setupForAsync();
+    m_client->setServerName(serverName);
+
+    m_rpcManager = new RpcManager();
+    m_rpcManager->setClient(m_client);
+
+    QObject::connect(m_client, &ControlWorker::requestReady, m_rpcManager,
+            [&](Control::Command command, const QVariantList &args, quint32 requestId) {
+                ProcessCommandResult r;
+                m_rpcManager->processCommandRpc(
+                        {
+                                .worker = m_client,
+                                .command = command,
+                                .args = args,
+                                .requestId = requestId,
+                        },
+                        r);
+            });
+
+    ASSERT_TRUE(m_client->connectToServer());
+}
+
+void RpcManagerTest::TearDown()
+{
+    delete m_rpcManager;
+    delete m_client;
+
+    QMetaObject::invokeMethod(
+            m_serverContext, [&] { delete m_serverContext; }, Qt::BlockingQueuedConnection);
+
+    m_serverThread.quit();
+    m_serverThread.wait();
+}
+
+bool RpcManagerTest::invokeAsync(int latency, const QVariant &value)
+{
+    return m_rpcManager->invokeOnServerAsync(Control::Rpc_StatManager_deleteStatApp,
+            { latency, value }, [&](bool ok, const QVariantList &args) {
+                if (ok) {
+                    m_results.append(args.value(0));
+                } else {
+                    ++m_errorsCount;
+                }
+            });
+}
+
+TEST_F(RpcManagerTest, asyncOutOfOrder)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    ASSERT_TRUE(invokeAsync(300, 1));
+    ASSERT_TRUE(invokeAsync(100, 2));
+    ASSERT_TRUE(invokeAsync(200, 3));
+
+    // Requests are pipelined: the caller isn't blocked
+    ASSERT_LT(timer.elapsed(), 100);
+    ASSERT_EQ(m_rpcManager->pendingRequestsCount(), 3);
+
+    ASSERT_TRUE(QTest::qWaitFor([&] { return m_rpcManager->pendingRequestsCount() == 0; }));
+
+    // Replies are matched by request ids, not by the order
+    ASSERT_EQ(m_results, QList<QVariant>({ 2, 3, 1 }));
+    ASSERT_EQ(m_errorsCount, 0);
+
+    // Latencies overlap
+    ASSERT_LT(timer.elapsed(), 300 + 100 + 200);
+}
+
+TEST_F(RpcManagerTest, blockingWhileAsyncPending)
+{
+    ASSERT_TRUE(invokeAsync(200, 1));
+
+    QVariantList resArgs;
+    ASSERT_TRUE(m_rpcManager->doOnServer(
+            Control::Rpc_StatManager_deleteStatApp, { 50, "blocking" }, &resArgs));
+    ASSERT_EQ(resArgs.value(0).toString(), "blocking");
+
+    ASSERT_TRUE(QTest::qWaitFor([&] { return m_rpcManager->pendingRequestsCount() == 0; }));
+
+    ASSERT_EQ(m_results, QList<QVariant>({ 1 }));
+}
+
+TEST_F(RpcManagerTest, blockingError)
+{
+    ASSERT_FALSE(m_rpcManager->doOnServer(Control::Rpc_StatManager_deleteStatApp, { 10 }));
+
+    ASSERT_EQ(m_rpcManager->pendingRequestsCount(), 0);
+}
+
+TEST_F(RpcManagerTest, disconnectAbortsPending)
+{
+    ASSERT_TRUE(invokeAsync(1000, 1));
+    ASSERT_TRUE(invokeAsync(1000, 2));
+
+    ASSERT_TRUE(m_rpcManager->invokeOnServerAsync(
+            Control::Rpc_StatManager_deleteStatApp, { closeConnectionLatency }));
+
+    ASSERT_TRUE(QTest::qWaitFor([&] { return m_errorsCount == 2; }));
+
+    ASSERT_EQ(m_rpcManager->pendingRequestsCount(), 0);
+    ASSERT_TRUE(m_results.isEmpty());
+}
+
+TEST_F(RpcManagerTest, droppedHostLookup)
+{
+    auto hostInfoManager = new TestHostInfoManagerRpc();
+
+    IocContainer container;
+    container.setService(*m_rpcManager);
+    container.setService<HostInfoManager>(hostInfoManager);
+    container.pinToThread();
+
+    HostInfoCache cache;
+    cache.setUp();
+
+    QSignalSpy spy(hostInfoManager, &HostInfoManager::lookupDropped);
+
+    ASSERT_EQ(cache.hostName("1.1.1.1"), QString());
+
+    // The service reports the dropped lookup to the client
+    ASSERT_TRUE(spy.wait());
+    ASSERT_EQ(spy.at(0).at(0).toString(), "1.1.1.1");
+
+    // The client's cache requests it again
+    ASSERT_EQ(cache.hostName("1.1.1.1"), QString());
+
+    ASSERT_TRUE(QTest::qWaitFor([&] { return hostInfoManager->lookupsCount() == 2; }));
+
+    cache.tearDown();
+}
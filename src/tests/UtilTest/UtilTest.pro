@@ -5,13 +5,19 @@ HEADERS += \
     tst_confutil.h \
     tst_dateutil.h \
     tst_fileutil.h \
+    tst_graphseries.h \
     tst_ioccontainer.h \
     tst_netutil.h \
     tst_ruletextparser.h \
-    tst_stringutil.h
+    tst_sqlitedbext.h \
+    tst_stringutil.h \
+    tst_workermanager.h
 
 SOURCES += \
     tst_main.cpp
 
 # Test Data
 RESOURCES += data.qrc
+
+# Conf DB schema
+RESOURCES += $$PWD/../../ui/conf/conf_migrations.qrc
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <QElapsedTimer>
+#include <QRandomGenerator>
 #include <QSignalSpy>
 
 #include <googletest.h>
 
 #include <conf/addressgroup.h>
+#include <conf/app.h>
 #include <conf/appgroup.h>
 #include <conf/confrulemanager.h>
 #include <conf/firewallconf.h>
@@ -18,6 +21,8 @@
 #include <util/fileutil.h>
 #include <util/net/netformatutil.h>
 #include <util/net/netutil.h>
+#include <util/net/portrange.h>
+#include <util/net/protorange.h>
 #include <util/stringutil.h>
 
 #include <mocks/mocksqlitestmt.h>
@@ -28,12 +33,66 @@ class ConfUtilTest : public Test
 protected:
     void SetUp();
     void TearDown();
+
+    static QString randomRuleText(QRandomGenerator &rand, int depth);
+    static QString randomRuleFilter(QRandomGenerator &rand);
 };
 
 void ConfUtilTest::SetUp() { }
 
 void ConfUtilTest::TearDown() { }
 
+QString ConfUtilTest::randomRuleText(QRandomGenerator &rand, int depth)
+{
+    QStringList lines;
+
+    const int linesCount = 1 + rand.bounded(3);
+    for (int i = 0; i < linesCount; ++i) {
+        QStringList sections;
+
+        const int sectionsCount = 1 + rand.bounded(3);
+        for (int j = 0; j < sectionsCount; ++j) {
+            const bool isList = (depth < 3 && rand.bounded(4) == 0);
+
+            sections << (isList ? "{" + randomRuleText(rand, depth + 1) + "}"
+                                : randomRuleFilter(rand));
+        }
+
+        lines << sections.join(':');
+    }
+
+    return lines.join('\n');
+}
+
+QString ConfUtilTest::randomRuleFilter(QRandomGenerator &rand)
+{
+    static const char *const filters[] = {
+        "ip(1.1.1.1, 10.0.0.0/8)",
+        "ip(2.2.2.2-2.2.2.9)",
+        "local_ip(192.168.0.0/16)",
+        "port(80, 443, 1000-2000)",
+        "local_port(53, 5000-6000)",
+        "proto(6, 17)",
+        "proto(1)",
+        "tcp(80, 443)",
+        "udp(53)",
+        "dir(IN)",
+        "dir(OUT)",
+        "ip_ver(4)",
+        "area(LOCALHOST)",
+        "area(LAN, INET)",
+        "act(BLOCK)",
+        "act(ALLOW)",
+        "=local_port",
+    };
+
+    const QString filter = filters[rand.bounded(int(std::size(filters)))];
+
+    const bool isNot = !filter.startsWith('=') && rand.bounded(3) == 0;
+
+    return isNot ? "!" + filter : filter;
+}
+
 TEST_F(ConfUtilTest, confWriteRead)
 {
     EnvManager envManager;
@@ -647,3 +706,446 @@ TEST_F(ConfUtilTest, ruleFilterAction)
         ASSERT_FALSE(DriverCommon::confRulesConnBlocked(data, &conn, /*ruleId=*/1));
     }
 }
+
+TEST_F(ConfUtilTest, rulesPortProtoBitmap)
+{
+    // Same values as one bitmap filter and as OR-ed small lists
+    QStringList portValues;
+    QStringList protoValues;
+
+    quint32 seed = 1;
+    for (int i = 0; i < 200; ++i) {
+        seed = seed * 1103515245 + 12345;
+        const int port = (seed >> 8) % 65000;
+
+        portValues << ((i % 3 == 0) ? QString("%1-%2").arg(port).arg(port + (seed & 0xFF))
+                                    : QString::number(port));
+    }
+    portValues << "65535";
+
+    for (int proto = 1; proto < 250; proto += 5) {
+        protoValues << ((proto % 2 == 0) ? QString("%1-%2").arg(proto).arg(proto + 2)
+                                         : QString::number(proto));
+    }
+
+    const auto chunkedText = [](const QString &name, const QStringList &values, int chunkSize) {
+        QStringList lines;
+        for (int i = 0; i < values.size(); i += chunkSize) {
+            lines << QString("%1(%2)").arg(name, values.mid(i, chunkSize).join(", "));
+        }
+        return lines.join('\n');
+    };
+
+    const QString portText = QString("port(%1)").arg(portValues.join(", "));
+    const QString portListText = chunkedText("port", portValues, 16);
+    const QString protoText = QString("proto(%1)").arg(protoValues.join(", "));
+    const QString protoListText = chunkedText("proto", protoValues, 8);
+    const QString tcpText = QString("tcp(%1)").arg(portValues.join(", "));
+
+    // Check the chosen formats
+    {
+        PortRange portRange;
+        ASSERT_TRUE(portRange.fromText(portValues.join('\n')));
+        ASSERT_TRUE(portRange.isBitmap());
+        ASSERT_TRUE(portRange.checkSize());
+        ASSERT_EQ(portRange.sizeToWrite(), FORT_CONF_PORT_BITMAP_SIZE);
+
+        PortRange portListRange;
+        ASSERT_TRUE(portListRange.fromText(portValues.mid(0, 16).join('\n')));
+        ASSERT_FALSE(portListRange.isBitmap());
+
+        ProtoRange protoRange;
+        ASSERT_TRUE(protoRange.fromText(protoValues.join('\n')));
+        ASSERT_TRUE(protoRange.isBitmap());
+        ASSERT_EQ(protoRange.sizeToWrite(), FORT_CONF_PROTO_BITMAP_SIZE);
+
+        ProtoRange protoListRange;
+        ASSERT_TRUE(protoListRange.fromText(protoValues.mid(0, 8).join('\n')));
+        ASSERT_FALSE(protoListRange.isBitmap());
+    }
+
+    static Rule g_rules[] = {
+        { .blocked = true, .ruleId = 1 },
+        { .blocked = true, .ruleId = 2 },
+        { .blocked = true, .ruleId = 3 },
+        { .blocked = true, .ruleId = 4 },
+        { .blocked = true, .ruleId = 5 },
+        { .blocked = true, .ruleId = 6 },
+    };
+
+    g_rules[0].ruleText = portText;
+    g_rules[1].ruleText = portListText;
+    g_rules[2].ruleText = protoText;
+    g_rules[3].ruleText = protoListText;
+    g_rules[4].ruleText = tcpText;
+    g_rules[5].ruleText = "!" + portText;
+
+    class TestRules : public ConfRulesWalker
+    {
+    public:
+        bool walkRules(
+                WalkRulesArgs &wra, const std::function<walkRulesCallback> &func) const override
+        {
+            wra.maxRuleId = 6;
+
+            return walkRulesLoop(func);
+        }
+
+    private:
+        bool walkRulesLoop(const std::function<walkRulesCallback> &func) const
+        {
+            for (const auto &rule : g_rules) {
+                if (!func(rule))
+                    return false;
+            }
+
+            return true;
+        }
+    };
+
+    TestRules testRules;
+
+    ConfBuffer confBuf;
+
+    if (!confBuf.writeRules(testRules)) {
+        qCritical() << "Error:" << confBuf.errorMessage();
+        Q_UNREACHABLE();
+    }
+
+    // Check the buffer
+    const char *data = confBuf.data();
+
+    // Ports
+    for (int port = 0; port <= 65535; ++port) {
+        FORT_CONF_META_CONN conn = {
+            .ip_proto = IpProto_TCP,
+            .remote_port = quint16(port),
+            .remote_ip = { .v4 = NetFormatUtil::textToIp4("1.1.1.1") },
+        };
+
+        const bool listBlocked = DriverCommon::confRulesConnBlocked(data, &conn, /*ruleId=*/2);
+
+        ASSERT_EQ(DriverCommon::confRulesConnBlocked(data, &conn, /*ruleId=*/1), listBlocked);
+        ASSERT_EQ(DriverCommon::confRulesConnBlocked(data, &conn, /*ruleId=*/5), listBlocked);
+        ASSERT_EQ(DriverCommon::confRulesConnBlocked(data, &conn, /*ruleId=*/6), !listBlocked);
+
+        conn.ip_proto = IpProto_UDP;
+
+        ASSERT_FALSE(DriverCommon::confRulesConnBlocked(data, &conn, /*ruleId=*/5));
+    }
+
+    // Protocols
+    for (int proto = 0; proto <= 255; ++proto) {
+        FORT_CONF_META_CONN conn = {
+            .ip_proto = quint8(proto),
+            .remote_port = 80,
+            .remote_ip = { .v4 = NetFormatUtil::textToIp4("1.1.1.1") },
+        };
+
+        const bool listBlocked = DriverCommon::confRulesConnBlocked(data, &conn, /*ruleId=*/4);
+
+        ASSERT_EQ(DriverCommon::confRulesConnBlocked(data, &conn, /*ruleId=*/3), listBlocked);
+    }
+}
+
+TEST_F(ConfUtilTest, rulesFilterProgram)
+{
+    constexpr int rulesCount = 200;
+
+    static QVector<Rule> g_rules;
+
+    QRandomGenerator rand(rulesCount);
+
+    g_rules.clear();
+    for (int i = 0; i < rulesCount; ++i) {
+        Rule rule;
+        rule.blocked = rand.bounded(2) != 0;
+        rule.exclusive = rand.bounded(4) == 0;
+        rule.ruleId = i + 1;
+        rule.ruleText = randomRuleText(rand, /*depth=*/0);
+
+        g_rules.append(rule);
+    }
+
+    class TestRules : public ConfRulesWalker
+    {
+    public:
+        bool walkRules(
+                WalkRulesArgs &wra, const std::function<walkRulesCallback> &func) const override
+        {
+            wra.maxRuleId = rulesCount;
+
+            return walkRulesLoop(func);
+        }
+
+    private:
+        bool walkRulesLoop(const std::function<walkRulesCallback> &func) const
+        {
+            for (const auto &rule : g_rules) {
+                if (!func(rule))
+                    return false;
+            }
+
+            return true;
+        }
+    };
+
+    TestRules testRules;
+
+    ConfBuffer treeBuf;
+    treeBuf.setCompileRuleFilters(false);
+
+    ConfBuffer programBuf;
+
+    for (ConfBuffer *confBuf : { &treeBuf, &programBuf }) {
+        if (!confBuf->writeRules(testRules)) {
+            qCritical() << "Error:" << confBuf->errorMessage();
+            Q_UNREACHABLE();
+        }
+    }
+
+    ASSERT_TRUE(treeBuf.buffer() != programBuf.buffer());
+
+    // Compare the verdicts
+    static const char *const ips[] = { "1.1.1.1", "2.2.2.5", "10.1.2.3", "192.168.1.1",
+        "127.0.0.1", "8.8.8.8" };
+    static const quint16 ports[] = { 53, 80, 443, 1500, 5353, 8080 };
+    static const quint8 protos[] = { IpProto_TCP, IpProto_UDP, 1 };
+
+    for (int i = 0; i < 2000; ++i) {
+        const FORT_CONF_META_CONN conn = {
+            .inbound = rand.bounded(2) != 0,
+            .is_loopback = rand.bounded(4) == 0,
+            .is_local_net = rand.bounded(2) != 0,
+            .ip_proto = protos[rand.bounded(int(std::size(protos)))],
+            .local_port = ports[rand.bounded(int(std::size(ports)))],
+            .remote_port = ports[rand.bounded(int(std::size(ports)))],
+            .local_ip = { .v4 = NetFormatUtil::textToIp4(ips[rand.bounded(int(std::size(ips)))]) },
+            .remote_ip = { .v4 = NetFormatUtil::textToIp4(ips[rand.bounded(int(std::size(ips)))]) },
+        };
+
+        for (quint16 ruleId = 1; ruleId <= rulesCount; ++ruleId) {
+            FORT_CONF_META_CONN treeConn = conn;
+            FORT_CONF_META_CONN programConn = conn;
+
+            const bool treeFiltered =
+                    DriverCommon::confRulesConnFiltered(treeBuf.data(), &treeConn, ruleId);
+            const bool programFiltered =
+                    DriverCommon::confRulesConnFiltered(programBuf.data(), &programConn, ruleId);
+
+            ASSERT_EQ(treeFiltered, programFiltered) << g_rules[ruleId - 1].ruleText.toStdString();
+            ASSERT_EQ(treeConn.blocked, programConn.blocked);
+            ASSERT_EQ(treeConn.rule_filter_action, programConn.rule_filter_action);
+        }
+    }
+}
+
+TEST_F(ConfUtilTest, rulesSetMasks)
+{
+    // Root rule -> 20 presets -> 24 rules in each
+    constexpr int presetsCount = 20;
+    constexpr int presetRulesCount = 24;
+    constexpr int rulesCount = 1 + presetsCount + presetsCount * presetRulesCount;
+
+    static const char *const ruleTexts[] = {
+        "tcp(80, 443)",
+        "udp(53)",
+        "dir(IN):tcp(22)",
+        "dir(OUT):udp(123)",
+        "ip_ver(6):tcp(443)",
+        "area(LAN):udp(137-139)",
+        "area(LOCALHOST):tcp(5000-5100)",
+        "proto(1, 58)",
+        "10.0.0.0/8:tcp(3389)",
+        "[fe80::]/10:udp(546, 547)",
+        "192.168.0.0/16:445",
+        "!dir(IN):udp(500, 4500)",
+        "act(BLOCK):tcp(25)",
+        "1.1.1.1:53\n8.8.8.8:53",
+        "dir(OUT):tcp(8000-8999)",
+        "area(LAN):{udp(67, 68)\nudp(1900)}",
+    };
+
+    static QVector<Rule> g_rules;
+    static WalkRulesArgs g_wra;
+
+    g_rules.clear();
+    g_wra = {};
+    g_wra.maxRuleId = rulesCount;
+
+    Rule rootRule;
+    rootRule.ruleType = Rule::GlobalBeforeAppsRule;
+    rootRule.ruleId = 1;
+    g_rules.append(rootRule);
+
+    g_wra.ruleSetMap.insert(1, { .index = 0, .count = presetsCount });
+
+    for (int i = 0; i < presetsCount; ++i) {
+        g_wra.ruleSetIds.append(2 + i);
+    }
+
+    for (int i = 0; i < presetsCount; ++i) {
+        Rule presetRule;
+        presetRule.ruleType = Rule::PresetRule;
+        presetRule.ruleId = 2 + i;
+        g_rules.append(presetRule);
+
+        const quint16 firstRuleId = 2 + presetsCount + i * presetRulesCount;
+
+        g_wra.ruleSetMap.insert(presetRule.ruleId,
+                { .index = quint32(g_wra.ruleSetIds.size()), .count = presetRulesCount });
+
+        for (int j = 0; j < presetRulesCount; ++j) {
+            const quint16 ruleId = firstRuleId + j;
+
+            Rule rule;
+            rule.blocked = (ruleId % 3) == 0;
+            rule.ruleType = Rule::PresetRule;
+            rule.ruleId = ruleId;
+            rule.ruleText = ruleTexts[(i * 7 + j) % std::size(ruleTexts)];
+            g_rules.append(rule);
+
+            g_wra.ruleSetIds.append(ruleId);
+        }
+    }
+
+    class TestRules : public ConfRulesWalker
+    {
+    public:
+        bool walkRules(
+                WalkRulesArgs &wra, const std::function<walkRulesCallback> &func) const override
+        {
+            wra = g_wra;
+
+            return walkRulesLoop(func);
+        }
+
+    private:
+        bool walkRulesLoop(const std::function<walkRulesCallback> &func) const
+        {
+            for (const auto &rule : g_rules) {
+                if (!func(rule))
+                    return false;
+            }
+
+            return true;
+        }
+    };
+
+    TestRules testRules;
+
+    ConfBuffer plainBuf;
+    plainBuf.setUseRuleMasks(false);
+
+    ConfBuffer maskBuf;
+
+    for (ConfBuffer *confBuf : { &plainBuf, &maskBuf }) {
+        if (!confBuf->writeRules(testRules)) {
+            qCritical() << "Error:" << confBuf->errorMessage();
+            Q_UNREACHABLE();
+        }
+    }
+
+    // Connections
+    static const char *const ips[] = { "1.1.1.1", "8.8.8.8", "10.1.2.3", "192.168.1.1",
+        "127.0.0.1", "93.184.216.34" };
+    static const quint16 ports[] = { 22, 25, 53, 67, 80, 123, 138, 443, 445, 3389, 5050, 8443 };
+    static const quint8 protos[] = { IpProto_TCP, IpProto_UDP, IpProto_ICMP, IpProto_ICMPV6, 47 };
+
+    QRandomGenerator rand(rulesCount);
+    QVector<FORT_CONF_META_CONN> conns;
+
+    for (int i = 0; i < 20000; ++i) {
+        const bool isIPv6 = rand.bounded(5) == 0;
+        const bool isLoopback = rand.bounded(8) == 0;
+
+        FORT_CONF_META_CONN conn = {
+            .inbound = rand.bounded(3) == 0,
+            .isIPv6 = isIPv6,
+            .is_loopback = isLoopback,
+            .is_local_net = isLoopback || rand.bounded(3) == 0,
+            .ip_proto = protos[rand.bounded(int(std::size(protos)))],
+            .local_port = ports[rand.bounded(int(std::size(ports)))],
+            .remote_port = ports[rand.bounded(int(std::size(ports)))],
+        };
+
+        if (isIPv6) {
+            conn.remote_ip.v6 = NetFormatUtil::textToIp6(rand.bounded(2) ? "fe80::1" : "2001::1");
+        } else {
+            conn.remote_ip.v4 = NetFormatUtil::textToIp4(ips[rand.bounded(int(std::size(ips)))]);
+        }
+
+        conns.append(conn);
+    }
+
+    // Compare the verdicts
+    QVector<FORT_CONF_META_CONN> plainConns = conns;
+    QVector<FORT_CONF_META_CONN> maskConns = conns;
+    QVector<bool> plainResults(conns.size());
+    QVector<bool> maskResults(conns.size());
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0, n = conns.size(); i < n; ++i) {
+        plainResults[i] =
+                DriverCommon::confRulesConnFiltered(plainBuf.data(), &plainConns[i], /*ruleId=*/1);
+    }
+
+    const qint64 plainElapsed = timer.restart();
+
+    for (int i = 0, n = conns.size(); i < n; ++i) {
+        maskResults[i] =
+                DriverCommon::confRulesConnFiltered(maskBuf.data(), &maskConns[i], /*ruleId=*/1);
+    }
+
+    const qint64 maskElapsed = timer.elapsed();
+
+    qDebug() << "rules:" << rulesCount << "conns:" << conns.size() << "plain>" << plainElapsed
+             << "msec" << "masks>" << maskElapsed << "msec";
+
+    for (int i = 0, n = conns.size(); i < n; ++i) {
+        const FORT_CONF_META_CONN &plainConn = plainConns[i];
+        const FORT_CONF_META_CONN &maskConn = maskConns[i];
+
+        ASSERT_EQ(plainResults[i], maskResults[i]);
+
+        if (plainResults[i]) {
+            ASSERT_EQ(plainConn.blocked, maskConn.blocked);
+            ASSERT_EQ(plainConn.rule_id, maskConn.rule_id);
+        }
+    }
+}
+
+TEST_F(ConfUtilTest, appEntriesSkipInvalid)
+{
+    App app1;
+    app1.appPath = "C:\\Program Files\\App1\\app1.exe";
+
+    App appLong;
+    appLong.appPath = "C:\\" + QString(FORT_CONF_APP_PATH_MAX + 1, 'a') + ".exe";
+
+    App app2;
+    app2.appPath = "C:\\Program Files\\App2\\app2.exe";
+
+    // The invalid app does not fail the batch
+    {
+        ConfBuffer confBuf;
+        QStringList skippedAppPaths;
+
+        ASSERT_TRUE(confBuf.writeAppEntries({ app1, appLong, app2 }, skippedAppPaths));
+        ASSERT_EQ(skippedAppPaths, QStringList({ appLong.appPath }));
+
+        const auto appEntries = PCFORT_APP_ENTRIES(confBuf.buffer().constData());
+        ASSERT_EQ(appEntries->count, 2);
+    }
+
+    // No valid apps
+    {
+        ConfBuffer confBuf;
+        QStringList skippedAppPaths;
+
+        ASSERT_FALSE(confBuf.writeAppEntries({ appLong }, skippedAppPaths));
+        ASSERT_EQ(skippedAppPaths.size(), 1);
+    }
+}
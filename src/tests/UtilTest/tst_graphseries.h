@@ -0,0 +1,168 @@
+#pragma once
+
+#include <QMap>
+#include <QRandomGenerator>
+
+#include <googletest.h>
+
+#include <form/graph/graphseries.h>
+
+class GraphSeriesTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+};
+
+void GraphSeriesTest::SetUp() { }
+
+void GraphSeriesTest::TearDown() { }
+
+TEST_F(GraphSeriesTest, bucketValues)
+{
+    GraphSeries series(100);
+
+    for (int i = 0; i < 16; ++i) {
+        series.addValue(1000 + i, i);
+    }
+
+    ASSERT_EQ(series.lastTime(), 1015);
+    ASSERT_EQ(series.lastValue(), 15);
+
+    ASSERT_EQ(series.buckets(0, 0).size(), 16);
+
+    // Buckets of 4 seconds
+    const QVector<GraphBucket> buckets = series.buckets(2, 0);
+    ASSERT_EQ(buckets.size(), 4);
+
+    for (int i = 0; i < 4; ++i) {
+        const GraphBucket &bucket = buckets[i];
+        const int first = i * 4;
+
+        ASSERT_EQ(bucket.time, 1000 + first);
+        ASSERT_EQ(bucket.count, 4);
+        ASSERT_EQ(bucket.minValue, first);
+        ASSERT_EQ(bucket.maxValue, first + 3);
+        ASSERT_EQ(bucket.avgValue(), first + 1.5);
+    }
+}
+
+TEST_F(GraphSeriesTest, sameSecondValues)
+{
+    GraphSeries series(100);
+
+    series.addValue(1000, 5);
+    series.addValue(1000, 7);
+
+    ASSERT_EQ(series.lastValue(), 12);
+    ASSERT_EQ(series.buckets(1, 0).value(0).maxValue, 12);
+
+    series.addValue(1001, 1);
+
+    const GraphBucket bucket = series.buckets(1, 0).value(0);
+    ASSERT_EQ(bucket.time, 1000);
+    ASSERT_EQ(bucket.count, 2);
+    ASSERT_EQ(bucket.minValue, 1);
+    ASSERT_EQ(bucket.maxValue, 12);
+    ASSERT_EQ(bucket.sumValue, 13);
+}
+
+TEST_F(GraphSeriesTest, fixedCapacity)
+{
+    GraphSeries series(10);
+
+    for (int i = 0; i < 1000; ++i) {
+        series.addValue(1000 + i, i);
+    }
+
+    const qint64 timeFrom = series.lastTime() - series.maxSeconds();
+
+    ASSERT_EQ(series.buckets(0, timeFrom).size(), 11);
+    ASSERT_LE(series.buckets(0, 0).size(), 12);
+    ASSERT_LE(series.buckets(3, 0).size(), 3);
+
+    ASSERT_EQ(series.buckets(0, timeFrom).first().time, timeFrom);
+}
+
+TEST_F(GraphSeriesTest, clockChanges)
+{
+    GraphSeries series(10);
+
+    series.addValue(1000, 1);
+    series.addValue(1001, 2);
+
+    // Time goes back
+    series.addValue(990, 3);
+
+    ASSERT_EQ(series.buckets(0, 0).size(), 1);
+    ASSERT_EQ(series.buckets(4, 0).size(), 1);
+    ASSERT_EQ(series.lastTime(), 990);
+
+    // All samples are out of date
+    series.addValue(2000, 4);
+
+    ASSERT_EQ(series.buckets(0, 0).size(), 1);
+    ASSERT_EQ(series.buckets(4, 0).value(0).sumValue, 4);
+}
+
+TEST_F(GraphSeriesTest, levelForWidth)
+{
+    ASSERT_EQ(GraphSeries::levelForWidth(100, 100), 0);
+    ASSERT_EQ(GraphSeries::levelForWidth(101, 100), 1);
+    ASSERT_EQ(GraphSeries::levelForWidth(500, 100), 3);
+    ASSERT_EQ(GraphSeries::levelForWidth(500, 0), 9);
+    ASSERT_EQ(GraphSeries::levelForWidth(100000, 1), GraphSeries::levelCount - 1);
+}
+
+TEST_F(GraphSeriesTest, randomBuckets)
+{
+    constexpr int maxSeconds = 300;
+
+    GraphSeries series(maxSeconds);
+    QRandomGenerator rand(1);
+
+    QMap<qint64, int> samples;
+    qint64 unixTime = 1700000000;
+
+    for (int i = 0; i < 2000; ++i) {
+        unixTime += 1 + rand.bounded(3); // with gaps
+
+        const int value = rand.bounded(1000);
+
+        samples.insert(unixTime, value);
+        series.addValue(unixTime, value);
+    }
+
+    const qint64 timeFrom = unixTime - maxSeconds;
+
+    for (int level = 0; level < GraphSeries::levelCount; ++level) {
+        const qint64 span = GraphSeries::levelSpan(level);
+
+        // Brute force buckets of the retained samples
+        QMap<qint64, GraphBucket> expected;
+        for (auto it = samples.constBegin(); it != samples.constEnd(); ++it) {
+            const qint64 bucketTime = it.key() & ~(span - 1);
+            if (bucketTime + span <= timeFrom)
+                continue;
+
+            GraphBucket &bucket = expected[bucketTime];
+            bucket.time = bucketTime;
+            bucket.addValue(it.value());
+        }
+
+        const QVector<GraphBucket> buckets = series.buckets(level, timeFrom);
+        ASSERT_EQ(buckets.size(), expected.size()) << "level" << level;
+
+        int i = 0;
+        for (const GraphBucket &e : std::as_const(expected)) {
+            const GraphBucket &bucket = buckets[i++];
+
+            ASSERT_EQ(bucket.time, e.time);
+            ASSERT_EQ(bucket.count, e.count);
+            ASSERT_EQ(bucket.minValue, e.minValue);
+            ASSERT_EQ(bucket.maxValue, e.maxValue);
+            ASSERT_EQ(bucket.sumValue, e.sumValue);
+        }
+    }
+}
@@ -2,10 +2,13 @@
 #include "tst_confutil.h"
 #include "tst_dateutil.h"
 #include "tst_fileutil.h"
+#include "tst_graphseries.h"
 #include "tst_ioccontainer.h"
 #include "tst_netutil.h"
 #include "tst_ruletextparser.h"
+#include "tst_sqlitedbext.h"
 #include "tst_stringutil.h"
+#include "tst_workermanager.h"
 
 #include <QCoreApplication>
 
@@ -1,14 +1,26 @@
 #pragma once
 
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
 #include <QFileInfo>
+#include <QRandomGenerator>
 #include <QSignalSpy>
 
 #include <googletest.h>
 
+#include <common/fortconf.h>
+
+#include <driver/drivercommon.h>
 #include <task/taskzonedownloader.h>
+#include <task/zoneparsemanager.h>
+#include <util/conf/confbuffer.h>
+#include <util/conf/confdata.h>
+#include <util/conf/zonecachefile.h>
 #include <util/fileutil.h>
 #include <util/net/arearange.h>
 #include <util/net/dirrange.h>
+#include <util/net/iplistscanner.h>
 #include <util/net/iprange.h>
 #include <util/net/ipverrange.h>
 #include <util/net/netformatutil.h>
@@ -144,8 +156,20 @@ TEST_F(NetUtilTest, ip6Ranges)
     ASSERT_TRUE(ipRange.fromText("[::2]/126\n"
                                  "[::1]/126\n"));
     ASSERT_EQ(ipRange.toText(),
-            QString("::1-::3\n"
-                    "::2-::3\n"));
+            QString("::1-::3\n"));
+
+    // Merge ranges
+    ASSERT_TRUE(ipRange.fromText("::1\n"
+                                 "::2-::7\n"
+                                 "::8\n"
+                                 "::a\n"
+                                 "::5-::6\n"));
+    ASSERT_EQ(ipRange.toText(),
+            QString("::a\n"
+                    "::1-::8\n"));
+
+    ASSERT_FALSE(ipRange.fromText("::3 - ::2"));
+    ASSERT_EQ(ipRange.errorLineNo(), 1);
 }
 
 TEST_F(NetUtilTest, portRanges)
@@ -289,3 +313,676 @@ TEST_F(NetUtilTest, taskTasix)
     ASSERT_TRUE(tasix.saveAddressesAsText(out.filePath()));
     ASSERT_GT(out.size(), 0);
 }
+
+namespace {
+
+const char *const zoneCacheText = "10.0.0.0/8\n"
+                                  "172.16.0.1\n"
+                                  "192.168.0.0 - 192.168.255.255\n"
+                                  "[2002::]/16\n"
+                                  "::1\n";
+
+QByteArray zoneCacheData()
+{
+    IpRange ipRange;
+    if (!ipRange.fromText(zoneCacheText))
+        return {};
+
+    ConfBuffer confBuf;
+    confBuf.writeZone(ipRange);
+
+    return confBuf.buffer();
+}
+
+void corruptFile(const QString &filePath, int offset, const QByteArray &bytes)
+{
+    QByteArray data = FileUtil::readFileData(filePath);
+    data.replace(offset, bytes.size(), bytes);
+
+    FileUtil::writeFileData(filePath, data);
+}
+
+void truncateFile(const QString &filePath, int size)
+{
+    FileUtil::writeFileData(filePath, FileUtil::readFileData(filePath).left(size));
+}
+
+}
+
+TEST_F(NetUtilTest, zoneCacheFile)
+{
+    const QByteArray zoneData = zoneCacheData();
+    ASSERT_FALSE(zoneData.isEmpty());
+
+    const QString filePath("./zones/cache-test.bin");
+
+    QString checksum;
+    ASSERT_TRUE(ZoneCacheFile::write(filePath, zoneData, checksum));
+    ASSERT_FALSE(checksum.isEmpty());
+
+    const QByteArray fileData = FileUtil::readFileData(filePath);
+    ASSERT_TRUE(ZoneCacheFile::isZoneCacheData(fileData));
+    ASSERT_EQ(fileData.size(), qsizetype(sizeof(ZoneCacheFile::Header)) + zoneData.size());
+
+    // Valid file
+    {
+        ZoneCacheFile cacheFile(filePath);
+        ASSERT_EQ(cacheFile.open(checksum), ZoneCacheFile::ErrorOk);
+        ASSERT_EQ(cacheFile.checksum(), checksum);
+        ASSERT_EQ(cacheFile.zoneData(), zoneData);
+
+        ConfBuffer confBuf(cacheFile.zoneData());
+
+        IpRange ipRange;
+        ASSERT_TRUE(confBuf.loadZone(ipRange));
+
+        IpRange textRange;
+        ASSERT_TRUE(textRange.fromText(zoneCacheText));
+        ASSERT_EQ(ipRange.toText(), textRange.toText());
+
+        cacheFile.close();
+        ASSERT_FALSE(cacheFile.isOpen());
+        ASSERT_TRUE(cacheFile.zoneData().isEmpty());
+    }
+
+    // Unexpected checksum
+    {
+        ZoneCacheFile cacheFile(filePath);
+        ASSERT_EQ(cacheFile.open(QString(checksum).replace(0, 1, "x")),
+                ZoneCacheFile::ErrorChecksum);
+        ASSERT_FALSE(cacheFile.isOpen());
+    }
+
+    // Missing file
+    {
+        ZoneCacheFile cacheFile("./zones/cache-missing.bin");
+        ASSERT_EQ(cacheFile.open(), ZoneCacheFile::ErrorOpen);
+    }
+
+    // Bad zone data
+    {
+        ASSERT_FALSE(ZoneCacheFile::write(filePath, zoneData.left(zoneData.size() - 1), checksum));
+        ASSERT_FALSE(ZoneCacheFile::checkZoneData(zoneData.constData(), zoneData.size() + 4));
+        ASSERT_TRUE(ZoneCacheFile::checkZoneData(zoneData.constData(), zoneData.size()));
+    }
+}
+
+TEST_F(NetUtilTest, zoneCacheFileCorrupted)
+{
+    const QByteArray zoneData = zoneCacheData();
+    ASSERT_FALSE(zoneData.isEmpty());
+
+    const QString filePath("./zones/cache-corrupt.bin");
+    const int headerSize = sizeof(ZoneCacheFile::Header);
+
+    const auto checkCorrupted = [&](auto corruptFunc, ZoneCacheFile::OpenError expectedError,
+                                        bool verifyData = true) {
+        QString checksum;
+        ASSERT_TRUE(ZoneCacheFile::write(filePath, zoneData, checksum));
+
+        corruptFunc();
+
+        ZoneCacheFile cacheFile(filePath);
+        ASSERT_EQ(cacheFile.open(checksum, verifyData), expectedError);
+        ASSERT_EQ(cacheFile.isOpen(), expectedError == ZoneCacheFile::ErrorOk);
+    };
+
+    // Bad magic
+    checkCorrupted([&] { corruptFile(filePath, 0, "XXXX"); }, ZoneCacheFile::ErrorHeader);
+
+    // Newer version
+    checkCorrupted([&] { corruptFile(filePath, 4, QByteArray("\x7F\x00", 2)); },
+            ZoneCacheFile::ErrorVersion);
+
+    // Truncated header
+    checkCorrupted([&] { truncateFile(filePath, headerSize / 2); }, ZoneCacheFile::ErrorHeader);
+
+    // Truncated payload
+    checkCorrupted(
+            [&] { truncateFile(filePath, headerSize + zoneData.size() - 4); },
+            ZoneCacheFile::ErrorSize);
+
+    // Inconsistent IPv4 addresses count
+    checkCorrupted([&] { corruptFile(filePath, headerSize, QByteArray("\x7F\x00\x00\x00", 4)); },
+            ZoneCacheFile::ErrorLayout);
+
+    // Damaged payload
+    const int lastByteOffset = headerSize + zoneData.size() - 1;
+    const QByteArray damagedByte(1, char(~zoneData.back()));
+
+    checkCorrupted([&] { corruptFile(filePath, lastByteOffset, damagedByte); },
+            ZoneCacheFile::ErrorChecksum);
+
+    // Damaged payload is not detected without the data verification
+    checkCorrupted([&] { corruptFile(filePath, lastByteOffset, damagedByte); },
+            ZoneCacheFile::ErrorOk, /*verifyData=*/false);
+}
+
+TEST_F(NetUtilTest, zoneCacheDownloader)
+{
+    const QByteArray zoneData = zoneCacheData();
+    ASSERT_FALSE(zoneData.isEmpty());
+
+    TaskZoneDownloader zone;
+    zone.setZoneId(2);
+    zone.setCachePath("./zones/");
+
+    // Convert the compressed file of previous versions
+    {
+        const QByteArray binData = qCompress(zoneData);
+        const QByteArray binChecksumData =
+                QCryptographicHash::hash(binData, QCryptographicHash::Sha256);
+        const QString legacyChecksum = QString::fromLatin1(binChecksumData.toHex());
+
+        ASSERT_TRUE(FileUtil::writeFileData(zone.cacheFileBinPath(), binData));
+
+        zone.setBinChecksum(legacyChecksum);
+        ASSERT_TRUE(zone.loadAddresses());
+        ASSERT_NE(zone.binChecksum(), legacyChecksum);
+        ASSERT_EQ(zone.zoneData(), zoneData);
+
+        ASSERT_TRUE(
+                ZoneCacheFile::isZoneCacheData(FileUtil::readFileData(zone.cacheFileBinPath())));
+    }
+
+    // Mapped file
+    {
+        ASSERT_TRUE(zone.loadAddresses());
+        ASSERT_FALSE(zone.cacheFile().isNull());
+        ASSERT_TRUE(zone.cacheFile()->isOpen());
+        ASSERT_EQ(zone.zoneData(), zoneData);
+        ASSERT_EQ(zone.zoneData().constData(), zone.cacheFile()->zoneData().constData());
+    }
+
+    // Corrupted file is removed
+    {
+        zone.cacheFile()->close();
+
+        corruptFile(zone.cacheFileBinPath(), sizeof(ZoneCacheFile::Header), "\xFF");
+
+        ASSERT_FALSE(zone.loadAddresses());
+        ASSERT_TRUE(zone.zoneData().isEmpty());
+        ASSERT_FALSE(FileUtil::fileExists(zone.cacheFileBinPath()));
+    }
+}
+
+namespace {
+
+const char *const zonePatternGeneric = "^\\s*(\\[?[A-Fa-f\\d:.]+\\]?\\s*[\\/-]?\\s*\\S*)";
+const char *const zonePatternBgp = "^\\D{0,9}([\\d./-]{7,})";
+
+void setupZoneParser(TaskZoneDownloader &zone, IpListScanner::ScanType scanType)
+{
+    const bool isBgp = (scanType == IpListScanner::ScanBgp);
+
+    zone.setZoneType(scanType);
+    zone.setSort(true);
+    zone.setEmptyNetMask(isBgp ? 24 : 32);
+    zone.setPattern(isBgp ? zonePatternBgp : zonePatternGeneric);
+}
+
+void checkZoneParsersEqual(TaskZoneDownloader &zone, const QByteArray &data)
+{
+    QString textChecksum;
+    const auto text = QString::fromLatin1(data);
+    const auto list = zone.parseAddresses(text, textChecksum);
+
+    IpRange textRange;
+    textRange.setEmptyNetMask(zone.emptyNetMask());
+    const bool textOk = textRange.fromList(list, zone.sort());
+
+    QString dataChecksum;
+    IpRange dataRange;
+    dataRange.setEmptyNetMask(zone.emptyNetMask());
+    const int dataCount = zone.parseAddressesData(data, dataRange, dataChecksum);
+
+    ASSERT_EQ(dataCount >= 0, textOk);
+    ASSERT_EQ(dataChecksum, textChecksum);
+
+    if (textOk) {
+        ASSERT_EQ(dataCount, list.size());
+        ASSERT_EQ(dataRange.toText(), textRange.toText());
+    }
+}
+
+QByteArray generateZoneText(int linesCount)
+{
+    QRandomGenerator rand(linesCount);
+
+    QByteArray text;
+
+    for (int i = 0; i < linesCount; ++i) {
+        const quint32 ip4 = rand.generate();
+        const QByteArray ip4Text = NetFormatUtil::ip4ToText(ip4).toLatin1();
+
+        ip6_addr_t ip6;
+        ip6.lo64 = rand.generate64();
+        ip6.hi64 = rand.generate64();
+        const QByteArray ip6Text = NetFormatUtil::ip6ToText(ip6).toLatin1();
+
+        switch (rand.bounded(8)) {
+        case 0:
+            text += "# comment " + ip4Text;
+            break;
+        case 1:
+            text += ip4Text + '/' + QByteArray::number(rand.bounded(8, 33));
+            break;
+        case 2:
+            text += ip4Text + " - " + NetFormatUtil::ip4ToText(ip4 | 0xFF).toLatin1();
+            break;
+        case 3:
+            text += '[' + ip6Text + "]/" + QByteArray::number(rand.bounded(16, 129));
+            break;
+        case 4:
+            text += "  \t" + ip4Text + "\r";
+            break;
+        default:
+            text += ip4Text;
+        }
+
+        text += '\n';
+    }
+
+    return text;
+}
+
+}
+
+TEST_F(NetUtilTest, ip4TextLatin1)
+{
+    const QStringList list = { "0.0.0.0", "10.0.0.1", "172.16.0.1", "255.255.255.255",
+        "256.0.0.1", "1.2.3", "1.2.3.4.", "1..2.3", "a.b.c.d", "" };
+
+    for (const auto &ipStr : list) {
+        bool textOk, latin1Ok;
+        const quint32 textIp = NetFormatUtil::textToIp4(ipStr, &textOk);
+        const quint32 latin1Ip = NetFormatUtil::latin1ToIp4(ipStr.toLatin1(), &latin1Ok);
+
+        ASSERT_EQ(latin1Ok, textOk);
+        if (textOk) {
+            ASSERT_EQ(latin1Ip, textIp);
+        }
+    }
+}
+
+TEST_F(NetUtilTest, ip6TextLatin1)
+{
+    const QStringList list = { "::", "::1", "2002::", "ff02::1:3", "fe80::e58c:84f8:a156:2a23",
+        "::ffff:10.0.0.1", "1:2:3:4:5:6:7:8", "1:2:3:4:5:6:7:8:9", ":1", "1::2::3", "12345::",
+        ":::" };
+
+    for (const auto &ipStr : list) {
+        bool textOk, latin1Ok;
+        const ip6_addr_t textIp = NetFormatUtil::textToIp6(ipStr, &textOk);
+        const ip6_addr_t latin1Ip = NetFormatUtil::latin1ToIp6(ipStr.toLatin1(), &latin1Ok);
+
+        ASSERT_EQ(latin1Ok, textOk);
+        if (textOk) {
+            ASSERT_EQ(memcmp(&latin1Ip, &textIp, sizeof(ip6_addr_t)), 0);
+        }
+    }
+}
+
+TEST_F(NetUtilTest, zoneScannerGeneric)
+{
+    TaskZoneDownloader zone;
+    setupZoneParser(zone, IpListScanner::ScanGeneric);
+
+    checkZoneParsersEqual(zone,
+            "# comment\n"
+            "; comment\n"
+            "\n"
+            "  127.0.0.1\r\n"
+            "172.16.0.0/20\n"
+            "192.168.0.0 - 192.168.255.255\n"
+            "[::2]/126\n"
+            "2002::/16\n"
+            "::1\n");
+
+    // Bad format
+    checkZoneParsersEqual(zone, "bad line\n");
+
+    // Bad mask
+    checkZoneParsersEqual(zone, "10.0.0.1 # comment\n");
+    checkZoneParsersEqual(zone, "10.0.0.1/33\n");
+    checkZoneParsersEqual(zone, "10.0.0.1/\n");
+
+    // Bad range
+    checkZoneParsersEqual(zone, "10.0.0.32 - 10.0.0.24\n");
+
+    checkZoneParsersEqual(zone, generateZoneText(1000));
+}
+
+TEST_F(NetUtilTest, zoneScannerBgp)
+{
+    const QByteArray buf = FileUtil::readFileData(":/data/tasix-mrlg.html");
+    ASSERT_FALSE(buf.isEmpty());
+
+    TaskZoneDownloader zone;
+    setupZoneParser(zone, IpListScanner::ScanBgp);
+
+    checkZoneParsersEqual(zone, buf);
+
+    checkZoneParsersEqual(zone,
+            "* i5.182.26.0/24    193.27.207.62   0 0 8193 i\n"
+            "*>i                 193.27.207.62   0 0 8193 i\n"
+            "abcdefghi10.0.0.0/8\n"
+            "ab.-/1.2.3.4\n");
+}
+
+TEST_F(NetUtilTest, zoneScannerCustomPattern)
+{
+    IpListScanner::ScanType scanType;
+    ASSERT_TRUE(IpListScanner::scanTypeByPattern(zonePatternGeneric, scanType));
+    ASSERT_EQ(scanType, IpListScanner::ScanGeneric);
+    ASSERT_TRUE(IpListScanner::scanTypeByPattern(zonePatternBgp, scanType));
+    ASSERT_EQ(scanType, IpListScanner::ScanBgp);
+
+    TaskZoneDownloader zone;
+    setupZoneParser(zone, IpListScanner::ScanGeneric);
+
+    // Custom pattern of an edited zone type is parsed by the regular expression
+    zone.setPattern("^ip=(\\S+)");
+    ASSERT_FALSE(IpListScanner::scanTypeByPattern(zone.pattern(), scanType));
+
+    const QByteArray data = "ip=10.0.0.1\n"
+                            "10.0.0.2\n"
+                            "ip=192.168.0.0/16\n";
+
+    QString checksum;
+    IpRange ipRange;
+    ASSERT_EQ(zone.parseAddressesData(data, ipRange, checksum), 2);
+    ASSERT_EQ(ipRange.toText(), "10.0.0.1\n192.168.0.0-192.168.255.255\n");
+
+    checkZoneParsersEqual(zone, data);
+}
+
+TEST_F(NetUtilTest, zoneScannerTiming)
+{
+    const QByteArray data = generateZoneText(200 * 1000);
+
+    TaskZoneDownloader zone;
+    setupZoneParser(zone, IpListScanner::ScanGeneric);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QString textChecksum;
+    IpRange textRange;
+    int textCount = 0;
+    {
+        const auto text = QString::fromLatin1(data);
+        const auto list = zone.parseAddresses(text, textChecksum);
+
+        ASSERT_TRUE(textRange.fromList(list, zone.sort()));
+        textCount = list.size();
+    }
+
+    const qint64 textElapsed = timer.restart();
+
+    QString dataChecksum;
+    IpRange dataRange;
+    const int dataCount = zone.parseAddressesData(data, dataRange, dataChecksum);
+
+    const qint64 dataElapsed = timer.elapsed();
+
+    qDebug() << "regexp parser elapsed>" << textElapsed << "msec";
+    qDebug() << "scanner elapsed>" << dataElapsed << "msec";
+
+    // The scanner gives the same results as the regular expression
+    ASSERT_EQ(dataCount, textCount);
+    ASSERT_EQ(dataChecksum, textChecksum);
+    ASSERT_EQ(dataRange.toText(), textRange.toText());
+}
+
+namespace {
+
+constexpr ip4_t randomIp4Base = 0x0A000000; // 10.0.0.0
+constexpr int randomIpSpace = 4096;
+
+ip6_addr_t ip6FromOffset(int offset)
+{
+    ip6_addr_t ip = {};
+    ip.data[0] = char(0x20);
+    ip.data[1] = char(0x01);
+    ip.data[14] = char(offset >> 8);
+    ip.data[15] = char(offset);
+    return ip;
+}
+
+// Random overlapping and adjacent ranges, as offsets in the small address space
+QVector<ValuePair<int>> generateRandomRanges(QRandomGenerator &rand, int count)
+{
+    QVector<ValuePair<int>> ranges;
+
+    for (int i = 0; i < count; ++i) {
+        const int from = rand.bounded(randomIpSpace);
+        const int to = (rand.bounded(3) == 0)
+                ? from
+                : qMin(from + rand.bounded(1, 64), randomIpSpace - 1);
+
+        ranges.append({ from, to });
+    }
+
+    return ranges;
+}
+
+QString randomRangesToText(const QVector<ValuePair<int>> &ranges, bool isIPv6)
+{
+    QString text;
+
+    for (const auto &range : ranges) {
+        const QString fromText = isIPv6 ? NetFormatUtil::ip6ToText(ip6FromOffset(range.from))
+                                        : NetFormatUtil::ip4ToText(randomIp4Base + range.from);
+        const QString toText = isIPv6 ? NetFormatUtil::ip6ToText(ip6FromOffset(range.to))
+                                      : NetFormatUtil::ip4ToText(randomIp4Base + range.to);
+
+        text += (range.from == range.to) ? fromText : fromText + '-' + toText;
+        text += '\n';
+    }
+
+    return text;
+}
+
+bool randomRangesContain(const QVector<ValuePair<int>> &ranges, int offset)
+{
+    for (const auto &range : ranges) {
+        if (offset >= range.from && offset <= range.to)
+            return true;
+    }
+    return false;
+}
+
+void checkRandomRanges(int seed, int count, bool isIPv6)
+{
+    QRandomGenerator rand(seed);
+
+    const auto ranges = generateRandomRanges(rand, count);
+
+    IpRange ipRange;
+    ASSERT_TRUE(ipRange.fromText(randomRangesToText(ranges, isIPv6)));
+
+    // Coalesced lists are never bigger than the input
+    int singlesCount = 0;
+    for (const auto &range : ranges) {
+        if (range.from == range.to) {
+            ++singlesCount;
+        }
+    }
+
+    ASSERT_LE(ipRange.sizeToWrite(),
+            isIPv6 ? FORT_CONF_ADDR_LIST_SIZE(0, 0, singlesCount, count - singlesCount)
+                   : FORT_CONF_ADDR_LIST_SIZE(singlesCount, count - singlesCount, 0, 0));
+
+    // Ranges are sorted, disjoint and not adjacent; singles are outside of ranges
+    if (!isIPv6) {
+        for (int i = 1, n = ipRange.pair4Size(); i < n; ++i) {
+            ASSERT_GT(quint64(ipRange.pair4At(i).from), quint64(ipRange.pair4At(i - 1).to) + 1);
+        }
+        for (int i = 1, n = ipRange.ip4Size(); i < n; ++i) {
+            ASSERT_GT(ipRange.ip4At(i), ipRange.ip4At(i - 1) + 1);
+        }
+    }
+
+    QByteArray buffer(ipRange.sizeToWrite(), '\0');
+    ConfData confData(buffer.data());
+    ipRange.write(confData);
+
+    ASSERT_EQ(int(confData.dataOffset()), buffer.size());
+
+    // Membership is the same as of the input ranges union
+    for (int offset = -16; offset < randomIpSpace + 16; ++offset) {
+        ip_addr_t ip = {};
+        if (isIPv6) {
+            ip.v6 = ip6FromOffset(offset & 0xFFFF);
+        } else {
+            ip.v4 = randomIp4Base + offset;
+        }
+
+        const bool expected = offset >= 0 && randomRangesContain(ranges, offset);
+        const bool actual = DriverCommon::addrListIpInRange(buffer.constData(), ip, isIPv6);
+
+        ASSERT_EQ(actual, expected) << "seed=" << seed << " offset=" << offset;
+    }
+}
+
+}
+
+TEST_F(NetUtilTest, ip4RangesCoalesceRandom)
+{
+    for (int seed = 1; seed <= 20; ++seed) {
+        checkRandomRanges(seed, seed * 25, /*isIPv6=*/false);
+    }
+}
+
+TEST_F(NetUtilTest, ip6RangesCoalesceRandom)
+{
+    for (int seed = 1; seed <= 20; ++seed) {
+        checkRandomRanges(seed, seed * 25, /*isIPv6=*/true);
+    }
+}
+
+TEST_F(NetUtilTest, ip4RangesSortTiming)
+{
+    const QByteArray data = generateZoneText(200000);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    IpListScanner scanner(data);
+
+    IpRange ipRange;
+    ASSERT_TRUE(ipRange.fromScanner(scanner));
+
+    qDebug() << "sort & merge elapsed>" << timer.elapsed() << "msec";
+
+    for (int i = 1, n = ipRange.pair4Size(); i < n; ++i) {
+        ASSERT_GT(quint64(ipRange.pair4At(i).from), quint64(ipRange.pair4At(i - 1).to) + 1);
+    }
+}
+
+namespace {
+
+struct ZoneSource
+{
+    QByteArray text;
+    bool success = false;
+};
+
+void setupLocalZone(TaskZoneDownloader &zone, int zoneId, const QString &srcPath,
+        const QString &cachePath)
+{
+    zone.setZoneId(zoneId);
+    zone.setZoneName(QString("zone%1").arg(zoneId));
+    zone.setSort(true);
+    zone.setEmptyNetMask(32);
+    zone.setUrl(QFileInfo(srcPath).absoluteFilePath());
+    zone.setCachePath(cachePath);
+}
+
+}
+
+TEST_F(NetUtilTest, zoneParallelParse)
+{
+    const QList<ZoneSource> sources = {
+        { .text = generateZoneText(20000), .success = true },
+        { .text = "10.0.0.0/8\n1.2.3.4/99\n", .success = false }, // bad mask
+        { .text = "192.168.0.0/16\n[2002::]/16\n", .success = true },
+        { .text = "# no addresses\n", .success = false },
+        { .text = generateZoneText(30000), .success = true },
+    };
+
+    const int zonesCount = sources.size();
+
+    QList<TaskZoneDownloader *> zones;
+    for (int i = 0; i < zonesCount; ++i) {
+        const QString srcPath = QString("./zones-src/zone%1.txt").arg(i + 1);
+        ASSERT_TRUE(FileUtil::writeFileData(srcPath, sources[i].text));
+
+        auto zone = new TaskZoneDownloader();
+        setupLocalZone(*zone, i + 1, srcPath, "./zones-parallel/");
+        zone->setDeferParse(true);
+
+        FileUtil::removeFile(zone->cacheFileBinPath());
+
+        zones.append(zone);
+    }
+
+    QMap<int, bool> results;
+    {
+        ZoneParseManager manager;
+
+        QObject context;
+        QObject::connect(
+                &manager, &ZoneParseManager::zoneParsed, &context,
+                [&](int zoneIndex, bool success) { results.insert(zoneIndex, success); },
+                Qt::QueuedConnection);
+
+        // Download the local files sequentially and parse them in parallel
+        for (int i = 0; i < zonesCount; ++i) {
+            TaskZoneDownloader *zone = zones[i];
+
+            QSignalSpy finishedSpy(zone, &TaskWorker::finished);
+            zone->run();
+
+            ASSERT_EQ(finishedSpy.count(), 1);
+            ASSERT_TRUE(finishedSpy.at(0).at(0).toBool());
+
+            manager.parseZone(i, zone, zone->takeDownloadedData());
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        while (results.size() < zonesCount && timer.elapsed() < 30000) {
+            QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 100);
+        }
+    }
+
+    ASSERT_EQ(results.size(), zonesCount);
+
+    for (int i = 0; i < zonesCount; ++i) {
+        const ZoneSource &source = sources[i];
+        TaskZoneDownloader *zone = zones[i];
+
+        // Failed zones do not affect the others
+        ASSERT_EQ(results.value(i), source.success) << "zone=" << i;
+        ASSERT_EQ(FileUtil::fileExists(zone->cacheFileBinPath()), source.success);
+
+        if (!source.success)
+            continue;
+
+        // Same result as of the sequential parsing
+        TaskZoneDownloader serialZone;
+        setupLocalZone(serialZone, i + 1, zone->url(), "./zones-serial/");
+        FileUtil::removeFile(serialZone.cacheFileBinPath());
+
+        ASSERT_TRUE(serialZone.processData(source.text));
+        ASSERT_EQ(zone->addressCount(), serialZone.addressCount());
+        ASSERT_EQ(zone->textChecksum(), serialZone.textChecksum());
+        ASSERT_EQ(zone->binChecksum(), serialZone.binChecksum());
+        ASSERT_EQ(zone->zoneData(), serialZone.zoneData());
+    }
+
+    qDeleteAll(zones);
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+
+#include <googletest.h>
+
+#include <conf/confmanager.h>
+#include <sqlite/dbquery.h>
+#include <sqlite/sqlitedb.h>
+#include <sqlite/sqlitestmt.h>
+
+class SqliteDbExtTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    int countRows(const QString &sql, const QVariantHash &vars = {});
+    QString lowerName(qint64 appId);
+
+protected:
+    SqliteDb m_sqliteDb; // temporary database
+};
+
+namespace {
+
+constexpr int benchAppCount = 30000;
+
+}
+
+void SqliteDbExtTest::SetUp()
+{
+    ASSERT_TRUE(m_sqliteDb.open());
+    ASSERT_TRUE(ConfManager::migrateDb(&m_sqliteDb));
+
+    // The lower_name column is filled by the triggers
+    ASSERT_TRUE(m_sqliteDb.executeStr(
+            QString("INSERT INTO app(app_id, path, name, notes, blocked, creat_time)"
+                    "  WITH RECURSIVE c(x) AS ("
+                    "    SELECT 1 UNION ALL SELECT x + 1 FROM c"
+                    "      WHERE x < %1"
+                    "  )"
+                    "  SELECT x, 'C:\\Program Files\\App' || x || '.exe',"
+                    "    'Application ' || (x * 7919 % %1), NULL, 0, x FROM c;")
+                    .arg(benchAppCount)));
+}
+
+void SqliteDbExtTest::TearDown()
+{
+    m_sqliteDb.close();
+}
+
+int SqliteDbExtTest::countRows(const QString &sql, const QVariantHash &vars)
+{
+    return DbQuery(&m_sqliteDb).sql(sql).vars(vars).execute().toInt();
+}
+
+QString SqliteDbExtTest::lowerName(qint64 appId)
+{
+    return DbQuery(&m_sqliteDb)
+            .sql("SELECT lower_name FROM app WHERE app_id = :id;")
+            .vars({ { ":id", appId } })
+            .execute()
+            .toString();
+}
+
+TEST_F(SqliteDbExtTest, lower)
+{
+    ASSERT_EQ(DbQuery(&m_sqliteDb).sql("SELECT lower('Fort FIREWALL 3.x');").execute().toString(),
+            "fort firewall 3.x");
+    ASSERT_EQ(DbQuery(&m_sqliteDb).sql("SELECT lower('ÄRGER Über');").execute().toString(),
+            "ärger über");
+    ASSERT_TRUE(DbQuery(&m_sqliteDb).sql("SELECT lower(NULL);").execute().isNull());
+}
+
+TEST_F(SqliteDbExtTest, lowerNameTriggers)
+{
+    ASSERT_EQ(lowerName(1), "application 7919");
+
+    // Insert
+    ASSERT_TRUE(m_sqliteDb.execute("INSERT INTO app(app_id, path, name, blocked, creat_time)"
+                                   "  VALUES(0, 'C:\\test.exe', 'Fort FIREWALL', 0, 0);"));
+    ASSERT_EQ(lowerName(0), "fort firewall");
+
+    // Update of the name
+    ASSERT_TRUE(m_sqliteDb.execute("UPDATE app SET name = 'ÄRGER Über' WHERE app_id = 0;"));
+    ASSERT_EQ(lowerName(0), "ärger über");
+
+    // Update of other columns
+    ASSERT_TRUE(m_sqliteDb.execute("UPDATE app SET notes = 'Notes' WHERE app_id = 0;"));
+    ASSERT_EQ(lowerName(0), "ärger über");
+}
+
+TEST_F(SqliteDbExtTest, lowerNameImport)
+{
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+
+    const QString filePath = tempDir.filePath("conf.db");
+
+    // DB of the previous version without the lower_name column
+    {
+        SqliteDb oldDb(filePath);
+        ASSERT_TRUE(oldDb.open());
+
+        ASSERT_TRUE(oldDb.execute("CREATE TABLE app(app_id INTEGER PRIMARY KEY, path TEXT,"
+                                  "  name TEXT, blocked BOOLEAN NOT NULL,"
+                                  "  creat_time INTEGER NOT NULL);"
+                                  "INSERT INTO app(app_id, path, name, blocked, creat_time)"
+                                  "  VALUES(1, 'C:\\test.exe', 'Fort FIREWALL', 0, 0);"));
+        ASSERT_TRUE(oldDb.setUserVersion(54));
+    }
+
+    // Re-created DB imports the old rows
+    SqliteDb sqliteDb(filePath);
+    ASSERT_TRUE(sqliteDb.open());
+    ASSERT_TRUE(ConfManager::migrateDb(&sqliteDb));
+
+    ASSERT_EQ(DbQuery(&sqliteDb)
+                      .sql("SELECT lower_name FROM app WHERE app_id = 1;")
+                      .execute()
+                      .toString(),
+            "fort firewall");
+}
+
+TEST_F(SqliteDbExtTest, regexp)
+{
+    ASSERT_EQ(countRows("SELECT COUNT(*) FROM app WHERE name REGEXP :regexp;",
+                      { { ":regexp", "^application 1$" } }),
+            1);
+    ASSERT_EQ(countRows("SELECT COUNT(*) FROM app WHERE path REGEXP :regexp;",
+                      { { ":regexp", "app2999\\d\\.exe$" } }),
+            10);
+
+    // Invalid pattern matches nothing
+    ASSERT_EQ(countRows("SELECT COUNT(*) FROM app WHERE name REGEXP :regexp;",
+                      { { ":regexp", "(" } }),
+            0);
+}
+
+TEST_F(SqliteDbExtTest, regexpBench)
+{
+    const QVariantHash vars = { { ":regexp", "app\\d*7\\.exe|notes" } };
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int count = countRows("SELECT COUNT(*) FROM app t"
+                                "  WHERE t.path REGEXP :regexp OR t.name REGEXP :regexp"
+                                "    OR t.notes REGEXP :regexp;",
+            vars);
+
+    qDebug() << "REGEXP over" << benchAppCount << "apps x 3 columns:" << timer.elapsed() << "ms";
+
+    ASSERT_EQ(count, benchAppCount / 10);
+}
+
+TEST_F(SqliteDbExtTest, orderByLowerNameBench)
+{
+    const auto sqlLowerFunc = "SELECT app_id FROM app t ORDER BY lower(t.name) LIMIT 64;";
+    const auto sqlLowerColumn = "SELECT app_id FROM app t ORDER BY t.lower_name LIMIT 64;";
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const qint64 funcAppId = DbQuery(&m_sqliteDb).sql(sqlLowerFunc).execute().toLongLong();
+
+    const qint64 funcMsecs = timer.restart();
+
+    const qint64 columnAppId = DbQuery(&m_sqliteDb).sql(sqlLowerColumn).execute().toLongLong();
+
+    const qint64 columnMsecs = timer.elapsed();
+
+    qDebug() << "ORDER BY lower(name):" << funcMsecs << "ms; ORDER BY lower_name:" << columnMsecs
+             << "ms";
+
+    ASSERT_EQ(funcAppId, columnAppId);
+}
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QSemaphore>
+#include <QThread>
+
+#include <googletest.h>
+
+#include <util/worker/workerjob.h>
+#include <util/worker/workermanager.h>
+
+namespace {
+
+class JobLog
+{
+public:
+    void append(const QString &text)
+    {
+        QMutexLocker locker(&m_mutex);
+
+        m_texts.append(text);
+    }
+
+    QStringList texts() const
+    {
+        QMutexLocker locker(&m_mutex);
+
+        return m_texts;
+    }
+
+private:
+    QStringList m_texts;
+
+    mutable QMutex m_mutex;
+};
+
+// Logs its text; merges the jobs of the same kind, i.e. of the same first letter
+class LogJob : public WorkerJob
+{
+public:
+    explicit LogJob(JobLog &log, const QString &text) : WorkerJob(text), m_log(log), m_text(text)
+    {
+    }
+
+    bool mergeJob(const WorkerJob &job) override
+    {
+        const auto &logJob = static_cast<const LogJob &>(job);
+
+        if (logJob.text().at(0) != text().at(0))
+            return false;
+
+        m_text += '+';
+        m_text += logJob.text();
+        return true;
+    }
+
+    void doJob(WorkerObject & /*worker*/) override { m_log.append(m_text); }
+
+private:
+    JobLog &m_log;
+    QString m_text;
+};
+
+class KeyLogJob : public LogJob
+{
+public:
+    using LogJob::LogJob;
+
+    QString mergeKey() const override { return text(); }
+};
+
+// Logs its text also when dropped
+class DropLogJob : public LogJob
+{
+public:
+    explicit DropLogJob(JobLog &log, JobLog &droppedLog, const QString &text) :
+        LogJob(log, text), m_droppedLog(droppedLog)
+    {
+    }
+
+    void reportDropped(WorkerManager & /*manager*/) override { m_droppedLog.append(text()); }
+
+private:
+    JobLog &m_droppedLog;
+};
+
+// Occupies a worker until finished
+class BlockingJob : public WorkerJob
+{
+public:
+    void doJob(WorkerObject & /*worker*/) override
+    {
+        m_started.release();
+        m_finish.acquire();
+    }
+
+    void waitStarted() { m_started.acquire(); }
+    void finish() { m_finish.release(); }
+
+private:
+    QSemaphore m_started;
+    QSemaphore m_finish;
+};
+
+class TestWorkerManager : public WorkerManager
+{
+public:
+    using WorkerManager::jobCount;
+
+    void setCanMergeJobs(bool v) { m_canMergeJobs = v; }
+
+protected:
+    bool canMergeJobs() const override { return m_canMergeJobs; }
+
+private:
+    bool m_canMergeJobs = false;
+};
+
+}
+
+class WorkerManagerTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    void blockWorker();
+    bool finishJobs(int count, int msecs = 5000);
+
+    WorkerJobPtr logJob(const QString &text) { return WorkerJobPtr(new LogJob(m_log, text)); }
+    WorkerJobPtr keyJob(const QString &text) { return WorkerJobPtr(new KeyLogJob(m_log, text)); }
+    WorkerJobPtr dropJob(const QString &text)
+    {
+        return WorkerJobPtr(new DropLogJob(m_log, m_droppedLog, text));
+    }
+
+protected:
+    JobLog m_log;
+    JobLog m_droppedLog;
+
+    BlockingJob *m_blockingJob = nullptr;
+
+    TestWorkerManager *m_manager = nullptr;
+};
+
+void WorkerManagerTest::SetUp()
+{
+    m_manager = new TestWorkerManager();
+    m_manager->setMaxWorkersCount(1);
+}
+
+void WorkerManagerTest::TearDown()
+{
+    delete m_manager;
+}
+
+void WorkerManagerTest::blockWorker()
+{
+    m_blockingJob = new BlockingJob();
+
+    m_manager->enqueueJob(WorkerJobPtr(m_blockingJob));
+    m_blockingJob->waitStarted();
+}
+
+bool WorkerManagerTest::finishJobs(int count, int msecs)
+{
+    m_blockingJob->finish();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    while (m_log.texts().size() < count) {
+        if (timer.hasExpired(msecs))
+            return false;
+
+        QThread::msleep(1);
+    }
+
+    return true;
+}
+
+TEST_F(WorkerManagerTest, fifoOrder)
+{
+    blockWorker();
+
+    m_manager->enqueueJob(logJob("a"));
+    m_manager->enqueueJob(logJob("b"));
+    m_manager->enqueueJobs({ logJob("c"), logJob("d") });
+
+    ASSERT_EQ(m_manager->jobCount(), 4);
+
+    ASSERT_TRUE(finishJobs(4));
+    ASSERT_EQ(m_log.texts(), QStringList({ "a", "b", "c", "d" }));
+}
+
+TEST_F(WorkerManagerTest, firstOrder)
+{
+    blockWorker();
+
+    m_manager->enqueueJobs({ keyJob("a"), keyJob("b"), keyJob("c") });
+
+    // Queued job of the same key is moved to the front
+    m_manager->enqueueJobsFirst({ keyJob("d"), keyJob("b") });
+
+    // Queued job of the same key is kept in place
+    m_manager->enqueueJob(keyJob("c"));
+
+    ASSERT_EQ(m_manager->jobCount(), 4);
+
+    ASSERT_TRUE(finishJobs(4));
+    ASSERT_EQ(m_log.texts(), QStringList({ "d", "b", "a", "c" }));
+}
+
+TEST_F(WorkerManagerTest, mergeLastJob)
+{
+    m_manager->setCanMergeJobs(true);
+
+    blockWorker();
+
+    // Jobs are merged into the last one only to keep the order of kinds
+    m_manager->enqueueJobs({ logJob("a1"), logJob("a2"), logJob("b1"), logJob("a3") });
+
+    ASSERT_EQ(m_manager->jobCount(), 3);
+
+    ASSERT_TRUE(finishJobs(3));
+    ASSERT_EQ(m_log.texts(), QStringList({ "a1+a2", "b1", "a3" }));
+}
+
+TEST_F(WorkerManagerTest, backPressure)
+{
+    m_manager->setMaxJobsCount(3);
+
+    blockWorker();
+
+    // New jobs are dropped
+    m_manager->enqueueJobs({ logJob("a"), logJob("b"), logJob("c"), logJob("d") });
+
+    ASSERT_EQ(m_manager->jobCount(), 3);
+
+    // The oldest jobs are dropped
+    m_manager->enqueueJobsFirst({ logJob("e") });
+
+    ASSERT_EQ(m_manager->jobCount(), 3);
+
+    ASSERT_TRUE(finishJobs(3));
+    ASSERT_EQ(m_log.texts(), QStringList({ "e", "a", "b" }));
+}
+
+TEST_F(WorkerManagerTest, reportDropped)
+{
+    m_manager->setMaxJobsCount(2);
+
+    blockWorker();
+
+    m_manager->enqueueJobs({ dropJob("a"), dropJob("b"), dropJob("c") });
+
+    ASSERT_EQ(m_droppedLog.texts(), QStringList({ "c" }));
+
+    m_manager->enqueueJobsFirst({ dropJob("d") });
+
+    ASSERT_EQ(m_droppedLog.texts(), QStringList({ "c", "b" }));
+
+    ASSERT_TRUE(finishJobs(2));
+    ASSERT_EQ(m_log.texts(), QStringList({ "d", "a" }));
+}
+
+TEST_F(WorkerManagerTest, clearQueue)
+{
+    blockWorker();
+
+    m_manager->enqueueJobs({ keyJob("a"), logJob("b") });
+    m_manager->clear();
+
+    ASSERT_EQ(m_manager->jobCount(), 0);
+
+    // Cleared keys are queued again
+    m_manager->enqueueJob(keyJob("a"));
+
+    ASSERT_TRUE(finishJobs(1));
+    ASSERT_EQ(m_log.texts(), QStringList({ "a" }));
+}
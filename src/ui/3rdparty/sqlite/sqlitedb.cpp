@@ -513,7 +513,7 @@ bool SqliteDb::createFtsTable(const FtsTable &ftsTable)
             "CREATE TRIGGER IF NOT EXISTS %2_ad AFTER DELETE ON %1 BEGIN"
             "  INSERT INTO %2(%2, rowid, %4) VALUES('delete', %6);"
             "END;"
-            "CREATE TRIGGER IF NOT EXISTS %2_au AFTER UPDATE ON %1 BEGIN"
+            "CREATE TRIGGER IF NOT EXISTS %2_au AFTER UPDATE OF %4 ON %1 BEGIN"
             "  INSERT INTO %2(%2, rowid, %4) VALUES('delete', %6);"
             "  INSERT INTO %2(rowid, %4) VALUES (%5);"
             "END;";
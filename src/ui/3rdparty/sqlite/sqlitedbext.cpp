@@ -17,11 +17,49 @@ QString valueTextUtf8(sqlite3_value *value)
     return QString::fromUtf8(textUtf8);
 }
 
+bool isAsciiText(const unsigned char *text, int size)
+{
+    for (int i = 0; i < size; ++i) {
+        if (text[i] >= 0x80)
+            return false;
+    }
+    return true;
+}
+
+void extLowerAscii(sqlite3_context *ctx, const unsigned char *text, int size)
+{
+    char *result = static_cast<char *>(sqlite3_malloc(size + 1));
+    if (!result) {
+        sqlite3_result_error_nomem(ctx);
+        return;
+    }
+
+    for (int i = 0; i < size; ++i) {
+        const char c = char(text[i]);
+        result[i] = (c >= 'A' && c <= 'Z') ? char(c + ('a' - 'A')) : c;
+    }
+    result[size] = '\0';
+
+    sqlite3_result_text(ctx, result, size, sqlite3_free);
+}
+
 void extLower(sqlite3_context *ctx, int argc, sqlite3_value **argv)
 {
     Q_ASSERT(argc == 1);
 
-    const auto textLower = valueTextUtf8(argv[0]).toLower();
+    const unsigned char *textUtf8 = sqlite3_value_text(argv[0]);
+    if (!textUtf8)
+        return; // NULL
+
+    const int size = sqlite3_value_bytes(argv[0]);
+
+    // Most of names are ASCII: don't convert them to QString
+    if (isAsciiText(textUtf8, size)) {
+        extLowerAscii(ctx, textUtf8, size);
+        return;
+    }
+
+    const auto textLower = QString::fromUtf8(textUtf8, size).toLower();
     const auto result = textLower.toUtf8();
 
     sqlite3_result_text(ctx, result.data(), result.size(), SQLITE_TRANSIENT);
@@ -39,15 +77,44 @@ bool createExtLower(struct sqlite3 *db)
             == SQLITE_OK;
 }
 
+void deleteRegexp(void *p)
+{
+    delete static_cast<QRegularExpression *>(p);
+}
+
+const QRegularExpression *cachedRegexp(sqlite3_context *ctx, sqlite3_value *patternValue)
+{
+    // The pattern is usually a constant of the statement: compile it once per statement
+    auto re = static_cast<const QRegularExpression *>(sqlite3_get_auxdata(ctx, 0));
+    if (re)
+        return re;
+
+    auto newRe = new QRegularExpression(
+            valueTextUtf8(patternValue), QRegularExpression::CaseInsensitiveOption);
+    newRe->optimize(); // JIT-compile
+
+    if (!newRe->isValid()) {
+        qCWarning(LC) << "Invalid regexp:" << newRe->pattern() << newRe->errorString();
+    }
+
+    sqlite3_set_auxdata(ctx, 0, newRe, &deleteRegexp);
+
+    // SQLite may delete the auxdata immediately on failure
+    return static_cast<const QRegularExpression *>(sqlite3_get_auxdata(ctx, 0));
+}
+
 void extRegexp(sqlite3_context *ctx, int argc, sqlite3_value **argv)
 {
     Q_ASSERT(argc == 2);
 
-    const auto pattern = valueTextUtf8(argv[0]);
-    const auto text = valueTextUtf8(argv[1]);
+    const QRegularExpression *re = cachedRegexp(ctx, argv[0]);
+    if (!re) {
+        sqlite3_result_error_nomem(ctx);
+        return;
+    }
 
-    const QRegularExpression re(pattern, QRegularExpression::CaseInsensitiveOption);
-    const auto match = re.match(text);
+    const auto text = valueTextUtf8(argv[1]);
+    const auto match = re->match(text);
 
     sqlite3_result_int(ctx, match.hasMatch());
 }
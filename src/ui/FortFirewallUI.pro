@@ -33,6 +33,7 @@ SOURCES += \
     control/command/controlcommandbase.cpp \
     control/command/controlcommandblock.cpp \
     control/command/controlcommandconf.cpp \
+    control/command/controlcommanddriver.cpp \
     control/command/controlcommandfilter.cpp \
     control/command/controlcommandfiltermode.cpp \
     control/command/controlcommandgroup.cpp \
@@ -42,6 +43,7 @@ SOURCES += \
     control/command/controlcommandrpc.cpp \
     control/command/controlcommandzone.cpp \
     control/control.cpp \
+    control/controlargs.cpp \
     control/controlmanager.cpp \
     control/controlworker.cpp \
     drivelist/drivelistmanager.cpp \
@@ -87,6 +89,7 @@ SOURCES += \
     form/dialog/splashscreen.cpp \
     form/graph/axistickerspeed.cpp \
     form/graph/graphplot.cpp \
+    form/graph/graphseries.cpp \
     form/graph/graphwindow.cpp \
     form/home/homecontroller.cpp \
     form/home/homewindow.cpp \
@@ -138,6 +141,7 @@ SOURCES += \
     log/logentry.cpp \
     log/logentryapp.cpp \
     log/logentryconn.cpp \
+    log/logentrydropped.cpp \
     log/logentryprocnew.cpp \
     log/logentrystattraf.cpp \
     log/logentrytime.cpp \
@@ -177,6 +181,7 @@ SOURCES += \
     rpc/dberrormanagerrpc.cpp \
     rpc/drivelistmanagerrpc.cpp \
     rpc/drivermanagerrpc.cpp \
+    rpc/hostinfomanagerrpc.cpp \
     rpc/logmanagerrpc.cpp \
     rpc/quotamanagerrpc.cpp \
     rpc/rpcmanager.cpp \
@@ -207,6 +212,8 @@ SOURCES += \
     task/taskupdatechecker.cpp \
     task/taskworker.cpp \
     task/taskzonedownloader.cpp \
+    task/zoneparsejob.cpp \
+    task/zoneparsemanager.cpp \
     user/iniuser.cpp \
     user/usersettings.cpp \
     util/bitutil.cpp \
@@ -217,7 +224,9 @@ SOURCES += \
     util/conf/confrodata.cpp \
     util/conf/confutil.cpp \
     util/conf/ruletextparser.cpp \
+    util/conf/zonecachefile.cpp \
     util/consoleoutput.cpp \
+    util/dataiconengine.cpp \
     util/dateutil.cpp \
     util/device.cpp \
     util/dirinfo.cpp \
@@ -237,6 +246,7 @@ SOURCES += \
     util/net/actionrange.cpp \
     util/net/arearange.cpp \
     util/net/dirrange.cpp \
+    util/net/iplistscanner.cpp \
     util/net/iprange.cpp \
     util/net/ipverrange.cpp \
     util/net/netdownloader.cpp \
@@ -298,6 +308,7 @@ HEADERS += \
     control/command/controlcommandbase.h \
     control/command/controlcommandblock.h \
     control/command/controlcommandconf.h \
+    control/command/controlcommanddriver.h \
     control/command/controlcommandfilter.h \
     control/command/controlcommandfiltermode.h \
     control/command/controlcommandgroup.h \
@@ -307,6 +318,7 @@ HEADERS += \
     control/command/controlcommandrpc.h \
     control/command/controlcommandzone.h \
     control/control.h \
+    control/controlargs.h \
     control/control_types.h \
     control/controlmanager.h \
     control/controlworker.h \
@@ -354,6 +366,7 @@ HEADERS += \
     form/form_types.h \
     form/graph/axistickerspeed.h \
     form/graph/graphplot.h \
+    form/graph/graphseries.h \
     form/graph/graphwindow.h \
     form/home/homecontroller.h \
     form/home/homewindow.h \
@@ -405,6 +418,7 @@ HEADERS += \
     log/logentry.h \
     log/logentryapp.h \
     log/logentryconn.h \
+    log/logentrydropped.h \
     log/logentryprocnew.h \
     log/logentrystattraf.h \
     log/logentrytime.h \
@@ -448,6 +462,7 @@ HEADERS += \
     rpc/dberrormanagerrpc.h \
     rpc/drivelistmanagerrpc.h \
     rpc/drivermanagerrpc.h \
+    rpc/hostinfomanagerrpc.h \
     rpc/logmanagerrpc.h \
     rpc/quotamanagerrpc.h \
     rpc/rpcmanager.h \
@@ -478,6 +493,8 @@ HEADERS += \
     task/taskupdatechecker.h \
     task/taskworker.h \
     task/taskzonedownloader.h \
+    task/zoneparsejob.h \
+    task/zoneparsemanager.h \
     user/iniuser.h \
     user/usersettings.h \
     util/bitutil.h \
@@ -492,7 +509,9 @@ HEADERS += \
     util/conf/confruleswalker.h \
     util/conf/confutil.h \
     util/conf/ruletextparser.h \
+    util/conf/zonecachefile.h \
     util/consoleoutput.h \
+    util/dataiconengine.h \
     util/dateutil.h \
     util/device.h \
     util/dirinfo.h \
@@ -513,6 +532,7 @@ HEADERS += \
     util/net/actionrange.h \
     util/net/arearange.h \
     util/net/dirrange.h \
+    util/net/iplistscanner.h \
     util/net/iprange.h \
     util/net/ipverrange.h \
     util/net/netdownloader.h \
@@ -562,6 +582,7 @@ RESOURCES += \
 OTHER_FILES += \
     appinfo/migrations/*.sql \
     conf/migrations/*.sql \
+    hostinfo/migrations/*.sql \
     stat/migrations/block/*.sql \
     stat/migrations/conn/*.sql \
     stat/migrations/traf/*.sql
@@ -569,6 +590,7 @@ OTHER_FILES += \
 RESOURCES += \
     appinfo/appinfo_migrations.qrc \
     conf/conf_migrations.qrc \
+    hostinfo/hostinfo_migrations.qrc \
     stat/stat_migrations.qrc
 
 # Zone
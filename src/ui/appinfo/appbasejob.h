@@ -9,6 +9,8 @@ public:
     explicit AppBaseJob(const QString &appPath);
 
     const QString &appPath() const { return text(); }
+
+    QString mergeKey() const override { return appPath(); }
 };
 
 #endif // APPBASEJOB_H
@@ -19,13 +19,18 @@ void AppIconJob::reportResult(WorkerObject &worker)
     emitFinished(static_cast<AppInfoManager *>(worker.manager()));
 }
 
+void AppIconJob::reportDropped(WorkerManager &manager)
+{
+    emit static_cast<AppInfoManager &>(manager).lookupIconDropped(appPath());
+}
+
 void AppIconJob::loadAppIcon(AppInfoManager *manager)
 {
     // Try to load from DB
-    m_image = manager->loadIconFromDb(iconId());
+    m_iconData = manager->loadIconFromDb(iconId());
 }
 
 void AppIconJob::emitFinished(AppInfoManager *manager)
 {
-    emit manager->lookupIconFinished(appPath(), m_image);
+    emit manager->lookupIconFinished(appPath(), m_iconData);
 }
@@ -1,8 +1,6 @@
 #ifndef APPICONJOB_H
 #define APPICONJOB_H
 
-#include <QImage>
-
 #include "appbasejob.h"
 
 class AppInfoManager;
@@ -16,6 +14,7 @@ public:
 
     void doJob(WorkerObject &worker) override;
     void reportResult(WorkerObject &worker) override;
+    void reportDropped(WorkerManager &manager) override;
 
 private:
     void loadAppIcon(AppInfoManager *manager);
@@ -24,7 +23,7 @@ private:
 private:
     const qint64 m_iconId = 0;
 
-    QImage m_image;
+    QByteArray m_iconData;
 };
 
 #endif // APPICONJOB_H
@@ -9,7 +9,10 @@ QString AppInfo::filePath(const QString &appPath) const
 
 bool AppInfo::checkFileModified(const QString &appPath)
 {
-    const auto appFileModTime = AppInfoUtil::fileModTime(filePath(appPath), fileExists);
+    qint64 appFileSize = 0;
+    const auto appFileModTime =
+            AppInfoUtil::fileModTime(filePath(appPath), fileExists, appFileSize);
 
-    return appFileModTime.isValid() && appFileModTime != fileModTime;
+    return appFileModTime.isValid()
+            && (appFileModTime != fileModTime || appFileSize != fileSize);
 }
@@ -18,6 +18,7 @@ public:
     qint64 iconId = 0;
 
     QDateTime fileModTime;
+    qint64 fileSize = 0;
 
     QString altPath;
     QString fileDescription;
@@ -1,8 +1,8 @@
 #include "appinfocache.h"
 
 #include <QIcon>
-#include <QImage>
 
+#include <util/dataiconengine.h>
 #include <util/iconcache.h>
 #include <util/ioc/ioccontainer.h>
 
@@ -10,7 +10,8 @@
 
 AppInfoCache::AppInfoCache(QObject *parent) : QObject(parent), m_cache(1000)
 {
-    connect(&m_triggerTimer, &QTimer::timeout, this, &AppInfoCache::cacheChanged);
+    connect(&m_triggerTimer, &QTimer::timeout, this, &AppInfoCache::emitChangedAppPaths);
+    connect(&m_lookupTimer, &QTimer::timeout, this, &AppInfoCache::lookupAppPaths);
 }
 
 void AppInfoCache::setUp()
@@ -21,6 +22,10 @@ void AppInfoCache::setUp()
             &AppInfoCache::handleFinishedInfoLookup);
     connect(appInfoManager, &AppInfoManager::lookupIconFinished, this,
             &AppInfoCache::handleFinishedIconLookup);
+    connect(appInfoManager, &AppInfoManager::lookupInfoDropped, this,
+            &AppInfoCache::handleDroppedInfoLookup);
+    connect(appInfoManager, &AppInfoManager::lookupIconDropped, this,
+            &AppInfoCache::handleDroppedIconLookup);
 }
 
 void AppInfoCache::tearDown()
@@ -66,12 +71,8 @@ AppInfo AppInfoCache::appInfo(const QString &appPath)
 
     appInfoCached(appPath, appInfo, lookupRequired);
 
-    if (!lookupRequired) {
-        lookupRequired = appInfo.isValid() && appInfo.checkFileModified(appPath);
-    }
-
     if (lookupRequired && appInfo.fileExists) {
-        IoC<AppInfoManager>()->lookupAppInfo(appPath);
+        emitLookupAppPath(appPath);
     }
 
     return appInfo;
@@ -87,19 +88,52 @@ void AppInfoCache::handleFinishedInfoLookup(const QString &appPath, const AppInf
 
     IconCache::remove(appPath); // invalidate cached icon
 
-    emitCacheChanged();
+    emitCacheChanged(appPath);
 }
 
-void AppInfoCache::handleFinishedIconLookup(const QString &appPath, const QImage &image)
+void AppInfoCache::handleFinishedIconLookup(const QString &appPath, const QByteArray &iconData)
 {
-    if (image.isNull())
+    const QIcon icon = DataIconEngine::icon(iconData);
+    if (icon.isNull())
         return;
 
-    const QPixmap pixmap = QPixmap::fromImage(image);
+    IconCache::insert(appPath, icon); // update cached icon
+
+    emitCacheChanged(appPath);
+}
+
+void AppInfoCache::handleDroppedInfoLookup(const QString &appPath)
+{
+    // Look up again when the app is requested next time
+    m_cache.remove(appPath);
+}
+
+void AppInfoCache::handleDroppedIconLookup(const QString &appPath)
+{
+    // Look up again when the icon is requested next time
+    IconCache::remove(appPath);
+}
 
-    IconCache::insert(appPath, pixmap); // update cached icon
+void AppInfoCache::emitChangedAppPaths()
+{
+    if (m_changedAppPaths.isEmpty())
+        return;
+
+    const QStringList appPaths(m_changedAppPaths.constBegin(), m_changedAppPaths.constEnd());
+    m_changedAppPaths.clear();
 
-    emitCacheChanged();
+    emit cacheChanged(appPaths);
+}
+
+void AppInfoCache::lookupAppPaths()
+{
+    if (m_lookupAppPaths.isEmpty())
+        return;
+
+    const QStringList appPaths = m_lookupAppPaths;
+    m_lookupAppPaths.clear();
+
+    IoC<AppInfoManager>()->lookupAppInfos(appPaths);
 }
 
 void AppInfoCache::appInfoCached(const QString &appPath, AppInfo &info, bool &lookupRequired)
@@ -117,6 +151,9 @@ void AppInfoCache::appInfoCached(const QString &appPath, AppInfo &info, bool &lo
 
         if (!lookupRequired) {
             *cachedInfo = info;
+
+            // Check the file metadata once per loading from DB
+            lookupRequired = info.checkFileModified(appPath);
         }
 
         m_cache.insert(appPath, cachedInfo, /*cost=*/1);
@@ -124,7 +161,21 @@ void AppInfoCache::appInfoCached(const QString &appPath, AppInfo &info, bool &lo
     }
 }
 
-void AppInfoCache::emitCacheChanged()
+void AppInfoCache::emitCacheChanged(const QString &appPath)
 {
+    // Coalesce the changes until the trigger fires
+    m_changedAppPaths.insert(appPath);
+
     m_triggerTimer.startTrigger();
 }
+
+void AppInfoCache::emitLookupAppPath(const QString &appPath)
+{
+    // Collect the apps of painted rows to extract their infos in one batch
+    if (m_lookupAppPaths.contains(appPath))
+        return;
+
+    m_lookupAppPaths.append(appPath);
+
+    m_lookupTimer.startTrigger();
+}
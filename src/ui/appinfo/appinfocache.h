@@ -3,6 +3,7 @@
 
 #include <QCache>
 #include <QObject>
+#include <QSet>
 
 #include <util/ioc/iocservice.h>
 #include <util/triggertimer.h>
@@ -26,21 +27,32 @@ public:
     AppInfo appInfo(const QString &appPath);
 
 signals:
-    void cacheChanged();
+    void cacheChanged(const QStringList &appPaths);
 
 private slots:
     void handleFinishedInfoLookup(const QString &appPath, const AppInfo &info);
-    void handleFinishedIconLookup(const QString &appPath, const QImage &image);
+    void handleFinishedIconLookup(const QString &appPath, const QByteArray &iconData);
+    void handleDroppedInfoLookup(const QString &appPath);
+    void handleDroppedIconLookup(const QString &appPath);
+
+    void emitChangedAppPaths();
+    void lookupAppPaths();
 
 private:
     void appInfoCached(const QString &appPath, AppInfo &info, bool &lookupRequired);
 
-    void emitCacheChanged();
+    void emitCacheChanged(const QString &appPath);
+
+    void emitLookupAppPath(const QString &appPath);
 
 private:
     QCache<QString, AppInfo> m_cache;
 
+    QSet<QString> m_changedAppPaths;
+    QStringList m_lookupAppPaths;
+
     TriggerTimer m_triggerTimer;
+    TriggerTimer m_lookupTimer;
 };
 
 #endif // APPINFOCACHE_H
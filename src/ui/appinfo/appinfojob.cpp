@@ -19,6 +19,11 @@ void AppInfoJob::reportResult(WorkerObject &worker)
     emitFinished(static_cast<AppInfoManager *>(worker.manager()));
 }
 
+void AppInfoJob::reportDropped(WorkerManager &manager)
+{
+    emit static_cast<AppInfoManager &>(manager).lookupInfoDropped(appPath());
+}
+
 void AppInfoJob::loadAppInfo(AppInfoManager *manager)
 {
     // Try to load from DB
@@ -13,6 +13,7 @@ public:
 
     void doJob(WorkerObject &worker) override;
     void reportResult(WorkerObject &worker) override;
+    void reportDropped(WorkerManager &manager) override;
 
 private:
     void loadAppInfo(AppInfoManager *manager);
@@ -16,14 +16,16 @@ namespace {
 
 const QLoggingCategory LC("appInfo");
 
-constexpr int DATABASE_USER_VERSION = 7;
+constexpr int DATABASE_USER_VERSION = 8;
 
 constexpr int APP_CACHE_MAX_COUNT = 3000;
+constexpr int APP_JOBS_MAX_COUNT = 1000;
 constexpr int APP_PURGE_INTERVAL = 3000; // 3 seconds
 
-const char *const sqlSelectAppInfo = "SELECT alt_path, file_descr, company_name,"
-                                     "    product_name, product_ver, file_mod_time, icon_id"
-                                     "  FROM app WHERE path = ?1;";
+const char *const sqlSelectAppInfo =
+        "SELECT alt_path, file_descr, company_name,"
+        "    product_name, product_ver, file_mod_time, file_size, icon_id"
+        "  FROM app WHERE path = ?1;";
 
 const char *const sqlSelectIconImage = "SELECT image FROM icon WHERE icon_id = ?1;";
 
@@ -36,9 +38,10 @@ const char *const sqlUpdateIconRefCount = "UPDATE icon"
                                           "  SET ref_count = ref_count + ?2"
                                           "  WHERE icon_id = ?1;";
 
-const char *const sqlInsertAppInfo = "INSERT INTO app(path, alt_path, file_descr, company_name,"
-                                     "    product_name, product_ver, file_mod_time, icon_id)"
-                                     "  VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8);";
+const char *const sqlInsertAppInfo =
+        "INSERT INTO app(path, alt_path, file_descr, company_name,"
+        "    product_name, product_ver, file_mod_time, file_size, icon_id)"
+        "  VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9);";
 
 const char *const sqlSelectAppCount = "SELECT count(*) FROM app;";
 
@@ -60,6 +63,7 @@ AppInfoManager::AppInfoManager(const QString &filePath, QObject *parent, quint32
     m_sqliteDb(new SqliteDb(filePath, openFlags))
 {
     setMaxWorkersCount(1);
+    setMaxJobsCount(APP_JOBS_MAX_COUNT);
 
     connect(&m_appsPurgeTimer, &QTimer::timeout, this, &AppInfoManager::purgeApps);
 }
@@ -74,14 +78,22 @@ WorkerObject *AppInfoManager::createWorker()
     return new AppInfoWorker(this);
 }
 
-void AppInfoManager::lookupAppInfo(const QString &appPath)
+void AppInfoManager::lookupAppInfos(const QStringList &appPaths)
 {
-    enqueueJob(WorkerJobPtr(new AppInfoJob(appPath)));
+    QList<WorkerJobPtr> jobs;
+    jobs.reserve(appPaths.size());
+
+    for (const QString &appPath : appPaths) {
+        jobs.append(WorkerJobPtr(new AppInfoJob(appPath)));
+    }
+
+    // The latest requested apps are of the visible rows: extract them first
+    enqueueJobsFirst(jobs);
 }
 
 void AppInfoManager::lookupAppIcon(const QString &appPath, qint64 iconId)
 {
-    enqueueJob(WorkerJobPtr(new AppIconJob(appPath, iconId)));
+    enqueueJobFirst(WorkerJobPtr(new AppIconJob(appPath, iconId)));
 }
 
 void AppInfoManager::checkLookupInfoFinished(const QString &appPath)
@@ -128,7 +140,8 @@ bool AppInfoManager::loadInfoFromDb(const QString &appPath, AppInfo &appInfo)
     appInfo.productName = stmt.columnText(3);
     appInfo.productVersion = stmt.columnText(4);
     appInfo.fileModTime = stmt.columnDateTime(5);
-    appInfo.iconId = stmt.columnInt64(6);
+    appInfo.fileSize = stmt.columnInt64(6);
+    appInfo.iconId = stmt.columnInt64(7);
 
     return true;
 }
@@ -158,11 +171,13 @@ bool AppInfoManager::setupDb()
 
 void AppInfoManager::saveAppIcon(const QImage &appIcon, QVariant &iconId, bool &ok)
 {
-    const uint iconHash = uint(qHashBits(appIcon.constBits(), size_t(appIcon.sizeInBytes())));
+    // Store the compressed image: it's decoded when painted
+    const QByteArray iconData = AppInfoUtil::iconToData(appIcon);
+    const uint iconHash = uint(qHash(iconData));
 
     iconId = DbQuery(sqliteDb()).sql(sqlSelectIconIdByHash).vars({ iconHash }).execute();
     if (iconId.isNull()) {
-        DbQuery(sqliteDb(), &ok).sql(sqlInsertIcon).vars({ iconHash, appIcon }).executeOk();
+        DbQuery(sqliteDb(), &ok).sql(sqlInsertIcon).vars({ iconHash, iconData }).executeOk();
         if (ok) {
             iconId = sqliteDb()->lastInsertRowid();
         }
@@ -185,6 +200,7 @@ void AppInfoManager::saveAppInfo(
         appInfo.productName,
         appInfo.productVersion,
         appInfo.fileModTime,
+        appInfo.fileSize,
         iconId,
     };
 
@@ -212,16 +228,17 @@ void AppInfoManager::purgeApps()
     commitTransaction();
 }
 
-QImage AppInfoManager::loadIconFromDb(qint64 iconId)
+QByteArray AppInfoManager::loadIconFromDb(qint64 iconId)
 {
     if (iconId == 0)
         return {};
 
     QMutexLocker locker(&m_mutex);
 
-    const QVariant icon = DbQuery(sqliteDb()).sql(sqlSelectIconImage).vars({ iconId }).execute();
+    const QVariant iconData =
+            DbQuery(sqliteDb()).sql(sqlSelectIconImage).vars({ iconId }).execute();
 
-    return icon.value<QImage>();
+    return iconData.toByteArray();
 }
 
 bool AppInfoManager::saveToDb(const QString &appPath, AppInfo &appInfo, const QImage &appIcon)
@@ -30,7 +30,7 @@ public:
     QImage loadIconFromFs(const QString &appPath, const AppInfo &appInfo);
 
     bool loadInfoFromDb(const QString &appPath, AppInfo &appInfo);
-    QImage loadIconFromDb(qint64 iconId);
+    QByteArray loadIconFromDb(qint64 iconId);
 
     bool saveToDb(const QString &appPath, AppInfo &appInfo, const QImage &appIcon);
 
@@ -39,10 +39,14 @@ public:
 
 signals:
     void lookupInfoFinished(const QString &appPath, const AppInfo &appInfo);
-    void lookupIconFinished(const QString &appPath, const QImage &image);
+    void lookupIconFinished(const QString &appPath, const QByteArray &iconData);
+
+    // The lookup job was dropped by back-pressure and will not finish
+    void lookupInfoDropped(const QString &appPath);
+    void lookupIconDropped(const QString &appPath);
 
 public slots:
-    virtual void lookupAppInfo(const QString &appPath);
+    virtual void lookupAppInfos(const QStringList &appPaths);
     void lookupAppIcon(const QString &appPath, qint64 iconId);
 
     void checkLookupInfoFinished(const QString &appPath);
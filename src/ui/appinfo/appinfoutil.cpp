@@ -1,5 +1,6 @@
 #include "appinfoutil.h"
 
+#include <QBuffer>
 #include <QFileInfo>
 #include <QImage>
 #include <QVarLengthArray>
@@ -197,8 +198,10 @@ bool getInfo(const QString &appPath, AppInfo &appInfo)
 
     const auto wow64FsRedir = disableWow64FsRedirection();
 
-    // File modification time
-    appInfo.fileModTime = FileUtil::fileModTime(path);
+    // File modification time & size
+    const QFileInfo fi(path);
+    appInfo.fileModTime = FileUtil::fileModTime(fi);
+    appInfo.fileSize = fi.size();
 
     const bool ok = appInfo.fileModTime.isValid();
     if (ok) {
@@ -234,6 +237,20 @@ QImage getIcon(const QString &appPath)
     return result;
 }
 
+QByteArray iconToData(const QImage &image)
+{
+    if (image.isNull())
+        return {};
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+
+    image.save(&buffer, "PNG");
+
+    return data;
+}
+
 void initThread()
 {
     CoInitialize(nullptr);
@@ -255,7 +272,7 @@ bool fileExists(const QString &appPath)
     return res;
 }
 
-QDateTime fileModTime(const QString &appPath, bool &fileExists)
+QDateTime fileModTime(const QString &appPath, bool &fileExists, qint64 &fileSize)
 {
     if (appPath.isEmpty() || FileUtil::isSystemApp(appPath))
         return {};
@@ -266,6 +283,7 @@ QDateTime fileModTime(const QString &appPath, bool &fileExists)
     fileExists = fi.exists();
 
     const QDateTime res = fileExists ? FileUtil::fileModTime(fi) : QDateTime();
+    fileSize = fileExists ? fi.size() : 0;
 
     revertWow64FsRedirection(wow64FsRedir);
 
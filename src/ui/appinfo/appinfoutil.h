@@ -11,12 +11,14 @@ namespace AppInfoUtil {
 bool getInfo(const QString &appPath, AppInfo &appInfo);
 QImage getIcon(const QString &appPath);
 
+QByteArray iconToData(const QImage &image);
+
 void initThread();
 void doneThread();
 
 bool fileExists(const QString &appPath);
 
-QDateTime fileModTime(const QString &appPath, bool &fileExists);
+QDateTime fileModTime(const QString &appPath, bool &fileExists, qint64 &fileSize);
 
 bool openFolder(const QString &appPath);
 
@@ -7,6 +7,7 @@ CREATE TABLE app(
   product_name TEXT,
   product_ver TEXT,
   file_mod_time INTEGER,
+  file_size INTEGER,
   icon_id INTEGER
 );
 
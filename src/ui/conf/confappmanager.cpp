@@ -33,6 +33,8 @@ const QLoggingCategory LC("confApp");
 constexpr int APP_END_TIMER_INTERVAL_MIN = 100;
 constexpr int APP_END_TIMER_INTERVAL_MAX = 24 * 60 * 60 * 1000; // 1 day
 
+constexpr int DRIVER_APPS_BATCH_MAX = 1024;
+
 #define SELECT_APP_FIELDS                                                                          \
     "    t.app_id,"                                                                                \
     "    t.origin_path,"                                                                           \
@@ -146,6 +148,8 @@ ConfAppManager::ConfAppManager(QObject *parent) : ConfManagerBase(parent)
     connect(&m_appsChangedTimer, &QTimer::timeout, this, &ConfAppManager::appsChanged);
     connect(&m_appUpdatedTimer, &QTimer::timeout, this, &ConfAppManager::appUpdated);
 
+    connect(&m_driverAppsTimer, &QTimer::timeout, this, &ConfAppManager::flushDriverApps);
+
     m_appEndTimer.setSingleShot(true);
     connect(&m_appEndTimer, &QTimer::timeout, this, &ConfAppManager::updateAppEndTimes);
 }
@@ -822,6 +826,12 @@ bool ConfAppManager::updateDriverConf(bool onlyFlags)
 
     m_driveMask = confBuf.driveMask();
 
+    // The whole conf already contains the pending apps
+    if (!onlyFlags) {
+        m_driverPendingApps.clear();
+        m_driverAppsTimer.stop();
+    }
+
     return true;
 }
 
@@ -874,6 +884,20 @@ bool ConfAppManager::updateDriverDeleteApp(const QString &appPath)
 
 bool ConfAppManager::updateDriverUpdateApp(const App &app, bool remove)
 {
+    if (!remove) {
+        // Coalesce the additions into one batch
+        m_driverPendingApps.insert(app.appPath, app);
+
+        if (m_driverPendingApps.size() < DRIVER_APPS_BATCH_MAX) {
+            m_driverAppsTimer.startTrigger();
+            return true;
+        }
+
+        return flushDriverApps();
+    }
+
+    m_driverPendingApps.remove(app.appPath);
+
     ConfBuffer confBuf;
 
     if (!confBuf.writeAppEntry(app)) {
@@ -882,12 +906,43 @@ bool ConfAppManager::updateDriverUpdateApp(const App &app, bool remove)
     }
 
     auto driverManager = IoC<DriverManager>();
-    if (!driverManager->writeApp(confBuf.buffer(), remove)) {
+    if (!driverManager->writeApp(confBuf.buffer(), /*remove=*/true)) {
+        qCWarning(LC) << "Update driver error:" << driverManager->errorMessage();
+        return false;
+    }
+
+    return true;
+}
+
+bool ConfAppManager::flushDriverApps()
+{
+    m_driverAppsTimer.stop();
+
+    if (m_driverPendingApps.isEmpty())
+        return true;
+
+    const QList<App> apps = m_driverPendingApps.values();
+    m_driverPendingApps.clear();
+
+    ConfBuffer confBuf;
+    QStringList skippedAppPaths;
+
+    const bool ok = confBuf.writeAppEntries(apps, skippedAppPaths);
+
+    if (!skippedAppPaths.isEmpty()) {
+        qCWarning(LC) << "Driver config error:" << confBuf.errorMessage() << skippedAppPaths;
+    }
+
+    if (!ok)
+        return false;
+
+    auto driverManager = IoC<DriverManager>();
+    if (!driverManager->writeApps(confBuf.buffer())) {
         qCWarning(LC) << "Update driver error:" << driverManager->errorMessage();
         return false;
     }
 
-    m_driveMask |= remove ? 0 : confBuf.driveMask();
+    m_driveMask |= confBuf.driveMask();
 
     return true;
 }
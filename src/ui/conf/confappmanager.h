@@ -1,8 +1,10 @@
 #ifndef CONFAPPMANAGER_H
 #define CONFAPPMANAGER_H
 
+#include <QHash>
 #include <QObject>
 
+#include <conf/app.h>
 #include <util/classhelpers.h>
 #include <util/conf/confappswalker.h>
 #include <util/ioc/iocservice.h>
@@ -10,7 +12,6 @@
 
 #include "confmanagerbase.h"
 
-class App;
 class AppGroup;
 class ConfManager;
 class FirewallConf;
@@ -101,12 +102,17 @@ private:
     bool updateDriverUpdateApp(const App &app, bool remove = false);
     bool updateDriverUpdateAppConf(const App &app);
 
+    bool flushDriverApps();
+
 private:
     quint32 m_driveMask = 0;
 
+    QHash<QString, App> m_driverPendingApps;
+
     TriggerTimer m_appAlertedTimer;
     TriggerTimer m_appsChangedTimer;
     TriggerTimer m_appUpdatedTimer;
+    TriggerTimer m_driverAppsTimer;
 
     QTimer m_appEndTimer;
 };
@@ -30,7 +30,7 @@ namespace {
 
 const QLoggingCategory LC("conf");
 
-constexpr int DATABASE_USER_VERSION = 54;
+constexpr int DATABASE_USER_VERSION = 55;
 
 constexpr int CONF_PERIODS_UPDATE_INTERVAL = 60 * 1000; // 1 minute
 
@@ -643,9 +643,7 @@ bool ConfManager::setupDb()
         return false;
     }
 
-    SqliteDb::MigrateOptions opt = migrateOptions();
-
-    if (!sqliteDb()->migrate(opt)) {
+    if (!migrateDb(sqliteDb())) {
         qCCritical(LC) << "Migration error" << sqliteDb()->filePath();
         return false;
     }
@@ -659,6 +657,13 @@ void ConfManager::setupDefault(FirewallConf &conf) const
     conf.addDefaultAppGroup();
 }
 
+bool ConfManager::migrateDb(SqliteDb *sqliteDb)
+{
+    SqliteDb::MigrateOptions opt = migrateOptions();
+
+    return sqliteDb->migrate(opt);
+}
+
 bool ConfManager::checkCanMigrate(Settings *settings) const
 {
     QString viaVersion;
@@ -43,6 +43,8 @@ public:
 
     bool checkCanMigrate(Settings *settings) const;
 
+    static bool migrateDb(SqliteDb *sqliteDb);
+
     bool loadConf(FirewallConf &conf);
     void load();
     void reload();
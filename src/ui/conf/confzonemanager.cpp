@@ -163,7 +163,7 @@ bool ConfZoneManager::addOrUpdateZone(Zone &zone)
     if (isNew) {
         emit zoneAdded();
     } else {
-        emit zoneUpdated();
+        emit zoneUpdated(zone.zoneId);
     }
 
     return true;
@@ -213,7 +213,7 @@ bool ConfZoneManager::updateZoneName(quint8 zoneId, const QString &zoneName)
     endTransaction(ok);
 
     if (ok) {
-        emit zoneUpdated();
+        emit zoneUpdated(zoneId);
     }
 
     return ok;
@@ -232,7 +232,7 @@ bool ConfZoneManager::updateZoneEnabled(quint8 zoneId, bool enabled)
     endTransaction(ok);
 
     if (ok) {
-        emit zoneUpdated();
+        emit zoneUpdated(zoneId);
 
         updateDriverZoneFlag(zoneId, enabled);
     }
@@ -261,7 +261,7 @@ bool ConfZoneManager::updateZoneResult(const Zone &zone)
     endTransaction(ok);
 
     if (ok) {
-        emit zoneUpdated();
+        emit zoneUpdated(zone.zoneId);
     }
 
     return ok;
@@ -35,7 +35,7 @@ public:
 signals:
     void zoneAdded();
     void zoneRemoved(quint8 zoneId);
-    void zoneUpdated();
+    void zoneUpdated(quint8 zoneId);
 
 private:
     bool updateDriverZoneFlag(quint8 zoneId, bool enabled);
@@ -11,6 +11,8 @@
 #define DEFAULT_TRAF_DAY_KEEP_DAYS     365 // ~1 year
 #define DEFAULT_TRAF_MONTH_KEEP_MONTHS 36 // ~3 years
 #define DEFAULT_LOG_CONN_KEEP_COUNT    10000
+#define DEFAULT_STAT_FLUSH_PERIOD_MIN  500 // msec
+#define DEFAULT_STAT_FLUSH_PERIOD_MAX  2000 // msec
 
 class IniOptions : public MapSettings
 {
@@ -101,6 +103,18 @@ public:
     }
     void setConnKeepCount(int v) { setValue("stat/connKeepCount", v); }
 
+    int statFlushPeriodMin() const
+    {
+        return valueInt("stat/flushPeriodMinMsec", DEFAULT_STAT_FLUSH_PERIOD_MIN);
+    }
+    void setStatFlushPeriodMin(int v) { setValue("stat/flushPeriodMinMsec", v); }
+
+    int statFlushPeriodMax() const
+    {
+        return valueInt("stat/flushPeriodMaxMsec", DEFAULT_STAT_FLUSH_PERIOD_MAX);
+    }
+    void setStatFlushPeriodMax(int v) { setValue("stat/flushPeriodMaxMsec", v); }
+
     bool updateKeepCurrentVersion() const { return valueBool("autoUpdate/keepCurrentVersion"); }
     void setUpdateKeepCurrentVersion(bool v) { setValue("autoUpdate/keepCurrentVersion", v); }
 
@@ -58,6 +58,7 @@ CREATE TABLE app(
   path TEXT,
   icon_path TEXT,
   name TEXT,
+  lower_name TEXT, -- lower(name) for sorting, maintained by triggers
   notes TEXT,
   is_wildcard BOOLEAN NOT NULL DEFAULT 0,
   apply_parent BOOLEAN NOT NULL DEFAULT 0,
@@ -80,10 +81,18 @@ CREATE TABLE app(
 
 CREATE INDEX app_app_group_id_idx ON app(app_group_id);
 CREATE UNIQUE INDEX app_path_uk ON app(path);
-CREATE INDEX app_name_idx ON app(lower(name));
+CREATE INDEX app_lower_name_idx ON app(lower_name);
 CREATE INDEX app_rule_id_idx ON app(rule_id);
 CREATE INDEX app_end_time_idx ON app(end_time);
 
+CREATE TRIGGER app_lower_name_ai AFTER INSERT ON app BEGIN
+  UPDATE app SET lower_name = lower(new.name) WHERE app_id = new.app_id;
+END;
+
+CREATE TRIGGER app_lower_name_au AFTER UPDATE OF name ON app BEGIN
+  UPDATE app SET lower_name = lower(new.name) WHERE app_id = new.app_id;
+END;
+
 CREATE TABLE app_alert(
   app_id INTEGER PRIMARY KEY
 );
@@ -0,0 +1,68 @@
+#include "controlcommanddriver.h"
+
+#include <driver/drivermanager.h>
+#include <log/logmanager.h>
+#include <util/ioc/ioccontainer.h>
+
+namespace {
+
+enum DriverAction : quint32 {
+    DriverActionNone = 0,
+    DriverActionStats = (1 << 0),
+};
+
+DriverAction driverActionByText(const QString &commandText)
+{
+    if (commandText == "stats")
+        return DriverActionStats;
+
+    return DriverActionNone;
+}
+
+QString logDroppedText()
+{
+    const LogManager *logManager = IoC<LogManager>();
+
+    return QString("Dropped logs: stat=%1 proc=%2 app=%3 conn=%4")
+            .arg(logManager->droppedCount(FORT_LOG_CLASS_STAT))
+            .arg(logManager->droppedCount(FORT_LOG_CLASS_PROC))
+            .arg(logManager->droppedCount(FORT_LOG_CLASS_APP))
+            .arg(logManager->droppedCount(FORT_LOG_CLASS_CONN));
+}
+
+bool processCommandDriverAction(DriverAction driverAction, ProcessCommandResult &r)
+{
+    switch (driverAction) {
+    case DriverActionStats: {
+        const QString statsText = IoC<DriverManager>()->statsText();
+        if (statsText.isEmpty())
+            return false;
+
+        // Dropped log records are counted by the log manager
+        r.commandOutput = statsText + '\n' + logDroppedText();
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+}
+
+bool ControlCommandDriver::processCommand(const ProcessCommandArgs &p, ProcessCommandResult &r)
+{
+    const DriverAction driverAction = driverActionByText(p.args.value(0).toString());
+    if (driverAction == DriverActionNone) {
+        r.errorMessage = "Usage: driver stats";
+        return false;
+    }
+
+    if (!checkCommandActionPassword(r, driverAction, DriverActionStats))
+        return false;
+
+    const bool ok = processCommandDriverAction(driverAction, r);
+
+    uncheckCommandActionPassword();
+
+    return ok;
+}
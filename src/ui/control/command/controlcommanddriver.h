@@ -0,0 +1,12 @@
+#ifndef CONTROLCOMMANDDRIVER_H
+#define CONTROLCOMMANDDRIVER_H
+
+#include "controlcommandbase.h"
+
+class ControlCommandDriver : public ControlCommandBase
+{
+public:
+    static bool processCommand(const ProcessCommandArgs &p, ProcessCommandResult &r);
+};
+
+#endif // CONTROLCOMMANDDRIVER_H
@@ -6,6 +6,7 @@
 #include "controlcommandbackup.h"
 #include "controlcommandblock.h"
 #include "controlcommandconf.h"
+#include "controlcommanddriver.h"
 #include "controlcommandfilter.h"
 #include "controlcommandfiltermode.h"
 #include "controlcommandgroup.h"
@@ -26,6 +27,7 @@ static const processCommand_func processCommand_funcList[] = {
     &ControlCommandConf::processCommand, // Control::CommandConf,
     &ControlCommandBackup::processCommand, // Control::CommandBackup,
     &ControlCommandZone::processCommand, // Control::CommandZone,
+    &ControlCommandDriver::processCommand, // Control::CommandDriver,
 };
 
 }
@@ -33,7 +35,7 @@ static const processCommand_func processCommand_funcList[] = {
 bool ControlCommandManager::processCommand(const ProcessCommandArgs &p, ProcessCommandResult &r)
 {
     const processCommand_func func = RpcManager::getProcessFunc(p.command, processCommand_funcList,
-            Control::CommandHome, Control::CommandZone, &ControlCommandRpc::processCommand);
+            Control::CommandHome, Control::CommandDriver, &ControlCommandRpc::processCommand);
 
     const bool ok = func(p, r);
 
@@ -45,11 +47,11 @@ bool ControlCommandManager::processCommand(const ProcessCommandArgs &p, ProcessC
         r.ok = ok;
         r.isSendResult = true;
 
-        r.args = { r.commandResult, r.errorMessage };
+        r.args = { r.commandResult, r.errorMessage, r.commandOutput };
     }
 
     if (r.isSendResult) {
-        p.worker->sendResult(r.ok, r.args);
+        p.worker->sendResult(r.ok, r.args, p.requestId);
     }
 
     return ok;
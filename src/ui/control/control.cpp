@@ -18,14 +18,16 @@ static const QHash<Command, const char *> g_commandNames = {
     CASE_STRING(CommandConf),
     CASE_STRING(CommandBackup),
     CASE_STRING(CommandZone),
+    CASE_STRING(CommandDriver),
 
     CASE_STRING(Rpc_Result_Ok),
     CASE_STRING(Rpc_Result_Error),
 
     CASE_STRING(Rpc_RpcManager_initClient),
 
-    CASE_STRING(Rpc_AppInfoManager_lookupAppInfo),
+    CASE_STRING(Rpc_AppInfoManager_lookupAppInfos),
     CASE_STRING(Rpc_AppInfoManager_checkLookupInfoFinished),
+    CASE_STRING(Rpc_AppInfoManager_lookupInfoDropped),
 
     CASE_STRING(Rpc_AutoUpdateManager_startDownload),
     CASE_STRING(Rpc_AutoUpdateManager_runInstaller),
@@ -76,6 +78,10 @@ static const QHash<Command, const char *> g_commandNames = {
 
     CASE_STRING(Rpc_DriveListManager_onDriveListChanged),
 
+    CASE_STRING(Rpc_HostInfoManager_lookupHosts),
+    CASE_STRING(Rpc_HostInfoManager_checkLookupFinished),
+    CASE_STRING(Rpc_HostInfoManager_lookupDropped),
+
     CASE_STRING(Rpc_QuotaManager_alert),
 
     CASE_STRING(Rpc_StatManager_deleteStatApp),
@@ -119,6 +125,7 @@ static const QHash<RpcManager, const char *> g_managerNames = {
     CASE_STRING(Rpc_ConfZoneManager),
     CASE_STRING(Rpc_DriverManager),
     CASE_STRING(Rpc_DriveListManager),
+    CASE_STRING(Rpc_HostInfoManager),
     CASE_STRING(Rpc_QuotaManager),
     CASE_STRING(Rpc_StatManager),
     CASE_STRING(Rpc_StatConnManager),
@@ -143,14 +150,16 @@ static const RpcManager g_commandManagers[] = {
     Rpc_NoneManager, // CommandConf,
     Rpc_NoneManager, // CommandBackup,
     Rpc_NoneManager, // CommandZone,
+    Rpc_NoneManager, // CommandDriver,
 
     Rpc_NoneManager, // Rpc_Result_Ok,
     Rpc_NoneManager, // Rpc_Result_Error,
 
     Rpc_NoneManager, // Rpc_RpcManager_initClient,
 
-    Rpc_AppInfoManager, // Rpc_AppInfoManager_lookupAppInfo,
+    Rpc_AppInfoManager, // Rpc_AppInfoManager_lookupAppInfos,
     Rpc_AppInfoManager, // Rpc_AppInfoManager_checkLookupFinished,
+    Rpc_AppInfoManager, // Rpc_AppInfoManager_lookupInfoDropped,
 
     Rpc_AutoUpdateManager, // Rpc_AutoUpdateManager_startDownload,
     Rpc_AutoUpdateManager, // Rpc_AutoUpdateManager_runInstaller,
@@ -202,6 +211,10 @@ static const RpcManager g_commandManagers[] = {
 
     Rpc_DriveListManager, // Rpc_DriveListManager_onDriveListChanged,
 
+    Rpc_HostInfoManager, // Rpc_HostInfoManager_lookupHosts,
+    Rpc_HostInfoManager, // Rpc_HostInfoManager_checkLookupFinished,
+    Rpc_HostInfoManager, // Rpc_HostInfoManager_lookupDropped,
+
     Rpc_QuotaManager, // Rpc_QuotaManager_alert,
 
     Rpc_StatManager, // Rpc_StatManager_deleteStatApp,
@@ -247,14 +260,16 @@ static const qint8 g_commandValidations[] = {
     0, // CommandConf,
     0, // CommandBackup,
     0, // CommandZone,
+    0, // CommandDriver,
 
     0, // Rpc_Result_Ok,
     0, // Rpc_Result_Error,
 
     0, // Rpc_RpcManager_initClient,
 
-    true, // Rpc_AppInfoManager_lookupAppInfo,
+    true, // Rpc_AppInfoManager_lookupAppInfos,
     0, // Rpc_AppInfoManager_checkLookupFinished,
+    0, // Rpc_AppInfoManager_lookupInfoDropped,
 
     true, // Rpc_AutoUpdateManager_startDownload,
     true, // Rpc_AutoUpdateManager_runInstaller,
@@ -306,6 +321,10 @@ static const qint8 g_commandValidations[] = {
 
     true, // Rpc_DriveListManager_onDriveListChanged,
 
+    true, // Rpc_HostInfoManager_lookupHosts,
+    0, // Rpc_HostInfoManager_checkLookupFinished,
+    0, // Rpc_HostInfoManager_lookupDropped,
+
     0, // Rpc_QuotaManager_alert,
 
     true, // Rpc_StatManager_deleteStatApp,
@@ -20,14 +20,16 @@ enum Command : qint8 {
     CommandConf,
     CommandBackup,
     CommandZone,
+    CommandDriver,
 
     Rpc_Result_Ok,
     Rpc_Result_Error,
 
     Rpc_RpcManager_initClient,
 
-    Rpc_AppInfoManager_lookupAppInfo,
+    Rpc_AppInfoManager_lookupAppInfos,
     Rpc_AppInfoManager_checkLookupInfoFinished,
+    Rpc_AppInfoManager_lookupInfoDropped,
 
     Rpc_AutoUpdateManager_startDownload,
     Rpc_AutoUpdateManager_runInstaller,
@@ -79,6 +81,10 @@ enum Command : qint8 {
 
     Rpc_DriveListManager_onDriveListChanged,
 
+    Rpc_HostInfoManager_lookupHosts,
+    Rpc_HostInfoManager_checkLookupFinished,
+    Rpc_HostInfoManager_lookupDropped,
+
     Rpc_QuotaManager_alert,
 
     Rpc_StatManager_deleteStatApp,
@@ -123,6 +129,7 @@ enum RpcManager : qint8 {
     Rpc_ConfZoneManager,
     Rpc_DriverManager,
     Rpc_DriveListManager,
+    Rpc_HostInfoManager,
     Rpc_QuotaManager,
     Rpc_StatManager,
     Rpc_StatConnManager,
@@ -137,6 +144,7 @@ struct ProcessCommandArgs
     ControlWorker *worker = nullptr;
     const Control::Command command = Control::CommandNone;
     const QVariantList &args;
+    const quint32 requestId = 0;
 };
 
 struct ProcessCommandResult
@@ -146,6 +154,7 @@ struct ProcessCommandResult
     Control::CommandResult commandResult = Control::CommandResultNone;
     QVariantList args;
     QString errorMessage;
+    QString commandOutput;
 };
 
 using processCommand_func = bool (*)(const ProcessCommandArgs &p, ProcessCommandResult &r);
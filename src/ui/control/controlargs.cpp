@@ -0,0 +1,560 @@
+#include "controlargs.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QLoggingCategory>
+#include <QtEndian>
+
+#include <cstring>
+
+namespace {
+
+const QLoggingCategory LC("controlArgs");
+
+constexpr int argsMaxCount = 32;
+constexpr int valueMaxDepth = 8;
+
+constexpr int compressMinSize = 1024;
+
+class ArgsWriter
+{
+public:
+    explicit ArgsWriter(QByteArray &data) : m_data(data) { }
+
+    int textSize() const { return m_textSize; }
+
+    void writeByte(quint8 v) { m_data.append(char(v)); }
+
+    void writeVarint(quint64 v)
+    {
+        while (v >= 0x80) {
+            writeByte(quint8(v) | 0x80);
+            v >>= 7;
+        }
+        writeByte(quint8(v));
+    }
+
+    void writeZigzag(qint64 v) { writeVarint((quint64(v) << 1) ^ quint64(v >> 63)); }
+
+    void writeBytes(const QByteArray &v)
+    {
+        writeVarint(v.size());
+        m_data.append(v);
+    }
+
+    void writeString(const QString &v)
+    {
+        const QByteArray utf8 = v.toUtf8();
+
+        m_textSize += utf8.size();
+
+        writeBytes(utf8);
+    }
+
+    bool writeValue(const QVariant &v, int depth = 0);
+
+private:
+    bool writeStringList(const QStringList &list);
+    bool writeList(const QVariantList &list, int depth);
+    bool writeMap(const QVariantMap &map, int depth);
+    bool writeVariant(const QVariant &v);
+
+private:
+    int m_textSize = 0;
+
+    QByteArray &m_data;
+};
+
+bool ArgsWriter::writeValue(const QVariant &v, int depth)
+{
+    if (depth > valueMaxDepth) {
+        qCWarning(LC) << "Bad write value depth";
+        return false;
+    }
+
+    switch (v.typeId()) {
+    case QMetaType::UnknownType: {
+        writeByte(ControlArgs::TagInvalid);
+    } break;
+    case QMetaType::Bool: {
+        writeByte(v.toBool() ? ControlArgs::TagTrue : ControlArgs::TagFalse);
+    } break;
+    case QMetaType::Int: {
+        writeByte(ControlArgs::TagInt);
+        writeZigzag(v.toInt());
+    } break;
+    case QMetaType::UInt: {
+        writeByte(ControlArgs::TagUInt);
+        writeVarint(v.toUInt());
+    } break;
+    case QMetaType::LongLong: {
+        writeByte(ControlArgs::TagLongLong);
+        writeZigzag(v.toLongLong());
+    } break;
+    case QMetaType::ULongLong: {
+        writeByte(ControlArgs::TagULongLong);
+        writeVarint(v.toULongLong());
+    } break;
+    case QMetaType::UShort: {
+        writeByte(ControlArgs::TagUShort);
+        writeVarint(v.value<quint16>());
+    } break;
+    case QMetaType::UChar: {
+        writeByte(ControlArgs::TagUChar);
+        writeByte(v.value<quint8>());
+    } break;
+    case QMetaType::Double: {
+        const double d = v.toDouble();
+
+        quint64 bits;
+        memcpy(&bits, &d, sizeof(bits));
+        bits = qToLittleEndian(bits);
+
+        writeByte(ControlArgs::TagDouble);
+        m_data.append((const char *) &bits, sizeof(bits));
+    } break;
+    case QMetaType::QString: {
+        writeByte(ControlArgs::TagString);
+        writeString(v.toString());
+    } break;
+    case QMetaType::QByteArray: {
+        writeByte(ControlArgs::TagByteArray);
+        writeBytes(v.toByteArray());
+    } break;
+    case QMetaType::QStringList: {
+        writeByte(ControlArgs::TagStringList);
+        return writeStringList(v.toStringList());
+    }
+    case QMetaType::QVariantList: {
+        writeByte(ControlArgs::TagList);
+        return writeList(v.toList(), depth);
+    }
+    case QMetaType::QVariantMap: {
+        writeByte(ControlArgs::TagMap);
+        return writeMap(v.toMap(), depth);
+    }
+    case QMetaType::QDateTime: {
+        const QDateTime dateTime = v.toDateTime();
+        if (!dateTime.isValid())
+            return writeVariant(v);
+
+        writeByte(ControlArgs::TagDateTime);
+        writeZigzag(dateTime.toMSecsSinceEpoch());
+    } break;
+    default:
+        return writeVariant(v);
+    }
+
+    return true;
+}
+
+bool ArgsWriter::writeStringList(const QStringList &list)
+{
+    writeVarint(list.size());
+
+    for (const QString &s : list) {
+        writeString(s);
+    }
+
+    return true;
+}
+
+bool ArgsWriter::writeList(const QVariantList &list, int depth)
+{
+    writeVarint(list.size());
+
+    for (const QVariant &v : list) {
+        if (!writeValue(v, depth + 1))
+            return false;
+    }
+
+    return true;
+}
+
+bool ArgsWriter::writeMap(const QVariantMap &map, int depth)
+{
+    writeVarint(map.size());
+
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+        writeString(it.key());
+
+        if (!writeValue(it.value(), depth + 1))
+            return false;
+    }
+
+    return true;
+}
+
+bool ArgsWriter::writeVariant(const QVariant &v)
+{
+    QByteArray data;
+    {
+        QDataStream stream(&data, QDataStream::WriteOnly);
+        stream << v;
+
+        if (stream.status() != QDataStream::Ok) {
+            qCWarning(LC) << "Bad write value type:" << v.metaType().name();
+            return false;
+        }
+    }
+
+    writeByte(ControlArgs::TagVariant);
+    writeBytes(data);
+
+    return true;
+}
+
+class ArgsReader
+{
+public:
+    explicit ArgsReader(const QByteArray &data) :
+        m_p(data.constData()), m_end(data.constData() + data.size())
+    {
+    }
+
+    bool atEnd() const { return m_p == m_end; }
+
+    bool readByte(quint8 &v)
+    {
+        if (m_p == m_end)
+            return false;
+
+        v = quint8(*m_p++);
+        return true;
+    }
+
+    bool readVarint(quint64 &v)
+    {
+        v = 0;
+
+        for (int shift = 0; shift < 64; shift += 7) {
+            quint8 b;
+            if (!readByte(b))
+                return false;
+
+            v |= quint64(b & 0x7F) << shift;
+
+            if ((b & 0x80) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    bool readZigzag(qint64 &v)
+    {
+        quint64 u;
+        if (!readVarint(u))
+            return false;
+
+        v = qint64(u >> 1) ^ -qint64(u & 1);
+        return true;
+    }
+
+    bool readSize(int &v)
+    {
+        quint64 u;
+        if (!readVarint(u) || u > quint64(m_end - m_p))
+            return false;
+
+        v = int(u);
+        return true;
+    }
+
+    bool readBytes(QByteArray &v)
+    {
+        int size;
+        if (!readSize(size))
+            return false;
+
+        v = QByteArray(m_p, size);
+        m_p += size;
+        return true;
+    }
+
+    bool readString(QString &v)
+    {
+        int size;
+        if (!readSize(size))
+            return false;
+
+        v = QString::fromUtf8(m_p, size);
+        m_p += size;
+        return true;
+    }
+
+    bool readValue(QVariant &v, int depth = 0);
+
+private:
+    bool readValueByTag(QVariant &v, quint8 tag, int depth);
+
+    bool readStringList(QVariant &v);
+    bool readList(QVariant &v, int depth);
+    bool readMap(QVariant &v, int depth);
+    bool readVariant(QVariant &v);
+
+private:
+    const char *m_p = nullptr;
+    const char *const m_end = nullptr;
+};
+
+bool ArgsReader::readValue(QVariant &v, int depth)
+{
+    if (depth > valueMaxDepth)
+        return false;
+
+    quint8 tag;
+    if (!readByte(tag))
+        return false;
+
+    return readValueByTag(v, tag, depth);
+}
+
+bool ArgsReader::readValueByTag(QVariant &v, quint8 tag, int depth)
+{
+    quint64 u;
+    qint64 i;
+
+    switch (tag) {
+    case ControlArgs::TagInvalid: {
+        v = QVariant();
+    } break;
+    case ControlArgs::TagFalse:
+    case ControlArgs::TagTrue: {
+        v = (tag == ControlArgs::TagTrue);
+    } break;
+    case ControlArgs::TagInt: {
+        if (!readZigzag(i))
+            return false;
+        v = int(i);
+    } break;
+    case ControlArgs::TagUInt: {
+        if (!readVarint(u))
+            return false;
+        v = uint(u);
+    } break;
+    case ControlArgs::TagLongLong: {
+        if (!readZigzag(i))
+            return false;
+        v = i;
+    } break;
+    case ControlArgs::TagULongLong: {
+        if (!readVarint(u))
+            return false;
+        v = u;
+    } break;
+    case ControlArgs::TagUShort: {
+        if (!readVarint(u))
+            return false;
+        v = QVariant::fromValue(quint16(u));
+    } break;
+    case ControlArgs::TagUChar: {
+        quint8 b;
+        if (!readByte(b))
+            return false;
+        v = QVariant::fromValue(b);
+    } break;
+    case ControlArgs::TagDouble: {
+        quint64 bits;
+        if (m_end - m_p < qint64(sizeof(bits)))
+            return false;
+
+        memcpy(&bits, m_p, sizeof(bits));
+        m_p += sizeof(bits);
+        bits = qFromLittleEndian(bits);
+
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        v = d;
+    } break;
+    case ControlArgs::TagString: {
+        QString s;
+        if (!readString(s))
+            return false;
+        v = s;
+    } break;
+    case ControlArgs::TagByteArray: {
+        QByteArray bytes;
+        if (!readBytes(bytes))
+            return false;
+        v = bytes;
+    } break;
+    case ControlArgs::TagStringList: {
+        return readStringList(v);
+    }
+    case ControlArgs::TagList: {
+        return readList(v, depth);
+    }
+    case ControlArgs::TagMap: {
+        return readMap(v, depth);
+    }
+    case ControlArgs::TagDateTime: {
+        if (!readZigzag(i))
+            return false;
+        v = QDateTime::fromMSecsSinceEpoch(i);
+    } break;
+    case ControlArgs::TagVariant: {
+        return readVariant(v);
+    }
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+bool ArgsReader::readStringList(QVariant &v)
+{
+    int count;
+    if (!readSize(count))
+        return false;
+
+    QStringList list;
+    list.reserve(count);
+
+    while (--count >= 0) {
+        QString s;
+        if (!readString(s))
+            return false;
+
+        list.append(s);
+    }
+
+    v = list;
+    return true;
+}
+
+bool ArgsReader::readList(QVariant &v, int depth)
+{
+    int count;
+    if (!readSize(count))
+        return false;
+
+    QVariantList list;
+    list.reserve(count);
+
+    while (--count >= 0) {
+        QVariant item;
+        if (!readValue(item, depth + 1))
+            return false;
+
+        list.append(item);
+    }
+
+    v = list;
+    return true;
+}
+
+bool ArgsReader::readMap(QVariant &v, int depth)
+{
+    int count;
+    if (!readSize(count))
+        return false;
+
+    QVariantMap map;
+
+    while (--count >= 0) {
+        QString key;
+        QVariant value;
+        if (!(readString(key) && readValue(value, depth + 1)))
+            return false;
+
+        map.insert(key, value);
+    }
+
+    v = map;
+    return true;
+}
+
+bool ArgsReader::readVariant(QVariant &v)
+{
+    QByteArray data;
+    if (!readBytes(data))
+        return false;
+
+    QDataStream stream(data);
+    stream >> v;
+
+    return stream.status() == QDataStream::Ok;
+}
+
+}
+
+bool ControlArgs::write(QByteArray &data, const QVariantList &args, int &textSize)
+{
+    const int argsCount = args.count();
+    if (argsCount == 0)
+        return true;
+
+    if (argsCount > argsMaxCount) {
+        qCWarning(LC) << "Bad write args count:" << argsCount;
+        return false;
+    }
+
+    ArgsWriter writer(data);
+
+    writer.writeByte(argsCount);
+
+    for (const QVariant &arg : args) {
+        if (!writer.writeValue(arg))
+            return false;
+    }
+
+    textSize = writer.textSize();
+
+    return true;
+}
+
+bool ControlArgs::read(const QByteArray &data, QVariantList &args)
+{
+    if (data.isEmpty())
+        return true;
+
+    ArgsReader reader(data);
+
+    quint8 argsCount;
+    if (!reader.readByte(argsCount) || argsCount > argsMaxCount) {
+        qCWarning(LC) << "Bad read args count";
+        return false;
+    }
+
+    args.reserve(argsCount);
+
+    while (argsCount-- > 0) {
+        QVariant arg;
+        if (!reader.readValue(arg)) {
+            qCWarning(LC) << "Bad read arg:" << args.size();
+            return false;
+        }
+
+        args.append(arg);
+    }
+
+    if (!reader.atEnd()) {
+        qCWarning(LC) << "Bad read args: trailing data";
+        return false;
+    }
+
+    return true;
+}
+
+bool ControlArgs::isCompressible(int dataSize, int textSize)
+{
+    // Binary blobs (e.g. images) are compressed already; numbers are packed by varints
+    return dataSize >= compressMinSize && textSize >= dataSize / 2;
+}
+
+QByteArray ControlArgs::compress(const QByteArray &data, bool &compressed)
+{
+    QByteArray compressedData = qCompress(data);
+
+    // Keep the compressed data only when it's worth to uncompress
+    compressed = (compressedData.size() < data.size() - data.size() / 8);
+
+    return compressed ? compressedData : data;
+}
+
+QByteArray ControlArgs::uncompress(const QByteArray &data, bool compressed)
+{
+    return compressed ? qUncompress(data) : data;
+}
@@ -0,0 +1,41 @@
+#ifndef CONTROLARGS_H
+#define CONTROLARGS_H
+
+#include <QByteArray>
+#include <QVariant>
+
+// Compact typed binary encoding of command arguments:
+// a type tag per value, varints for integers, length-prefixed UTF-8 strings.
+// Values of other types are written by QDataStream.
+class ControlArgs
+{
+public:
+    enum ValueTag : quint8 {
+        TagInvalid = 0,
+        TagFalse,
+        TagTrue,
+        TagInt, // zigzag varint
+        TagUInt, // varint
+        TagLongLong, // zigzag varint
+        TagULongLong, // varint
+        TagUShort, // varint
+        TagUChar,
+        TagDouble, // little-endian IEEE 754
+        TagString, // varint size + UTF-8
+        TagByteArray, // varint size + bytes
+        TagStringList, // varint count + strings
+        TagList, // varint count + values
+        TagMap, // varint count + (string key + value) pairs
+        TagDateTime, // zigzag varint msecs since epoch
+        TagVariant, // varint size + QDataStream
+    };
+
+    static bool write(QByteArray &data, const QVariantList &args, int &textSize);
+    static bool read(const QByteArray &data, QVariantList &args);
+
+    static bool isCompressible(int dataSize, int textSize);
+    static QByteArray compress(const QByteArray &data, bool &compressed);
+    static QByteArray uncompress(const QByteArray &data, bool compressed);
+};
+
+#endif // CONTROLARGS_H
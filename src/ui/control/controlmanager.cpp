@@ -110,6 +110,7 @@ bool ControlManager::processCommandClient(ProcessCommandResult &r)
         { "conf", Control::CommandConf },
         { "backup", Control::CommandBackup },
         { "zone", Control::CommandZone },
+        { "driver", Control::CommandDriver },
     };
 
     const auto settings = IoC<FortSettings>();
@@ -135,6 +136,10 @@ bool ControlManager::processCommandClient(ProcessCommandResult &r)
 
     const bool ok = postCommand(command, args, &r);
 
+    if (!r.commandOutput.isEmpty()) {
+        out.write(r.commandOutput);
+    }
+
     if (!r.errorMessage.isEmpty()) {
         out.write(QStringList { r.errorMessage });
     }
@@ -155,9 +160,10 @@ bool ControlManager::postCommand(
             [&commandOk, r](Control::Command command, const QVariantList &args) {
                 commandOk = command;
 
-                if (r && args.size() == 2) {
+                if (r && args.size() >= 2) {
                     r->commandResult = args[0].value<Control::CommandResult>();
                     r->errorMessage = args[1].toString();
+                    r->commandOutput = args.value(2).toString();
                 }
             });
 
@@ -231,7 +237,8 @@ void ControlManager::onDisconnected()
     m_clients.removeOne(w);
 }
 
-bool ControlManager::processRequest(Control::Command command, const QVariantList &args)
+bool ControlManager::processRequest(
+        Control::Command command, const QVariantList &args, quint32 requestId)
 {
     ControlWorker *w = qobject_cast<ControlWorker *>(sender());
     if (Q_UNLIKELY(!w))
@@ -247,6 +254,7 @@ bool ControlManager::processRequest(Control::Command command, const QVariantList
                     .worker = w,
                     .command = command,
                     .args = args,
+                    .requestId = requestId,
             },
             r);
 
@@ -44,7 +44,7 @@ private slots:
     void onNewConnection();
     void onDisconnected();
 
-    bool processRequest(Control::Command command, const QVariantList &args);
+    bool processRequest(Control::Command command, const QVariantList &args, quint32 requestId);
 
 private:
     static QString getServerName(bool isService = false);
@@ -1,17 +1,18 @@
 #include "controlworker.h"
 
-#include <QDataStream>
 #include <QLocalSocket>
 #include <QLoggingCategory>
 #include <QTimer>
 
+#include "controlargs.h"
+
 namespace {
 
 const QLoggingCategory LC("controlWorker");
 
-constexpr int commandMaxArgs = 32;
 constexpr int commandArgMaxSize = 4 * 1024;
-constexpr quint32 dataMaxSize = 1 * 1024 * 1024;
+static_assert(Control::Rpc_TaskManager_zonesDownloaded < 0x80, "Command must fit in 7 bits");
+static_assert(ControlWorker::chunkMaxSize < (1 << 23), "Chunk size must fit in 23 bits");
 
 quint32 nextWorkerId()
 {
@@ -21,29 +22,21 @@ quint32 nextWorkerId()
 
 bool buildArgsData(QByteArray &buffer, const QVariantList &args, bool &compressed)
 {
-    const int argsCount = args.count();
-    if (argsCount == 0)
-        return true;
-
-    if (argsCount > commandMaxArgs) {
-        qCWarning(LC) << "Bad build args count:" << argsCount;
-        return false;
-    }
-
     QByteArray data;
-    {
-        QDataStream stream(&data, QDataStream::WriteOnly);
+    int textSize = 0;
+    if (!ControlArgs::write(data, args, textSize))
+        return false;
 
-        stream << qint8(argsCount);
+    compressed = false;
+    buffer = ControlArgs::isCompressible(data.size(), textSize)
+            ? ControlArgs::compress(data, compressed)
+            : std::move(data);
 
-        for (const auto &arg : args) {
-            stream << arg;
-        }
+    if (buffer.size() > ControlWorker::dataMaxSize) {
+        qCWarning(LC) << "Bad build args size:" << buffer.size();
+        return false;
     }
 
-    compressed = (data.size() > 128);
-    buffer = compressed ? qCompress(data) : std::move(data);
-
     return true;
 }
 
@@ -52,26 +45,13 @@ bool parseArgsData(const QByteArray &buffer, QVariantList &args, bool compressed
     if (buffer.isEmpty())
         return true;
 
-    const QByteArray data = compressed ? qUncompress(buffer) : buffer;
-
-    QDataStream stream(data);
-
-    qint8 argsCount;
-    stream >> argsCount;
-
-    if (argsCount > commandMaxArgs) {
-        qCWarning(LC) << "Bad parse args count:" << argsCount;
+    const QByteArray data = ControlArgs::uncompress(buffer, compressed);
+    if (data.isEmpty()) {
+        qCWarning(LC) << "Bad parse args: uncompress";
         return false;
     }
 
-    while (--argsCount >= 0) {
-        QVariant arg;
-        stream >> arg;
-
-        args.append(arg);
-    }
-
-    return true;
+    return ControlArgs::read(data, args);
 }
 
 }
@@ -204,18 +184,33 @@ void ControlWorker::stopReconnectTimer()
     }
 }
 
-QByteArray ControlWorker::buildCommandData(Control::Command command, const QVariantList &args)
+QByteArray ControlWorker::buildCommandData(
+        Control::Command command, const QVariantList &args, quint32 requestId)
 {
     QByteArray data;
     bool compressed = false;
     if (!buildArgsData(data, args, compressed))
         return {};
 
-    RequestHeader request(command, compressed, data.size());
+    const int dataSize = data.size();
+    const int chunksCount = qMax(1, (dataSize + chunkMaxSize - 1) / chunkMaxSize);
 
     QByteArray buffer;
-    buffer.append((const char *) &request, sizeof(RequestHeader));
-    buffer.append(data);
+    buffer.reserve(dataSize + chunksCount * int(sizeof(RequestHeader)));
+
+    // Split big data to chunks
+    int offset = 0;
+    do {
+        const int chunkSize = qMin(dataSize - offset, chunkMaxSize);
+        const bool hasNextChunk = (offset + chunkSize < dataSize);
+
+        const RequestHeader request(command, compressed, chunkSize, requestId, hasNextChunk);
+
+        buffer.append((const char *) &request, sizeof(RequestHeader));
+        buffer.append(data.constData() + offset, chunkSize);
+
+        offset += chunkSize;
+    } while (offset < dataSize);
 
     return buffer;
 }
@@ -239,11 +234,12 @@ bool ControlWorker::sendCommandData(const QByteArray &commandData)
     return true;
 }
 
-bool ControlWorker::sendCommand(Control::Command command, const QVariantList &args)
+bool ControlWorker::sendCommand(
+        Control::Command command, const QVariantList &args, quint32 requestId)
 {
-    // DBG: qCDebug(LC) << "Send Command: id:" << id() << command << args.size();
+    // DBG: qCDebug(LC) << "Send Command: id:" << id() << command << args.size() << requestId;
 
-    const QByteArray buffer = buildCommandData(command, args);
+    const QByteArray buffer = buildCommandData(command, args, requestId);
     if (buffer.isEmpty()) {
         qCWarning(LC) << "Bad RPC command to send:" << command << args;
         return false;
@@ -262,9 +258,9 @@ bool ControlWorker::postCommand(Control::Command command, const QVariantList &ar
     return true;
 }
 
-bool ControlWorker::sendResult(bool ok, const QVariantList &args)
+bool ControlWorker::sendResult(bool ok, const QVariantList &args, quint32 requestId)
 {
-    return sendCommand(ok ? Control::Rpc_Result_Ok : Control::Rpc_Result_Error, args);
+    return sendCommand(ok ? Control::Rpc_Result_Ok : Control::Rpc_Result_Error, args, requestId);
 }
 
 bool ControlWorker::waitResult(Control::Command &resultCommand, int msecs) const
@@ -296,7 +292,7 @@ void ControlWorker::processRequest()
 {
     ++m_processing;
 
-    while (socket()->bytesAvailable() >= int(sizeof(RequestHeader))) {
+    while (canReadRequest()) {
         if (!readRequest()) {
             close();
             clearRequest();
@@ -311,9 +307,21 @@ void ControlWorker::processRequest()
     }
 }
 
+bool ControlWorker::canReadRequest() const
+{
+    const qint64 bytesAvailable = socket()->bytesAvailable();
+
+    if (m_requestHeader.command() == Control::CommandNone)
+        return bytesAvailable >= qint64(sizeof(RequestHeader));
+
+    return bytesAvailable > 0;
+}
+
 void ControlWorker::clearRequest()
 {
     m_requestHeader.clear();
+    m_chunkHeader.clear();
+    m_requestDataSize = 0;
     m_requestBuffer.clear();
 }
 
@@ -322,7 +330,7 @@ bool ControlWorker::readRequest()
     if (m_requestHeader.command() == Control::CommandNone && !readRequestHeader())
         return false;
 
-    const int bytesNeeded = m_requestHeader.dataSize() - m_requestBuffer.size();
+    const int bytesNeeded = m_requestDataSize - m_requestBuffer.size();
     if (bytesNeeded > 0) {
         if (socket()->bytesAvailable() == 0)
             return true; // need more data
@@ -339,17 +347,24 @@ bool ControlWorker::readRequest()
             return true; // need more data
     }
 
+    if (m_requestHeader.hasNextChunk()) {
+        m_chunkHeader = m_requestHeader;
+        m_requestHeader.clear();
+        return true; // need next chunk
+    }
+
     QVariantList args;
     if (!parseArgsData(m_requestBuffer, args, m_requestHeader.compressed()))
         return false;
 
     const Control::Command command = m_requestHeader.command();
+    const quint32 requestId = m_requestHeader.requestId();
 
     clearRequest();
 
-    // DBG: qCDebug(LC) << "requestReady>" << id() << command << args;
+    // DBG: qCDebug(LC) << "requestReady>" << id() << command << args << requestId;
 
-    emit requestReady(command, args);
+    emit requestReady(command, args, requestId);
 
     return true;
 }
@@ -363,12 +378,32 @@ bool ControlWorker::readRequestHeader()
     }
 
     if (m_requestHeader.command() == Control::CommandNone
-            || m_requestHeader.dataSize() > dataMaxSize) {
+            || m_requestHeader.dataSize() > quint32(chunkMaxSize)) {
         qCWarning(LC) << "Bad request:" << "command=" << m_requestHeader.command()
                       << "size=" << m_requestHeader.dataSize();
         return false;
     }
 
+    // Next chunk of the request
+    if (m_chunkHeader.command() != Control::CommandNone) {
+        if (m_requestHeader.command() != m_chunkHeader.command()
+                || m_requestHeader.requestId() != m_chunkHeader.requestId()
+                || m_requestHeader.compressed() != m_chunkHeader.compressed()) {
+            qCWarning(LC) << "Bad request chunk:" << "command=" << m_requestHeader.command();
+            return false;
+        }
+
+        m_chunkHeader.clear();
+    }
+
+    m_requestDataSize += m_requestHeader.dataSize();
+
+    if (m_requestDataSize > dataMaxSize) {
+        qCWarning(LC) << "Bad request:" << "command=" << m_requestHeader.command()
+                      << "total size=" << m_requestDataSize;
+        return false;
+    }
+
     return true;
 }
 
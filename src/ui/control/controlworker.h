@@ -14,6 +14,9 @@ class ControlWorker : public QObject
     Q_OBJECT
 
 public:
+    static constexpr int chunkMaxSize = 1 * 1024 * 1024;
+    static constexpr int dataMaxSize = 64 * 1024 * 1024; // of all chunks
+
     explicit ControlWorker(QLocalSocket *socket, QObject *parent = nullptr);
 
     bool isServiceClient() const { return m_isServiceClient; }
@@ -41,13 +44,15 @@ public:
     bool connectToServer();
     bool reconnectToServer();
 
-    static QByteArray buildCommandData(Control::Command command, const QVariantList &args = {});
+    static QByteArray buildCommandData(
+            Control::Command command, const QVariantList &args = {}, quint32 requestId = 0);
     bool sendCommandData(const QByteArray &commandData);
 
-    bool sendCommand(Control::Command command, const QVariantList &args = {});
+    bool sendCommand(
+            Control::Command command, const QVariantList &args = {}, quint32 requestId = 0);
     bool postCommand(Control::Command command, const QVariantList &args = {});
 
-    bool sendResult(bool ok, const QVariantList &args = {});
+    bool sendResult(bool ok, const QVariantList &args = {}, quint32 requestId = 0);
     bool waitResult(Control::Command &resultCommand, int msecs = 700) const;
 
     bool waitForSent(int msecs = 700) const;
@@ -58,7 +63,7 @@ public:
 signals:
     void connected();
     void disconnected();
-    void requestReady(Control::Command command, const QVariantList &args);
+    void requestReady(Control::Command command, const QVariantList &args, quint32 requestId);
 
 public slots:
     void close();
@@ -73,6 +78,8 @@ private slots:
     void processRequest();
 
 private:
+    bool canReadRequest() const;
+
     void clearRequest();
     bool readRequest();
 
@@ -82,26 +89,38 @@ protected:
     struct RequestHeader
     {
         RequestHeader(Control::Command command = Control::CommandNone, bool compressed = false,
-                quint32 dataSize = 0) :
-            m_command(command), m_compressed(compressed), m_dataSize(dataSize)
+                quint32 dataSize = 0, quint32 requestId = 0, bool hasNextChunk = false) :
+            m_command(command),
+            m_compressed(compressed),
+            m_hasNextChunk(hasNextChunk),
+            m_dataSize(dataSize),
+            m_requestId(requestId)
         {
         }
 
         Control::Command command() const { return static_cast<Control::Command>(m_command); }
         bool compressed() const { return m_compressed; }
-        quint32 dataSize() const { return m_dataSize; }
+        bool hasNextChunk() const { return m_hasNextChunk; }
+        quint32 dataSize() const { return m_dataSize; } // of the chunk
+
+        // Request's results are tagged with its id; zero for untagged commands
+        quint32 requestId() const { return m_requestId; }
 
         void clear()
         {
             m_command = Control::CommandNone;
             m_compressed = false;
+            m_hasNextChunk = false;
             m_dataSize = 0;
+            m_requestId = 0;
         }
 
     private:
         quint32 m_command : 7;
         quint32 m_compressed : 1;
-        quint32 m_dataSize : 24;
+        quint32 m_hasNextChunk : 1;
+        quint32 m_dataSize : 23;
+        quint32 m_requestId;
     };
 
 private:
@@ -115,6 +134,9 @@ private:
     const quint32 m_id = 0;
 
     RequestHeader m_requestHeader;
+    RequestHeader m_chunkHeader; // previous chunk's header
+
+    int m_requestDataSize = 0;
     QByteArray m_requestBuffer;
 
     QString m_serverName;
@@ -1,6 +1,7 @@
 #include "drivercommon.h"
 
 #include <common/fortconf.h>
+#include <common/fortdef.h>
 #include <common/fortioctl.h>
 #include <common/fortlog.h>
 #include <common/fortprov.h>
@@ -67,6 +68,16 @@ quint32 ioctlSetRuleFlag()
     return FORT_IOCTL_SETRULEFLAG;
 }
 
+quint32 ioctlAddApps()
+{
+    return FORT_IOCTL_ADDAPPS;
+}
+
+quint32 ioctlGetStats()
+{
+    return FORT_IOCTL_GETSTATS;
+}
+
 quint32 userErrorCode()
 {
     return FORT_ERROR_USER_ERROR;
@@ -137,6 +148,11 @@ quint32 logTimeSize()
     return FORT_LOG_TIME_SIZE;
 }
 
+quint32 logDroppedSize()
+{
+    return FORT_LOG_DROPPED_SIZE;
+}
+
 quint8 logType(const char *input)
 {
     return fort_log_type(input);
@@ -187,6 +203,21 @@ void logTimeRead(const char *input, int *systemTimeChanged, qint64 *unixTime)
     fort_log_time_read(input, systemTimeChanged, unixTime);
 }
 
+void logDroppedWrite(char *output, const quint32 *droppedCounts)
+{
+    fort_log_dropped_write(output, droppedCounts);
+}
+
+void logDroppedRead(const char *input, quint32 *droppedCounts)
+{
+    fort_log_dropped_read(input, droppedCounts);
+}
+
+bool addrListIpInRange(const void *addrList, const ip_addr_t ip, bool isIPv6)
+{
+    return fort_conf_ip_inlist(PCFORT_CONF_ADDR_LIST(addrList), ip, isIPv6);
+}
+
 bool confIpInRange(
         const void *drvConf, const ip_addr_t ip, bool isIPv6, bool included, int addrGroupIndex)
 {
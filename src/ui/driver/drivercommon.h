@@ -20,6 +20,8 @@ quint32 ioctlSetZones();
 quint32 ioctlSetZoneFlag();
 quint32 ioctlSetRules();
 quint32 ioctlSetRuleFlag();
+quint32 ioctlAddApps();
+quint32 ioctlGetStats();
 
 quint32 userErrorCode();
 
@@ -44,6 +46,8 @@ quint32 logStatSize(quint16 procCount);
 
 quint32 logTimeSize();
 
+quint32 logDroppedSize();
+
 quint8 logType(const char *input);
 
 void logAppHeaderWrite(char *output, bool blocked, quint32 pid, quint16 pathLen);
@@ -60,6 +64,11 @@ void logStatTrafHeaderRead(const char *input, quint16 *procCount);
 void logTimeWrite(char *output, int systemTimeChanged, qint64 unixTime);
 void logTimeRead(const char *input, int *systemTimeChanged, qint64 *unixTime);
 
+void logDroppedWrite(char *output, const quint32 *droppedCounts);
+void logDroppedRead(const char *input, quint32 *droppedCounts);
+
+bool addrListIpInRange(const void *addrList, const ip_addr_t ip, bool isIPv6 = false);
+
 bool confIpInRange(const void *drvConf, const ip_addr_t ip, bool isIPv6 = false,
         bool included = false, int addrGroupIndex = 0);
 bool confIp4InRange(const void *drvConf, quint32 ip, bool included = false, int addrGroupIndex = 0);
@@ -2,8 +2,11 @@
 
 #include <QLoggingCategory>
 #include <QProcess>
+#include <QStringList>
 #include <QThreadPool>
 
+#include <common/fortperf.h>
+
 #include <conf/firewallconf.h>
 #include <driver/drivercommon.h>
 #include <util/fileutil.h>
@@ -13,6 +16,90 @@ namespace {
 
 const QLoggingCategory LC("driver.manager");
 
+const char *const calloutNames[FORT_PERF_CALLOUT_COUNT] = {
+    "connect-v4",
+    "connect-v6",
+    "accept-v4",
+    "accept-v6",
+    "transport-in",
+    "transport-out",
+};
+
+const char *const lockNames[FORT_PERF_LOCK_COUNT] = {
+    "stat",
+    "buffer",
+    "shaper",
+};
+
+QString calloutStatsText(const char *name, const FORT_PERF_CALLOUT &callout)
+{
+    const quint64 avg = (callout.count == 0) ? 0 : callout.time_sum / callout.count;
+
+    return QString("  %1: count=%2 avg=%3ns p50<=%4ns p99<=%5ns max=%6ns")
+            .arg(name)
+            .arg(callout.count)
+            .arg(avg)
+            .arg(fort_perf_callout_percentile(&callout, 500))
+            .arg(fort_perf_callout_percentile(&callout, 990))
+            .arg(callout.time_max);
+}
+
+QString lockStatsText(const char *name, const FORT_PERF_LOCK &lock)
+{
+    const double percent =
+            (lock.acquire_count == 0) ? 0 : 100.0 * lock.contend_count / lock.acquire_count;
+
+    return QString("  %1: acquired=%2 contended=%3 (%4%)")
+            .arg(name)
+            .arg(lock.acquire_count)
+            .arg(lock.contend_count)
+            .arg(percent, 0, 'f', 2);
+}
+
+QStringList statsLines(const FORT_PERF_STATS &stats)
+{
+    QStringList lines;
+
+    lines << QString("CPUs: %1").arg(stats.cpu_count);
+
+    lines << "Callouts:";
+    for (int i = 0; i < FORT_PERF_CALLOUT_COUNT; ++i) {
+        lines << calloutStatsText(calloutNames[i], stats.callouts[i]);
+    }
+
+    lines << "Locks:";
+    for (int i = 0; i < FORT_PERF_LOCK_COUNT; ++i) {
+        lines << lockStatsText(lockNames[i], stats.locks[i]);
+    }
+
+    lines << "Shaper queues:";
+    for (int i = 0; i < FORT_PERF_QUEUE_MAX; ++i) {
+        const FORT_PERF_QUEUE &queue = stats.queues[i];
+        if (queue.drop_count == 0 && queue.queued_max == 0)
+            continue;
+
+        lines << QString("  group %1 %2: dropped=%3 queued-max=%4 bytes")
+                         .arg(i / 2 + 1)
+                         .arg((i % 2) == 0 ? "in" : "out")
+                         .arg(queue.drop_count)
+                         .arg(queue.queued_max);
+    }
+
+    lines << QString("Buffer: high-water=%1 bytes irp-waits=%2")
+                     .arg(stats.buffer_high_water)
+                     .arg(stats.buffer_irp_waits);
+
+    lines << QString("Reauth: skipped=%1 evaluated=%2")
+                     .arg(stats.reauth_skipped_count)
+                     .arg(stats.reauth_evaluated_count);
+
+    lines << QString("Address cache: hits=%1 misses=%2")
+                     .arg(stats.addr_cache_hit_count)
+                     .arg(stats.addr_cache_miss_count);
+
+    return lines;
+}
+
 }
 
 DriverManager::DriverManager(QObject *parent, bool useDevice) : QObject(parent)
@@ -116,6 +203,11 @@ bool DriverManager::writeApp(QByteArray &buf, bool remove)
     return writeData(remove ? DriverCommon::ioctlDelApp() : DriverCommon::ioctlAddApp(), buf);
 }
 
+bool DriverManager::writeApps(QByteArray &buf)
+{
+    return writeData(DriverCommon::ioctlAddApps(), buf);
+}
+
 bool DriverManager::writeZones(QByteArray &buf, bool onlyFlags)
 {
     const auto code = onlyFlags ? DriverCommon::ioctlSetZoneFlag() : DriverCommon::ioctlSetZones();
@@ -130,6 +222,27 @@ bool DriverManager::writeRules(QByteArray &buf, bool onlyFlags)
     return writeData(code, buf);
 }
 
+bool DriverManager::readStats(QByteArray &buf)
+{
+    buf.resize(sizeof(FORT_PERF_STATS));
+
+    return readData(DriverCommon::ioctlGetStats(), buf)
+            && buf.size() == qsizetype(sizeof(FORT_PERF_STATS));
+}
+
+QString DriverManager::statsText()
+{
+    QByteArray buf;
+    if (!readStats(buf)) {
+        qCWarning(LC) << "Driver statistics error:" << errorMessage();
+        return {};
+    }
+
+    const auto &stats = *reinterpret_cast<const FORT_PERF_STATS *>(buf.constData());
+
+    return statsLines(stats).join('\n');
+}
+
 bool DriverManager::writeData(quint32 code, QByteArray &buf)
 {
     if (!isDeviceOpened())
@@ -148,6 +261,27 @@ bool DriverManager::writeData(quint32 code, QByteArray &buf)
     return ok;
 }
 
+bool DriverManager::readData(quint32 code, QByteArray &buf)
+{
+    if (!isDeviceOpened())
+        return false;
+
+    const bool wasCancelled = driverWorker()->cancelAsyncIo();
+
+    qsizetype retSize = 0;
+    const bool ok = device().ioctl(code, nullptr, 0, buf.data(), buf.size(), &retSize);
+
+    updateErrorCode(ok);
+
+    if (wasCancelled) {
+        driverWorker()->continueAsyncIo();
+    }
+
+    buf.resize(ok ? retSize : 0);
+
+    return ok;
+}
+
 bool DriverManager::checkReinstallDriver()
 {
     return executeCommand("check-reinstall.bat");
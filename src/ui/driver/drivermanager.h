@@ -49,9 +49,14 @@ public slots:
     bool writeServices(QByteArray &buf);
     bool writeConf(QByteArray &buf, bool onlyFlags = false);
     bool writeApp(QByteArray &buf, bool remove = false);
+    bool writeApps(QByteArray &buf);
     bool writeZones(QByteArray &buf, bool onlyFlags = false);
     bool writeRules(QByteArray &buf, bool onlyFlags = false);
 
+    bool readStats(QByteArray &buf);
+
+    QString statsText();
+
 protected:
     void setErrorCode(quint32 v);
 
@@ -62,6 +67,7 @@ private:
     void closeWorker();
 
     bool writeData(quint32 code, QByteArray &buf);
+    bool readData(quint32 code, QByteArray &buf);
 
     static bool executeCommand(const QString &fileName);
 
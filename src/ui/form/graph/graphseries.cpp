@@ -0,0 +1,202 @@
+#include "graphseries.h"
+
+void GraphBucket::addValue(double value)
+{
+    if (count == 0 || value < minValue) {
+        minValue = value;
+    }
+    if (count == 0 || value > maxValue) {
+        maxValue = value;
+    }
+
+    sumValue += value;
+    ++count;
+}
+
+void GraphBucket::addBucket(const GraphBucket &bucket)
+{
+    if (bucket.count == 0)
+        return;
+
+    if (count == 0 || bucket.minValue < minValue) {
+        minValue = bucket.minValue;
+    }
+    if (count == 0 || bucket.maxValue > maxValue) {
+        maxValue = bucket.maxValue;
+    }
+
+    sumValue += bucket.sumValue;
+    count += bucket.count;
+}
+
+const GraphBucket &GraphSeries::Level::at(int index) const
+{
+    return ring.at((first + index) % ring.size());
+}
+
+GraphBucket &GraphSeries::Level::last()
+{
+    return ring[(first + count - 1) % ring.size()];
+}
+
+void GraphSeries::Level::append(const GraphBucket &bucket)
+{
+    if (count < ring.size()) {
+        ++count;
+    } else {
+        first = (first + 1) % ring.size(); // overwrite the oldest bucket
+    }
+
+    last() = bucket;
+}
+
+void GraphSeries::Level::reset(int capacity)
+{
+    first = 0;
+    count = 0;
+    ring.resize(capacity);
+}
+
+GraphSeries::GraphSeries(int maxSeconds)
+{
+    setMaxSeconds(maxSeconds);
+}
+
+void GraphSeries::setMaxSeconds(int v)
+{
+    v = qMax(v, 1);
+
+    if (m_maxSeconds == v)
+        return;
+
+    m_maxSeconds = v;
+
+    // The partial buckets at both ends need 2 more slots
+    for (int level = 0; level < levelCount; ++level) {
+        const int capacity = int(m_maxSeconds / levelSpan(level)) + 2;
+
+        m_levels[level].reset(capacity);
+    }
+}
+
+qint64 GraphSeries::lastTime() const
+{
+    const Level &level0 = m_levels[0];
+
+    return isEmpty() ? 0 : level0.at(level0.count - 1).time;
+}
+
+double GraphSeries::lastValue() const
+{
+    const Level &level0 = m_levels[0];
+
+    return isEmpty() ? 0 : level0.at(level0.count - 1).sumValue;
+}
+
+void GraphSeries::addValue(qint64 unixTime, double value)
+{
+    Level &level0 = m_levels[0];
+
+    if (!isEmpty()) {
+        const qint64 lastTime = this->lastTime();
+
+        // Add to the current second
+        if (unixTime == lastTime) {
+            GraphBucket &bucket = level0.last();
+            bucket.sumValue += value;
+            bucket.minValue = bucket.maxValue = bucket.sumValue;
+            return;
+        }
+
+        // The clock was changed or all samples are out of date
+        if (unixTime < lastTime || unixTime - lastTime > m_maxSeconds) {
+            clear();
+        } else {
+            closeLastSecond();
+        }
+    }
+
+    GraphBucket bucket = { .time = unixTime };
+    bucket.addValue(value);
+
+    level0.append(bucket);
+}
+
+void GraphSeries::clear()
+{
+    for (Level &level : m_levels) {
+        level.first = 0;
+        level.count = 0;
+    }
+}
+
+QVector<GraphBucket> GraphSeries::buckets(int level, qint64 timeFrom) const
+{
+    level = qBound(0, level, levelCount - 1);
+
+    const Level &l = m_levels[level];
+    const qint64 span = levelSpan(level);
+
+    QVector<GraphBucket> list;
+    list.reserve(l.count + 1);
+
+    for (int i = 0; i < l.count; ++i) {
+        const GraphBucket &bucket = l.at(i);
+
+        if (bucket.time + span > timeFrom) {
+            list.append(bucket);
+        }
+    }
+
+    // The current second isn't closed yet
+    if (level > 0 && !isEmpty()) {
+        const Level &level0 = m_levels[0];
+        const GraphBucket &bucket0 = level0.at(level0.count - 1);
+
+        const qint64 bucketTime = bucket0.time & ~(span - 1);
+
+        if (!list.isEmpty() && list.last().time == bucketTime) {
+            list.last().addBucket(bucket0);
+        } else {
+            GraphBucket bucket = { .time = bucketTime };
+            bucket.addBucket(bucket0);
+
+            list.append(bucket);
+        }
+    }
+
+    return list;
+}
+
+int GraphSeries::levelForWidth(qint64 duration, int barCount)
+{
+    barCount = qMax(barCount, 1);
+
+    int level = 0;
+    while (level < levelCount - 1 && duration > barCount * levelSpan(level)) {
+        ++level;
+    }
+
+    return level;
+}
+
+void GraphSeries::closeLastSecond()
+{
+    const Level &level0 = m_levels[0];
+    const GraphBucket &bucket0 = level0.at(level0.count - 1);
+
+    for (int level = 1; level < levelCount; ++level) {
+        Level &l = m_levels[level];
+
+        const qint64 bucketTime = bucket0.time & ~(levelSpan(level) - 1);
+
+        if (l.count > 0 && l.last().time == bucketTime) {
+            l.last().addBucket(bucket0);
+        } else {
+            GraphBucket bucket = { .time = bucketTime };
+            bucket.addBucket(bucket0);
+
+            l.append(bucket);
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef GRAPHSERIES_H
+#define GRAPHSERIES_H
+
+#include <QVector>
+
+struct GraphBucket
+{
+    double avgValue() const { return count > 0 ? sumValue / count : 0; }
+
+    void addValue(double value);
+    void addBucket(const GraphBucket &bucket);
+
+    qint64 time = 0; // start of the bucket
+    double minValue = 0;
+    double maxValue = 0;
+    double sumValue = 0;
+    int count = 0;
+};
+
+// Samples of the last seconds, kept in fixed-capacity ring buffers of several resolutions:
+// a bucket of the level N spans 2^N seconds.
+class GraphSeries
+{
+public:
+    static constexpr int levelCount = 14; // up to 8192 seconds per bucket
+
+    explicit GraphSeries(int maxSeconds = 500);
+
+    int maxSeconds() const { return m_maxSeconds; }
+    void setMaxSeconds(int v);
+
+    bool isEmpty() const { return m_levels[0].count == 0; }
+
+    qint64 lastTime() const;
+    double lastValue() const;
+
+    void addValue(qint64 unixTime, double value);
+
+    void clear();
+
+    QVector<GraphBucket> buckets(int level, qint64 timeFrom) const;
+
+    static qint64 levelSpan(int level) { return qint64(1) << level; }
+    static int levelForWidth(qint64 duration, int barCount);
+
+private:
+    struct Level
+    {
+        const GraphBucket &at(int index) const;
+        GraphBucket &last();
+
+        void append(const GraphBucket &bucket);
+        void reset(int capacity);
+
+        int first = 0;
+        int count = 0;
+        QVector<GraphBucket> ring;
+    };
+
+    void closeLastSecond();
+
+private:
+    int m_maxSeconds = 0;
+
+    Level m_levels[levelCount];
+};
+
+#endif // GRAPHSERIES_H
@@ -6,6 +6,7 @@
 #include <QVBoxLayout>
 
 #include <conf/confmanager.h>
+#include <conf/firewallconf.h>
 #include <form/controls/controlutil.h>
 #include <user/iniuser.h>
 #include <util/dateutil.h>
@@ -20,6 +21,8 @@ namespace {
 
 constexpr int stickyDistance = 30;
 
+constexpr qint64 trafficPeriodMinMsecs = 100;
+
 inline void checkWindowHorizontalEdges(const QRect &screenRect, const QRect &winRect, QPoint &diff)
 {
     const int leftDiff = screenRect.x() - winRect.x();
@@ -46,39 +49,6 @@ inline void checkWindowVerticalEdges(const QRect &screenRect, const QRect &winRe
     }
 }
 
-bool clearGraphData(
-        const QSharedPointer<QCPBarsDataContainer> &data, double rangeLowerKey, double unixTimeKey)
-{
-    if (data->isEmpty())
-        return true;
-
-    const auto hi = data->constEnd() - 1;
-    if (rangeLowerKey > hi->mainKey() || unixTimeKey < hi->mainKey()) {
-        data->clear();
-        return true;
-    }
-
-    const auto lo = data->constBegin();
-    if (lo->mainKey() < rangeLowerKey) {
-        data->removeBefore(rangeLowerKey);
-    }
-
-    return data->isEmpty();
-}
-
-void adjustGraphData(
-        const QSharedPointer<QCPBarsDataContainer> &data, double unixTimeKey, quint32 &bits)
-{
-    const auto hi = data->constEnd() - 1;
-
-    // Check existing key
-    if (qFuzzyCompare(unixTimeKey, hi->mainKey())) {
-        bits += quint32(hi->mainValue());
-    }
-
-    data->removeAfter(unixTimeKey);
-}
-
 QPen adjustPen(const QPen &pen, const QColor &color)
 {
     QPen newPen(pen);
@@ -339,6 +309,8 @@ void GraphWindow::setupTimer()
     m_updateTimer.setInterval(1000); // 1 second
 
     m_updateTimer.start();
+
+    m_heldTimer.start();
 }
 
 void GraphWindow::onMouseDoubleClick(QMouseEvent *event)
@@ -450,6 +422,52 @@ void GraphWindow::checkHoverLeave()
 }
 
 void GraphWindow::addTraffic(qint64 unixTime, quint32 inBytes, quint32 outBytes)
+{
+    // The rest of the previous record is shown at once
+    const double inBits = m_heldInBits;
+    const double outBits = m_heldOutBits;
+
+    // The driver flushes the traffic each 0.5-2 seconds: show it evenly over the period
+    m_heldMsecs = trafficPeriodMsecs();
+    m_heldInBits = double(inBytes) * 8;
+    m_heldOutBits = double(outBytes) * 8;
+
+    m_heldTimer.start();
+
+    addTrafficBits(unixTime, inBits, outBits);
+}
+
+void GraphWindow::addEmptyTraffic()
+{
+    // Show the part of held traffic for the elapsed time
+    const qint64 msecs = qMin(m_heldTimer.restart(), m_heldMsecs);
+    const double ratio = (m_heldMsecs > 0) ? double(msecs) / m_heldMsecs : 0;
+
+    const double inBits = m_heldInBits * ratio;
+    const double outBits = m_heldOutBits * ratio;
+
+    m_heldMsecs -= msecs;
+    m_heldInBits -= inBits;
+    m_heldOutBits -= outBits;
+
+    addTrafficBits(DateUtil::getUnixTime(), inBits, outBits);
+}
+
+qint64 GraphWindow::trafficPeriodMsecs()
+{
+    if (!m_trafficTimer.isValid()) {
+        m_trafficTimer.start();
+        return m_updateTimer.interval();
+    }
+
+    const qint64 periodMaxMsecs = confManager()->conf()->ini().statFlushPeriodMax();
+
+    // No traffic is flushed while idle
+    return qBound(trafficPeriodMinMsecs, m_trafficTimer.restart(),
+            qMax(periodMaxMsecs, trafficPeriodMinMsecs));
+}
+
+void GraphWindow::addTrafficBits(qint64 unixTime, double inBits, double outBits)
 {
     if (m_lastUnixTime != unixTime) {
         m_lastUnixTime = unixTime;
@@ -457,15 +475,26 @@ void GraphWindow::addTraffic(qint64 unixTime, quint32 inBytes, quint32 outBytes)
         updateSpeed();
     }
 
-    const qint64 rangeLower = unixTime - iniUser()->graphWindowMaxSeconds();
+    const int maxSeconds = iniUser()->graphWindowMaxSeconds();
 
-    const double rangeLowerKey = double(rangeLower);
-    const double unixTimeKey = double(unixTime);
+    m_seriesIn.setMaxSeconds(maxSeconds);
+    m_seriesOut.setMaxSeconds(maxSeconds);
+
+    m_seriesIn.addValue(unixTime, inBits);
+    m_seriesOut.addValue(unixTime, outBits);
+
+    // Show the retained seconds by coarser bars, when they don't fit the width
+    const int barCount = qMax(qFloor(m_plot->axisRect()->width() / 4), 1);
+    const int level = GraphSeries::levelForWidth(maxSeconds, barCount);
+    const qint64 timeFrom = unixTime - maxSeconds;
 
-    addData(m_graphIn, rangeLowerKey, unixTimeKey, inBytes);
-    addData(m_graphOut, rangeLowerKey, unixTimeKey, outBytes);
+    updateGraphData(m_graphIn, m_seriesIn, level, timeFrom);
+    updateGraphData(m_graphOut, m_seriesOut, level, timeFrom);
 
-    m_plot->xAxis->setRange(unixTimeKey, qFloor(m_plot->axisRect()->width() / 4), Qt::AlignRight);
+    const double unixTimeKey = double(unixTime);
+    const double rangeSize = double(barCount * GraphSeries::levelSpan(level));
+
+    m_plot->xAxis->setRange(unixTimeKey, rangeSize, Qt::AlignRight);
 
     m_graphIn->rescaleValueAxis(false, true);
     m_graphOut->rescaleValueAxis(true, true);
@@ -495,22 +524,20 @@ void GraphWindow::addTraffic(qint64 unixTime, quint32 inBytes, quint32 outBytes)
     m_plot->replot();
 }
 
-void GraphWindow::addEmptyTraffic()
+void GraphWindow::updateGraphData(
+        QCPBars *graph, const GraphSeries &series, int level, qint64 timeFrom)
 {
-    addTraffic(DateUtil::getUnixTime(), 0, 0);
-}
+    const QVector<GraphBucket> buckets = series.buckets(level, timeFrom);
 
-void GraphWindow::addData(QCPBars *graph, double rangeLowerKey, double unixTimeKey, quint32 bytes)
-{
-    auto data = graph->data();
-    quint32 bits = bytes * 8;
+    // Bars of coarser buckets show the peaks
+    QVector<QCPBarsData> dataList;
+    dataList.reserve(buckets.size());
 
-    if (!clearGraphData(data, rangeLowerKey, unixTimeKey)) {
-        adjustGraphData(data, unixTimeKey, bits);
+    for (const GraphBucket &bucket : buckets) {
+        dataList.append(QCPBarsData(double(bucket.time), bucket.maxValue));
     }
 
-    // Add data
-    data->add(QCPBarsData(unixTimeKey, bits));
+    graph->data()->set(dataList, /*alreadySorted=*/true);
 }
 
 void GraphWindow::updateSpeed()
@@ -534,10 +561,8 @@ void GraphWindow::updateSpeed()
 
 QString GraphWindow::getSpeedText() const
 {
-    const auto inBits =
-            m_graphIn->data()->isEmpty() ? 0 : (m_graphIn->data()->constEnd() - 1)->mainValue();
-    const auto outBits =
-            m_graphOut->data()->isEmpty() ? 0 : (m_graphOut->data()->constEnd() - 1)->mainValue();
+    const auto inBits = m_seriesIn.lastValue();
+    const auto outBits = m_seriesOut.lastValue();
 
     return QChar(0x2193) // ↓
             + FormatUtil::formatSpeed(quint64(inBits), m_unitFormat) + "  " + QChar(0x2191) // ↑
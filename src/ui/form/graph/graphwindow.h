@@ -1,11 +1,14 @@
 #ifndef GRAPHWINDOW_H
 #define GRAPHWINDOW_H
 
+#include <QElapsedTimer>
 #include <QTimer>
 
 #include <form/controls/formwindow.h>
 #include <util/formatutil.h>
 
+#include "graphseries.h"
+
 class AxisTickerSpeed;
 
 class ConfManager;
@@ -83,7 +86,10 @@ private:
 
     void setupTimer();
 
-    void addData(QCPBars *graph, double rangeLowerKey, double unixTimeKey, quint32 bytes);
+    qint64 trafficPeriodMsecs();
+    void addTrafficBits(qint64 unixTime, double inBits, double outBits);
+
+    void updateGraphData(QCPBars *graph, const GraphSeries &series, int level, qint64 timeFrom);
 
     void updateSpeed();
     QString getSpeedText() const;
@@ -105,6 +111,17 @@ private:
 
     qint64 m_lastUnixTime = 0;
 
+    // Traffic of the last record, which is not shown yet
+    qint64 m_heldMsecs = 0;
+    double m_heldInBits = 0;
+    double m_heldOutBits = 0;
+
+    QElapsedTimer m_heldTimer;
+    QElapsedTimer m_trafficTimer;
+
+    GraphSeries m_seriesIn;
+    GraphSeries m_seriesOut;
+
     GraphPlot *m_plot = nullptr;
     QSharedPointer<AxisTickerSpeed> m_ticker;
     QCPBars *m_graphIn = nullptr;
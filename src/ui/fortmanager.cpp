@@ -31,6 +31,7 @@
 #include <rpc/dberrormanagerrpc.h>
 #include <rpc/drivelistmanagerrpc.h>
 #include <rpc/drivermanagerrpc.h>
+#include <rpc/hostinfomanagerrpc.h>
 #include <rpc/logmanagerrpc.h>
 #include <rpc/quotamanagerrpc.h>
 #include <rpc/rpcmanager.h>
@@ -72,6 +73,7 @@ inline void setupMasterServices(IocContainer *ioc, const FortSettings *settings)
     ioc->setService(new AutoUpdateManager(settings->updatePath()));
     ioc->setService(new DriverManager());
     ioc->setService(new AppInfoManager(settings->cacheFilePath()));
+    ioc->setService(new HostInfoManager(settings->hostInfoCacheFilePath()));
     ioc->setService(new LogManager());
     ioc->setService(new ServiceInfoManager());
     ioc->setService(new TaskManager());
@@ -93,6 +95,8 @@ inline void setupClientServices(IocContainer *ioc, const FortSettings *settings)
     ioc->setService<DriverManager>(new DriverManagerRpc());
     ioc->setService<AppInfoManager>(
             new AppInfoManagerRpc(settings->cacheFilePath(), settings->noCache()));
+    ioc->setService<HostInfoManager>(
+            new HostInfoManagerRpc(settings->hostInfoCacheFilePath(), settings->noCache()));
     ioc->setService<LogManager>(new LogManagerRpc());
     ioc->setService<ServiceInfoManager>(new ServiceInfoManagerRpc());
     ioc->setService<TaskManager>(new TaskManagerRpc());
@@ -592,6 +596,7 @@ void FortManager::setupResources()
     Q_INIT_RESOURCE(appinfo_migrations);
     Q_INIT_RESOURCE(conf_migrations);
     Q_INIT_RESOURCE(conf_zone);
+    Q_INIT_RESOURCE(hostinfo_migrations);
     Q_INIT_RESOURCE(stat_migrations);
 
     Q_INIT_RESOURCE(fort_icons);
@@ -1,20 +1,28 @@
 #include "hostinfocache.h"
 
+#include <util/ioc/ioccontainer.h>
+
 #include "hostinfomanager.h"
 
-HostInfoCache::HostInfoCache(QObject *parent) :
-    QObject(parent), m_manager(new HostInfoManager(this)), m_cache(1000)
+HostInfoCache::HostInfoCache(QObject *parent) : QObject(parent), m_cache(1000)
 {
-    connect(m_manager, &HostInfoManager::lookupFinished, this,
-            &HostInfoCache::handleFinishedLookup);
+    connect(&m_lookupTimer, &QTimer::timeout, this, &HostInfoCache::lookupHosts);
+    connect(&m_triggerTimer, &QTimer::timeout, this, &HostInfoCache::emitChangedAddresses);
+}
+
+void HostInfoCache::setUp()
+{
+    auto hostInfoManager = IoCDependency<HostInfoManager>();
 
-    connect(&m_triggerTimer, &QTimer::timeout, this, &HostInfoCache::cacheChanged);
+    connect(hostInfoManager, &HostInfoManager::lookupFinished, this,
+            &HostInfoCache::handleFinishedLookup);
+    connect(hostInfoManager, &HostInfoManager::lookupDropped, this,
+            &HostInfoCache::handleDroppedLookup);
 }
 
-HostInfoCache::~HostInfoCache()
+void HostInfoCache::tearDown()
 {
-    clear();
-    close();
+    IoC<HostInfoManager>()->disconnect(this);
 }
 
 QString HostInfoCache::hostName(const QString &address)
@@ -27,25 +35,29 @@ QString HostInfoCache::hostName(const QString &address)
 
     hostInfo = new HostInfo();
 
+    const bool isCached = IoC<HostInfoManager>()->loadHostFromDb(address, hostInfo->hostName);
+    const QString hostName = hostInfo->hostName;
+
     m_cache.insert(address, hostInfo, 1);
     /* hostInfo may be deleted */
 
-    m_manager->lookupHost(address);
+    if (!isCached) {
+        lookupHostLater(address);
+    }
 
-    return {};
+    return hostName;
 }
 
 void HostInfoCache::clear()
 {
-    m_manager->clear();
-    m_cache.clear();
+    const QStringList addresses = m_cache.keys();
 
-    emitCacheChanged();
-}
+    m_lookupAddresses.clear();
+    m_cache.clear();
 
-void HostInfoCache::close()
-{
-    m_manager->abortWorkers();
+    for (const QString &address : addresses) {
+        emitCacheChanged(address);
+    }
 }
 
 void HostInfoCache::handleFinishedLookup(const QString &address, const QString &hostName)
@@ -56,10 +68,48 @@ void HostInfoCache::handleFinishedLookup(const QString &address, const QString &
 
     hostInfo->hostName = hostName;
 
-    emitCacheChanged();
+    emitCacheChanged(address);
 }
 
-void HostInfoCache::emitCacheChanged()
+void HostInfoCache::handleDroppedLookup(const QString &address)
 {
+    // Look up again when the address is requested next time
+    m_cache.remove(address);
+}
+
+void HostInfoCache::lookupHosts()
+{
+    if (m_lookupAddresses.isEmpty())
+        return;
+
+    IoC<HostInfoManager>()->lookupHosts(m_lookupAddresses);
+
+    m_lookupAddresses.clear();
+}
+
+void HostInfoCache::lookupHostLater(const QString &address)
+{
+    // Addresses of the painted rows are requested in a batch
+    m_lookupAddresses.append(address);
+
+    m_lookupTimer.startTrigger();
+}
+
+void HostInfoCache::emitChangedAddresses()
+{
+    if (m_changedAddresses.isEmpty())
+        return;
+
+    const QStringList addresses(m_changedAddresses.constBegin(), m_changedAddresses.constEnd());
+    m_changedAddresses.clear();
+
+    emit cacheChanged(addresses);
+}
+
+void HostInfoCache::emitCacheChanged(const QString &address)
+{
+    // Coalesce the changes until the trigger fires
+    m_changedAddresses.insert(address);
+
     m_triggerTimer.startTrigger();
 }
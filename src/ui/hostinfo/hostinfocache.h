@@ -3,6 +3,7 @@
 
 #include <QCache>
 #include <QObject>
+#include <QSet>
 
 #include <util/ioc/iocservice.h>
 #include <util/triggertimer.h>
@@ -17,10 +18,12 @@ class HostInfoCache : public QObject, public IocService
 
 public:
     explicit HostInfoCache(QObject *parent = nullptr);
-    ~HostInfoCache() override;
+
+    void setUp() override;
+    void tearDown() override;
 
 signals:
-    void cacheChanged();
+    void cacheChanged(const QStringList &addresses);
 
 public slots:
     QString hostName(const QString &address);
@@ -28,18 +31,26 @@ public slots:
     void clear();
 
 private slots:
-    void close();
-
     void handleFinishedLookup(const QString &address, const QString &hostName);
+    void handleDroppedLookup(const QString &address);
 
-private:
-    void emitCacheChanged();
+    void lookupHosts();
+
+    void emitChangedAddresses();
 
 private:
-    HostInfoManager *m_manager = nullptr;
+    void lookupHostLater(const QString &address);
 
+    void emitCacheChanged(const QString &address);
+
+private:
     QCache<QString, HostInfo> m_cache;
 
+    QStringList m_lookupAddresses;
+    TriggerTimer m_lookupTimer;
+
+    QSet<QString> m_changedAddresses;
+
     TriggerTimer m_triggerTimer;
 };
 
@@ -1,15 +1,14 @@
 #include "hostinfojob.h"
 
-#include <util/net/netutil.h>
 #include <util/worker/workerobject.h>
 
 #include "hostinfomanager.h"
 
 HostInfoJob::HostInfoJob(const QString &address) : WorkerJob(address) { }
 
-void HostInfoJob::doJob(WorkerObject & /*worker*/)
+void HostInfoJob::doJob(WorkerObject &worker)
 {
-    m_hostName = NetUtil::getHostName(address());
+    lookupHost(static_cast<HostInfoManager *>(worker.manager()));
 }
 
 void HostInfoJob::reportResult(WorkerObject &worker)
@@ -17,6 +16,22 @@ void HostInfoJob::reportResult(WorkerObject &worker)
     emitFinished(static_cast<HostInfoManager *>(worker.manager()));
 }
 
+void HostInfoJob::reportDropped(WorkerManager &manager)
+{
+    emit static_cast<HostInfoManager &>(manager).lookupDropped(address());
+}
+
+void HostInfoJob::lookupHost(HostInfoManager *manager)
+{
+    // Was it resolved by a previous job?
+    if (manager->loadHostFromDb(address(), m_hostName))
+        return;
+
+    m_hostName = manager->resolveHost(address());
+
+    manager->saveToDb(address(), m_hostName);
+}
+
 void HostInfoJob::emitFinished(HostInfoManager *manager)
 {
     emit manager->lookupFinished(address(), m_hostName);
@@ -12,10 +12,15 @@ public:
 
     QString address() const { return text(); }
 
+    QString mergeKey() const override { return address(); }
+
     void doJob(WorkerObject &worker) override;
     void reportResult(WorkerObject &worker) override;
+    void reportDropped(WorkerManager &manager) override;
 
 private:
+    void lookupHost(HostInfoManager *manager);
+
     void emitFinished(HostInfoManager *manager);
 
 private:
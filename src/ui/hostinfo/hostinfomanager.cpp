@@ -1,15 +1,196 @@
 #include "hostinfomanager.h"
 
+#include <QDateTime>
+#include <QLoggingCategory>
+
+#include <sqlite/dbquery.h>
+#include <sqlite/sqlitedb.h>
+#include <sqlite/sqlitestmt.h>
+
+#include <util/net/netutil.h>
+
 #include "hostinfojob.h"
 
-HostInfoManager::HostInfoManager(QObject *parent) : WorkerManager(parent)
+namespace {
+
+const QLoggingCategory LC("hostInfo");
+
+constexpr int DATABASE_USER_VERSION = 1;
+
+constexpr int HOST_WORKERS_MAX_COUNT = 4;
+constexpr int HOST_JOBS_MAX_COUNT = 1000;
+
+constexpr int HOST_CACHE_MAX_COUNT = 10000;
+constexpr int HOST_PURGE_INTERVAL = 3000; // 3 seconds
+
+constexpr qint64 HOST_NAME_TTL = 24 * 60 * 60; // 1 day
+constexpr qint64 HOST_NAME_NOT_FOUND_TTL = 60 * 60; // 1 hour
+
+const char *const sqlSelectHost = "SELECT host_name, lookup_time FROM host WHERE address = ?1;";
+
+const char *const sqlInsertHost = "INSERT OR REPLACE INTO host(address, host_name, lookup_time)"
+                                  "  VALUES(?1, ?2, ?3);";
+
+const char *const sqlSelectHostCount = "SELECT count(*) FROM host;";
+
+const char *const sqlDeleteOldHosts = "DELETE FROM host WHERE host_id IN ("
+                                      "  SELECT host_id FROM host ORDER BY host_id LIMIT ?1"
+                                      ");";
+
+}
+
+HostInfoManager::HostInfoManager(const QString &filePath, QObject *parent, quint32 openFlags) :
+    WorkerManager(parent),
+    m_resolver(&NetUtil::getHostName),
+    m_hostsPurgeTimer(HOST_PURGE_INTERVAL),
+    m_sqliteDb(new SqliteDb(filePath, openFlags))
 {
-    setMaxWorkersCount(2);
+    setMaxWorkersCount(HOST_WORKERS_MAX_COUNT);
+    setMaxJobsCount(HOST_JOBS_MAX_COUNT);
 
     QSysInfo::machineHostName(); // Initialize ws2_32.dll
+
+    connect(this, &HostInfoManager::lookupFinished, this, &HostInfoManager::handleFinishedLookup);
+
+    connect(&m_lookupsFinishedTimer, &QTimer::timeout, this,
+            &HostInfoManager::emitLookupsFinished);
+    connect(&m_hostsPurgeTimer, &QTimer::timeout, this, &HostInfoManager::purgeHosts);
+}
+
+QString HostInfoManager::resolveHost(const QString &address) const
+{
+    const QString hostName = m_resolver(address);
+
+    // Numeric address is not a name
+    return (hostName == address) ? QString() : hostName;
+}
+
+void HostInfoManager::setUp()
+{
+    setupDb();
+}
+
+void HostInfoManager::lookupHosts(const QStringList &addresses)
+{
+    QList<WorkerJobPtr> jobs;
+    jobs.reserve(addresses.size());
+
+    for (const QString &address : addresses) {
+        jobs.append(WorkerJobPtr(new HostInfoJob(address)));
+    }
+
+    // The latest requested addresses are of the visible rows: resolve them first
+    enqueueJobsFirst(jobs);
+}
+
+void HostInfoManager::checkLookupFinished(const QStringList &addresses)
+{
+    for (const QString &address : addresses) {
+        QString hostName;
+        if (loadHostFromDb(address, hostName)) {
+            emit lookupFinished(address, hostName);
+        }
+    }
+}
+
+bool HostInfoManager::loadHostFromDb(const QString &address, QString &hostName)
+{
+    if (address.isEmpty())
+        return false;
+
+    QMutexLocker locker(&m_mutex);
+
+    SqliteStmt stmt;
+    if (!stmt.prepare(sqliteDb()->db(), sqlSelectHost))
+        return false;
+
+    stmt.bindText(1, address);
+
+    if (stmt.step() != SqliteStmt::StepRow)
+        return false;
+
+    hostName = stmt.columnText(0);
+
+    // Not found names are looked up again sooner
+    const qint64 lookupTime = stmt.columnInt64(1);
+    const qint64 ttl = hostName.isEmpty() ? HOST_NAME_NOT_FOUND_TTL : HOST_NAME_TTL;
+
+    return QDateTime::currentSecsSinceEpoch() < lookupTime + ttl;
+}
+
+bool HostInfoManager::saveToDb(const QString &address, const QString &hostName)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const QVariantList vars = {
+        address,
+        hostName.isEmpty() ? QVariant() : hostName,
+        QDateTime::currentSecsSinceEpoch(),
+    };
+
+    bool ok = true;
+    DbQuery(sqliteDb(), &ok).sql(sqlInsertHost).vars(vars).executeOk();
+
+    if (ok) {
+        // Delete excess hosts later
+        emitHostsPurge();
+    }
+
+    return ok;
+}
+
+void HostInfoManager::handleFinishedLookup(const QString &address)
+{
+    m_finishedAddresses.append(address);
+
+    m_lookupsFinishedTimer.startTrigger();
 }
 
-void HostInfoManager::lookupHost(const QString &address)
+bool HostInfoManager::setupDb()
 {
-    enqueueJob(WorkerJobPtr(new HostInfoJob(address)));
+    if (!sqliteDb()->open()) {
+        qCCritical(LC) << "File open error:" << sqliteDb()->filePath()
+                       << sqliteDb()->errorMessage();
+        return false;
+    }
+
+    SqliteDb::MigrateOptions opt = {
+        .sqlDir = ":/hostinfo/migrations",
+        .version = DATABASE_USER_VERSION,
+        .recreate = true,
+        .importOldData = false,
+    };
+
+    if (!sqliteDb()->migrate(opt)) {
+        qCCritical(LC) << "Migration error" << sqliteDb()->filePath();
+        return false;
+    }
+
+    return true;
+}
+
+void HostInfoManager::emitLookupsFinished()
+{
+    const QStringList addresses = m_finishedAddresses;
+    m_finishedAddresses.clear();
+
+    emit lookupsFinished(addresses);
+}
+
+void HostInfoManager::emitHostsPurge()
+{
+    QMetaObject::invokeMethod(
+            &m_hostsPurgeTimer, &TriggerTimer::startTrigger, Qt::QueuedConnection);
+}
+
+void HostInfoManager::purgeHosts()
+{
+    QMutexLocker locker(&m_mutex);
+
+    const int hostCount = DbQuery(sqliteDb()).sql(sqlSelectHostCount).execute().toInt();
+    const int excessCount = hostCount - HOST_CACHE_MAX_COUNT;
+
+    if (excessCount > 0) {
+        DbQuery(sqliteDb()).sql(sqlDeleteOldHosts).vars({ excessCount }).executeOk();
+    }
 }
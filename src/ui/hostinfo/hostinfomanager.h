@@ -1,22 +1,74 @@
 #ifndef HOSTINFOMANAGER_H
 #define HOSTINFOMANAGER_H
 
+#include <QMutex>
+
+#include <functional>
+
+#include <sqlite/sqliteutilbase.h>
+
+#include <util/classhelpers.h>
+#include <util/ioc/iocservice.h>
+#include <util/triggertimer.h>
 #include <util/worker/workermanager.h>
 
-class HostInfoManager : public WorkerManager
+using HostResolverFunc = std::function<QString(const QString &address)>;
+
+class HostInfoManager : public WorkerManager, public IocService, public SqliteUtilBase
 {
     Q_OBJECT
 
 public:
-    explicit HostInfoManager(QObject *parent = nullptr);
+    explicit HostInfoManager(
+            const QString &filePath, QObject *parent = nullptr, quint32 openFlags = 0);
+    CLASS_DELETE_COPY_MOVE(HostInfoManager)
 
     QString workerName() const override { return "HostInfoWorker"; }
 
+    SqliteDb *sqliteDb() const { return m_sqliteDb.data(); }
+
+    // Called from worker threads
+    void setResolver(const HostResolverFunc &v) { m_resolver = v; }
+    QString resolveHost(const QString &address) const;
+
+    void setUp() override;
+
+    bool loadHostFromDb(const QString &address, QString &hostName);
+    bool saveToDb(const QString &address, const QString &hostName);
+
 signals:
     void lookupFinished(const QString &address, const QString &hostName);
+    void lookupsFinished(const QStringList &addresses);
+
+    // The lookup job was dropped by back-pressure and will not finish
+    void lookupDropped(const QString &address);
 
 public slots:
-    void lookupHost(const QString &address);
+    virtual void lookupHosts(const QStringList &addresses);
+
+    void checkLookupFinished(const QStringList &addresses);
+
+private slots:
+    void handleFinishedLookup(const QString &address);
+
+private:
+    bool setupDb();
+
+    void emitLookupsFinished();
+
+    void emitHostsPurge();
+    void purgeHosts();
+
+private:
+    HostResolverFunc m_resolver;
+
+    QStringList m_finishedAddresses;
+    TriggerTimer m_lookupsFinishedTimer;
+
+    TriggerTimer m_hostsPurgeTimer;
+
+    SqliteDbPtr m_sqliteDb;
+    QMutex m_mutex;
 };
 
 #endif // HOSTINFOMANAGER_H
@@ -0,0 +1,8 @@
+CREATE TABLE host(
+  host_id INTEGER PRIMARY KEY,
+  address TEXT NOT NULL,
+  host_name TEXT,
+  lookup_time INTEGER NOT NULL
+);
+
+CREATE UNIQUE INDEX host_address_uk ON host(address);
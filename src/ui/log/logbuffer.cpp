@@ -4,6 +4,7 @@
 
 #include "logentryapp.h"
 #include "logentryconn.h"
+#include "logentrydropped.h"
 #include "logentryprocnew.h"
 #include "logentrystattraf.h"
 #include "logentrytime.h"
@@ -265,3 +266,27 @@ void LogBuffer::readEntryTime(LogEntryTime *logEntry)
     const int entrySize = int(DriverCommon::logTimeSize());
     m_offset += entrySize;
 }
+
+void LogBuffer::writeEntryDropped(const LogEntryDropped *logEntry)
+{
+    const int entrySize = int(DriverCommon::logDroppedSize());
+    prepareFor(entrySize);
+
+    char *output = this->output();
+
+    DriverCommon::logDroppedWrite(output, logEntry->droppedCounts());
+
+    m_top += entrySize;
+}
+
+void LogBuffer::readEntryDropped(LogEntryDropped *logEntry)
+{
+    Q_ASSERT(m_offset < m_top);
+
+    const char *input = this->input();
+
+    DriverCommon::logDroppedRead(input, logEntry->droppedCounts());
+
+    const int entrySize = int(DriverCommon::logDroppedSize());
+    m_offset += entrySize;
+}
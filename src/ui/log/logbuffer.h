@@ -8,6 +8,7 @@
 
 class LogEntryApp;
 class LogEntryConn;
+class LogEntryDropped;
 class LogEntryProcNew;
 class LogEntryStatTraf;
 class LogEntryTime;
@@ -40,6 +41,9 @@ public:
     void writeEntryTime(const LogEntryTime *logEntry);
     void readEntryTime(LogEntryTime *logEntry);
 
+    void writeEntryDropped(const LogEntryDropped *logEntry);
+    void readEntryDropped(LogEntryDropped *logEntry);
+
 public slots:
     void reset(int top = 0);
 
@@ -0,0 +1,6 @@
+#include "logentrydropped.h"
+
+void LogEntryDropped::setDroppedCount(FortLogClass logClass, quint32 count)
+{
+    m_droppedCounts[logClass] = count;
+}
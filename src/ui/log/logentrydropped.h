@@ -0,0 +1,23 @@
+#ifndef LOGENTRYDROPPED_H
+#define LOGENTRYDROPPED_H
+
+#include "logentry.h"
+
+class LogEntryDropped : public LogEntry
+{
+public:
+    explicit LogEntryDropped() = default;
+
+    FortLogType type() const override { return FORT_LOG_TYPE_DROPPED; }
+
+    quint32 droppedCount(FortLogClass logClass) const { return m_droppedCounts[logClass]; }
+    void setDroppedCount(FortLogClass logClass, quint32 count);
+
+    const quint32 *droppedCounts() const { return m_droppedCounts; }
+    quint32 *droppedCounts() { return m_droppedCounts; }
+
+private:
+    quint32 m_droppedCounts[FORT_LOG_CLASS_COUNT] = {};
+};
+
+#endif // LOGENTRYDROPPED_H
@@ -17,6 +17,7 @@
 #include "logbuffer.h"
 #include "logentryapp.h"
 #include "logentryconn.h"
+#include "logentrydropped.h"
 #include "logentryprocnew.h"
 #include "logentrystattraf.h"
 #include "logentrytime.h"
@@ -157,6 +158,8 @@ bool LogManager::processLogEntry(LogBuffer *logBuffer, FortLogType logType)
         return processLogEntryStatTraf(logBuffer);
     case FORT_LOG_TYPE_TIME:
         return processLogEntryTime(logBuffer);
+    case FORT_LOG_TYPE_DROPPED:
+        return processLogEntryDropped(logBuffer);
     default:
         return processLogEntryError(logBuffer, logType);
     }
@@ -222,6 +225,24 @@ bool LogManager::processLogEntryTime(LogBuffer *logBuffer)
     return true;
 }
 
+bool LogManager::processLogEntryDropped(LogBuffer *logBuffer)
+{
+    LogEntryDropped droppedEntry;
+    logBuffer->readEntryDropped(&droppedEntry);
+
+    for (int i = 0; i < FORT_LOG_CLASS_COUNT; ++i) {
+        m_droppedCounts[i] += droppedEntry.droppedCount(FortLogClass(i));
+    }
+
+    qCWarning(LC) << "Log entries dropped:"
+                  << "stat=" << droppedEntry.droppedCount(FORT_LOG_CLASS_STAT)
+                  << "proc=" << droppedEntry.droppedCount(FORT_LOG_CLASS_PROC)
+                  << "app=" << droppedEntry.droppedCount(FORT_LOG_CLASS_APP)
+                  << "conn=" << droppedEntry.droppedCount(FORT_LOG_CLASS_CONN);
+
+    return true;
+}
+
 bool LogManager::processLogEntryError(LogBuffer *logBuffer, FortLogType logType)
 {
     if (logBuffer->offset() < logBuffer->top()) {
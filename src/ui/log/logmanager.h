@@ -20,6 +20,8 @@ public:
 
     QString errorMessage() const { return m_errorMessage; }
 
+    quint64 droppedCount(FortLogClass logClass) const { return m_droppedCounts[logClass]; }
+
     void setUp() override;
     void tearDown() override;
 
@@ -50,6 +52,7 @@ private:
     bool processLogEntryProcNew(LogBuffer *logBuffer);
     bool processLogEntryStatTraf(LogBuffer *logBuffer);
     bool processLogEntryTime(LogBuffer *logBuffer);
+    bool processLogEntryDropped(LogBuffer *logBuffer);
     bool processLogEntryError(LogBuffer *logBuffer, FortLogType logType);
 
 private:
@@ -60,6 +63,8 @@ private:
     QString m_errorMessage;
 
     qint64 m_currentUnixTime = 0;
+
+    quint64 m_droppedCounts[FORT_LOG_CLASS_COUNT] = {};
 };
 
 #endif // LOGMANAGER_H
@@ -1,5 +1,7 @@
 #include "applistmodel.h"
 
+#include <QSet>
+
 #include <sqlite/dbquery.h>
 #include <sqlite/sqlitedb.h>
 #include <sqlite/sqlitestmt.h>
@@ -93,7 +95,7 @@ void AppListModel::initialize()
     connect(confAppManager(), &ConfAppManager::appsChanged, this, &TableItemModel::reset);
     connect(confAppManager(), &ConfAppManager::appUpdated, this, &TableItemModel::refresh);
 
-    connect(appInfoCache(), &AppInfoCache::cacheChanged, this, &AppListModel::refresh);
+    connect(appInfoCache(), &AppInfoCache::cacheChanged, this, &AppListModel::updateAppPaths);
 }
 
 int AppListModel::columnCount(const QModelIndex & /*parent*/) const
@@ -227,41 +229,51 @@ AppStatesCount AppListModel::appStatesCount() const
     };
 }
 
-bool AppListModel::updateTableRow(const QVariantHash &vars, int /*row*/) const
+void AppListModel::updateAppPaths(const QStringList &appPaths)
 {
-    SqliteStmt stmt;
-    if (!DbQuery(sqliteDb()).sql(sql()).vars(vars).prepareRow(stmt)) {
-        m_appRow.invalidate();
-        return false;
-    }
+    const QSet<QString> appPathSet(appPaths.constBegin(), appPaths.constEnd());
+
+    const QList<int> rows = cachedRows([&](const TableRow &tableRow) {
+        return appPathSet.contains(static_cast<const AppRow &>(tableRow).appPath);
+    });
+
+    emitCellsChanged(rows, int(AppListColumn::Name));
+}
 
-    m_appRow.appId = stmt.columnInt64(0);
-    m_appRow.appOriginPath = stmt.columnText(1);
-    m_appRow.appPath = stmt.columnText(2);
-    m_appRow.iconPath = stmt.columnText(3);
-    m_appRow.appName = stmt.columnText(4);
-    m_appRow.notes = stmt.columnText(5);
-    m_appRow.isWildcard = stmt.columnBool(6);
-    m_appRow.applyParent = stmt.columnBool(7);
-    m_appRow.applyChild = stmt.columnBool(8);
-    m_appRow.applySpecChild = stmt.columnBool(9);
-    m_appRow.killChild = stmt.columnBool(10);
-    m_appRow.lanOnly = stmt.columnBool(11);
-    m_appRow.parked = stmt.columnBool(12);
-    m_appRow.logAllowedConn = stmt.columnBool(13);
-    m_appRow.logBlockedConn = stmt.columnBool(14);
-    m_appRow.blocked = stmt.columnBool(15);
-    m_appRow.killProcess = stmt.columnBool(16);
-    m_appRow.zones.accept_mask = stmt.columnUInt(17);
-    m_appRow.zones.reject_mask = stmt.columnUInt(18);
-    m_appRow.ruleId = stmt.columnUInt(19);
-    m_appRow.scheduleAction = stmt.columnInt(20);
-    m_appRow.scheduleTime = stmt.columnDateTime(21);
-    m_appRow.creatTime = stmt.columnDateTime(22);
-    m_appRow.groupIndex = stmt.columnInt(23);
-    m_appRow.alerted = stmt.columnBool(24);
-
-    return true;
+void AppListModel::fillTableRow(SqliteStmt &stmt, TableRow &tableRow) const
+{
+    AppRow &appRow = static_cast<AppRow &>(tableRow);
+
+    appRow.appId = stmt.columnInt64(0);
+    appRow.appOriginPath = stmt.columnText(1);
+    appRow.appPath = stmt.columnText(2);
+    appRow.iconPath = stmt.columnText(3);
+    appRow.appName = stmt.columnText(4);
+    appRow.notes = stmt.columnText(5);
+    appRow.isWildcard = stmt.columnBool(6);
+    appRow.applyParent = stmt.columnBool(7);
+    appRow.applyChild = stmt.columnBool(8);
+    appRow.applySpecChild = stmt.columnBool(9);
+    appRow.killChild = stmt.columnBool(10);
+    appRow.lanOnly = stmt.columnBool(11);
+    appRow.parked = stmt.columnBool(12);
+    appRow.logAllowedConn = stmt.columnBool(13);
+    appRow.logBlockedConn = stmt.columnBool(14);
+    appRow.blocked = stmt.columnBool(15);
+    appRow.killProcess = stmt.columnBool(16);
+    appRow.zones.accept_mask = stmt.columnUInt(17);
+    appRow.zones.reject_mask = stmt.columnUInt(18);
+    appRow.ruleId = stmt.columnUInt(19);
+    appRow.scheduleAction = stmt.columnInt(20);
+    appRow.scheduleTime = stmt.columnDateTime(21);
+    appRow.creatTime = stmt.columnDateTime(22);
+    appRow.groupIndex = stmt.columnInt(23);
+    appRow.alerted = stmt.columnBool(24);
+}
+
+void AppListModel::setTableRow(const TableRow &tableRow) const
+{
+    m_appRow = static_cast<const AppRow &>(tableRow);
 }
 
 QString AppListModel::sqlBase() const
@@ -327,7 +339,7 @@ QString AppListModel::sqlWhereFts() const
 
 QString AppListModel::sqlOrderColumn() const
 {
-    static const QString nameColumn = "lower(t.name)";
+    static const QString nameColumn = "t.lower_name";
     static const QString pathColumn = "t.path";
 
     static const QStringList sortStateColumns = {
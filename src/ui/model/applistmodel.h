@@ -88,8 +88,13 @@ signals:
     void sortStateChanged();
     void filtersChanged();
 
+protected slots:
+    void updateAppPaths(const QStringList &appPaths);
+
 protected:
-    bool updateTableRow(const QVariantHash &vars, int row) const override;
+    TableRowPtr createTableRow() const override { return std::make_shared<AppRow>(); }
+    void fillTableRow(SqliteStmt &stmt, TableRow &tableRow) const override;
+    void setTableRow(const TableRow &tableRow) const override;
     TableRow &tableRow() const override { return m_appRow; }
 
     QString sqlBase() const override;
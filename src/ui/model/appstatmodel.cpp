@@ -2,6 +2,7 @@
 
 #include <QFont>
 #include <QIcon>
+#include <QSet>
 
 #include <sqlite/dbquery.h>
 #include <sqlite/sqlitedb.h>
@@ -85,7 +86,7 @@ void AppStatModel::initialize()
     connect(statManager(), &StatManager::appStatRemoved, this, &AppStatModel::refresh);
     connect(statManager(), &StatManager::appCreated, this, &AppStatModel::refresh);
 
-    connect(appInfoCache(), &AppInfoCache::cacheChanged, this, &AppStatModel::refresh);
+    connect(appInfoCache(), &AppInfoCache::cacheChanged, this, &AppStatModel::updateAppPaths);
 }
 
 int AppStatModel::columnCount(const QModelIndex & /*parent*/) const
@@ -218,21 +219,31 @@ const AppStatRow &AppStatModel::appStatRowAt(int row) const
     return m_appStatRow;
 }
 
-bool AppStatModel::updateTableRow(const QVariantHash &vars, int /*row*/) const
+void AppStatModel::updateAppPaths(const QStringList &appPaths)
 {
-    SqliteStmt stmt;
-    if (!DbQuery(sqliteDb()).sql(sql()).vars(vars).prepareRow(stmt)) {
-        m_appStatRow.invalidate();
-        return false;
-    }
+    const QSet<QString> appPathSet(appPaths.constBegin(), appPaths.constEnd());
+
+    const QList<int> rows = cachedRows([&](const TableRow &tableRow) {
+        return appPathSet.contains(static_cast<const AppStatRow &>(tableRow).appPath);
+    });
+
+    emitCellsChanged(rows, int(AppStatColumn::Program));
+}
 
-    m_appStatRow.appId = stmt.columnInt64(0);
-    m_appStatRow.confAppId = stmt.columnInt64(1);
-    m_appStatRow.appPath = stmt.columnText(2);
-    m_appStatRow.inBytes = stmt.columnInt64(3);
-    m_appStatRow.outBytes = stmt.columnInt64(4);
+void AppStatModel::fillTableRow(SqliteStmt &stmt, TableRow &tableRow) const
+{
+    AppStatRow &appStatRow = static_cast<AppStatRow &>(tableRow);
+
+    appStatRow.appId = stmt.columnInt64(0);
+    appStatRow.confAppId = stmt.columnInt64(1);
+    appStatRow.appPath = stmt.columnText(2);
+    appStatRow.inBytes = stmt.columnInt64(3);
+    appStatRow.outBytes = stmt.columnInt64(4);
+}
 
-    return true;
+void AppStatModel::setTableRow(const TableRow &tableRow) const
+{
+    m_appStatRow = static_cast<const AppStatRow &>(tableRow);
 }
 
 QString AppStatModel::sqlBase() const
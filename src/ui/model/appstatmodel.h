@@ -55,8 +55,13 @@ public:
 
     static QString columnName(const AppStatColumn column);
 
+protected slots:
+    void updateAppPaths(const QStringList &appPaths);
+
 protected:
-    bool updateTableRow(const QVariantHash &vars, int row) const override;
+    TableRowPtr createTableRow() const override { return std::make_shared<AppStatRow>(); }
+    void fillTableRow(SqliteStmt &stmt, TableRow &tableRow) const override;
+    void setTableRow(const TableRow &tableRow) const override;
     TableRow &tableRow() const override { return m_appStatRow; }
 
     QString sqlBase() const override;
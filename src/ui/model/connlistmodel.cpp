@@ -3,6 +3,7 @@
 #include <QFont>
 #include <QIcon>
 #include <QLoggingCategory>
+#include <QSet>
 
 #include <sqlite/dbquery.h>
 #include <sqlite/sqlitedb.h>
@@ -24,22 +25,16 @@ namespace {
 
 const QLoggingCategory LC("connListModel");
 
-QString formatIp(const ip_addr_t ip, bool isIPv6, bool resolveAddress = false)
-{
-    QString address = NetFormatUtil::ipToText(ip, isIPv6);
+constexpr int rowCacheMaxCount = 512;
 
-    if (resolveAddress) {
-        const QString hostName = IoC<HostInfoCache>()->hostName(address);
-        if (!hostName.isEmpty()) {
-            return hostName;
-        }
-    }
-
-    if (isIPv6) {
-        address = '[' + address + ']';
-    }
+QString formatAddress(const QString &address, bool isIPv6)
+{
+    return isIPv6 ? ('[' + address + ']') : address;
+}
 
-    return address;
+QString formatIp(const ip_addr_t ip, bool isIPv6)
+{
+    return formatAddress(NetFormatUtil::ipToText(ip, isIPv6), isIPv6);
 }
 
 QString formatPort(const quint16 port, int role)
@@ -86,88 +81,82 @@ QString directionIconPath(const ConnRow &connRow)
     return connRow.inbound ? ":/icons/green_down.png" : ":/icons/blue_up.png";
 }
 
-QVariant dataDisplayAppName(const ConnRow &connRow, int /*role*/)
+QVariant dataDisplayAppName(const ConnRowCache &rowCache, int /*role*/)
 {
-    return IoC<AppInfoCache>()->appName(connRow.appPath);
+    return rowCache.appName;
 }
 
-QVariant dataDisplayProcessId(const ConnRow &connRow, int /*role*/)
+QVariant dataDisplayProcessId(const ConnRowCache &rowCache, int /*role*/)
 {
-    return connRow.pid;
+    return rowCache.connRow.pid;
 }
 
-QVariant dataDisplayProtocolName(const ConnRow &connRow, int /*role*/)
+QVariant dataDisplayProtocolName(const ConnRowCache &rowCache, int /*role*/)
 {
-    return NetUtil::protocolName(connRow.ipProto);
+    return NetUtil::protocolName(rowCache.connRow.ipProto);
 }
 
-QVariant dataDisplayLocalHostName(const ConnRow &connRow, int role)
+QVariant dataDisplayLocalHostName(const ConnRowCache &rowCache, int /*role*/)
 {
-    const bool resolveAddress = (role >= Qt::UserRole);
-
-    return formatIp(connRow.localIp, connRow.isIPv6, resolveAddress);
+    return rowCache.localHostName;
 }
 
-QVariant dataDisplayLocalIp(const ConnRow &connRow, int /*role*/)
+QVariant dataDisplayLocalIp(const ConnRowCache &rowCache, int /*role*/)
 {
-    return formatIp(connRow.localIp, connRow.isIPv6);
+    return rowCache.localIp;
 }
 
-QVariant dataDisplayLocalPort(const ConnRow &connRow, int role)
+QVariant dataDisplayLocalPort(const ConnRowCache &rowCache, int role)
 {
-    return formatPort(connRow.localPort, role);
+    return formatPort(rowCache.connRow.localPort, role);
 }
 
-QVariant dataDisplayRemoteHostName(const ConnRow &connRow, int role)
+QVariant dataDisplayRemoteHostName(const ConnRowCache &rowCache, int /*role*/)
 {
-    const bool resolveAddress = (role >= Qt::UserRole);
-
-    return formatIp(connRow.remoteIp, connRow.isIPv6, resolveAddress);
+    return rowCache.remoteHostName;
 }
 
-QVariant dataDisplayRemoteIp(const ConnRow &connRow, int /*role*/)
+QVariant dataDisplayRemoteIp(const ConnRowCache &rowCache, int /*role*/)
 {
-    return formatIp(connRow.remoteIp, connRow.isIPv6);
+    return rowCache.remoteIp;
 }
 
-QVariant dataDisplayRemotePort(const ConnRow &connRow, int role)
+QVariant dataDisplayRemotePort(const ConnRowCache &rowCache, int role)
 {
-    return formatPort(connRow.remotePort, role);
+    return formatPort(rowCache.connRow.remotePort, role);
 }
 
-QVariant dataDisplayDirection(const ConnRow &connRow, int role)
+QVariant dataDisplayDirection(const ConnRowCache &rowCache, int role)
 {
     if (role != Qt::ToolTipRole)
         return {};
 
-    return connRow.inbound ? ConnListModel::tr("In") : ConnListModel::tr("Out");
+    return rowCache.connRow.inbound ? ConnListModel::tr("In") : ConnListModel::tr("Out");
 }
 
-QVariant dataDisplayAction(const ConnRow &connRow, int role)
+QVariant dataDisplayAction(const ConnRowCache &rowCache, int role)
 {
     if (role != Qt::ToolTipRole)
         return {};
 
-    return connRow.blocked ? ConnListModel::tr("Blocked") : ConnListModel::tr("Allowed");
+    return rowCache.connRow.blocked ? ConnListModel::tr("Blocked") : ConnListModel::tr("Allowed");
 }
 
-QVariant dataDisplayReason(const ConnRow &connRow, int role)
+QVariant dataDisplayReason(const ConnRowCache &rowCache, int role)
 {
     if (role != Qt::ToolTipRole)
         return {};
 
+    const ConnRow &connRow = rowCache.connRow;
+
     QStringList list = { ConnListModel::reasonText(FortConnReason(connRow.reason)) };
 
     if (connRow.ruleId != 0) {
-        const QString ruleName = IoC<ConfRuleManager>()->ruleNameById(connRow.ruleId);
-
-        list << ConnListModel::tr("Rule: %1").arg(ruleName);
+        list << ConnListModel::tr("Rule: %1").arg(rowCache.ruleName);
     }
 
     if (connRow.zoneId != 0) {
-        const QString zoneName = IoC<ConfZoneManager>()->zoneNameById(connRow.zoneId);
-
-        list << ConnListModel::tr("Zone: %1").arg(zoneName);
+        list << ConnListModel::tr("Zone: %1").arg(rowCache.zoneName);
     }
 
     if (connRow.inherited) {
@@ -177,12 +166,12 @@ QVariant dataDisplayReason(const ConnRow &connRow, int role)
     return list.join('\n');
 }
 
-QVariant dataDisplayTime(const ConnRow &connRow, int /*role*/)
+QVariant dataDisplayTime(const ConnRowCache &rowCache, int /*role*/)
 {
-    return connRow.connTime;
+    return rowCache.connRow.connTime;
 }
 
-using dataDisplay_func = QVariant (*)(const ConnRow &connRow, int role);
+using dataDisplay_func = QVariant (*)(const ConnRowCache &rowCache, int role);
 
 static const dataDisplay_func dataDisplay_funcList[] = {
     &dataDisplayAppName,
@@ -234,8 +223,17 @@ void ConnListModel::initialize()
     setSortColumn(int(ConnListColumn::Time));
     setSortOrder(Qt::DescendingOrder);
 
-    connect(appInfoCache(), &AppInfoCache::cacheChanged, this, &ConnListModel::refresh);
-    connect(hostInfoCache(), &HostInfoCache::cacheChanged, this, &ConnListModel::refresh);
+    connect(appInfoCache(), &AppInfoCache::cacheChanged, this, &ConnListModel::updateAppPaths);
+    connect(hostInfoCache(), &HostInfoCache::cacheChanged, this,
+            &ConnListModel::updateAddresses);
+
+    auto confRuleManager = IoC<ConfRuleManager>();
+    auto confZoneManager = IoC<ConfZoneManager>();
+
+    connect(confRuleManager, &ConfRuleManager::ruleRemoved, this, &ConnListModel::updateRuleId);
+    connect(confRuleManager, &ConfRuleManager::ruleUpdated, this, &ConnListModel::updateRuleId);
+    connect(confZoneManager, &ConfZoneManager::zoneRemoved, this, &ConnListModel::updateZoneId);
+    connect(confZoneManager, &ConfZoneManager::zoneUpdated, this, &ConnListModel::updateZoneId);
     connect(statConnManager(), &StatConnManager::connChanged, this,
             &ConnListModel::updateConnIdRange);
 
@@ -314,18 +312,13 @@ QVariant ConnListModel::dataDisplay(const QModelIndex &index, int role) const
     const int row = index.row();
     const int column = index.column();
 
-    const auto &connRow = connRowAt(row);
-    if (connRow.isNull())
+    const ConnRowCache *rowCache = rowCacheAt(row);
+    if (!rowCache)
         return {};
 
     const dataDisplay_func func = dataDisplay_funcList[column];
 
-    if (column == int(ConnListColumn::LocalHostName)
-            || column == int(ConnListColumn::RemoteHostName)) {
-        role += resolveAddress() ? Qt::UserRole : 0;
-    }
-
-    return func(connRow, role);
+    return func(*rowCache, role);
 }
 
 QVariant ConnListModel::dataDecoration(const QModelIndex &index) const
@@ -356,6 +349,18 @@ const ConnRow &ConnListModel::connRowAt(int row) const
     return m_connRow;
 }
 
+const ConnRowCache *ConnListModel::rowCacheAt(int row) const
+{
+    updateRowCache(row);
+
+    if (m_connRow.isNull())
+        return nullptr;
+
+    const auto it = m_rowCache.constFind(row);
+
+    return (it != m_rowCache.constEnd()) ? &(*it) : nullptr;
+}
+
 QString ConnListModel::rowsAsFilter(const QVector<int> &rows) const
 {
     QStringList list;
@@ -392,8 +397,95 @@ void ConnListModel::updateConnIdRange()
     updateConnRows(oldIdMin, oldIdMax, idMin, idMax);
 }
 
+void ConnListModel::updateAppPaths(const QStringList &appPaths)
+{
+    const QSet<QString> appPathSet(appPaths.constBegin(), appPaths.constEnd());
+
+    QList<int> rows;
+    for (auto it = m_rowCache.begin(); it != m_rowCache.end(); ++it) {
+        ConnRowCache &rowCache = it.value();
+
+        if (appPathSet.contains(rowCache.connRow.appPath)) {
+            rowCache.appName = appNameByPath(rowCache.connRow.appPath);
+            rows.append(it.key());
+        }
+    }
+
+    emitCellsChanged(rows, int(ConnListColumn::Program));
+}
+
+void ConnListModel::updateAddresses(const QStringList &addresses)
+{
+    if (!resolveAddress())
+        return;
+
+    const QSet<QString> addressSet(addresses.constBegin(), addresses.constEnd());
+
+    QList<int> localRows;
+    QList<int> remoteRows;
+    for (auto it = m_rowCache.begin(); it != m_rowCache.end(); ++it) {
+        ConnRowCache &rowCache = it.value();
+
+        if (addressSet.contains(rowCache.localAddress)) {
+            rowCache.localHostName = formatHostName(rowCache.localAddress, rowCache.localIp);
+            localRows.append(it.key());
+        }
+        if (addressSet.contains(rowCache.remoteAddress)) {
+            rowCache.remoteHostName = formatHostName(rowCache.remoteAddress, rowCache.remoteIp);
+            remoteRows.append(it.key());
+        }
+    }
+
+    emitCellsChanged(localRows, int(ConnListColumn::LocalHostName));
+    emitCellsChanged(remoteRows, int(ConnListColumn::RemoteHostName));
+}
+
+void ConnListModel::updateRuleId(quint16 ruleId)
+{
+    QList<int> rows;
+    for (auto it = m_rowCache.begin(); it != m_rowCache.end(); ++it) {
+        ConnRowCache &rowCache = it.value();
+
+        if (rowCache.connRow.ruleId == ruleId) {
+            rowCache.ruleName = ruleNameById(ruleId);
+            rows.append(it.key());
+        }
+    }
+
+    emitCellsChanged(rows, int(ConnListColumn::Reason));
+}
+
+void ConnListModel::updateZoneId(quint8 zoneId)
+{
+    QList<int> rows;
+    for (auto it = m_rowCache.begin(); it != m_rowCache.end(); ++it) {
+        ConnRowCache &rowCache = it.value();
+
+        if (rowCache.connRow.zoneId == zoneId) {
+            rowCache.zoneName = zoneNameById(zoneId);
+            rows.append(it.key());
+        }
+    }
+
+    emitCellsChanged(rows, int(ConnListColumn::Reason));
+}
+
+void ConnListModel::invalidateRowCache() const
+{
+    m_rowCache.clear();
+
+    TableSqlModel::invalidateRowCache();
+}
+
 bool ConnListModel::updateTableRow(const QVariantHash & /*vars*/, int row) const
 {
+    // Recently loaded rows are not queried again on repaint
+    const auto it = m_rowCache.constFind(row);
+    if (it != m_rowCache.constEnd()) {
+        m_connRow = it->connRow;
+        return true;
+    }
+
     const qint64 connId = connIdByIndex(row);
 
     SqliteStmt stmt;
@@ -427,9 +519,56 @@ bool ConnListModel::updateTableRow(const QVariantHash & /*vars*/, int row) const
     m_connRow.confAppId = stmt.columnInt64(17);
     m_connRow.appPath = stmt.columnText(18);
 
+    addRowCache(row);
+
     return true;
 }
 
+void ConnListModel::addRowCache(int row) const
+{
+    // Rows of the viewport are loaded again on the next repaint
+    if (m_rowCache.size() >= rowCacheMaxCount) {
+        m_rowCache.clear();
+    }
+
+    const bool isIPv6 = m_connRow.isIPv6;
+
+    ConnRowCache &rowCache = m_rowCache[row];
+
+    rowCache.connRow = m_connRow;
+
+    rowCache.appName = appNameByPath(m_connRow.appPath);
+
+    rowCache.localAddress = NetFormatUtil::ipToText(m_connRow.localIp, isIPv6);
+    rowCache.remoteAddress = NetFormatUtil::ipToText(m_connRow.remoteIp, isIPv6);
+
+    rowCache.localIp = formatAddress(rowCache.localAddress, isIPv6);
+    rowCache.remoteIp = formatAddress(rowCache.remoteAddress, isIPv6);
+
+    rowCache.localHostName = formatHostName(rowCache.localAddress, rowCache.localIp);
+    rowCache.remoteHostName = formatHostName(rowCache.remoteAddress, rowCache.remoteIp);
+
+    if (m_connRow.ruleId != 0) {
+        rowCache.ruleName = ruleNameById(m_connRow.ruleId);
+    }
+
+    if (m_connRow.zoneId != 0) {
+        rowCache.zoneName = zoneNameById(m_connRow.zoneId);
+    }
+}
+
+QString ConnListModel::formatHostName(const QString &address, const QString &formattedIp) const
+{
+    if (resolveAddress()) {
+        const QString hostName = hostNameByAddress(address);
+        if (!hostName.isEmpty()) {
+            return hostName;
+        }
+    }
+
+    return formattedIp;
+}
+
 void ConnListModel::fillConnIdRange(qint64 &idMin, qint64 &idMax)
 {
     statConnManager()->getConnIdRange(sqliteDb(), idMin, idMax);
@@ -449,6 +588,26 @@ qint64 ConnListModel::connIdByIndex(int row) const
     return isAscendingOrder() ? (connIdMin() + row) : (connIdMax() - row);
 }
 
+QString ConnListModel::appNameByPath(const QString &appPath) const
+{
+    return appInfoCache()->appName(appPath);
+}
+
+QString ConnListModel::hostNameByAddress(const QString &address) const
+{
+    return hostInfoCache()->hostName(address);
+}
+
+QString ConnListModel::ruleNameById(quint16 ruleId) const
+{
+    return IoC<ConfRuleManager>()->ruleNameById(ruleId);
+}
+
+QString ConnListModel::zoneNameById(quint8 zoneId) const
+{
+    return IoC<ConfZoneManager>()->zoneNameById(zoneId);
+}
+
 int ConnListModel::doSqlCount() const
 {
     return connIdMax() <= 0 ? 0 : int(connIdMax() - connIdMin()) + 1;
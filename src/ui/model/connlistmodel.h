@@ -42,6 +42,25 @@ struct ConnRow : TableRow
     QDateTime connTime;
 };
 
+struct ConnRowCache
+{
+    ConnRow connRow;
+
+    QString appName;
+
+    QString localAddress;
+    QString remoteAddress;
+
+    QString localIp; // formatted address
+    QString remoteIp;
+
+    QString localHostName; // resolved name or formatted address
+    QString remoteHostName;
+
+    QString ruleName;
+    QString zoneName;
+};
+
 class ConnListModel : public TableSqlModel
 {
     Q_OBJECT
@@ -77,7 +96,14 @@ public:
 protected slots:
     void updateConnIdRange();
 
+    void updateAppPaths(const QStringList &appPaths);
+    void updateAddresses(const QStringList &addresses);
+    void updateRuleId(quint16 ruleId);
+    void updateZoneId(quint8 zoneId);
+
 protected:
+    void invalidateRowCache() const override;
+
     bool updateTableRow(const QVariantHash &vars, int row) const override;
     TableRow &tableRow() const override { return m_connRow; }
 
@@ -90,6 +116,11 @@ protected:
 
     virtual qint64 connIdByIndex(int row) const;
 
+    virtual QString appNameByPath(const QString &appPath) const;
+    virtual QString hostNameByAddress(const QString &address) const;
+    virtual QString ruleNameById(quint16 ruleId) const;
+    virtual QString zoneNameById(quint8 zoneId) const;
+
     int doSqlCount() const override;
     QString sqlBase() const override;
     QString sqlWhere() const override;
@@ -108,6 +139,12 @@ private:
     QVariant dataDisplay(const QModelIndex &index, int role) const;
     QVariant dataDecoration(const QModelIndex &index) const;
 
+    const ConnRowCache *rowCacheAt(int row) const;
+
+    void addRowCache(int row) const;
+
+    QString formatHostName(const QString &address, const QString &formattedIp) const;
+
     void updateConnRows(qint64 oldIdMin, qint64 oldIdMax, qint64 idMin, qint64 idMax);
     void resetConnRows(qint64 idMin, qint64 idMax);
     void removeConnRows(qint64 idMin, int count);
@@ -120,6 +157,8 @@ private:
     qint64 m_connIdMax = 0;
 
     mutable ConnRow m_connRow;
+
+    mutable QHash<int, ConnRowCache> m_rowCache; // of recently loaded rows
 };
 
 #endif // CONNLISTMODEL_H
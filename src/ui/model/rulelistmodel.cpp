@@ -286,11 +286,6 @@ RuleRow RuleListModel::ruleRowById(int ruleId, Rule::RuleType ruleType) const
     return ruleRow;
 }
 
-bool RuleListModel::updateTableRow(const QVariantHash &vars, int /*row*/) const
-{
-    return updateRuleRow(sql(), vars, m_ruleRow);
-}
-
 bool RuleListModel::updateRuleRow(
         const QString &sql, const QVariantHash &vars, RuleRow &ruleRow) const
 {
@@ -300,6 +295,15 @@ bool RuleListModel::updateRuleRow(
         return false;
     }
 
+    fillTableRow(stmt, ruleRow);
+
+    return true;
+}
+
+void RuleListModel::fillTableRow(SqliteStmt &stmt, TableRow &tableRow) const
+{
+    RuleRow &ruleRow = static_cast<RuleRow &>(tableRow);
+
     ruleRow.ruleId = stmt.columnInt(0);
     ruleRow.enabled = stmt.columnBool(1);
     ruleRow.blocked = stmt.columnBool(2);
@@ -315,8 +319,11 @@ bool RuleListModel::updateRuleRow(
     ruleRow.zones.reject_mask = stmt.columnUInt(12);
     ruleRow.modTime = stmt.columnDateTime(13);
     ruleRow.trayMenu = stmt.columnBool(14);
+}
 
-    return true;
+void RuleListModel::setTableRow(const TableRow &tableRow) const
+{
+    m_ruleRow = static_cast<const RuleRow &>(tableRow);
 }
 
 QString RuleListModel::sqlBase() const
@@ -60,7 +60,9 @@ protected:
 
     void fillQueryVars(QVariantHash &vars) const override;
 
-    bool updateTableRow(const QVariantHash &vars, int row) const override;
+    TableRowPtr createTableRow() const override { return std::make_shared<RuleRow>(); }
+    void fillTableRow(SqliteStmt &stmt, TableRow &tableRow) const override;
+    void setTableRow(const TableRow &tableRow) const override;
     TableRow &tableRow() const override { return m_ruleRow; }
 
     bool updateRuleRow(const QString &sql, const QVariantHash &vars, RuleRow &ruleRow) const;
@@ -187,17 +187,9 @@ QVariant ZoneListModel::zoneSourceByCode(const QString &sourceCode) const
     return zoneSourceById(sourceId);
 }
 
-bool ZoneListModel::updateTableRow(const QVariantHash &vars, int /*row*/) const
+void ZoneListModel::fillTableRow(SqliteStmt &stmt, TableRow &tableRow) const
 {
-    return updateZoneRow(sql(), vars, m_zoneRow);
-}
-
-bool ZoneListModel::updateZoneRow(
-        const QString &sql, const QVariantHash &vars, ZoneRow &zoneRow) const
-{
-    SqliteStmt stmt;
-    if (!DbQuery(sqliteDb()).sql(sql).vars(vars).prepareRow(stmt))
-        return false;
+    ZoneRow &zoneRow = static_cast<ZoneRow &>(tableRow);
 
     zoneRow.zoneId = stmt.columnInt(0);
     zoneRow.enabled = stmt.columnBool(1);
@@ -213,8 +205,11 @@ bool ZoneListModel::updateZoneRow(
     zoneRow.sourceModTime = stmt.columnDateTime(11);
     zoneRow.lastRun = stmt.columnDateTime(12);
     zoneRow.lastSuccess = stmt.columnDateTime(13);
+}
 
-    return true;
+void ZoneListModel::setTableRow(const TableRow &tableRow) const
+{
+    m_zoneRow = static_cast<const ZoneRow &>(tableRow);
 }
 
 QString ZoneListModel::sqlBase() const
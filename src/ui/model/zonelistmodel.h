@@ -50,11 +50,11 @@ public:
 protected:
     Qt::ItemFlags flagIsUserCheckable(const QModelIndex &index) const override;
 
-    bool updateTableRow(const QVariantHash &vars, int row) const override;
+    TableRowPtr createTableRow() const override { return std::make_shared<ZoneRow>(); }
+    void fillTableRow(SqliteStmt &stmt, TableRow &tableRow) const override;
+    void setTableRow(const TableRow &tableRow) const override;
     TableRow &tableRow() const override { return m_zoneRow; }
 
-    bool updateZoneRow(const QString &sql, const QVariantHash &vars, ZoneRow &zoneRow) const;
-
     QString sqlBase() const override;
 
 private:
@@ -11,9 +11,9 @@ AppInfoManagerRpc::AppInfoManagerRpc(const QString &filePath, bool noCache, QObj
 {
 }
 
-void AppInfoManagerRpc::lookupAppInfo(const QString &appPath)
+void AppInfoManagerRpc::lookupAppInfos(const QStringList &appPaths)
 {
-    IoC<RpcManager>()->invokeOnServer(Control::Rpc_AppInfoManager_lookupAppInfo, { appPath });
+    IoC<RpcManager>()->invokeOnServer(Control::Rpc_AppInfoManager_lookupAppInfos, { appPaths });
 }
 
 bool AppInfoManagerRpc::processServerCommand(
@@ -22,14 +22,18 @@ bool AppInfoManagerRpc::processServerCommand(
     auto appInfoManager = IoC<AppInfoManager>();
 
     switch (p.command) {
-    case Control::Rpc_AppInfoManager_lookupAppInfo: {
-        appInfoManager->lookupAppInfo(p.args.value(0).toString());
+    case Control::Rpc_AppInfoManager_lookupAppInfos: {
+        appInfoManager->lookupAppInfos(p.args.value(0).toStringList());
         return true;
     }
     case Control::Rpc_AppInfoManager_checkLookupInfoFinished: {
         appInfoManager->checkLookupInfoFinished(p.args.value(0).toString());
         return true;
     }
+    case Control::Rpc_AppInfoManager_lookupInfoDropped: {
+        emit appInfoManager->lookupInfoDropped(p.args.value(0).toString());
+        return true;
+    }
     default:
         return false;
     }
@@ -44,4 +48,9 @@ void AppInfoManagerRpc::setupServerSignals(RpcManager *rpcManager)
                 rpcManager->invokeOnClients(
                         Control::Rpc_AppInfoManager_checkLookupInfoFinished, { appPath });
             });
+    connect(appInfoManager, &AppInfoManager::lookupInfoDropped, rpcManager,
+            [=](const QString &appPath) {
+                rpcManager->invokeOnClients(
+                        Control::Rpc_AppInfoManager_lookupInfoDropped, { appPath });
+            });
 }
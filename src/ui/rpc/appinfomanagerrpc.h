@@ -18,7 +18,7 @@ public:
     static void setupServerSignals(RpcManager *rpcManager);
 
 public slots:
-    void lookupAppInfo(const QString &appPath) override;
+    void lookupAppInfos(const QStringList &appPaths) override;
 };
 
 #endif // APPINFOMANAGERRPC_H
@@ -140,7 +140,7 @@ void AutoUpdateManagerRpc::setupServerSignals(RpcManager *rpcManager)
 
 bool AutoUpdateManagerRpc::startDownload()
 {
-    return IoC<RpcManager>()->doOnServer(Control::Rpc_AutoUpdateManager_startDownload);
+    return IoC<RpcManager>()->invokeOnServerAsync(Control::Rpc_AutoUpdateManager_startDownload);
 }
 
 bool AutoUpdateManagerRpc::runInstaller()
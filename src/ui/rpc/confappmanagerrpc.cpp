@@ -168,12 +168,12 @@ bool ConfAppManagerRpc::deleteApps(const QVector<qint64> &appIdList)
     QVariantList args;
     VariantUtil::addToList(args, QVariant(appIdVarList));
 
-    return IoC<RpcManager>()->doOnServer(Control::Rpc_ConfAppManager_deleteApps, args);
+    return IoC<RpcManager>()->invokeOnServerAsync(Control::Rpc_ConfAppManager_deleteApps, args);
 }
 
 bool ConfAppManagerRpc::clearAlerts()
 {
-    return IoC<RpcManager>()->doOnServer(Control::Rpc_ConfAppManager_clearAlerts);
+    return IoC<RpcManager>()->invokeOnServerAsync(Control::Rpc_ConfAppManager_clearAlerts);
 }
 
 bool ConfAppManagerRpc::purgeApps()
@@ -191,7 +191,8 @@ bool ConfAppManagerRpc::updateAppsBlocked(
     VariantUtil::addToList(args, QVariant(appIdVarList));
     args << blocked << killProcess;
 
-    return IoC<RpcManager>()->doOnServer(Control::Rpc_ConfAppManager_updateAppsBlocked, args);
+    return IoC<RpcManager>()->invokeOnServerAsync(
+            Control::Rpc_ConfAppManager_updateAppsBlocked, args);
 }
 
 bool ConfAppManagerRpc::updateAppsTimer(const QVector<qint64> &appIdList, int minutes)
@@ -203,7 +204,8 @@ bool ConfAppManagerRpc::updateAppsTimer(const QVector<qint64> &appIdList, int mi
     VariantUtil::addToList(args, QVariant(appIdVarList));
     args << minutes;
 
-    return IoC<RpcManager>()->doOnServer(Control::Rpc_ConfAppManager_updateAppsTimer, args);
+    return IoC<RpcManager>()->invokeOnServerAsync(
+            Control::Rpc_ConfAppManager_updateAppsTimer, args);
 }
 
 bool ConfAppManagerRpc::importAppsBackup(const QString &path)
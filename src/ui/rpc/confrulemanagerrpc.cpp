@@ -87,7 +87,7 @@ bool ConfRuleManagerRpc::updateRuleName(quint16 ruleId, const QString &ruleName)
 
 bool ConfRuleManagerRpc::updateRuleEnabled(quint16 ruleId, bool enabled)
 {
-    return IoC<RpcManager>()->doOnServer(
+    return IoC<RpcManager>()->invokeOnServerAsync(
             Control::Rpc_ConfRuleManager_updateRuleEnabled, { ruleId, enabled });
 }
 
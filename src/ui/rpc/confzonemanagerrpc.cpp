@@ -86,7 +86,7 @@ bool ConfZoneManagerRpc::updateZoneName(quint8 zoneId, const QString &zoneName)
 
 bool ConfZoneManagerRpc::updateZoneEnabled(quint8 zoneId, bool enabled)
 {
-    return IoC<RpcManager>()->doOnServer(
+    return IoC<RpcManager>()->invokeOnServerAsync(
             Control::Rpc_ConfZoneManager_updateZoneEnabled, { zoneId, enabled });
 }
 
@@ -124,7 +124,7 @@ bool ConfZoneManagerRpc::processServerCommand(const ProcessCommandArgs &p, Proce
         return true;
     }
     case Control::Rpc_ConfZoneManager_zoneUpdated: {
-        emit confZoneManager->zoneUpdated();
+        emit confZoneManager->zoneUpdated(p.args.value(0).toInt());
         return true;
     }
     default: {
@@ -144,6 +144,7 @@ void ConfZoneManagerRpc::setupServerSignals(RpcManager *rpcManager)
     connect(confZoneManager, &ConfZoneManager::zoneRemoved, rpcManager, [=](quint8 zoneId) {
         rpcManager->invokeOnClients(Control::Rpc_ConfZoneManager_zoneRemoved, { zoneId });
     });
-    connect(confZoneManager, &ConfZoneManager::zoneUpdated, rpcManager,
-            [=] { rpcManager->invokeOnClients(Control::Rpc_ConfZoneManager_zoneUpdated); });
+    connect(confZoneManager, &ConfZoneManager::zoneUpdated, rpcManager, [=](quint8 zoneId) {
+        rpcManager->invokeOnClients(Control::Rpc_ConfZoneManager_zoneUpdated, { zoneId });
+    });
 }
@@ -0,0 +1,56 @@
+#include "hostinfomanagerrpc.h"
+
+#include <sqlite/sqlitedb.h>
+
+#include <rpc/rpcmanager.h>
+#include <util/ioc/ioccontainer.h>
+
+HostInfoManagerRpc::HostInfoManagerRpc(const QString &filePath, bool noCache, QObject *parent) :
+    HostInfoManager(filePath, parent,
+            (noCache ? SqliteDb::OpenDefaultReadWrite : SqliteDb::OpenDefaultReadOnly))
+{
+}
+
+void HostInfoManagerRpc::lookupHosts(const QStringList &addresses)
+{
+    IoC<RpcManager>()->invokeOnServer(Control::Rpc_HostInfoManager_lookupHosts, { addresses });
+}
+
+bool HostInfoManagerRpc::processServerCommand(
+        const ProcessCommandArgs &p, ProcessCommandResult & /*r*/)
+{
+    auto hostInfoManager = IoC<HostInfoManager>();
+
+    switch (p.command) {
+    case Control::Rpc_HostInfoManager_lookupHosts: {
+        hostInfoManager->lookupHosts(p.args.value(0).toStringList());
+        return true;
+    }
+    case Control::Rpc_HostInfoManager_checkLookupFinished: {
+        hostInfoManager->checkLookupFinished(p.args.value(0).toStringList());
+        return true;
+    }
+    case Control::Rpc_HostInfoManager_lookupDropped: {
+        emit hostInfoManager->lookupDropped(p.args.value(0).toString());
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+void HostInfoManagerRpc::setupServerSignals(RpcManager *rpcManager)
+{
+    auto hostInfoManager = IoC<HostInfoManager>();
+
+    connect(hostInfoManager, &HostInfoManager::lookupsFinished, rpcManager,
+            [=](const QStringList &addresses) {
+                rpcManager->invokeOnClients(
+                        Control::Rpc_HostInfoManager_checkLookupFinished, { addresses });
+            });
+    connect(hostInfoManager, &HostInfoManager::lookupDropped, rpcManager,
+            [=](const QString &address) {
+                rpcManager->invokeOnClients(
+                        Control::Rpc_HostInfoManager_lookupDropped, { address });
+            });
+}
@@ -0,0 +1,24 @@
+#ifndef HOSTINFOMANAGERRPC_H
+#define HOSTINFOMANAGERRPC_H
+
+#include <control/control_types.h>
+#include <hostinfo/hostinfomanager.h>
+
+class RpcManager;
+
+class HostInfoManagerRpc : public HostInfoManager
+{
+    Q_OBJECT
+
+public:
+    explicit HostInfoManagerRpc(const QString &filePath, bool noCache, QObject *parent = nullptr);
+
+    static bool processServerCommand(const ProcessCommandArgs &p, ProcessCommandResult &r);
+
+    static void setupServerSignals(RpcManager *rpcManager);
+
+public slots:
+    void lookupHosts(const QStringList &addresses) override;
+};
+
+#endif // HOSTINFOMANAGERRPC_H
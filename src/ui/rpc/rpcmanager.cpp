@@ -1,6 +1,7 @@
 #include "rpcmanager.h"
 
 #include <QLoggingCategory>
+#include <QTimer>
 
 #include <conf/firewallconf.h>
 #include <conf/rule.h>
@@ -17,6 +18,7 @@
 #include <rpc/confzonemanagerrpc.h>
 #include <rpc/drivelistmanagerrpc.h>
 #include <rpc/drivermanagerrpc.h>
+#include <rpc/hostinfomanagerrpc.h>
 #include <rpc/quotamanagerrpc.h>
 #include <rpc/serviceinfomanagerrpc.h>
 #include <rpc/statconnmanagerrpc.h>
@@ -30,6 +32,10 @@ namespace {
 
 const QLoggingCategory LC("rpc");
 
+constexpr int requestTimeoutMsecs = 10 * 1000;
+constexpr int requestWaitMsecs = 700;
+constexpr int requestWaitCount = 3;
+
 void showErrorBox(const QString &text)
 {
     auto windowManager = IoC<WindowManager>();
@@ -87,20 +93,30 @@ void RpcManager::setupServerSignals()
     ConfRuleManagerRpc::setupServerSignals(this);
     ConfZoneManagerRpc::setupServerSignals(this);
     DriverManagerRpc::setupServerSignals(this);
+    HostInfoManagerRpc::setupServerSignals(this);
     QuotaManagerRpc::setupServerSignals(this);
     StatManagerRpc::setupServerSignals(this);
     StatConnManagerRpc::setupServerSignals(this);
     TaskManagerRpc::setupServerSignals(this);
 }
 
+void RpcManager::setClient(ControlWorker *client)
+{
+    m_client = client;
+
+    // Results of the requests sent over a previous connection never come
+    connect(client, &ControlWorker::connected, this, [&] {
+        abortRequests();
+        invokeOnServer(Control::Rpc_RpcManager_initClient);
+    });
+    connect(client, &ControlWorker::disconnected, this, &RpcManager::abortRequests);
+}
+
 void RpcManager::setupClient()
 {
     auto controlManager = IoCDependency<ControlManager>();
 
-    m_client = controlManager->newServiceClient(this);
-
-    connect(client(), &ControlWorker::connected, this,
-            [&] { invokeOnServer(Control::Rpc_RpcManager_initClient); });
+    setClient(controlManager->newServiceClient(this));
 
     client()->setIsTryReconnect(true);
     client()->reconnectToServer();
@@ -115,48 +131,145 @@ void RpcManager::closeClient()
     client()->close();
 }
 
-bool RpcManager::waitResult()
+bool RpcManager::checkClientConnected()
 {
-    return client()->waitResult(m_resultCommand);
+    if (!client()->isConnected() && !client()->reconnectToServer()) {
+        showErrorBox(tr("Service isn't available."));
+        return false;
+    }
+
+    return true;
 }
 
-void RpcManager::sendResult(ControlWorker *w, bool ok, const QVariantList &args)
+bool RpcManager::invokeOnServer(Control::Command cmd, const QVariantList &args)
 {
-    // DBG: qCDebug(LC) << "Send Result to Client: id:" << w->id() << ok << args.size();
+    if (!checkClientConnected())
+        return false;
 
-    w->sendResult(ok, args);
+    return client()->sendCommand(cmd, args);
 }
 
-bool RpcManager::invokeOnServer(Control::Command cmd, const QVariantList &args)
+bool RpcManager::invokeOnServerAsync(
+        Control::Command cmd, const QVariantList &args, const RpcResultFunc &onResult)
 {
-    if (!client()->isConnected() && !client()->reconnectToServer()) {
-        showErrorBox(tr("Service isn't available."));
+    const quint32 requestId = sendRequest(cmd, args, onResult);
+    if (requestId == 0)
         return false;
-    }
 
-    return client()->sendCommand(cmd, args);
+    QTimer::singleShot(
+            requestTimeoutMsecs, this, [=, this] { processRequestTimeout(requestId); });
+
+    return true;
 }
 
 bool RpcManager::doOnServer(Control::Command cmd, const QVariantList &args, QVariantList *resArgs)
 {
-    if (!invokeOnServer(cmd, args))
+    bool ok = false;
+
+    const quint32 requestId =
+            sendRequest(cmd, args, [&](bool resultOk, const QVariantList &resultArgs) {
+                ok = resultOk;
+
+                if (resArgs) {
+                    *resArgs = resultArgs;
+                }
+            });
+    if (requestId == 0)
         return false;
 
-    if (!waitResult()) {
+    if (!waitRequest(requestId)) {
+        m_requests.remove(requestId);
+
         showErrorBox(tr("Service isn't responding."));
         return false;
     }
 
-    if (resultCommand() != Control::Rpc_Result_Ok)
-        return false;
+    return ok;
+}
+
+quint32 RpcManager::sendRequest(
+        Control::Command cmd, const QVariantList &args, const RpcResultFunc &onResult)
+{
+    if (!checkClientConnected())
+        return 0;
 
-    if (resArgs) {
-        *resArgs = resultArgs();
+    quint32 requestId = ++m_lastRequestId;
+    if (Q_UNLIKELY(requestId == 0)) {
+        requestId = ++m_lastRequestId; // zero is for untagged commands
+    }
+
+    if (!client()->sendCommand(cmd, args, requestId))
+        return 0;
+
+    m_requests.insert(requestId, onResult);
+
+    return requestId;
+}
+
+bool RpcManager::waitRequest(quint32 requestId)
+{
+    // Results of other pending requests are processed while waiting
+    int waitCount = requestWaitCount;
+    while (m_requests.contains(requestId)) {
+        if (!client()->waitForRead(requestWaitMsecs)) {
+            if (--waitCount <= 0)
+                return false;
+        }
     }
 
     return true;
 }
 
+void RpcManager::processResult(quint32 requestId, bool ok, const QVariantList &args)
+{
+    const auto it = m_requests.constFind(requestId);
+    if (it == m_requests.constEnd()) {
+        qCDebug(LC) << "Stale result:" << requestId << ok;
+        return;
+    }
+
+    const RpcResultFunc onResult = it.value();
+
+    m_requests.erase(it);
+
+    if (onResult) {
+        onResult(ok, args);
+    } else if (!ok) {
+        qCWarning(LC) << "Request error:" << requestId;
+
+        showErrorBox(tr("Service couldn't execute the command."));
+    }
+}
+
+void RpcManager::processRequestTimeout(quint32 requestId)
+{
+    if (!m_requests.contains(requestId))
+        return;
+
+    qCWarning(LC) << "Request timed out:" << requestId;
+
+    const RpcResultFunc onResult = m_requests.take(requestId);
+    if (onResult) {
+        onResult(/*ok=*/false, {});
+    }
+
+    showErrorBox(tr("Service isn't responding."));
+}
+
+void RpcManager::abortRequests()
+{
+    if (m_requests.isEmpty())
+        return;
+
+    const auto requests = std::exchange(m_requests, {});
+
+    for (const RpcResultFunc &onResult : requests) {
+        if (onResult) {
+            onResult(/*ok=*/false, {});
+        }
+    }
+}
+
 void RpcManager::invokeOnClients(Control::Command cmd, const QVariantList &args)
 {
     const auto &clients = IoC<ControlManager>()->clients();
@@ -194,8 +307,7 @@ bool RpcManager::processCommandRpc(const ProcessCommandArgs &p, ProcessCommandRe
     switch (p.command) {
     case Control::Rpc_Result_Ok:
     case Control::Rpc_Result_Error: {
-        m_resultCommand = p.command;
-        m_resultArgs = p.args;
+        processResult(p.requestId, (p.command == Control::Rpc_Result_Ok), p.args);
         return true;
     }
     case Control::Rpc_RpcManager_initClient: {
@@ -216,6 +328,7 @@ static const processCommand_func processManager_funcList[] = {
     &ConfZoneManagerRpc::processServerCommand, // Control::Rpc_ConfZoneManager,
     &DriverManagerRpc::processServerCommand, // Control::Rpc_DriverManager,
     &DriveListManagerRpc::processServerCommand, // Control::Rpc_DriveListManager,
+    &HostInfoManagerRpc::processServerCommand, // Control::Rpc_HostInfoManager,
     &QuotaManagerRpc::processServerCommand, // Control::Rpc_QuotaManager,
     &StatManagerRpc::processServerCommand, // Control::Rpc_StatManager,
     &StatConnManagerRpc::processServerCommand, // Control::Rpc_StatBlockManager,
@@ -1,15 +1,20 @@
 #ifndef RPCMANAGER_H
 #define RPCMANAGER_H
 
+#include <QHash>
 #include <QObject>
 #include <QVariant>
 
+#include <functional>
+
 #include <control/control.h>
 #include <util/ioc/iocservice.h>
 
 struct ProcessCommandArgs;
 class ControlWorker;
 
+using RpcResultFunc = std::function<void(bool ok, const QVariantList &args)>;
+
 class RpcManager : public QObject, public IocService
 {
     Q_OBJECT
@@ -17,18 +22,17 @@ class RpcManager : public QObject, public IocService
 public:
     explicit RpcManager(QObject *parent = nullptr);
 
-    Control::Command resultCommand() const { return m_resultCommand; }
-    QVariantList resultArgs() const { return m_resultArgs; }
-
     ControlWorker *client() const { return m_client; }
+    void setClient(ControlWorker *client);
+
+    int pendingRequestsCount() const { return m_requests.size(); }
 
     void setUp() override;
     void tearDown() override;
 
-    bool waitResult();
-    void sendResult(ControlWorker *w, bool ok, const QVariantList &args = {});
-
     bool invokeOnServer(Control::Command cmd, const QVariantList &args = {});
+    bool invokeOnServerAsync(
+            Control::Command cmd, const QVariantList &args = {}, const RpcResultFunc &onResult = {});
     bool doOnServer(
             Control::Command cmd, const QVariantList &args = {}, QVariantList *resArgs = nullptr);
 
@@ -53,14 +57,25 @@ private:
     void setupClient();
     void closeClient();
 
+    bool checkClientConnected();
+
+    quint32 sendRequest(
+            Control::Command cmd, const QVariantList &args, const RpcResultFunc &onResult);
+    bool waitRequest(quint32 requestId);
+
+    void processResult(quint32 requestId, bool ok, const QVariantList &args);
+    void processRequestTimeout(quint32 requestId);
+    void abortRequests();
+
     bool checkClientValidated(ControlWorker *w) const;
     void initClientOnServer(ControlWorker *w) const;
 
     bool processManagerRpc(const ProcessCommandArgs &p, ProcessCommandResult &r);
 
 private:
-    Control::Command m_resultCommand = Control::CommandNone;
-    QVariantList m_resultArgs;
+    quint32 m_lastRequestId = 0;
+
+    QHash<quint32, RpcResultFunc> m_requests;
 
     ControlWorker *m_client = nullptr;
 };
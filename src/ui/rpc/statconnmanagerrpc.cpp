@@ -28,7 +28,7 @@ StatConnManagerRpc::StatConnManagerRpc(const QString &filePath, QObject *parent)
 
 void StatConnManagerRpc::deleteConn(qint64 connIdTo)
 {
-    IoC<RpcManager>()->doOnServer(Control::Rpc_StatConnManager_deleteConn, { connIdTo });
+    IoC<RpcManager>()->invokeOnServerAsync(Control::Rpc_StatConnManager_deleteConn, { connIdTo });
 }
 
 bool StatConnManagerRpc::processServerCommand(const ProcessCommandArgs &p, ProcessCommandResult &r)
@@ -86,12 +86,13 @@ StatManagerRpc::StatManagerRpc(const QString &filePath, QObject *parent) :
 
 bool StatManagerRpc::deleteStatApp(qint64 appId)
 {
-    return IoC<RpcManager>()->doOnServer(Control::Rpc_StatManager_deleteStatApp, { appId });
+    return IoC<RpcManager>()->invokeOnServerAsync(
+            Control::Rpc_StatManager_deleteStatApp, { appId });
 }
 
 bool StatManagerRpc::resetAppTrafTotals()
 {
-    return IoC<RpcManager>()->doOnServer(Control::Rpc_StatManager_resetAppTrafTotals);
+    return IoC<RpcManager>()->invokeOnServerAsync(Control::Rpc_StatManager_resetAppTrafTotals);
 }
 
 bool StatManagerRpc::exportMasterBackup(const QString &path)
@@ -106,7 +107,7 @@ bool StatManagerRpc::importMasterBackup(const QString &path)
 
 bool StatManagerRpc::clearTraffic()
 {
-    return IoC<RpcManager>()->doOnServer(Control::Rpc_StatManager_clearTraffic);
+    return IoC<RpcManager>()->invokeOnServerAsync(Control::Rpc_StatManager_clearTraffic);
 }
 
 bool StatManagerRpc::processServerCommand(const ProcessCommandArgs &p, ProcessCommandResult &r)
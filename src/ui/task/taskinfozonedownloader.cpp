@@ -14,6 +14,7 @@
 
 #include "taskmanager.h"
 #include "taskzonedownloader.h"
+#include "zoneparsemanager.h"
 
 namespace {
 
@@ -26,6 +27,12 @@ TaskInfoZoneDownloader::TaskInfoZoneDownloader(TaskManager &taskManager) :
 {
 }
 
+TaskInfoZoneDownloader::~TaskInfoZoneDownloader()
+{
+    // Wait for the parsing jobs, which use the zones
+    delete m_parseManager;
+}
+
 TaskZoneDownloader *TaskInfoZoneDownloader::zoneDownloader() const
 {
     return static_cast<TaskZoneDownloader *>(taskWorker());
@@ -68,24 +75,44 @@ bool TaskInfoZoneDownloader::saveZoneAsText(const QString &filePath, int zoneInd
 
 void TaskInfoZoneDownloader::setupTaskWorker()
 {
+    // The aborted run is still parsing the downloaded zones: run after it
+    if (m_parsePendingCount > 0) {
+        m_runPending = true;
+        return;
+    }
+
+    m_runPending = false;
+
     m_success = false;
     m_zoneIndex = 0;
     m_zonesMask = 0;
     m_zoneNames.clear();
 
     clearSubResults();
+    clearZoneResults();
+
+    setupParseManager();
 
     setupNextTaskWorker();
 }
 
-void TaskInfoZoneDownloader::setupNextTaskWorker()
+void TaskInfoZoneDownloader::setupParseManager()
+{
+    if (m_parseManager)
+        return;
+
+    m_parseManager = new ZoneParseManager(this);
+
+    connect(m_parseManager, &ZoneParseManager::zoneParsed, this,
+            &TaskInfoZoneDownloader::handleZoneParsed, Qt::QueuedConnection);
+}
+
+bool TaskInfoZoneDownloader::setupNextTaskWorker()
 {
     const int rowCount = zoneListModel()->rowCount();
     if (m_zoneIndex >= rowCount) {
-        emitZonesUpdated();
-
-        TaskInfo::handleFinished(m_success);
-        return;
+        checkZoneResults();
+        return false;
     }
 
     abortTask();
@@ -94,6 +121,11 @@ void TaskInfoZoneDownloader::setupNextTaskWorker()
     auto worker = zoneDownloader();
 
     setupTaskWorkerByZone(worker);
+
+    // Parse the downloaded data in parallel with the next downloads
+    worker->setDeferParse(true);
+
+    return true;
 }
 
 void TaskInfoZoneDownloader::setupTaskWorkerByZone(TaskZoneDownloader *worker)
@@ -104,6 +136,7 @@ void TaskInfoZoneDownloader::setupTaskWorkerByZone(TaskZoneDownloader *worker)
     const ZoneTypeWrapper zoneType(zoneListModel()->zoneTypeByCode(zoneSource.zoneType()));
 
     worker->setZoneEnabled(zoneRow.enabled);
+    worker->setZoneType(zoneType.id());
     worker->setSort(zoneType.sort());
     worker->setEmptyNetMask(zoneType.emptyNetMask());
     worker->setZoneId(zoneRow.zoneId);
@@ -124,28 +157,95 @@ void TaskInfoZoneDownloader::setupTaskWorkerByZone(TaskZoneDownloader *worker)
 
 void TaskInfoZoneDownloader::handleFinished(bool success)
 {
-    processSubResult(success);
-
-    if (success) {
-        m_success = true;
-    }
-
     if (aborted()) {
         m_zoneIndex = INT_MAX;
     } else {
+        addZoneResult(zoneDownloader(), success);
+
         ++m_zoneIndex;
     }
 
-    setupNextTaskWorker();
-    runTaskWorker();
+    if (setupNextTaskWorker()) {
+        runTaskWorker();
+    }
+}
+
+void TaskInfoZoneDownloader::handleZoneParsed(int zoneIndex, bool success)
+{
+    --m_parsePendingCount;
+
+    m_zoneResults[zoneIndex].success = success;
+
+    checkZoneResults();
+}
+
+void TaskInfoZoneDownloader::addZoneResult(TaskZoneDownloader *worker, bool success)
+{
+    // Copy the zone's state from the downloader, which will be reused
+    auto zone = new TaskZoneDownloader(this);
+
+    setupTaskWorkerByZone(zone);
+
+    zone->setSourceModTime(worker->sourceModTime());
+
+    const int zoneIndex = m_zoneResults.size();
+
+    m_zoneResults.append({ .success = false, .zone = zone });
+
+    if (success) {
+        // The parsing rewrites the cache file
+        releaseZoneCacheFile(zone->zoneId());
+
+        ++m_parsePendingCount;
+
+        m_parseManager->parseZone(zoneIndex, zone, worker->takeDownloadedData());
+    }
 }
 
-void TaskInfoZoneDownloader::processSubResult(bool success)
+void TaskInfoZoneDownloader::checkZoneResults()
 {
-    if (aborted() && !success)
+    if (m_parsePendingCount > 0 || m_zoneIndex < zoneListModel()->rowCount())
         return;
 
-    auto worker = zoneDownloader();
+    processZoneResults();
+
+    emitZonesUpdated();
+
+    // Continue with the run requested while parsing
+    if (m_runPending) {
+        setupTaskWorker();
+        runTaskWorker();
+        return;
+    }
+
+    TaskInfo::handleFinished(m_success);
+}
+
+void TaskInfoZoneDownloader::processZoneResults()
+{
+    for (const ZoneResult &result : std::as_const(m_zoneResults)) {
+        processSubResult(result.zone, result.success);
+    }
+
+    clearZoneResults();
+}
+
+void TaskInfoZoneDownloader::clearZoneResults()
+{
+    for (const ZoneResult &result : std::as_const(m_zoneResults)) {
+        result.zone->deleteLater();
+    }
+
+    m_zoneResults.clear();
+}
+
+void TaskInfoZoneDownloader::processSubResult(TaskZoneDownloader *worker, bool success)
+{
+    addSubResult(worker, success);
+
+    if (success) {
+        m_success = true;
+    }
 
     Zone zone;
     zone.zoneId = worker->zoneId();
@@ -158,8 +258,6 @@ void TaskInfoZoneDownloader::processSubResult(bool success)
     zone.lastSuccess = success ? zone.lastRun : worker->lastSuccess();
 
     IoC<ConfZoneManager>()->updateZoneResult(zone);
-
-    addSubResult(worker, success);
 }
 
 void TaskInfoZoneDownloader::clearSubResults()
@@ -168,6 +266,7 @@ void TaskInfoZoneDownloader::clearSubResults()
     m_enabledMask = 0;
     m_dataSize = 0;
     m_zonesData.clear();
+    m_zonesCacheFiles.clear();
 }
 
 void TaskInfoZoneDownloader::addSubResult(TaskZoneDownloader *worker, bool success)
@@ -187,6 +286,10 @@ void TaskInfoZoneDownloader::addSubResult(TaskZoneDownloader *worker, bool succe
     m_dataSize += size;
     m_zonesData.append(zoneData);
 
+    if (worker->cacheFile()) {
+        m_zonesCacheFiles.insert(worker->zoneId(), worker->cacheFile());
+    }
+
     insertZoneId(m_dataZonesMask, worker->zoneId());
 
     if (worker->zoneEnabled()) {
@@ -203,11 +306,40 @@ void TaskInfoZoneDownloader::emitZonesUpdated()
     clearSubResults();
 }
 
+void TaskInfoZoneDownloader::releaseZoneCacheFile(int zoneId)
+{
+    const ZoneCacheFilePtr cacheFile = m_zonesCacheFiles.take(zoneId);
+    if (!cacheFile)
+        return;
+
+    // Drop the zone's data, which refers to the mapped file
+    const char *mappedData = cacheFile->zoneData().constData();
+
+    m_zonesData.removeIf([&](const QByteArray &zoneData) {
+        if (zoneData.constData() != mappedData)
+            return false;
+
+        m_dataSize -= zoneData.size();
+        return true;
+    });
+
+    removeZoneId(m_dataZonesMask, zoneId);
+    removeZoneId(m_enabledMask, zoneId);
+
+    // Unmap the file to be able to rewrite or remove it
+    cacheFile->close();
+}
+
 void TaskInfoZoneDownloader::insertZoneId(quint32 &zonesMask, int zoneId)
 {
     zonesMask |= (quint32(1) << (zoneId - 1));
 }
 
+void TaskInfoZoneDownloader::removeZoneId(quint32 &zonesMask, int zoneId)
+{
+    zonesMask &= ~(quint32(1) << (zoneId - 1));
+}
+
 bool TaskInfoZoneDownloader::containsZoneId(quint32 zonesMask, int zoneId) const
 {
     return (zonesMask & (quint32(1) << (zoneId - 1))) != 0;
@@ -221,15 +353,32 @@ void TaskInfoZoneDownloader::loadZones()
     for (m_zoneIndex = 0; m_zoneIndex < rowCount; ++m_zoneIndex) {
         setupTaskWorkerByZone(&worker);
         addSubResult(&worker, /*success=*/false);
+
+        updateZoneBinChecksum(&worker);
     }
 }
 
+void TaskInfoZoneDownloader::updateZoneBinChecksum(TaskZoneDownloader *worker)
+{
+    Zone zone = zoneListModel()->zoneRowAt(m_zoneIndex);
+
+    // The cache file was converted from previous version
+    if (zone.binChecksum == worker->binChecksum())
+        return;
+
+    zone.binChecksum = worker->binChecksum();
+
+    IoC<ConfZoneManager>()->updateZoneResult(zone);
+}
+
 void TaskInfoZoneDownloader::removeOrphanCacheFiles()
 {
     const auto fileInfos = QDir(cachePath()).entryInfoList(QDir::Files);
     for (const auto &fi : fileInfos) {
         const auto zoneId = fi.baseName().toInt();
         if (zoneId != 0 && !containsZoneId(m_zonesMask, zoneId)) {
+            releaseZoneCacheFile(zoneId);
+
             FileUtil::removeFile(fi.filePath());
         }
     }
@@ -2,11 +2,15 @@
 #define TASKINFOZONEDOWNLOADER_H
 
 #include <QByteArray>
+#include <QHash>
+
+#include <util/conf/zonecachefile.h>
 
 #include "taskinfo.h"
 
 class TaskZoneDownloader;
 class ZoneListModel;
+class ZoneParseManager;
 
 class TaskInfoZoneDownloader : public TaskInfo
 {
@@ -14,6 +18,7 @@ class TaskInfoZoneDownloader : public TaskInfo
 
 public:
     explicit TaskInfoZoneDownloader(TaskManager &taskManager);
+    ~TaskInfoZoneDownloader() override;
 
     quint32 dataZonesMask() const { return m_dataZonesMask; }
     quint32 enabledMask() const { return m_enabledMask; }
@@ -37,18 +42,38 @@ protected slots:
 
     void handleFinished(bool success) override;
 
-    void processSubResult(bool success);
+    void handleZoneParsed(int zoneIndex, bool success);
+
     void clearSubResults();
 
 private:
-    void setupNextTaskWorker();
+    struct ZoneResult
+    {
+        bool success = false;
+        TaskZoneDownloader *zone = nullptr;
+    };
+
+    void setupParseManager();
+
+    bool setupNextTaskWorker();
     void setupTaskWorkerByZone(TaskZoneDownloader *worker);
+
+    void addZoneResult(TaskZoneDownloader *worker, bool success);
+    void checkZoneResults();
+    void processZoneResults();
+    void clearZoneResults();
+
+    void processSubResult(TaskZoneDownloader *worker, bool success);
     void addSubResult(TaskZoneDownloader *worker, bool success);
 
+    void releaseZoneCacheFile(int zoneId);
+
     void insertZoneId(quint32 &zonesMask, int zoneId);
+    void removeZoneId(quint32 &zonesMask, int zoneId);
     bool containsZoneId(quint32 zonesMask, int zoneId) const;
 
     void loadZones();
+    void updateZoneBinChecksum(TaskZoneDownloader *worker);
 
     void emitZonesUpdated();
 
@@ -58,7 +83,9 @@ private:
 
 private:
     bool m_success = false;
+    bool m_runPending = false;
     int m_zoneIndex = 0;
+    int m_parsePendingCount = 0;
     quint32 m_zonesMask = 0;
 
     quint32 m_dataZonesMask = 0;
@@ -67,6 +94,11 @@ private:
 
     QStringList m_zoneNames;
     QList<QByteArray> m_zonesData;
+    QHash<int, ZoneCacheFilePtr> m_zonesCacheFiles; // keep the zones data mapped, by zone id
+
+    QList<ZoneResult> m_zoneResults; // in the zones order
+
+    ZoneParseManager *m_parseManager = nullptr;
 };
 
 #endif // TASKINFOZONEDOWNLOADER_H
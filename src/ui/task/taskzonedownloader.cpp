@@ -6,6 +6,7 @@
 
 #include <util/conf/confbuffer.h>
 #include <util/fileutil.h>
+#include <util/net/iplistscanner.h>
 #include <util/net/iprange.h>
 #include <util/net/netdownloader.h>
 #include <util/stringutil.h>
@@ -39,18 +40,10 @@ void TaskZoneDownloader::setupDownloader()
 void TaskZoneDownloader::downloadFinished(const QByteArray &data, bool success)
 {
     if (success) {
-        success = false;
-
-        QString textChecksum;
-        const auto text = QString::fromLatin1(data);
-        const auto list = parseAddresses(text, textChecksum);
-
-        if (!list.isEmpty()
-                && (this->textChecksum() != textChecksum
-                        || !FileUtil::fileExists(cacheFileBinPath()))) {
-            setTextChecksum(textChecksum);
-            success = storeAddresses(list);
-            setAddressCount(success ? list.size() : 0);
+        if (deferParse()) {
+            m_downloadedData = data;
+        } else {
+            success = processData(data);
         }
     }
 
@@ -110,6 +103,62 @@ StringViewList TaskZoneDownloader::parseAddresses(const QString &text, QString &
     return list;
 }
 
+int TaskZoneDownloader::parseAddressesData(
+        const QByteArray &data, IpRange &ipRange, QString &checksum)
+{
+    auto scanType = IpListScanner::ScanType(zoneType());
+    if (!pattern().isEmpty() && !IpListScanner::scanTypeByPattern(pattern(), scanType))
+        return parseAddressesText(data, ipRange, checksum);
+
+    IpListScanner scanner(data, scanType);
+
+    const bool ok = ipRange.fromScanner(scanner, sort());
+
+    checksum = scanner.checksum();
+
+    if (!ok) {
+        qCWarning(LC) << zoneName() << ":" << ipRange.errorLineAndMessageDetails();
+        return -1;
+    }
+
+    return scanner.tokenCount();
+}
+
+int TaskZoneDownloader::parseAddressesText(
+        const QByteArray &data, IpRange &ipRange, QString &checksum) const
+{
+    // Custom pattern of the zone type
+    const QString text = QString::fromUtf8(data);
+    const auto list = parseAddresses(text, checksum);
+
+    if (!ipRange.fromList(list, sort())) {
+        qCWarning(LC) << zoneName() << ":" << ipRange.errorLineAndMessageDetails();
+        return -1;
+    }
+
+    return list.size();
+}
+
+bool TaskZoneDownloader::processData(const QByteArray &data)
+{
+    IpRange ipRange;
+    ipRange.setEmptyNetMask(emptyNetMask());
+
+    QString textChecksum;
+    const int count = parseAddressesData(data, ipRange, textChecksum);
+
+    if (count <= 0
+            || (this->textChecksum() == textChecksum && FileUtil::fileExists(cacheFileBinPath())))
+        return false;
+
+    setTextChecksum(textChecksum);
+
+    const bool success = storeAddresses(ipRange);
+    setAddressCount(success ? count : 0);
+
+    return success;
+}
+
 bool TaskZoneDownloader::storeAddresses(const StringViewList &list)
 {
     IpRange ipRange;
@@ -120,6 +169,13 @@ bool TaskZoneDownloader::storeAddresses(const StringViewList &list)
         return false;
     }
 
+    return storeAddresses(ipRange);
+}
+
+bool TaskZoneDownloader::storeAddresses(const IpRange &ipRange)
+{
+    m_cacheFile.reset();
+
     FileUtil::removeFile(cacheFileBinPath());
 
     // Store binary file
@@ -131,31 +187,73 @@ bool TaskZoneDownloader::storeAddresses(const StringViewList &list)
     if (m_zoneData.isEmpty())
         return false;
 
-    const auto binData = qCompress(m_zoneData);
+    return storeZoneData();
+}
 
-    const auto binChecksumData = QCryptographicHash::hash(binData, QCryptographicHash::Sha256);
-    setBinChecksum(QString::fromLatin1(binChecksumData.toHex()));
+bool TaskZoneDownloader::storeZoneData()
+{
+    QString binChecksum;
+    if (!ZoneCacheFile::write(cacheFileBinPath(), m_zoneData, binChecksum)) {
+        qCWarning(LC) << zoneName() << ": Cache write error:" << cacheFileBinPath();
+        return false;
+    }
 
-    return FileUtil::writeFileData(cacheFileBinPath(), binData);
+    // Verify the whole written payload once, the loads check only the layout
+    ZoneCacheFile cacheFile(cacheFileBinPath());
+    if (cacheFile.open(binChecksum, /*verifyData=*/true) != ZoneCacheFile::ErrorOk) {
+        FileUtil::removeFile(cacheFileBinPath());
+        return false;
+    }
+
+    setBinChecksum(binChecksum);
+
+    return true;
 }
 
 bool TaskZoneDownloader::loadAddresses()
 {
+    m_zoneData.clear();
+    m_cacheFile.reset();
+
     if (!FileUtil::fileExists(cacheFileBinPath()))
         return false;
 
+    ZoneCacheFilePtr cacheFile(new ZoneCacheFile(cacheFileBinPath()));
+
+    const auto err = cacheFile->open(binChecksum());
+    if (err == ZoneCacheFile::ErrorOk) {
+        m_cacheFile = cacheFile;
+        m_zoneData = cacheFile->zoneData(); // no copy, refers to the mapped file
+        return true;
+    }
+
+    cacheFile->close();
+
+    // Convert the compressed file of previous versions
+    if (err == ZoneCacheFile::ErrorHeader && loadAddressesLegacy())
+        return true;
+
+    FileUtil::removeFile(cacheFileBinPath());
+
+    return false;
+}
+
+bool TaskZoneDownloader::loadAddressesLegacy()
+{
     const auto binData = FileUtil::readFileData(cacheFileBinPath());
 
     const auto binChecksumData = QCryptographicHash::hash(binData, QCryptographicHash::Sha256);
 
-    if (binChecksum() != QString::fromLatin1(binChecksumData.toHex())) {
-        FileUtil::removeFile(cacheFileBinPath());
+    if (binChecksum() != QString::fromLatin1(binChecksumData.toHex()))
         return false;
-    }
 
-    m_zoneData = qUncompress(binData);
+    ConfBuffer confBuf(qUncompress(binData));
 
-    return true;
+    IpRange ipRange;
+    if (!confBuf.loadZone(ipRange))
+        return false;
+
+    return storeAddresses(ipRange);
 }
 
 bool TaskZoneDownloader::saveAddressesAsText(const QString &filePath)
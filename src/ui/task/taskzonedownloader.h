@@ -3,10 +3,13 @@
 
 #include <QDateTime>
 
+#include <util/conf/zonecachefile.h>
 #include <util/util_types.h>
 
 #include "taskdownloader.h"
 
+class IpRange;
+
 class TaskZoneDownloader : public TaskDownloader
 {
     Q_OBJECT
@@ -20,6 +23,12 @@ public:
     bool sort() const { return m_sort; }
     void setSort(bool v) { m_sort = v; }
 
+    bool deferParse() const { return m_deferParse; }
+    void setDeferParse(bool v) { m_deferParse = v; }
+
+    qint8 zoneType() const { return m_zoneType; }
+    void setZoneType(qint8 v) { m_zoneType = v; }
+
     int emptyNetMask() const { return m_emptyNetMask; }
     void setEmptyNetMask(int v) { m_emptyNetMask = v; }
 
@@ -61,9 +70,20 @@ public:
 
     const QByteArray &zoneData() const { return m_zoneData; }
 
+    // Downloaded data to be parsed by processData(), when the parsing is deferred
+    QByteArray takeDownloadedData() { return std::exchange(m_downloadedData, {}); }
+
+    // Mapped cache file, which holds the loaded zone data
+    const ZoneCacheFilePtr &cacheFile() const { return m_cacheFile; }
+
     StringViewList parseAddresses(const QString &text, QString &textChecksum) const;
+    int parseAddressesData(const QByteArray &data, IpRange &ipRange, QString &textChecksum);
+
+    // Parse and store the downloaded addresses, returns true when they're changed
+    bool processData(const QByteArray &data);
 
     bool storeAddresses(const StringViewList &list);
+    bool storeAddresses(const IpRange &ipRange);
     bool loadAddresses();
 
     bool saveAddressesAsText(const QString &filePath);
@@ -81,9 +101,17 @@ private:
     void loadTextInline();
     void loadLocalFile();
 
+    int parseAddressesText(const QByteArray &data, IpRange &ipRange, QString &checksum) const;
+
+    bool storeZoneData();
+    bool loadAddressesLegacy();
+
 private:
     bool m_zoneEnabled : 1 = false;
     bool m_sort : 1 = false;
+    bool m_deferParse : 1 = false;
+
+    qint8 m_zoneType = 0;
 
     int m_emptyNetMask = 32;
 
@@ -109,6 +137,9 @@ private:
     QDateTime m_lastSuccess;
 
     QByteArray m_zoneData;
+    QByteArray m_downloadedData;
+
+    ZoneCacheFilePtr m_cacheFile;
 };
 
 #endif // TASKZONEDOWNLOADER_H
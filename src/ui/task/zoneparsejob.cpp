@@ -0,0 +1,28 @@
+#include "zoneparsejob.h"
+
+#include <util/worker/workerobject.h>
+
+#include "taskzonedownloader.h"
+#include "zoneparsemanager.h"
+
+ZoneParseJob::ZoneParseJob(int zoneIndex, TaskZoneDownloader *zone, const QByteArray &data) :
+    WorkerJob(zone->zoneName()), m_zoneIndex(zoneIndex), m_zone(zone), m_data(data)
+{
+}
+
+void ZoneParseJob::doJob(WorkerObject & /*worker*/)
+{
+    m_success = m_zone->processData(m_data);
+
+    m_data.clear();
+}
+
+void ZoneParseJob::reportResult(WorkerObject &worker)
+{
+    emitFinished(static_cast<ZoneParseManager *>(worker.manager()));
+}
+
+void ZoneParseJob::emitFinished(ZoneParseManager *manager)
+{
+    emit manager->zoneParsed(zoneIndex(), m_success);
+}
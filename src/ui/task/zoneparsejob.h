@@ -0,0 +1,34 @@
+#ifndef ZONEPARSEJOB_H
+#define ZONEPARSEJOB_H
+
+#include <QByteArray>
+
+#include <util/worker/workerjob.h>
+
+class TaskZoneDownloader;
+class ZoneParseManager;
+
+class ZoneParseJob : public WorkerJob
+{
+public:
+    explicit ZoneParseJob(int zoneIndex, TaskZoneDownloader *zone, const QByteArray &data);
+
+    int zoneIndex() const { return m_zoneIndex; }
+
+    void doJob(WorkerObject &worker) override;
+    void reportResult(WorkerObject &worker) override;
+
+private:
+    void emitFinished(ZoneParseManager *manager);
+
+private:
+    bool m_success = false;
+
+    int m_zoneIndex = 0;
+
+    TaskZoneDownloader *m_zone = nullptr;
+
+    QByteArray m_data;
+};
+
+#endif // ZONEPARSEJOB_H
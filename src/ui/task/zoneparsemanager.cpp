@@ -0,0 +1,15 @@
+#include "zoneparsemanager.h"
+
+#include <QThread>
+
+#include "zoneparsejob.h"
+
+ZoneParseManager::ZoneParseManager(QObject *parent) : WorkerManager(parent)
+{
+    setMaxWorkersCount(QThread::idealThreadCount());
+}
+
+void ZoneParseManager::parseZone(int zoneIndex, TaskZoneDownloader *zone, const QByteArray &data)
+{
+    enqueueJob(WorkerJobPtr(new ZoneParseJob(zoneIndex, zone, data)));
+}
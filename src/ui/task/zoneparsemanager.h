@@ -0,0 +1,25 @@
+#ifndef ZONEPARSEMANAGER_H
+#define ZONEPARSEMANAGER_H
+
+#include <util/worker/workermanager.h>
+
+class TaskZoneDownloader;
+
+class ZoneParseManager : public WorkerManager
+{
+    Q_OBJECT
+
+public:
+    explicit ZoneParseManager(QObject *parent = nullptr);
+
+    QString workerName() const override { return "ZoneParseWorker"; }
+
+signals:
+    void zoneParsed(int zoneIndex, bool success);
+
+public slots:
+    // The zone must be alive until zoneParsed() is emitted
+    void parseZone(int zoneIndex, TaskZoneDownloader *zone, const QByteArray &data);
+};
+
+#endif // ZONEPARSEMANAGER_H
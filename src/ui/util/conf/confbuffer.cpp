@@ -13,6 +13,12 @@
 #include <manager/envmanager.h>
 #include <util/bitutil.h>
 #include <util/fileutil.h>
+#include <util/net/arearange.h>
+#include <util/net/dirrange.h>
+#include <util/net/iprange.h>
+#include <util/net/ipverrange.h>
+#include <util/net/portrange.h>
+#include <util/net/protorange.h>
 #include <util/net/valuerangeutil.h>
 #include <util/stringutil.h>
 
@@ -51,6 +57,303 @@ int writeServiceInfo(char *data, const ServiceInfo &serviceInfo)
     return FORT_SERVICE_INFO_NAME_OFF + FORT_CONF_STR_DATA_SIZE(nameLen);
 }
 
+struct RuleFilterOp
+{
+    const RuleFilter *filter = nullptr;
+
+    // Op index or terminal jump
+    quint32 trueJump = 0;
+    quint32 falseJump = 0;
+};
+
+using RuleFilterOps = QVector<RuleFilterOp>;
+
+const RuleFilter *nextRuleFilter(const RuleFilter *ruleFilter)
+{
+    return ruleFilter + 1 + (ruleFilter->isTypeList() ? ruleFilter->filterListCount : 0);
+}
+
+int ruleFilterLeafCount(const RuleFilter *ruleFilter, const RuleFilter *end)
+{
+    int count = 0;
+    for (; ruleFilter < end; ++ruleFilter) {
+        if (!ruleFilter->isTypeList()) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// Ops are emitted in the tree's order, so the next sibling starts right after the current one
+void compileRuleFilter(
+        const RuleFilter *ruleFilter, quint32 trueJump, quint32 falseJump, RuleFilterOps &ops)
+{
+    if (!ruleFilter->isTypeList()) {
+        RuleFilterOp op = { .filter = ruleFilter, .trueJump = trueJump, .falseJump = falseJump };
+
+        if (ruleFilter->isNot) {
+            std::swap(op.trueJump, op.falseJump);
+        }
+
+        ops.append(op);
+        return;
+    }
+
+    const bool isAnd = (ruleFilter->type == FORT_RULE_FILTER_TYPE_LIST_AND);
+    if (isAnd) {
+        falseJump |= FORT_CONF_RULE_FILTER_JUMP_RESET;
+    }
+
+    const RuleFilter *end = nextRuleFilter(ruleFilter);
+    const RuleFilter *subFilter = ruleFilter + 1;
+
+    for (;;) {
+        const RuleFilter *nextFilter = nextRuleFilter(subFilter);
+
+        if (nextFilter >= end) {
+            compileRuleFilter(subFilter, trueJump, falseJump, ops);
+            break;
+        }
+
+        const quint32 nextJump = ops.size() + ruleFilterLeafCount(subFilter, nextFilter);
+
+        if (isAnd) {
+            compileRuleFilter(subFilter, nextJump, falseJump, ops);
+        } else {
+            compileRuleFilter(subFilter, trueJump, nextJump, ops);
+        }
+
+        subFilter = nextFilter;
+    }
+}
+
+quint32 resolveRuleFilterJump(quint32 jump, const QVector<quint32> &opOffsets)
+{
+    const quint32 target = (jump & FORT_CONF_RULE_FILTER_JUMP_MASK);
+
+    if (target >= FORT_CONF_RULE_FILTER_JUMP_FALSE)
+        return jump;
+
+    return opOffsets[target] | (jump & FORT_CONF_RULE_FILTER_JUMP_RESET);
+}
+
+quint64 ruleMaskGroup(quint64 groupMask, quint64 mask)
+{
+    return (FORT_CONF_RULE_MASK_ALL & ~groupMask) | (mask & groupMask);
+}
+
+quint64 ruleMaskGroupNot(quint64 groupMask, quint64 mask, bool isNot)
+{
+    return ruleMaskGroup(groupMask, isNot ? ~mask : mask);
+}
+
+quint64 ipRangeRuleMask(const IpRange &ipRange)
+{
+    const bool isV4 = (ipRange.ip4Size() != 0 || ipRange.pair4Size() != 0);
+    const bool isV6 = (ipRange.ip6Size() != 0 || ipRange.pair6Size() != 0);
+
+    return ruleMaskGroup(FORT_CONF_RULE_MASK_IP_VERSION,
+            (isV4 ? FORT_CONF_RULE_MASK_IP_VERSION_4 : 0)
+                    | (isV6 ? FORT_CONF_RULE_MASK_IP_VERSION_6 : 0));
+}
+
+quint64 portRangeRuleMask(const PortRange &portRange)
+{
+    quint64 mask = 0;
+
+    for (const port_t port : portRange.portArray()) {
+        mask |= FORT_CONF_RULE_MASK_PORT(port);
+    }
+
+    for (int i = 0, n = portRange.pairSize(); i < n; ++i) {
+        const PortPair pair = portRange.pairAt(i);
+
+        if (pair.to - pair.from >= FORT_CONF_RULE_MASK_PORT_BLOOM_BITS - 1) {
+            mask = FORT_CONF_RULE_MASK_PORTS;
+            break;
+        }
+
+        for (int port = pair.from; port <= pair.to; ++port) {
+            mask |= FORT_CONF_RULE_MASK_PORT(port);
+        }
+    }
+
+    return ruleMaskGroup(FORT_CONF_RULE_MASK_PORTS, mask);
+}
+
+quint64 protoRuleMask(int proto)
+{
+    switch (proto) {
+    case IpProto_TCP:
+        return FORT_CONF_RULE_MASK_PROTO_TCP;
+    case IpProto_UDP:
+        return FORT_CONF_RULE_MASK_PROTO_UDP;
+    case IpProto_ICMP:
+    case IpProto_ICMPV6:
+        return FORT_CONF_RULE_MASK_PROTO_ICMP;
+    default:
+        return FORT_CONF_RULE_MASK_PROTO_OTHER;
+    }
+}
+
+quint64 protoRangeRuleMask(const ProtoRange &protoRange)
+{
+    quint64 mask = 0;
+
+    for (const proto_t proto : protoRange.protoArray()) {
+        mask |= protoRuleMask(proto);
+    }
+
+    for (int i = 0, n = protoRange.pairSize(); i < n; ++i) {
+        const ProtoPair pair = protoRange.pairAt(i);
+
+        for (int proto = pair.from; proto <= pair.to; ++proto) {
+            mask |= protoRuleMask(proto);
+        }
+    }
+
+    return ruleMaskGroup(FORT_CONF_RULE_MASK_PROTO, mask);
+}
+
+quint64 areaRangeRuleMask(const AreaRange &areaRange, bool isNot)
+{
+    const bool isLocalhost = areaRange.isLocalhost();
+    const bool isLan = areaRange.isLan();
+
+    const quint64 mask = (isLocalhost ? FORT_CONF_RULE_MASK_AREA_LOCALHOST : 0)
+            | (isLan ? FORT_CONF_RULE_MASK_AREA_LAN : 0)
+            | (isLocalhost || isLan ? FORT_CONF_RULE_MASK_AREA_LOCAL_LAN : 0)
+            | (areaRange.isInet() ? FORT_CONF_RULE_MASK_AREA_INET : 0);
+
+    return ruleMaskGroupNot(FORT_CONF_RULE_MASK_AREA, mask, isNot);
+}
+
+// Connections, which can be matched by the leaf filter
+quint64 ruleFilterValuesMask(const RuleFilter &ruleFilter, const ValueRange *range)
+{
+    if (ruleFilter.isEmpty())
+        return FORT_CONF_RULE_MASK_ALL;
+
+    const bool isNot = ruleFilter.isNot;
+
+    switch (ruleFilter.type) {
+    case FORT_RULE_FILTER_TYPE_ADDRESS:
+    case FORT_RULE_FILTER_TYPE_LOCAL_ADDRESS: {
+        return isNot ? FORT_CONF_RULE_MASK_ALL
+                     : ipRangeRuleMask(*static_cast<const IpRange *>(range));
+    }
+    case FORT_RULE_FILTER_TYPE_PORT: {
+        return isNot ? FORT_CONF_RULE_MASK_ALL
+                     : portRangeRuleMask(*static_cast<const PortRange *>(range));
+    }
+    case FORT_RULE_FILTER_TYPE_PORT_TCP:
+    case FORT_RULE_FILTER_TYPE_PORT_UDP: {
+        if (isNot)
+            return FORT_CONF_RULE_MASK_ALL;
+
+        const quint64 protoMask = ruleMaskGroup(FORT_CONF_RULE_MASK_PROTO,
+                (ruleFilter.type == FORT_RULE_FILTER_TYPE_PORT_TCP)
+                        ? FORT_CONF_RULE_MASK_PROTO_TCP
+                        : FORT_CONF_RULE_MASK_PROTO_UDP);
+
+        return protoMask & portRangeRuleMask(*static_cast<const PortRange *>(range));
+    }
+    case FORT_RULE_FILTER_TYPE_PROTOCOL: {
+        return isNot ? FORT_CONF_RULE_MASK_ALL
+                     : protoRangeRuleMask(*static_cast<const ProtoRange *>(range));
+    }
+    case FORT_RULE_FILTER_TYPE_IP_VERSION: {
+        const auto ipVerRange = static_cast<const IpVerRange *>(range);
+
+        return ruleMaskGroupNot(FORT_CONF_RULE_MASK_IP_VERSION,
+                (ipVerRange->isV4() ? FORT_CONF_RULE_MASK_IP_VERSION_4 : 0)
+                        | (ipVerRange->isV6() ? FORT_CONF_RULE_MASK_IP_VERSION_6 : 0),
+                isNot);
+    }
+    case FORT_RULE_FILTER_TYPE_DIRECTION: {
+        const auto dirRange = static_cast<const DirRange *>(range);
+
+        return ruleMaskGroupNot(FORT_CONF_RULE_MASK_DIR,
+                (dirRange->isIn() ? FORT_CONF_RULE_MASK_DIR_IN : 0)
+                        | (dirRange->isOut() ? FORT_CONF_RULE_MASK_DIR_OUT : 0),
+                isNot);
+    }
+    case FORT_RULE_FILTER_TYPE_AREA: {
+        return areaRangeRuleMask(*static_cast<const AreaRange *>(range), isNot);
+    }
+    default:
+        return FORT_CONF_RULE_MASK_ALL;
+    }
+}
+
+// AND lists intersect the masks of sub-filters, OR lists unite them
+quint64 ruleFilterTreeMask(const RuleFilter *ruleFilter, const quint64 *&leafMask)
+{
+    if (!ruleFilter->isTypeList())
+        return *leafMask++;
+
+    const bool isAnd = (ruleFilter->type == FORT_RULE_FILTER_TYPE_LIST_AND);
+
+    quint64 mask = isAnd ? FORT_CONF_RULE_MASK_ALL : 0;
+
+    const RuleFilter *end = nextRuleFilter(ruleFilter);
+    const RuleFilter *subFilter = ruleFilter + 1;
+
+    for (; subFilter < end; subFilter = nextRuleFilter(subFilter)) {
+        const quint64 subMask = ruleFilterTreeMask(subFilter, leafMask);
+
+        mask = isAnd ? (mask & subMask) : (mask | subMask);
+    }
+
+    return mask;
+}
+
+enum RuleMaskState : qint8 {
+    RuleMaskNone = 0,
+    RuleMaskOwn,
+    RuleMaskBusy,
+    RuleMaskDone,
+};
+
+quint64 writeRuleSetMask(char *data, quint16 ruleId, QVector<qint8> &ruleMaskStates)
+{
+    if (ruleId == 0)
+        return 0; // never matched
+
+    const qint8 state = (ruleId < ruleMaskStates.size()) ? ruleMaskStates[ruleId] : RuleMaskNone;
+    if (state == RuleMaskNone || state == RuleMaskBusy)
+        return FORT_CONF_RULE_MASK_ALL;
+
+    const quint32 *ruleOffsets =
+            (const quint32 *) (data + FORT_CONF_RULES_DATA_OFF) - 1; // exclude zero index
+
+    PFORT_CONF_RULE confRule =
+            PFORT_CONF_RULE(data + FORT_CONF_RULES_DATA_OFF + ruleOffsets[ruleId]);
+
+    quint64 *ruleMask = (quint64 *) ((char *) confRule + FORT_CONF_RULE_MASK_OFFSET(confRule));
+
+    if (state == RuleMaskDone)
+        return *ruleMask;
+
+    ruleMaskStates[ruleId] = RuleMaskBusy;
+
+    // Exclusive rules require own filters to match
+    const bool isExclusive = (confRule->exclusive && !confRule->blocked);
+
+    if (!isExclusive && *ruleMask != FORT_CONF_RULE_MASK_ALL) {
+        const quint16 *setIds =
+                (const quint16 *) ((char *) confRule + FORT_CONF_RULE_SET_INDEXES_OFFSET(confRule));
+
+        for (int i = 0, n = confRule->set_count; i < n; ++i) {
+            *ruleMask |= writeRuleSetMask(data, setIds[i], ruleMaskStates);
+        }
+    }
+
+    ruleMaskStates[ruleId] = RuleMaskDone;
+
+    return *ruleMask;
+}
+
 }
 
 ConfBuffer::ConfBuffer(const QByteArray &buffer, QObject *parent) :
@@ -170,6 +473,41 @@ bool ConfBuffer::writeAppEntry(const App &app, bool isNew)
     return true;
 }
 
+bool ConfBuffer::writeAppEntries(const QList<App> &apps, QStringList &skippedAppPaths)
+{
+    appdata_map_t appsMap;
+    quint32 appsSize = 0;
+
+    // Skip the invalid apps to not lose the rest of the batch
+    for (const App &app : apps) {
+        if (!addApp(app, /*isNew=*/false, appsMap, appsSize)) {
+            skippedAppPaths.append(app.appPath);
+        }
+    }
+
+    if (appsMap.isEmpty())
+        return false;
+
+    if (appsMap.size() > USHRT_MAX) {
+        setErrorMessage(tr("Too many application paths"));
+        return false;
+    }
+
+    // Resize the buffer
+    buffer().resize(FORT_CONF_APP_ENTRIES_DATA_OFF + appsSize);
+
+    // Fill the buffer
+    char *data = buffer().data();
+
+    PFORT_APP_ENTRIES appEntries = PFORT_APP_ENTRIES(data);
+    appEntries->count = quint16(appsMap.size());
+    appEntries->reserved = 0;
+
+    ConfData(appEntries->data).writeApps(appsMap);
+
+    return true;
+}
+
 void ConfBuffer::writeZone(const IpRange &ipRange)
 {
     // Resize the buffer
@@ -448,8 +786,9 @@ bool ConfBuffer::addApp(const App &app, bool isNew, appdata_map_t &appsMap, quin
 bool ConfBuffer::writeRules(const ConfRulesWalker &confRulesWalker)
 {
     WalkRulesArgs wra;
+    QVector<qint8> ruleMaskStates;
 
-    return confRulesWalker.walkRules(wra, [&](const Rule &rule) -> bool {
+    const bool ok = confRulesWalker.walkRules(wra, [&](const Rule &rule) -> bool {
         if (buffer().isEmpty()) {
             const int outSize =
                     FORT_CONF_RULES_DATA_OFF + FORT_CONF_RULES_OFFSETS_SIZE(wra.maxRuleId);
@@ -462,10 +801,31 @@ bool ConfBuffer::writeRules(const ConfRulesWalker &confRulesWalker)
             rules->max_rule_id = wra.maxRuleId;
             rules->glob.pre_rule_id = wra.globPreRuleId;
             rules->glob.post_rule_id = wra.globPostRuleId;
+
+            ruleMaskStates.resize(wra.maxRuleId + 1);
         }
 
-        return writeRule(rule, wra);
+        if (!writeRule(rule, wra))
+            return false;
+
+        ruleMaskStates[rule.ruleId] = RuleMaskOwn;
+
+        return true;
     });
+
+    if (ok && useRuleMasks()) {
+        writeRuleSetMasks(ruleMaskStates);
+    }
+
+    return ok;
+}
+
+void ConfBuffer::writeRuleSetMasks(QVector<qint8> &ruleMaskStates)
+{
+    // Unite the masks of rule sets
+    for (int ruleId = 1, n = ruleMaskStates.size(); ruleId < n; ++ruleId) {
+        writeRuleSetMask(data(), ruleId, ruleMaskStates);
+    }
 }
 
 void ConfBuffer::writeRuleFlag(int ruleId, bool enabled)
@@ -487,7 +847,8 @@ void ConfBuffer::writeRuleFlag(int ruleId, bool enabled)
 bool ConfBuffer::validateRuleText(const QString &ruleText)
 {
     int filtersCount;
-    return writeRuleText(ruleText, filtersCount);
+    quint64 filtersMask;
+    return writeRuleText(ruleText, filtersCount, filtersMask);
 }
 
 bool ConfBuffer::writeRule(const Rule &rule, const WalkRulesArgs &wra)
@@ -543,6 +904,13 @@ bool ConfBuffer::writeRule(const Rule &rule, const WalkRulesArgs &wra)
         data += sizeof(FORT_CONF_RULE_ZONES);
     }
 
+    // Write the rule's mask
+    {
+        *((quint64 *) data) = FORT_CONF_RULE_MASK_ALL;
+
+        data += sizeof(quint64);
+    }
+
     // Write the rule's set
     if (ruleSetCount != 0) {
         const char *setIndexes = (const char *) &wra.ruleSetIds[ruleSetInfo.index];
@@ -553,9 +921,11 @@ bool ConfBuffer::writeRule(const Rule &rule, const WalkRulesArgs &wra)
     }
 
     // Write the rule's text
+    int filtersCount = 0;
+    quint64 filtersMask = 0;
+
     if (hasFilters) {
-        int filtersCount = 0;
-        if (!writeRuleText(rule.ruleText, filtersCount))
+        if (!writeRuleText(rule.ruleText, filtersCount, filtersMask))
             return false;
 
         if (filtersCount == 0) {
@@ -565,10 +935,18 @@ bool ConfBuffer::writeRule(const Rule &rule, const WalkRulesArgs &wra)
         }
     }
 
+    // Zones and terminating rules can match any connection
+    if (useRuleMasks() && !(hasZones || rule.inlineZones || rule.terminate)) {
+        quint64 *ruleMask =
+                (quint64 *) (this->data() + oldSize + FORT_CONF_RULE_MASK_OFFSET(&confRule));
+
+        *ruleMask = (filtersCount != 0) ? filtersMask : 0;
+    }
+
     return true;
 }
 
-bool ConfBuffer::writeRuleText(const QString &ruleText, int &filtersCount)
+bool ConfBuffer::writeRuleText(const QString &ruleText, int &filtersCount, quint64 &filtersMask)
 {
     RuleTextParser parser(ruleText);
 
@@ -582,9 +960,84 @@ bool ConfBuffer::writeRuleText(const QString &ruleText, int &filtersCount)
         return true;
 
     const auto &ruleFilter = parser.ruleFilters().first();
-    Q_ASSERT(ruleFilter.isTypeList());
 
-    return writeRuleFilter(ruleFilter);
+    m_ruleFilterMasks.clear();
+
+    const bool ok = (compileRuleFilters() && ruleFilter.isTypeList())
+            ? writeRuleFilterProgram(ruleFilter)
+            : writeRuleFilter(ruleFilter);
+
+    if (ok) {
+        filtersMask = ruleFiltersMask(parser.ruleFilters());
+    }
+
+    return ok;
+}
+
+quint64 ConfBuffer::ruleFiltersMask(const QVector<RuleFilter> &ruleFilters) const
+{
+    // Actions change the connection even when the filters are not matched
+    const bool hasAction = std::any_of(ruleFilters.begin(), ruleFilters.end(),
+            [](const RuleFilter &rf) { return rf.type == FORT_RULE_FILTER_TYPE_ACTION; });
+
+    if (hasAction)
+        return FORT_CONF_RULE_MASK_ALL;
+
+    Q_ASSERT(m_ruleFilterMasks.size()
+            == ruleFilterLeafCount(
+                    ruleFilters.constData(), ruleFilters.constData() + ruleFilters.size()));
+
+    const quint64 *leafMask = m_ruleFilterMasks.constData();
+
+    return ruleFilterTreeMask(&ruleFilters.first(), leafMask);
+}
+
+bool ConfBuffer::writeRuleFilterProgram(const RuleFilter &ruleFilter)
+{
+    RuleFilterOps ops;
+    compileRuleFilter(&ruleFilter, FORT_CONF_RULE_FILTER_JUMP_TRUE,
+            FORT_CONF_RULE_FILTER_JUMP_FALSE, ops);
+
+    // Resize the buffer
+    const int oldSize = buffer().size();
+    const int programOffset = oldSize + sizeof(FORT_CONF_RULE_FILTER);
+
+    buffer().resize(programOffset);
+
+    // Fill the buffer
+    QVector<quint32> opOffsets;
+    opOffsets.reserve(ops.size());
+
+    for (const RuleFilterOp &op : std::as_const(ops)) {
+        const int opOffset = buffer().size();
+
+        opOffsets.append(opOffset - programOffset);
+
+        buffer().resize(opOffset + FORT_CONF_RULE_FILTER_OP_OFF);
+
+        if (!writeRuleFilter(*op.filter))
+            return false;
+    }
+
+    // Resolve the jumps
+    for (int i = 0, n = ops.size(); i < n; ++i) {
+        const RuleFilterOp &op = ops[i];
+
+        PFORT_CONF_RULE_FILTER_OP confOp =
+                PFORT_CONF_RULE_FILTER_OP(data() + programOffset + opOffsets[i]);
+
+        confOp->true_jump = resolveRuleFilterJump(op.trueJump, opOffsets);
+        confOp->false_jump = resolveRuleFilterJump(op.falseJump, opOffsets);
+        confOp->filter.is_not = false; // folded into the jumps
+    }
+
+    PFORT_CONF_RULE_FILTER confFilter = PFORT_CONF_RULE_FILTER(data() + oldSize);
+
+    *confFilter = {};
+    confFilter->type = FORT_RULE_FILTER_TYPE_PROGRAM;
+    confFilter->size = buffer().size() - oldSize;
+
+    return true;
 }
 
 bool ConfBuffer::writeRuleFilter(const RuleFilter &ruleFilter)
@@ -595,8 +1048,9 @@ bool ConfBuffer::writeRuleFilter(const RuleFilter &ruleFilter)
     buffer().resize(oldSize + sizeof(FORT_CONF_RULE_FILTER));
 
     // Fill the buffer
+    bool isBitmap = false;
     const bool ok = ruleFilter.isTypeList() ? writeRuleFilterList(ruleFilter)
-                                            : writeRuleFilterValues(ruleFilter);
+                                            : writeRuleFilterValues(ruleFilter, isBitmap);
 
     if (ok) {
         PFORT_CONF_RULE_FILTER confFilter = PFORT_CONF_RULE_FILTER(data() + oldSize);
@@ -604,6 +1058,7 @@ bool ConfBuffer::writeRuleFilter(const RuleFilter &ruleFilter)
         confFilter->is_not = ruleFilter.isNot;
         confFilter->equal_values = ruleFilter.equalValues;
         confFilter->is_empty = ruleFilter.isEmpty();
+        confFilter->is_bitmap = isBitmap;
         confFilter->type = ruleFilter.type;
 
         const quint32 filterSize = buffer().size() - oldSize;
@@ -635,7 +1090,7 @@ bool ConfBuffer::writeRuleFilterList(const RuleFilter &ruleListFilter)
     return true;
 }
 
-bool ConfBuffer::writeRuleFilterValues(const RuleFilter &ruleFilter)
+bool ConfBuffer::writeRuleFilterValues(const RuleFilter &ruleFilter, bool &isBitmap)
 {
     QScopedPointer<ValueRange> range(ValueRangeUtil::createRangeByType(ruleFilter.type));
 
@@ -660,5 +1115,9 @@ bool ConfBuffer::writeRuleFilterValues(const RuleFilter &ruleFilter)
 
     range->write(confData);
 
+    isBitmap = range->isBitmap();
+
+    m_ruleFilterMasks.append(ruleFilterValuesMask(ruleFilter, range.data()));
+
     return true;
 }
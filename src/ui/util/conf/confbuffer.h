@@ -26,6 +26,14 @@ public:
 
     bool hasError() const { return !errorMessage().isEmpty(); }
 
+    // Write the rule filter lists as compiled programs
+    bool compileRuleFilters() const { return m_compileRuleFilters; }
+    void setCompileRuleFilters(bool v) { m_compileRuleFilters = v; }
+
+    // Write the rule applicability masks to skip not matching rules of sets
+    bool useRuleMasks() const { return m_useRuleMasks; }
+    void setUseRuleMasks(bool v) { m_useRuleMasks = v; }
+
     const QByteArray &buffer() const { return m_buffer; }
     QByteArray &buffer() { return m_buffer; }
 
@@ -41,6 +49,7 @@ public slots:
             const FirewallConf &conf, const ConfAppsWalker *confAppsWalker, EnvManager &envManager);
     void writeFlags(const FirewallConf &conf);
     bool writeAppEntry(const App &app, bool isNew = false);
+    bool writeAppEntries(const QList<App> &apps, QStringList &skippedAppPaths);
 
     void writeZone(const IpRange &ipRange);
     void writeZones(quint32 zonesMask, quint32 enabledMask, quint32 dataSize,
@@ -72,18 +81,26 @@ private:
 
     bool addApp(const App &app, bool isNew, appdata_map_t &appsMap, quint32 &appsSize);
 
+    void writeRuleSetMasks(QVector<qint8> &ruleMaskStates);
     bool writeRule(const Rule &rule, const WalkRulesArgs &wra);
-    bool writeRuleText(const QString &ruleText, int &filtersCount);
+    bool writeRuleText(const QString &ruleText, int &filtersCount, quint64 &filtersMask);
+    quint64 ruleFiltersMask(const QVector<RuleFilter> &ruleFilters) const;
+    bool writeRuleFilterProgram(const RuleFilter &ruleFilter);
     bool writeRuleFilter(const RuleFilter &ruleFilter);
     bool writeRuleFilterList(const RuleFilter &ruleListFilter);
-    bool writeRuleFilterValues(const RuleFilter &ruleFilter);
+    bool writeRuleFilterValues(const RuleFilter &ruleFilter, bool &isBitmap);
 
 private:
+    bool m_compileRuleFilters : 1 = true;
+    bool m_useRuleMasks : 1 = true;
+
     quint32 m_driveMask = 0;
 
     QString m_errorMessage;
 
     QByteArray m_buffer;
+
+    QVector<quint64> m_ruleFilterMasks;
 };
 
 #endif // CONFBUFFER_H
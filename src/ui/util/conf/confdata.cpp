@@ -35,6 +35,13 @@ void writeAppGroupFlags(PFORT_CONF_GROUP out, const FirewallConf &conf)
     }
 }
 
+void setBitmapRange(quint8 *bitmap, int from, int to)
+{
+    for (int i = from; i <= to; ++i) {
+        bitmap[i >> 3] |= quint8(1 << (i & 7));
+    }
+}
+
 void writeLimitBps(PFORT_SPEED_LIMIT limit, quint32 kBits)
 {
     limit->bps = quint64(kBits) * (1024LL / 8); /* to bytes per second */
@@ -93,6 +100,12 @@ void writeLimits(PFORT_CONF_GROUP out, const QList<AppGroup *> &appGroups)
     }
 }
 
+void writeStatFlush(PFORT_CONF_STAT_FLUSH out, const IniOptions &ini)
+{
+    out->period_min = quint16(qBound(0, ini.statFlushPeriodMin(), 0xFFFF));
+    out->period_max = quint16(qBound(0, ini.statFlushPeriodMax(), 0xFFFF));
+}
+
 }
 
 ConfData::ConfData(void *data) : m_data((char *) data), m_base((char *) data) { }
@@ -127,6 +140,8 @@ void ConfData::writeConf(const WriteConfArgs &wca, AppParseOptions &opt)
 
     writeLimits(conf_group, wca.conf.appGroups());
 
+    writeStatFlush(&drvConfIo->stat_flush, wca.conf.ini());
+
     ConfData(&drvConf->flags).writeConfFlags(wca.conf);
 
     drvConf->proc_wild = opt.procWild;
@@ -260,6 +275,44 @@ void ConfData::writeProtoRange(const ProtoRange &protoRange)
     writeBytes(protoRange.pairToArray());
 }
 
+void ConfData::writePortBitmap(const PortRange &portRange)
+{
+    quint8 *bitmap = (quint8 *) m_data;
+
+    memset(bitmap, 0, FORT_CONF_PORT_BITMAP_SIZE);
+
+    for (const port_t port : portRange.portArray()) {
+        setBitmapRange(bitmap, port, port);
+    }
+
+    for (int i = 0, n = portRange.pairSize(); i < n; ++i) {
+        const PortPair pair = portRange.pairAt(i);
+
+        setBitmapRange(bitmap, pair.from, pair.to);
+    }
+
+    m_data += FORT_CONF_PORT_BITMAP_SIZE;
+}
+
+void ConfData::writeProtoBitmap(const ProtoRange &protoRange)
+{
+    quint8 *bitmap = (quint8 *) m_data;
+
+    memset(bitmap, 0, FORT_CONF_PROTO_BITMAP_SIZE);
+
+    for (const proto_t proto : protoRange.protoArray()) {
+        setBitmapRange(bitmap, proto, proto);
+    }
+
+    for (int i = 0, n = protoRange.pairSize(); i < n; ++i) {
+        const ProtoPair pair = protoRange.pairAt(i);
+
+        setBitmapRange(bitmap, pair.from, pair.to);
+    }
+
+    m_data += FORT_CONF_PROTO_BITMAP_SIZE;
+}
+
 void ConfData::writeIpVerRange(const IpVerRange &ipVerRange)
 {
     PFORT_CONF_RULE_FILTER_FLAGS filter = PFORT_CONF_RULE_FILTER_FLAGS(m_data);
@@ -55,6 +55,8 @@ public:
 
     void writePortRange(const PortRange &portRange);
     void writeProtoRange(const ProtoRange &protoRange);
+    void writePortBitmap(const PortRange &portRange);
+    void writeProtoBitmap(const ProtoRange &protoRange);
     void writeIpVerRange(const IpVerRange &ipVerRange);
     void writeDirRange(const DirRange &dirRange);
     void writeZonesRange(const ZonesRange &zonesRange);
@@ -0,0 +1,178 @@
+#include "zonecachefile.h"
+
+#include <QCryptographicHash>
+#include <QLoggingCategory>
+
+#include <common/fortconf.h>
+
+#include <util/fileutil.h>
+
+namespace {
+
+const QLoggingCategory LC("util.conf.zoneCacheFile");
+
+bool checkAddrListSize(const char *&data, quint64 &restSize, bool isIPv6)
+{
+    if (restSize < FORT_CONF_ADDR_LIST_OFF)
+        return false;
+
+    PCFORT_CONF_ADDR_LIST addr_list = PCFORT_CONF_ADDR_LIST(data);
+
+    if (addr_list->ip_n >= FORT_CONF_IP_MAX || addr_list->pair_n >= FORT_CONF_IP_MAX)
+        return false;
+
+    const quint64 addrListSize = isIPv6
+            ? FORT_CONF_ADDR6_LIST_SIZE(quint64(addr_list->ip_n), quint64(addr_list->pair_n))
+            : FORT_CONF_ADDR4_LIST_SIZE(quint64(addr_list->ip_n), quint64(addr_list->pair_n));
+
+    if (restSize < addrListSize)
+        return false;
+
+    data += addrListSize;
+    restSize -= addrListSize;
+
+    return true;
+}
+
+QByteArray hashData(const char *data, quint32 dataSize)
+{
+    return QCryptographicHash::hash(QByteArrayView(data, dataSize), QCryptographicHash::Sha256);
+}
+
+}
+
+ZoneCacheFile::ZoneCacheFile(const QString &filePath) : m_file(filePath) { }
+
+ZoneCacheFile::~ZoneCacheFile()
+{
+    close();
+}
+
+ZoneCacheFile::OpenError ZoneCacheFile::open(const QString &checksum, bool verifyData)
+{
+    close();
+
+    if (!m_file.open(QFile::ReadOnly))
+        return ErrorOpen;
+
+    const qint64 fileSize = m_file.size();
+    if (fileSize < qint64(sizeof(Header))) {
+        close();
+        return ErrorHeader;
+    }
+
+    m_map = m_file.map(0, fileSize);
+    if (!m_map) {
+        qCWarning(LC) << "Map error:" << filePath() << m_file.errorString();
+        close();
+        return ErrorMap;
+    }
+
+    const Header &header = *reinterpret_cast<const Header *>(m_map);
+
+    OpenError err = checkHeader(header);
+    if (err == ErrorOk && fileSize != qint64(header.headerSize) + header.dataSize) {
+        err = ErrorSize;
+    }
+
+    const char *data = reinterpret_cast<const char *>(m_map) + header.headerSize;
+
+    if (err == ErrorOk && !checkZoneData(data, header.dataSize)) {
+        err = ErrorLayout;
+    }
+
+    if (err == ErrorOk) {
+        const QByteArray checksumData(header.checksum, checksumSize);
+
+        m_checksum = QString::fromLatin1(checksumData.toHex());
+
+        if ((!checksum.isEmpty() && checksum != m_checksum)
+                || (verifyData && hashData(data, header.dataSize) != checksumData)) {
+            err = ErrorChecksum;
+        }
+    }
+
+    if (err != ErrorOk) {
+        qCWarning(LC) << "Invalid file:" << filePath() << "error:" << err;
+        close();
+        return err;
+    }
+
+    m_zoneData = QByteArray::fromRawData(data, header.dataSize);
+
+    return ErrorOk;
+}
+
+void ZoneCacheFile::close()
+{
+    m_zoneData.clear();
+    m_checksum.clear();
+
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+
+    m_file.close();
+}
+
+bool ZoneCacheFile::write(const QString &filePath, const QByteArray &zoneData, QString &checksum)
+{
+    if (!checkZoneData(zoneData.constData(), zoneData.size()))
+        return false;
+
+    const QByteArray checksumData = hashData(zoneData.constData(), zoneData.size());
+
+    Header header;
+    memset(&header, 0, sizeof(Header));
+
+    header.magic = magic;
+    header.version = version;
+    header.headerSize = sizeof(Header);
+    header.dataSize = zoneData.size();
+    memcpy(header.checksum, checksumData.constData(), checksumSize);
+
+    FileUtil::makePathForFile(filePath); // create destination directory
+
+    QFile file(filePath);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+
+    if (file.write(reinterpret_cast<const char *>(&header), sizeof(Header)) != sizeof(Header)
+            || file.write(zoneData) != zoneData.size() || !file.flush()) {
+        file.remove();
+        return false;
+    }
+
+    checksum = QString::fromLatin1(checksumData.toHex());
+
+    return true;
+}
+
+bool ZoneCacheFile::isZoneCacheData(const QByteArray &data)
+{
+    return data.size() >= qsizetype(sizeof(Header))
+            && reinterpret_cast<const Header *>(data.constData())->magic == magic;
+}
+
+bool ZoneCacheFile::checkZoneData(const char *data, quint32 dataSize)
+{
+    quint64 restSize = dataSize;
+
+    return checkAddrListSize(data, restSize, /*isIPv6=*/false)
+            && checkAddrListSize(data, restSize, /*isIPv6=*/true) && restSize == 0;
+}
+
+ZoneCacheFile::OpenError ZoneCacheFile::checkHeader(const Header &header) const
+{
+    if (header.magic != magic)
+        return ErrorHeader;
+
+    if (header.version != version)
+        return ErrorVersion;
+
+    if (header.headerSize < sizeof(Header) || header.headerSize % sizeof(quint32) != 0)
+        return ErrorHeader;
+
+    return ErrorOk;
+}
@@ -0,0 +1,75 @@
+#ifndef ZONECACHEFILE_H
+#define ZONECACHEFILE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QSharedPointer>
+
+// Uncompressed zone cache file: the header and the FORT_CONF_ADDR_LIST payload.
+// The payload is memory-mapped and used as is by the driver configuration writer.
+class ZoneCacheFile
+{
+public:
+    enum OpenError : qint8 {
+        ErrorOk = 0,
+        ErrorOpen,
+        ErrorMap,
+        ErrorHeader,
+        ErrorVersion,
+        ErrorSize,
+        ErrorLayout,
+        ErrorChecksum,
+    };
+
+    static constexpr quint32 magic = 0x435A5446; // "FTZC"
+    static constexpr quint16 version = 1;
+    static constexpr int checksumSize = 32; // SHA-256
+
+    struct Header
+    {
+        quint32 magic;
+        quint16 version;
+        quint16 headerSize;
+        quint32 dataSize;
+        quint32 reserved;
+        char checksum[checksumSize];
+    };
+
+    explicit ZoneCacheFile(const QString &filePath);
+    ~ZoneCacheFile();
+
+    QString filePath() const { return m_file.fileName(); }
+
+    bool isOpen() const { return m_map != nullptr; }
+
+    // Raw data of the mapped payload, valid until close()
+    const QByteArray &zoneData() const { return m_zoneData; }
+
+    QString checksum() const { return m_checksum; }
+
+    // Map and validate the file's header and layout, "checksum" is the expected one when not empty.
+    // "verifyData" hashes the whole payload too.
+    OpenError open(const QString &checksum = {}, bool verifyData = false);
+    void close();
+
+    static bool write(const QString &filePath, const QByteArray &zoneData, QString &checksum);
+
+    static bool isZoneCacheData(const QByteArray &data);
+
+    static bool checkZoneData(const char *data, quint32 dataSize);
+
+private:
+    OpenError checkHeader(const Header &header) const;
+
+private:
+    uchar *m_map = nullptr;
+
+    QString m_checksum;
+    QByteArray m_zoneData;
+
+    QFile m_file;
+};
+
+using ZoneCacheFilePtr = QSharedPointer<ZoneCacheFile>;
+
+#endif // ZONECACHEFILE_H
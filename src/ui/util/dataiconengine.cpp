@@ -0,0 +1,56 @@
+#include "dataiconengine.h"
+
+#include <QImage>
+#include <QPixmap>
+
+DataIconEngine::DataIconEngine(const QByteArray &data) : m_data(data) { }
+
+void DataIconEngine::paint(QPainter *painter, const QRect &rect, QIcon::Mode mode, QIcon::State state)
+{
+    decodedIcon().paint(painter, rect, Qt::AlignCenter, mode, state);
+}
+
+QSize DataIconEngine::actualSize(const QSize &size, QIcon::Mode mode, QIcon::State state)
+{
+    return decodedIcon().actualSize(size, mode, state);
+}
+
+QPixmap DataIconEngine::pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state)
+{
+    return decodedIcon().pixmap(size, mode, state);
+}
+
+QIconEngine *DataIconEngine::clone() const
+{
+    return new DataIconEngine(*this);
+}
+
+bool DataIconEngine::isNull()
+{
+    return m_decoded ? m_icon.isNull() : m_data.isEmpty();
+}
+
+QIcon DataIconEngine::icon(const QByteArray &data)
+{
+    if (data.isEmpty())
+        return {};
+
+    return QIcon(new DataIconEngine(data));
+}
+
+const QIcon &DataIconEngine::decodedIcon()
+{
+    // Decode the image on first paint only
+    if (!m_decoded) {
+        m_decoded = true;
+
+        const QImage image = QImage::fromData(m_data);
+        if (!image.isNull()) {
+            m_icon = QIcon(QPixmap::fromImage(image));
+        }
+
+        m_data.clear();
+    }
+
+    return m_icon;
+}
@@ -0,0 +1,35 @@
+#ifndef DATAICONENGINE_H
+#define DATAICONENGINE_H
+
+#include <QIcon>
+#include <QIconEngine>
+
+class DataIconEngine : public QIconEngine
+{
+public:
+    explicit DataIconEngine(const QByteArray &data);
+
+    bool isDecoded() const { return m_decoded; }
+
+    void paint(QPainter *painter, const QRect &rect, QIcon::Mode mode, QIcon::State state) override;
+    QSize actualSize(const QSize &size, QIcon::Mode mode, QIcon::State state) override;
+    QPixmap pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state) override;
+
+    QString key() const override { return "DataIconEngine"; }
+    QIconEngine *clone() const override;
+
+    bool isNull() override;
+
+    static QIcon icon(const QByteArray &data);
+
+private:
+    const QIcon &decodedIcon();
+
+private:
+    bool m_decoded = false;
+
+    QByteArray m_data;
+    QIcon m_icon;
+};
+
+#endif // DATAICONENGINE_H
@@ -1,5 +1,7 @@
 #include "tableitemmodel.h"
 
+#include <algorithm>
+
 #include <util/triggertimer.h>
 
 TableItemModel::TableItemModel(QObject *parent) : QAbstractItemModel(parent) { }
@@ -76,6 +78,11 @@ void TableItemModel::refresh()
 {
     invalidateRowCache();
 
+    refreshView();
+}
+
+void TableItemModel::refreshView()
+{
     const int rowCount = this->rowCount();
     if (rowCount <= 0)
         return;
@@ -86,6 +93,35 @@ void TableItemModel::refresh()
     emit dataChanged(firstCell, lastCell);
 }
 
+void TableItemModel::emitCellsChanged(QList<int> rows, int column)
+{
+    if (rows.isEmpty())
+        return;
+
+    std::sort(rows.begin(), rows.end());
+
+    // Emit a signal per contiguous range of rows
+    int firstRow = rows.first();
+    int lastRow = firstRow;
+
+    const auto emitRange = [&] {
+        emit dataChanged(index(firstRow, column), index(lastRow, column));
+    };
+
+    for (const int row : std::as_const(rows)) {
+        if (row <= lastRow + 1) {
+            lastRow = qMax(lastRow, row);
+            continue;
+        }
+
+        emitRange();
+
+        firstRow = lastRow = row;
+    }
+
+    emitRange();
+}
+
 void TableItemModel::invalidateRowCache() const
 {
     tableRow().invalidate();
@@ -41,6 +41,8 @@ public slots:
     void refreshLater();
     void refresh();
 
+    void refreshView();
+
 protected:
     virtual Qt::ItemFlags flagHasChildren(const QModelIndex &index) const;
     virtual Qt::ItemFlags flagIsUserCheckable(const QModelIndex &index) const;
@@ -49,6 +51,8 @@ protected:
     virtual void invalidateRowCache() const;
     void updateRowCache(int row) const;
 
+    void emitCellsChanged(QList<int> rows, int column);
+
     virtual void fillQueryVars(QVariantHash &vars) const;
     virtual void fillQueryVarsForRow(QVariantHash &vars, int row) const;
 
@@ -1,5 +1,7 @@
 #include "tablesqlmodel.h"
 
+#include <algorithm>
+
 #include <sqlite/dbquery.h>
 #include <sqlite/sqlitedb.h>
 #include <sqlite/sqlitestmt.h>
@@ -28,13 +30,153 @@ void TableSqlModel::sort(int column, Qt::SortOrder order)
 void TableSqlModel::invalidateRowCache() const
 {
     setSqlRowCount(-1);
+
+    m_rowBlocks.clear();
+    m_lastBlockIndex = -1;
+
     TableItemModel::invalidateRowCache();
 }
 
-void TableSqlModel::fillQueryVarsForRow(QVariantHash &vars, int row) const
+QList<int> TableSqlModel::cachedRows(const TableRowMatchFunc &isRowMatched) const
+{
+    QList<int> rows;
+
+    // Rows out of the cached blocks will be fetched anew
+    for (const TableRowBlock &block : std::as_const(m_rowBlocks)) {
+        for (const TableRowPtr &tableRow : block.rows) {
+            if (isRowMatched(*tableRow)) {
+                rows.append(tableRow->row);
+            }
+        }
+    }
+
+    return rows;
+}
+
+void TableSqlModel::fillQueryVarsForRow(QVariantHash &vars, int /*row*/) const
 {
     fillQueryVars(vars);
-    vars.insert(":offset", row);
+}
+
+bool TableSqlModel::updateTableRow(const QVariantHash &vars, int row) const
+{
+    const int blockIndex = row / rowBlockSize;
+
+    const TableRowBlock *block = rowBlockAt(blockIndex);
+    if (!block) {
+        if (!fetchRowBlocks(vars, blockIndex))
+            return false;
+
+        block = rowBlockAt(blockIndex);
+        if (!block)
+            return false;
+    }
+
+    m_lastBlockIndex = blockIndex;
+
+    const int blockRow = row - block->row;
+    if (blockRow >= block->rows.size())
+        return false;
+
+    setTableRow(*block->rows.at(blockRow));
+
+    return true;
+}
+
+TableRowPtr TableSqlModel::createTableRow() const
+{
+    return {};
+}
+
+void TableSqlModel::fillTableRow(SqliteStmt & /*stmt*/, TableRow & /*tableRow*/) const { }
+
+void TableSqlModel::setTableRow(const TableRow & /*tableRow*/) const { }
+
+const TableRowBlock *TableSqlModel::rowBlockAt(int blockIndex) const
+{
+    const int row = blockIndex * rowBlockSize;
+
+    for (const TableRowBlock &block : std::as_const(m_rowBlocks)) {
+        if (block.row == row)
+            return &block;
+    }
+
+    return nullptr;
+}
+
+bool TableSqlModel::fetchRowBlocks(const QVariantHash &vars, int blockIndex) const
+{
+    // Prefetch the next block in the scroll direction
+    if (blockIndex == m_lastBlockIndex + 1) {
+        return fetchRowBlocks(vars, blockIndex, 2);
+    }
+
+    if (blockIndex == m_lastBlockIndex - 1 && blockIndex > 0
+            && !rowBlockAt(blockIndex - 1)) {
+        return fetchRowBlocks(vars, blockIndex - 1, 2);
+    }
+
+    return fetchRowBlocks(vars, blockIndex, 1);
+}
+
+bool TableSqlModel::fetchRowBlocks(
+        const QVariantHash &vars, int firstBlockIndex, int blockCount) const
+{
+    const int firstRow = firstBlockIndex * rowBlockSize;
+
+    QVariantHash blockVars = vars;
+    blockVars.insert(":limit", blockCount * rowBlockSize);
+    blockVars.insert(":offset", firstRow);
+
+    SqliteStmt stmt;
+    if (!DbQuery(sqliteDb()).sql(sql()).vars(blockVars).prepare(stmt))
+        return false;
+
+    ++m_rowBlockFetchCount;
+
+    TableRowBlock block = { .row = firstRow };
+
+    while (stmt.step() == SqliteStmt::StepRow) {
+        TableRowPtr tableRow = createTableRow();
+        if (!tableRow)
+            return false;
+
+        tableRow->row = block.row + block.rows.size();
+        fillTableRow(stmt, *tableRow);
+
+        block.rows.append(tableRow);
+
+        if (block.rows.size() == rowBlockSize) {
+            const int nextRow = block.row + rowBlockSize;
+
+            addRowBlock(std::move(block));
+
+            block = TableRowBlock { .row = nextRow };
+        }
+    }
+
+    if (!block.rows.isEmpty() || block.row == firstRow) {
+        addRowBlock(std::move(block));
+    }
+
+    return true;
+}
+
+void TableSqlModel::addRowBlock(TableRowBlock &&block) const
+{
+    // Evict the farthest block
+    if (m_rowBlocks.size() >= rowBlockMaxCount) {
+        const auto distance = [&](const TableRowBlock &b) { return qAbs(b.row - block.row); };
+
+        const auto it = std::max_element(m_rowBlocks.begin(), m_rowBlocks.end(),
+                [&](const TableRowBlock &a, const TableRowBlock &b) {
+                    return distance(a) < distance(b);
+                });
+
+        m_rowBlocks.erase(it);
+    }
+
+    m_rowBlocks.append(std::move(block));
 }
 
 int TableSqlModel::doSqlCount() const
@@ -80,5 +222,5 @@ QString TableSqlModel::sqlOrderColumn() const
 
 QString TableSqlModel::sqlLimitOffset() const
 {
-    return " LIMIT 1 OFFSET :offset";
+    return " LIMIT :limit OFFSET :offset";
 }
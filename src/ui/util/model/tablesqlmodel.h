@@ -1,10 +1,24 @@
 #ifndef TABLESQLMODEL_H
 #define TABLESQLMODEL_H
 
+#include <functional>
+#include <memory>
+
 #include <sqlite/sqlite_types.h>
 
 #include "tableitemmodel.h"
 
+class SqliteStmt;
+
+using TableRowPtr = std::shared_ptr<TableRow>;
+using TableRowMatchFunc = std::function<bool(const TableRow &tableRow)>;
+
+struct TableRowBlock
+{
+    int row = -1; // first row
+    QList<TableRowPtr> rows;
+};
+
 class TableSqlModel : public TableItemModel
 {
     Q_OBJECT
@@ -23,11 +37,24 @@ public:
 
     void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
 
+    int rowBlockFetchCount() const { return m_rowBlockFetchCount; }
+
 protected:
+    static constexpr int rowBlockSize = 64;
+    static constexpr int rowBlockMaxCount = 8;
+
     void invalidateRowCache() const override;
 
+    QList<int> cachedRows(const TableRowMatchFunc &isRowMatched) const;
+
     void fillQueryVarsForRow(QVariantHash &vars, int row) const override;
 
+    bool updateTableRow(const QVariantHash &vars, int row) const override;
+
+    virtual TableRowPtr createTableRow() const;
+    virtual void fillTableRow(SqliteStmt &stmt, TableRow &tableRow) const;
+    virtual void setTableRow(const TableRow &tableRow) const;
+
     virtual int doSqlCount() const;
     virtual QString sqlCount() const;
 
@@ -45,11 +72,24 @@ protected:
     int sqlRowCount() const { return m_sqlRowCount; }
     void setSqlRowCount(int v) const { m_sqlRowCount = v; }
 
+private:
+    const TableRowBlock *rowBlockAt(int blockIndex) const;
+
+    bool fetchRowBlocks(const QVariantHash &vars, int blockIndex) const;
+    bool fetchRowBlocks(const QVariantHash &vars, int firstBlockIndex, int blockCount) const;
+
+    void addRowBlock(TableRowBlock &&block) const;
+
 private:
     int m_sortColumn = -1;
     Qt::SortOrder m_sortOrder = Qt::AscendingOrder;
 
     mutable int m_sqlRowCount = -1;
+
+    mutable int m_lastBlockIndex = -1;
+    mutable int m_rowBlockFetchCount = 0;
+
+    mutable QList<TableRowBlock> m_rowBlocks;
 };
 
 #endif // TABLESQLMODEL_H
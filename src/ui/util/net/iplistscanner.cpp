@@ -0,0 +1,183 @@
+#include "iplistscanner.h"
+
+namespace {
+
+constexpr int hashBufferSize = 64 * 1024;
+
+constexpr int bgpPrefixMax = 9;
+constexpr int bgpTokenMin = 7;
+
+// Sync with conf/zone/types.json
+const char *const patternGeneric = R"(^\s*(\[?[A-Fa-f\d:.]+\]?\s*[\/-]?\s*\S*))";
+const char *const patternBgp = R"(^\D{0,9}([\d./-]{7,}))";
+
+}
+
+IpListScanner::IpListScanner(const QByteArray &data, ScanType scanType) :
+    m_scanType(scanType),
+    m_data(data.constData()),
+    m_end(data.constData() + data.size()),
+    m_hash(QCryptographicHash::Sha256)
+{
+    m_hashBuffer.reserve(hashBufferSize);
+}
+
+bool IpListScanner::scanTypeByPattern(const QString &pattern, ScanType &scanType)
+{
+    if (pattern == QLatin1String(patternGeneric)) {
+        scanType = ScanGeneric;
+    } else if (pattern == QLatin1String(patternBgp)) {
+        scanType = ScanBgp;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+bool IpListScanner::nextToken(QByteArrayView &token)
+{
+    while (m_data < m_end) {
+        const auto line = nextLine();
+
+        if (line.isEmpty())
+            continue;
+
+        const char c = line.front();
+        if (c == '#' || c == ';') // commented line
+            continue;
+
+        token = (m_scanType == ScanBgp) ? lineTokenBgp(line) : lineTokenGeneric(line);
+
+        if (!token.isEmpty()) {
+            ++m_tokenCount;
+            addChecksumData(token);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+QString IpListScanner::checksum()
+{
+    flushChecksumData();
+
+    return QString::fromLatin1(m_hash.result().toHex());
+}
+
+QByteArrayView IpListScanner::nextLine()
+{
+    const char *lineBegin = m_data;
+    const char *lineEnd = (const char *) memchr(lineBegin, '\n', m_end - lineBegin);
+
+    if (lineEnd) {
+        m_data = lineEnd + 1;
+    } else {
+        lineEnd = m_data = m_end;
+    }
+
+    ++m_lineNo;
+
+    return QByteArrayView(lineBegin, lineEnd);
+}
+
+QByteArrayView IpListScanner::lineTokenGeneric(const QByteArrayView line) const
+{
+    const char *p = line.begin();
+    const char *end = line.end();
+
+    while (p < end && isSpace(*p)) {
+        ++p;
+    }
+
+    const char *tokenBegin = p;
+
+    if (p < end && *p == '[') {
+        ++p;
+    }
+
+    const char *ipBegin = p;
+    while (p < end && isIpChar(*p)) {
+        ++p;
+    }
+
+    if (p == ipBegin)
+        return {};
+
+    if (p < end && *p == ']') {
+        ++p;
+    }
+
+    while (p < end && isSpace(*p)) {
+        ++p;
+    }
+
+    if (p < end && (*p == '/' || *p == '-')) {
+        ++p;
+    }
+
+    while (p < end && isSpace(*p)) {
+        ++p;
+    }
+
+    while (p < end && !isSpace(*p)) {
+        ++p;
+    }
+
+    return QByteArrayView(tokenBegin, p);
+}
+
+QByteArrayView IpListScanner::lineTokenBgp(const QByteArrayView line) const
+{
+    const char *begin = line.begin();
+    const char *end = line.end();
+
+    // Greedy non-digits prefix
+    const char *p = begin;
+    const char *prefixEnd = begin + qMin<qsizetype>(bgpPrefixMax, line.size());
+    while (p < prefixEnd && !isDigit(*p)) {
+        ++p;
+    }
+
+    const char *tokenEnd = p;
+    while (tokenEnd < end && isBgpChar(*tokenEnd)) {
+        ++tokenEnd;
+    }
+
+    // Backtrack the prefix as the regular expression does
+    for (;;) {
+        if (tokenEnd - p >= bgpTokenMin)
+            return QByteArrayView(p, tokenEnd);
+
+        if (p == begin)
+            break;
+
+        --p;
+
+        if (!isBgpChar(*p)) {
+            tokenEnd = p;
+        }
+    }
+
+    return {};
+}
+
+void IpListScanner::addChecksumData(const QByteArrayView token)
+{
+    if (m_hashBuffer.size() + token.size() >= hashBufferSize) {
+        flushChecksumData();
+    }
+
+    m_hashBuffer.append(token);
+    m_hashBuffer.append('\n');
+}
+
+void IpListScanner::flushChecksumData()
+{
+    if (m_hashBuffer.isEmpty())
+        return;
+
+    m_hash.addData(m_hashBuffer);
+    m_hashBuffer.resize(0); // keep the capacity
+}
@@ -0,0 +1,71 @@
+#ifndef IPLISTSCANNER_H
+#define IPLISTSCANNER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QCryptographicHash>
+
+class IpListScanner
+{
+public:
+    // Sync with ZoneTypeWrapper::TypeId
+    enum ScanType : qint8 {
+        ScanGeneric = 0, // ^\s*(\[?[A-Fa-f\d:.]+\]?\s*[\/-]?\s*\S*)
+        ScanBgp, // ^\D{0,9}([\d./-]{7,})
+    };
+
+    explicit IpListScanner(const QByteArray &data, ScanType scanType = ScanGeneric);
+
+    // Scan type of the built-in zone type pattern, false for a custom pattern
+    static bool scanTypeByPattern(const QString &pattern, ScanType &scanType);
+
+    ScanType scanType() const { return m_scanType; }
+
+    int lineNo() const { return m_lineNo; }
+    int tokenCount() const { return m_tokenCount; }
+
+    // Find the next address token, skipping commented and not matching lines
+    bool nextToken(QByteArrayView &token);
+
+    // SHA-256 of the found tokens, each one terminated by '\n'
+    QString checksum();
+
+    static bool isSpace(char c)
+    {
+        return c == ' ' || (c >= '\t' && c <= '\r'); // \t \n \v \f \r
+    }
+
+    static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    static bool isHexDigit(char c)
+    {
+        return isDigit(c) || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f');
+    }
+
+    static bool isIpChar(char c) { return isHexDigit(c) || c == ':' || c == '.'; }
+
+    static bool isBgpChar(char c) { return isDigit(c) || c == '.' || c == '/' || c == '-'; }
+
+private:
+    QByteArrayView nextLine();
+
+    QByteArrayView lineTokenGeneric(const QByteArrayView line) const;
+    QByteArrayView lineTokenBgp(const QByteArrayView line) const;
+
+    void addChecksumData(const QByteArrayView token);
+    void flushChecksumData();
+
+private:
+    ScanType m_scanType = ScanGeneric;
+
+    int m_lineNo = 0;
+    int m_tokenCount = 0;
+
+    const char *m_data = nullptr;
+    const char *m_end = nullptr;
+
+    QByteArray m_hashBuffer;
+    QCryptographicHash m_hash;
+};
+
+#endif // IPLISTSCANNER_H
@@ -5,6 +5,7 @@
 #include <util/conf/confdata.h>
 #include <util/stringutil.h>
 
+#include "iplistscanner.h"
 #include "netformatutil.h"
 #include "netutil.h"
 
@@ -20,39 +21,124 @@ inline bool checkIp6MaskBitsCount(const int nbits)
     return (nbits >= 0 && nbits <= 128);
 }
 
+constexpr int radixSortMinSize = 64;
+
 inline bool compareLessIp6(const ip6_addr_t &l, const ip6_addr_t &r)
 {
     return fort_ip6_cmp(&l, &r) < 0;
 }
 
-inline void sortIp6Array(ip6_arr_t &array)
+inline quint8 ip4PairKeyByte(const Ip4Pair &pair, int byteIndex)
+{
+    return quint8(pair.from >> (byteIndex * 8));
+}
+
+inline quint8 ip6PairKeyByte(const Ip6Pair &pair, int byteIndex)
 {
-    std::sort(array.begin(), array.end(), compareLessIp6);
+    return quint8(pair.from.data[sizeof(ip6_addr_t) - 1 - byteIndex]); // network byte order
 }
 
-void sortIp6PairArray(ip6_arr_t &fromArray, ip6_arr_t &toArray)
+// LSD radix sort by 8 bits, skipping the passes with equal key bytes
+template<typename T, typename KeyByteFunc, typename LessFunc>
+void radixSort(QVector<T> &array, int keySize, KeyByteFunc keyByte, LessFunc lessFunc)
 {
-    Q_ASSERT(fromArray.size() == toArray.size());
+    const int arraySize = array.size();
+
+    if (arraySize < radixSortMinSize) {
+        std::sort(array.begin(), array.end(), lessFunc);
+        return;
+    }
 
-    const int arraySize = fromArray.size();
+    QVector<T> buffer(arraySize);
 
-    ip6_pair_arr_t pairArray;
-    pairArray.reserve(arraySize);
+    T *src = array.data();
+    T *dst = buffer.data();
 
-    for (int i = 0; i < arraySize; ++i) {
-        pairArray.append(Ip6Pair { fromArray[i], toArray[i] });
+    for (int byteIndex = 0; byteIndex < keySize; ++byteIndex) {
+        int offsets[256] = { 0 };
+
+        for (int i = 0; i < arraySize; ++i) {
+            ++offsets[keyByte(src[i], byteIndex)];
+        }
+
+        if (offsets[keyByte(src[0], byteIndex)] == arraySize)
+            continue; // all key bytes are equal
+
+        int offset = 0;
+        for (int &count : offsets) {
+            const int n = count;
+            count = offset;
+            offset += n;
+        }
+
+        for (int i = 0; i < arraySize; ++i) {
+            const T &v = src[i];
+            dst[offsets[keyByte(v, byteIndex)]++] = v;
+        }
+
+        std::swap(src, dst);
+    }
+
+    if (src != array.constData()) {
+        array.swap(buffer);
     }
+}
 
-    std::sort(pairArray.begin(), pairArray.end(),
+void sortIp4Pairs(ip4_pair_arr_t &pairs)
+{
+    radixSort(pairs, sizeof(ip4_t), ip4PairKeyByte,
+            [](const Ip4Pair &l, const Ip4Pair &r) { return l.from < r.from; });
+}
+
+void sortIp6Pairs(ip6_pair_arr_t &pairs)
+{
+    radixSort(pairs, sizeof(ip6_addr_t), ip6PairKeyByte,
             [](const Ip6Pair &l, const Ip6Pair &r) { return compareLessIp6(l.from, r.from); });
+}
+
+// Is the "from" address overlapping or adjacent to the range ending with "to"?
+inline bool ip4IsMergeable(ip4_t to, ip4_t from)
+{
+    return quint64(from) <= quint64(to) + 1;
+}
+
+bool ip6IsMergeable(const ip6_addr_t &to, const ip6_addr_t &from)
+{
+    if (!compareLessIp6(to, from))
+        return true;
+
+    // Is "from" equal to "to + 1"?
+    ip6_addr_t next = to;
+    for (int i = sizeof(ip6_addr_t); --i >= 0;) {
+        if (++next.data[i] != 0)
+            break;
+    }
+
+    return !compareLessIp6(next, from);
+}
+
+int parseMaskBits(const QByteArrayView mask, bool &ok)
+{
+    const char *p = mask.begin();
+    const char *end = mask.end();
 
-    for (int i = 0; i < arraySize; ++i) {
-        const Ip6Pair &pair = pairArray[i];
-        fromArray[i] = pair.from;
-        toArray[i] = pair.to;
+    const bool isNegative = (p < end && *p == '-');
+    if (p < end && (*p == '+' || *p == '-')) {
+        ++p;
     }
+
+    ok = (p < end && end - p <= 9);
+
+    int nbits = 0;
+    for (; ok && p < end; ++p) {
+        ok = IpListScanner::isDigit(*p);
+        nbits = nbits * 10 + (*p - '0');
+    }
+
+    return isNegative ? -nbits : nbits;
 }
 
+
 }
 
 IpRange::IpRange(QObject *parent) : ValueRange(parent) { }
@@ -119,8 +205,8 @@ bool IpRange::fromList(const StringViewList &list, bool sort)
 {
     clear();
 
-    ip4range_map_t ip4RangeMap;
-    int pair4Size = 0;
+    IpPairs ipPairs;
+    ipPairs.ip4Pairs.reserve(list.size());
 
     int lineNo = 0;
     for (const auto &line : list) {
@@ -130,31 +216,118 @@ bool IpRange::fromList(const StringViewList &list, bool sort)
         if (lineTrimmed.isEmpty() || lineTrimmed.startsWith('#')) // commented line
             continue;
 
-        if (parseIpLine(line, ip4RangeMap, pair4Size) != ErrorOk) {
+        if (parseIpLine(line, ipPairs) != ErrorOk) {
             appendErrorDetails(QString("line='%1'").arg(line));
             setErrorLineNo(lineNo);
             return false;
         }
     }
 
-    fillRangeArrays<ip4_t>({
-            .rangeMap = ip4RangeMap,
-            .valuesArray = m_ip4Array,
-            .pairFromArray = m_pair4FromArray,
-            .pairToArray = m_pair4ToArray,
-            .pairSize = pair4Size,
-    });
+    fillIpArrays(ipPairs, sort);
 
-    if (sort) {
-        sortIp6Array(m_ip6Array);
-        sortIp6PairArray(m_pair6FromArray, m_pair6ToArray);
+    return true;
+}
+
+bool IpRange::fromScanner(IpListScanner &scanner, bool sort)
+{
+    clear();
+
+    IpPairs ipPairs;
+
+    QByteArrayView token;
+    while (scanner.nextToken(token)) {
+        if (parseIpToken(token, ipPairs) != ErrorOk) {
+            appendErrorDetails(QString("line='%1'").arg(QString::fromLatin1(token)));
+            setErrorLineNo(scanner.lineNo());
+            return false;
+        }
     }
 
+    fillIpArrays(ipPairs, sort);
+
     return true;
 }
 
-IpRange::ParseError IpRange::parseIpLine(
-        const QStringView line, ip4range_map_t &ip4RangeMap, int &pair4Size)
+void IpRange::fillIpArrays(IpPairs &ipPairs, bool sort)
+{
+    fillIp4Arrays(ipPairs.ip4Pairs);
+    fillIp6Arrays(ipPairs.ip6Pairs, sort);
+}
+
+void IpRange::fillIp4Arrays(ip4_pair_arr_t &ip4Pairs)
+{
+    if (ip4Pairs.isEmpty())
+        return;
+
+    sortIp4Pairs(ip4Pairs);
+
+    // Merge overlapping and adjacent ranges
+    Ip4Pair range = ip4Pairs.first();
+
+    for (const Ip4Pair &pair : std::as_const(ip4Pairs)) {
+        if (ip4IsMergeable(range.to, pair.from)) {
+            range.to = qMax(range.to, pair.to);
+        } else {
+            appendIp4Pair(range);
+            range = pair;
+        }
+    }
+
+    appendIp4Pair(range);
+}
+
+void IpRange::fillIp6Arrays(ip6_pair_arr_t &ip6Pairs, bool sort)
+{
+    if (ip6Pairs.isEmpty())
+        return;
+
+    if (!sort) {
+        for (const Ip6Pair &pair : std::as_const(ip6Pairs)) {
+            appendIp6Pair(pair);
+        }
+        return;
+    }
+
+    sortIp6Pairs(ip6Pairs);
+
+    // Merge overlapping and adjacent ranges
+    Ip6Pair range = ip6Pairs.first();
+
+    for (const Ip6Pair &pair : std::as_const(ip6Pairs)) {
+        if (ip6IsMergeable(range.to, pair.from)) {
+            if (compareLessIp6(range.to, pair.to)) {
+                range.to = pair.to;
+            }
+        } else {
+            appendIp6Pair(range);
+            range = pair;
+        }
+    }
+
+    appendIp6Pair(range);
+}
+
+void IpRange::appendIp4Pair(const Ip4Pair &pair)
+{
+    if (pair.from == pair.to) {
+        m_ip4Array.append(pair.from);
+    } else {
+        m_pair4FromArray.append(pair.from);
+        m_pair4ToArray.append(pair.to);
+    }
+}
+
+void IpRange::appendIp6Pair(const Ip6Pair &pair)
+{
+    if (fort_ip6_cmp(&pair.from, &pair.to) == 0) {
+        m_ip6Array.append(pair.from);
+    } else {
+        m_pair6FromArray.append(pair.from);
+        m_pair6ToArray.append(pair.to);
+    }
+}
+
+IpRange::ParseError IpRange::parseIpLine(const QStringView line, IpPairs &ipPairs)
 {
     static const QRegularExpression ipRe(R"(^\[?([A-Fa-f\d:.]+)\]?\s*([\/-]?)\s*(\S*))");
 
@@ -177,12 +350,12 @@ IpRange::ParseError IpRange::parseIpLine(
     const char maskSep = sepStr.isEmpty() ? '\0' : sepStr.at(0).toLatin1();
     const bool isIPv6 = ip.contains(':');
 
-    return isIPv6 ? parseIp6Address(ip, mask, maskSep)
-                  : parseIp4Address(ip, mask, ip4RangeMap, pair4Size, maskSep);
+    return isIPv6 ? parseIp6Address(ip, mask, ipPairs.ip6Pairs, maskSep)
+                  : parseIp4Address(ip, mask, ipPairs.ip4Pairs, maskSep);
 }
 
-IpRange::ParseError IpRange::parseIp4Address(const QStringView ip, const QStringView mask,
-        ip4range_map_t &ip4RangeMap, int &pair4Size, char maskSep)
+IpRange::ParseError IpRange::parseIp4Address(
+        const QStringView ip, const QStringView mask, ip4_pair_arr_t &ip4Pairs, char maskSep)
 {
     ip4_t from, to = 0;
 
@@ -198,11 +371,7 @@ IpRange::ParseError IpRange::parseIp4Address(const QStringView ip, const QString
     if (err != ErrorOk)
         return err;
 
-    ip4RangeMap.insert(from, to);
-
-    if (from != to) {
-        ++pair4Size;
-    }
+    ip4Pairs.append(Ip4Pair { from, to });
 
     return ErrorOk;
 }
@@ -258,9 +427,8 @@ IpRange::ParseError IpRange::parseIp4AddressMaskPrefix(
 }
 
 IpRange::ParseError IpRange::parseIp6Address(
-        const QStringView ip, const QStringView &mask, char maskSep)
+        const QStringView ip, const QStringView &mask, ip6_pair_arr_t &ip6Pairs, char maskSep)
 {
-    bool hasMask = false;
     ip6_addr_t from, to;
 
     bool ok;
@@ -271,37 +439,32 @@ IpRange::ParseError IpRange::parseIp6Address(
         return ErrorBadAddress;
     }
 
-    const ParseError err = parseIp6AddressMask(mask, from, to, hasMask, maskSep);
+    const ParseError err = parseIp6AddressMask(mask, from, to, maskSep);
     if (err != ErrorOk)
         return err;
 
-    if (hasMask) {
-        m_pair6FromArray.append(from);
-        m_pair6ToArray.append(to);
-    } else {
-        m_ip6Array.append(from);
-    }
+    ip6Pairs.append(Ip6Pair { from, to });
 
     return ErrorOk;
 }
 
 IpRange::ParseError IpRange::parseIp6AddressMask(
-        const QStringView mask, ip6_addr_t &from, ip6_addr_t &to, bool &hasMask, char maskSep)
+        const QStringView mask, ip6_addr_t &from, ip6_addr_t &to, char maskSep)
 {
-    hasMask = false;
+    to = from;
 
     switch (maskSep) {
     case '-': // e.g. "::1 - ::2"
-        return parseIp6AddressMaskFull(mask, to, hasMask);
+        return parseIp6AddressMaskFull(mask, from, to);
     case '/': // e.g. "::1/24", "::1"
-        return parseIp6AddressMaskPrefix(mask, from, to, hasMask);
+        return parseIp6AddressMaskPrefix(mask, from, to);
     default:
         return ErrorOk;
     }
 }
 
 IpRange::ParseError IpRange::parseIp6AddressMaskFull(
-        const QStringView mask, ip6_addr_t &to, bool &hasMask)
+        const QStringView mask, const ip6_addr_t &from, ip6_addr_t &to)
 {
     bool ok;
     to = NetFormatUtil::textToIp6(mask, &ok);
@@ -311,13 +474,11 @@ IpRange::ParseError IpRange::parseIp6AddressMaskFull(
         return ErrorBadAddress2;
     }
 
-    hasMask = true;
-
-    return ErrorOk;
+    return checkIp6Range(from, to);
 }
 
 IpRange::ParseError IpRange::parseIp6AddressMaskPrefix(
-        const QStringView mask, ip6_addr_t &from, ip6_addr_t &to, bool &hasMask)
+        const QStringView mask, ip6_addr_t &from, ip6_addr_t &to)
 {
     bool ok;
     const int nbits = mask.toInt(&ok);
@@ -333,7 +494,165 @@ IpRange::ParseError IpRange::parseIp6AddressMaskPrefix(
 
     to = NetUtil::applyIp6Mask(from, nbits);
 
-    hasMask = true;
+    return ErrorOk;
+}
+
+IpRange::ParseError IpRange::checkIp6Range(const ip6_addr_t &from, const ip6_addr_t &to)
+{
+    if (compareLessIp6(to, from)) {
+        setErrorMessage(tr("Bad range"));
+        setErrorDetails(QString("IPv6 from='%1' to='%2'")
+                        .arg(NetFormatUtil::ip6ToText(from), NetFormatUtil::ip6ToText(to)));
+        return ErrorBadRange;
+    }
+
+    return ErrorOk;
+}
+
+IpRange::ParseError IpRange::parseIpToken(const QByteArrayView token, IpPairs &ipPairs)
+{
+    // Same as parseIpLine(), but without the regular expression
+    const char *p = token.begin();
+    const char *end = token.end();
+
+    if (p < end && *p == '[') {
+        ++p;
+    }
+
+    const char *ipBegin = p;
+    while (p < end && IpListScanner::isIpChar(*p)) {
+        ++p;
+    }
+
+    if (p == ipBegin) {
+        setErrorMessage(tr("Bad format"));
+        return ErrorBadFormat;
+    }
+
+    const QByteArrayView ip(ipBegin, p);
+
+    if (p < end && *p == ']') {
+        ++p;
+    }
+
+    while (p < end && IpListScanner::isSpace(*p)) {
+        ++p;
+    }
+
+    const char maskSep = (p < end && (*p == '/' || *p == '-')) ? *p++ : '\0';
+
+    while (p < end && IpListScanner::isSpace(*p)) {
+        ++p;
+    }
+
+    const char *maskBegin = p;
+    while (p < end && !IpListScanner::isSpace(*p)) {
+        ++p;
+    }
+
+    const QByteArrayView mask(maskBegin, p);
+
+    if ((maskSep == '\0') != mask.isEmpty()) {
+        setErrorMessage(tr("Bad mask"));
+        setErrorDetails(QString("ip='%1' sep='%2' mask='%3'")
+                        .arg(QString::fromLatin1(ip),
+                                maskSep != '\0' ? QString(QLatin1Char(maskSep)) : QString(),
+                                QString::fromLatin1(mask)));
+        return ErrorBadMaskFormat;
+    }
+
+    const bool isIPv6 = ip.contains(':');
+
+    return isIPv6 ? parseIp6Token(ip, mask, ipPairs.ip6Pairs, maskSep)
+                  : parseIp4Token(ip, mask, ipPairs.ip4Pairs, maskSep);
+}
+
+IpRange::ParseError IpRange::parseIp4Token(const QByteArrayView ip, const QByteArrayView mask,
+        ip4_pair_arr_t &ip4Pairs, char maskSep)
+{
+    bool ok;
+    const ip4_t from = NetFormatUtil::latin1ToIp4(ip, &ok);
+    if (!ok) {
+        setErrorMessage(tr("Bad IP address"));
+        setErrorDetails(QString("IPv4 ip='%1'").arg(QString::fromLatin1(ip)));
+        return ErrorBadAddress;
+    }
+
+    ip4_t to;
+
+    if (maskSep == '-') {
+        to = NetFormatUtil::latin1ToIp4(mask, &ok);
+        if (!ok) {
+            setErrorMessage(tr("Bad second IP address"));
+            setErrorDetails(QString("IPv4 ip='%1'").arg(QString::fromLatin1(mask)));
+            return ErrorBadAddress2;
+        }
+
+        if (from > to) {
+            setErrorMessage(tr("Bad range"));
+            setErrorDetails(QString("IPv4 from='%1' to='%2'")
+                            .arg(NetFormatUtil::ip4ToText(from), NetFormatUtil::ip4ToText(to)));
+            return ErrorBadRange;
+        }
+    } else {
+        ok = true;
+        const int nbits = mask.isEmpty() ? emptyNetMask() : parseMaskBits(mask, ok);
+
+        if (!ok || !checkIp4MaskBitsCount(nbits)) {
+            setErrorMessage(tr("Bad mask"));
+            setErrorDetails(QString("IPv4 mask='%1' nbits='%2'")
+                            .arg(QString::fromLatin1(mask), QString::number(nbits)));
+            return ErrorBadMask;
+        }
+
+        to = NetUtil::applyIp4Mask(from, nbits);
+    }
+
+    ip4Pairs.append(Ip4Pair { from, to });
+
+    return ErrorOk;
+}
+
+IpRange::ParseError IpRange::parseIp6Token(const QByteArrayView ip, const QByteArrayView mask,
+        ip6_pair_arr_t &ip6Pairs, char maskSep)
+{
+    bool ok;
+    const ip6_addr_t from = NetFormatUtil::latin1ToIp6(ip, &ok);
+    if (!ok) {
+        setErrorMessage(tr("Bad IP address"));
+        setErrorDetails(QString("IPv6 ip='%1'").arg(QString::fromLatin1(ip)));
+        return ErrorBadAddress;
+    }
+
+    ip6_addr_t to = from;
+
+    if (maskSep == '-') {
+        to = NetFormatUtil::latin1ToIp6(mask, &ok);
+        if (!ok) {
+            setErrorMessage(tr("Bad second IP address"));
+            setErrorDetails(QString("IPv6 ip='%1'").arg(QString::fromLatin1(mask)));
+            return ErrorBadAddress2;
+        }
+
+        const ParseError err = checkIp6Range(from, to);
+        if (err != ErrorOk)
+            return err;
+    } else if (maskSep == '/') {
+        const int nbits = parseMaskBits(mask, ok);
+
+        if (!ok || !checkIp6MaskBitsCount(nbits)) {
+            setErrorMessage(tr("Bad mask"));
+            setErrorDetails(QString("IPv6 mask='%1' nbits='%2'")
+                            .arg(QString::fromLatin1(mask), QString::number(nbits)));
+            return ErrorBadMask;
+        }
+
+        if (nbits != 128) {
+            to = NetUtil::applyIp6Mask(from, nbits);
+        }
+    }
+
+    ip6Pairs.append(Ip6Pair { from, to });
 
     return ErrorOk;
 }
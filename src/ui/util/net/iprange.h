@@ -5,14 +5,16 @@
 
 #include "valuerange.h"
 
+class IpListScanner;
+
 using ip4_t = quint32;
 
-using ip4range_map_t = QMap<ip4_t, ip4_t>;
 using ip4_arr_t = QVector<ip4_t>;
 
 using Ip4Pair = ValuePair<ip4_t>;
 using Ip6Pair = ValuePair<ip6_addr_t>;
 
+using ip4_pair_arr_t = QVector<Ip4Pair>;
 using ip6_pair_arr_t = QVector<Ip6Pair>;
 using ip6_arr_t = QVector<ip6_addr_t>;
 
@@ -73,6 +75,8 @@ public:
 
     bool fromList(const StringViewList &list, bool sort = true) override;
 
+    bool fromScanner(IpListScanner &scanner, bool sort = true);
+
     void write(ConfData &confData) const override;
 
 private:
@@ -86,26 +90,48 @@ private:
         ErrorBadRange,
     };
 
-    IpRange::ParseError parseIpLine(
-            const QStringView line, ip4range_map_t &ip4RangeMap, int &pair4Size);
+    // Parsed addresses and ranges, single address has equal bounds
+    struct IpPairs
+    {
+        ip4_pair_arr_t ip4Pairs;
+        ip6_pair_arr_t ip6Pairs;
+    };
+
+    void fillIpArrays(IpPairs &ipPairs, bool sort);
+    void fillIp4Arrays(ip4_pair_arr_t &ip4Pairs);
+    void fillIp6Arrays(ip6_pair_arr_t &ip6Pairs, bool sort);
+
+    void appendIp4Pair(const Ip4Pair &pair);
+    void appendIp6Pair(const Ip6Pair &pair);
+
+    IpRange::ParseError parseIpLine(const QStringView line, IpPairs &ipPairs);
+
+    IpRange::ParseError parseIpToken(const QByteArrayView token, IpPairs &ipPairs);
+
+    IpRange::ParseError parseIp4Token(const QByteArrayView ip, const QByteArrayView mask,
+            ip4_pair_arr_t &ip4Pairs, char maskSep);
+    IpRange::ParseError parseIp6Token(const QByteArrayView ip, const QByteArrayView mask,
+            ip6_pair_arr_t &ip6Pairs, char maskSep);
 
     IpRange::ParseError parseIp4Address(const QStringView ip, const QStringView mask,
-            ip4range_map_t &ip4RangeMap, int &pair4Size, char maskSep);
+            ip4_pair_arr_t &ip4Pairs, char maskSep);
 
     IpRange::ParseError parseIp4AddressMask(
             const QStringView mask, ip4_t &from, ip4_t &to, char maskSep);
     IpRange::ParseError parseIp4AddressMaskFull(const QStringView mask, ip4_t &from, ip4_t &to);
     IpRange::ParseError parseIp4AddressMaskPrefix(const QStringView mask, ip4_t &from, ip4_t &to);
 
-    IpRange::ParseError parseIp6Address(
-            const QStringView ip, const QStringView &mask, char maskSep);
+    IpRange::ParseError parseIp6Address(const QStringView ip, const QStringView &mask,
+            ip6_pair_arr_t &ip6Pairs, char maskSep);
 
     IpRange::ParseError parseIp6AddressMask(
-            const QStringView mask, ip6_addr_t &from, ip6_addr_t &to, bool &hasMask, char maskSep);
+            const QStringView mask, ip6_addr_t &from, ip6_addr_t &to, char maskSep);
     IpRange::ParseError parseIp6AddressMaskFull(
-            const QStringView mask, ip6_addr_t &to, bool &hasMask);
+            const QStringView mask, const ip6_addr_t &from, ip6_addr_t &to);
     IpRange::ParseError parseIp6AddressMaskPrefix(
-            const QStringView mask, ip6_addr_t &from, ip6_addr_t &to, bool &hasMask);
+            const QStringView mask, ip6_addr_t &from, ip6_addr_t &to);
+
+    IpRange::ParseError checkIp6Range(const ip6_addr_t &from, const ip6_addr_t &to);
 
 private:
     qint8 m_emptyNetMask = 32;
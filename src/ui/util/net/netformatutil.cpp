@@ -19,6 +19,159 @@ struct sock_addr
 
 #define sock_addr_get_inp(sap) ((void *) &(sap)->u.in.sin_addr)
 
+namespace {
+
+int hexDigitValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+// Dotted-decimal with four parts, leading zeros are read as decimal
+bool parseIp4(const char *p, const char *end, quint32 &ip)
+{
+    quint32 res = 0;
+    int partsCount = 0;
+
+    while (p < end) {
+        int value = 0;
+        int digitsCount = 0;
+
+        for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+            value = value * 10 + (*p - '0');
+
+            if (++digitsCount > 3 || value > 255)
+                return false;
+        }
+
+        if (digitsCount == 0 || ++partsCount > 4)
+            return false;
+
+        res = (res << 8) | quint32(value);
+
+        if (p < end) {
+            if (*p != '.' || ++p == end)
+                return false;
+        }
+    }
+
+    if (partsCount != 4)
+        return false;
+
+    ip = res;
+
+    return true;
+}
+
+bool parseIp6(const char *p, const char *end, quint8 *out)
+{
+    quint8 buf[16] = { 0 };
+    quint8 *bp = buf;
+    quint8 *bufEnd = buf + sizeof(buf);
+    quint8 *colonp = nullptr;
+
+    // Leading "::" requires some special handling
+    if (p < end && *p == ':') {
+        if (++p == end || *p != ':')
+            return false;
+    }
+
+    const char *curToken = p;
+    bool sawHexDigit = false;
+    int digitsCount = 0;
+    quint32 value = 0;
+
+    while (p < end) {
+        const char c = *p++;
+
+        const int hexValue = hexDigitValue(c);
+        if (hexValue >= 0) {
+            if (++digitsCount > 4)
+                return false;
+
+            value = (value << 4) | quint32(hexValue);
+            sawHexDigit = true;
+            continue;
+        }
+
+        if (c == ':') {
+            curToken = p;
+
+            if (!sawHexDigit) {
+                if (colonp)
+                    return false;
+
+                colonp = bp;
+                continue;
+            }
+
+            if (p == end || bp + 2 > bufEnd)
+                return false;
+
+            *bp++ = quint8(value >> 8);
+            *bp++ = quint8(value);
+
+            sawHexDigit = false;
+            digitsCount = 0;
+            value = 0;
+            continue;
+        }
+
+        // Embedded IPv4 address at the end
+        if (c == '.' && bp + 4 <= bufEnd) {
+            quint32 ip4;
+            if (!parseIp4(curToken, end, ip4))
+                return false;
+
+            *bp++ = quint8(ip4 >> 24);
+            *bp++ = quint8(ip4 >> 16);
+            *bp++ = quint8(ip4 >> 8);
+            *bp++ = quint8(ip4);
+
+            sawHexDigit = false;
+            break;
+        }
+
+        return false;
+    }
+
+    if (sawHexDigit) {
+        if (bp + 2 > bufEnd)
+            return false;
+
+        *bp++ = quint8(value >> 8);
+        *bp++ = quint8(value);
+    }
+
+    if (colonp) {
+        if (bp == bufEnd)
+            return false;
+
+        // Shift the tail after "::" to the end
+        const int n = int(bp - colonp);
+        for (int i = 1; i <= n; ++i) {
+            bufEnd[-i] = colonp[n - i];
+            colonp[n - i] = 0;
+        }
+
+        bp = bufEnd;
+    }
+
+    if (bp != bufEnd)
+        return false;
+
+    memcpy(out, buf, sizeof(buf));
+
+    return true;
+}
+
+}
+
 quint32 NetFormatUtil::textToIp4(const QStringView text, bool *ok)
 {
     quint32 ip4;
@@ -39,6 +192,19 @@ quint32 NetFormatUtil::textToIp4(const char *text, bool *ok)
     return textToIp4(QString::fromLatin1(text), ok);
 }
 
+quint32 NetFormatUtil::latin1ToIp4(const QByteArrayView text, bool *ok)
+{
+    quint32 ip4 = 0;
+
+    const bool res = parseIp4(text.begin(), text.end(), ip4);
+
+    if (ok) {
+        *ok = res;
+    }
+
+    return res ? ip4 : 0;
+}
+
 QString NetFormatUtil::ip4ToText(quint32 ip)
 {
     quint32 ip4 = htonl((unsigned long) ip);
@@ -70,6 +236,23 @@ ip6_addr_t NetFormatUtil::textToIp6(const char *text, bool *ok)
     return textToIp6(QString::fromLatin1(text), ok);
 }
 
+ip6_addr_t NetFormatUtil::latin1ToIp6(const QByteArrayView text, bool *ok)
+{
+    ip6_addr_t ip6;
+
+    const bool res = parseIp6(text.begin(), text.end(), (quint8 *) ip6.data);
+
+    if (ok) {
+        *ok = res;
+    }
+
+    if (!res) {
+        memset(&ip6, 0, sizeof(ip6));
+    }
+
+    return ip6;
+}
+
 QString NetFormatUtil::ip6ToText(const ip6_addr_t ip)
 {
     wchar_t buf[MAX_IPV6_LEN];
@@ -13,6 +13,9 @@ public:
     static quint32 textToIp4(const QStringView text, bool *ok = nullptr);
     static quint32 textToIp4(const char *text, bool *ok = nullptr);
 
+    // Convert IPv4 address from Latin-1 text to number, without a system call
+    static quint32 latin1ToIp4(const QByteArrayView text, bool *ok = nullptr);
+
     // Convert IPv4 address from number to text
     static QString ip4ToText(quint32 ip);
 
@@ -20,6 +23,9 @@ public:
     static ip6_addr_t textToIp6(const QStringView text, bool *ok = nullptr);
     static ip6_addr_t textToIp6(const char *text, bool *ok = nullptr);
 
+    // Convert IPv6 address from Latin-1 text to number, without a system call
+    static ip6_addr_t latin1ToIp6(const QByteArrayView text, bool *ok = nullptr);
+
     // Convert IPv6 address from number to text
     static QString ip6ToText(const ip6_addr_t ip);
 
@@ -15,12 +15,18 @@ bool PortRange::isEmpty() const
 
 bool PortRange::checkSize() const
 {
-    return (portSize() + pairSize()) < FORT_CONF_PORT_MAX;
+    return isBitmap() || (portSize() + pairSize()) < FORT_CONF_PORT_MAX;
 }
 
 int PortRange::sizeToWrite() const
 {
-    return FORT_CONF_PORT_LIST_SIZE(portSize(), pairSize());
+    return isBitmap() ? FORT_CONF_PORT_BITMAP_SIZE
+                      : FORT_CONF_PORT_LIST_SIZE(portSize(), pairSize());
+}
+
+bool PortRange::isBitmap() const
+{
+    return (portSize() + pairSize()) >= FORT_CONF_PORT_BITMAP_MIN;
 }
 
 void PortRange::clear()
@@ -150,5 +156,9 @@ bool PortRange::parsePortNumber(const QStringView port, port_t &v)
 
 void PortRange::write(ConfData &confData) const
 {
-    confData.writePortRange(*this);
+    if (isBitmap()) {
+        confData.writePortBitmap(*this);
+    } else {
+        confData.writePortRange(*this);
+    }
 }
@@ -45,6 +45,8 @@ public:
     bool checkSize() const override;
     int sizeToWrite() const override;
 
+    bool isBitmap() const override;
+
     void clear() override;
 
     void toList(QStringList &list) const override;
@@ -15,12 +15,18 @@ bool ProtoRange::isEmpty() const
 
 bool ProtoRange::checkSize() const
 {
-    return (protoSize() + pairSize()) < FORT_CONF_PROTO_MAX;
+    return isBitmap() || (protoSize() + pairSize()) < FORT_CONF_PROTO_MAX;
 }
 
 int ProtoRange::sizeToWrite() const
 {
-    return FORT_CONF_PROTO_LIST_SIZE(protoSize(), pairSize());
+    return isBitmap() ? FORT_CONF_PROTO_BITMAP_SIZE
+                      : FORT_CONF_PROTO_LIST_SIZE(protoSize(), pairSize());
+}
+
+bool ProtoRange::isBitmap() const
+{
+    return FORT_CONF_PROTO_LIST_SIZE(protoSize(), pairSize()) >= FORT_CONF_PROTO_BITMAP_SIZE;
 }
 
 void ProtoRange::clear()
@@ -147,5 +153,9 @@ bool ProtoRange::parseProtoNumber(const QStringView proto, proto_t &v)
 
 void ProtoRange::write(ConfData &confData) const
 {
-    confData.writeProtoRange(*this);
+    if (isBitmap()) {
+        confData.writeProtoBitmap(*this);
+    } else {
+        confData.writeProtoRange(*this);
+    }
 }
@@ -33,6 +33,9 @@ public:
     virtual bool checkSize() const { return true; }
     virtual int sizeToWrite() const = 0;
 
+    // Values are written as a bitmap instead of the sorted list
+    virtual bool isBitmap() const { return false; }
+
     virtual void clear();
 
     QString toText() const;
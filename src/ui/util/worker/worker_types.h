@@ -1,7 +1,9 @@
 #ifndef WORKER_TYPES_H
 #define WORKER_TYPES_H
 
+#include <QPair>
 #include <QSharedPointer>
+#include <QString>
 
 class WorkerJob;
 class WorkerObject;
@@ -9,4 +11,6 @@ class WorkerManager;
 
 using WorkerJobPtr = QSharedPointer<WorkerJob>;
 
+using WorkerJobKey = QPair<size_t, QString>; // job type hash, merge key
+
 #endif // WORKER_TYPES_H
@@ -15,6 +15,9 @@ public:
 
     const QString &text() const { return m_text; }
 
+    // Queued jobs of the same type and non-empty merge key are interchangeable
+    virtual QString mergeKey() const { return QString(); }
+
     virtual bool mergeJob(const WorkerJob &job)
     {
         Q_UNUSED(job);
@@ -24,6 +27,9 @@ public:
     virtual void doJob(WorkerObject &worker) { Q_UNUSED(worker); }
     virtual void reportResult(WorkerObject &worker) { Q_UNUSED(worker); }
 
+    // Called instead of doJob() when the queued job is dropped by back-pressure
+    virtual void reportDropped(WorkerManager &manager) { Q_UNUSED(manager); }
+
 private:
     const QString m_text;
 };
@@ -2,11 +2,20 @@
 
 #include <QThreadPool>
 
+#include <typeinfo>
+
 #include "workerjob.h"
 #include "workerobject.h"
 
 namespace {
+
 constexpr unsigned long WORKER_TIMEOUT_MSEC = 5000;
+
+WorkerJobKey jobKey(const WorkerJob &job)
+{
+    return { typeid(job).hash_code(), job.mergeKey() };
+}
+
 }
 
 WorkerManager::WorkerManager(QObject *parent) : QObject(parent) { }
@@ -34,12 +43,116 @@ bool WorkerManager::checkNewWorkerNeeded() const
     if (workersCount == 0)
         return true;
 
-    return workersCount < maxWorkersCount() && !m_jobQueue.isEmpty();
+    return workersCount < maxWorkersCount() && m_jobCount > 0;
+}
+
+bool WorkerManager::isJobQueued(const WorkerJobPtr &job) const
+{
+    const WorkerJobKey key = jobKey(*job);
+
+    return key.second.isEmpty() || m_keyJobs.value(key) == job;
+}
+
+bool WorkerManager::addJob(WorkerJobPtr job, QList<WorkerJobPtr> &droppedJobs)
+{
+    const WorkerJobKey key = jobKey(*job);
+    const bool isKeyed = !key.second.isEmpty();
+
+    // Coalesce with the queued job of the same key or merge into the last job
+    if (isKeyed ? m_keyJobs.contains(key) : mergeJob(job))
+        return false;
+
+    if (m_maxJobsCount > 0 && m_jobCount >= m_maxJobsCount) {
+        droppedJobs.append(job); // drop the excessive job
+        return false;
+    }
+
+    if (isKeyed) {
+        m_keyJobs.insert(key, job);
+    }
+
+    m_jobQueue.enqueue(job);
+    ++m_jobCount;
+
+    return true;
+}
+
+void WorkerManager::addJobFirst(WorkerJobPtr job)
+{
+    const WorkerJobKey key = jobKey(*job);
+
+    if (key.second.isEmpty()) {
+        ++m_jobCount;
+    } else {
+        // Supersede the queued job of the same key
+        WorkerJobPtr &keyJob = m_keyJobs[key];
+        if (!keyJob) {
+            ++m_jobCount;
+        }
+        keyJob = job;
+    }
+
+    m_jobQueue.prepend(job);
+}
+
+bool WorkerManager::takeJob(const WorkerJobPtr &job)
+{
+    const WorkerJobKey key = jobKey(*job);
+
+    if (!key.second.isEmpty()) {
+        const auto it = m_keyJobs.constFind(key);
+        if (it == m_keyJobs.constEnd() || it.value() != job)
+            return false; // superseded
+
+        m_keyJobs.erase(it);
+    }
+
+    --m_jobCount;
+
+    return true;
+}
+
+void WorkerManager::dropExcessJobs(QList<WorkerJobPtr> &droppedJobs)
+{
+    if (m_maxJobsCount <= 0)
+        return;
+
+    // The oldest requested jobs are at the back
+    while (m_jobCount > m_maxJobsCount) {
+        const WorkerJobPtr job = m_jobQueue.takeLast();
+
+        if (takeJob(job)) {
+            droppedJobs.append(job);
+        }
+    }
+}
+
+void WorkerManager::reportDroppedJobs(const QList<WorkerJobPtr> &droppedJobs)
+{
+    for (const WorkerJobPtr &job : droppedJobs) {
+        job->reportDropped(*this);
+    }
+}
+
+void WorkerManager::wakeWorkers(int jobsCount)
+{
+    if (jobsCount <= 0 || m_idleWorkersCount == 0)
+        return;
+
+    if (jobsCount >= m_idleWorkersCount) {
+        m_jobWaitCondition.wakeAll();
+    } else {
+        while (--jobsCount >= 0) {
+            m_jobWaitCondition.wakeOne();
+        }
+    }
 }
 
 void WorkerManager::clearJobQueue()
 {
+    m_jobCount = 0;
     m_jobQueue.clear();
+    m_keyJobs.clear();
 }
 
 void WorkerManager::workerFinished(WorkerObject *worker)
@@ -62,15 +175,17 @@ int WorkerManager::jobCount() const
 {
     QMutexLocker locker(&m_mutex);
 
-    return m_jobQueue.size();
+    return m_jobCount;
 }
 
 bool WorkerManager::mergeJob(WorkerJobPtr job)
 {
-    if (!canMergeJobs() || m_jobQueue.isEmpty())
+    if (!canMergeJobs() || m_jobCount == 0)
         return false;
 
-    return m_jobQueue.last()->mergeJob(*job);
+    const WorkerJobPtr &lastJob = m_jobQueue.last();
+
+    return isJobQueued(lastJob) && lastJob->mergeJob(*job);
 }
 
 void WorkerManager::clear()
@@ -96,33 +211,89 @@ void WorkerManager::abortWorkers()
 }
 
 void WorkerManager::enqueueJob(WorkerJobPtr job)
+{
+    enqueueJobs({ job });
+}
+
+void WorkerManager::enqueueJobs(const QList<WorkerJobPtr> &jobs)
 {
     QMutexLocker locker(&m_mutex);
 
     if (aborted())
         return;
 
-    setupWorker();
+    int addedCount = 0;
+    QList<WorkerJobPtr> droppedJobs;
+
+    for (const WorkerJobPtr &job : jobs) {
+        setupWorker();
+
+        if (addJob(job, droppedJobs)) {
+            ++addedCount;
+        }
+    }
+
+    wakeWorkers(addedCount);
+
+    locker.unlock();
+
+    reportDroppedJobs(droppedJobs);
+}
+
+void WorkerManager::enqueueJobFirst(WorkerJobPtr job)
+{
+    enqueueJobsFirst({ job });
+}
+
+void WorkerManager::enqueueJobsFirst(const QList<WorkerJobPtr> &jobs)
+{
+    QMutexLocker locker(&m_mutex);
 
-    if (mergeJob(job))
+    if (aborted())
         return;
 
-    m_jobQueue.enqueue(job);
+    // Keep the order of the jobs at the front
+    for (auto it = jobs.crbegin(); it != jobs.crend(); ++it) {
+        setupWorker();
+
+        addJobFirst(*it);
+    }
+
+    QList<WorkerJobPtr> droppedJobs;
+    dropExcessJobs(droppedJobs);
 
-    m_jobWaitCondition.wakeOne();
+    wakeWorkers(jobs.size());
+
+    locker.unlock();
+
+    reportDroppedJobs(droppedJobs);
 }
 
 WorkerJobPtr WorkerManager::dequeueJob()
 {
     QMutexLocker locker(&m_mutex);
 
-    while (!aborted() && m_jobQueue.isEmpty()) {
-        if (!m_jobWaitCondition.wait(&m_mutex, WORKER_TIMEOUT_MSEC))
+    while (!aborted() && m_jobCount == 0) {
+        ++m_idleWorkersCount;
+        const bool woken = m_jobWaitCondition.wait(&m_mutex, WORKER_TIMEOUT_MSEC);
+        --m_idleWorkersCount;
+
+        if (!woken)
             break; // timed out
     }
 
-    if (aborted() || m_jobQueue.isEmpty())
+    if (aborted() || m_jobCount == 0)
         return nullptr;
 
-    return m_jobQueue.dequeue();
+    // Skip the superseded jobs
+    for (;;) {
+        const WorkerJobPtr job = m_jobQueue.dequeue();
+
+        if (takeJob(job)) {
+            if (m_jobCount == 0) {
+                m_jobQueue.clear();
+            }
+            return job;
+        }
+    }
 }
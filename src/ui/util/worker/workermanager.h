@@ -1,6 +1,7 @@
 #ifndef WORKERMANAGER_H
 #define WORKERMANAGER_H
 
+#include <QHash>
 #include <QMutex>
 #include <QObject>
 #include <QQueue>
@@ -26,6 +27,10 @@ public:
     int maxWorkersCount() const { return m_maxWorkersCount; }
     void setMaxWorkersCount(int v) { m_maxWorkersCount = v; }
 
+    // Back-pressure: 0 means unlimited queued jobs
+    int maxJobsCount() const { return m_maxJobsCount; }
+    void setMaxJobsCount(int v) { m_maxJobsCount = v; }
+
     virtual QString workerName() const { return QString(); }
 
 public slots:
@@ -33,6 +38,9 @@ public slots:
     void abortWorkers();
 
     void enqueueJob(WorkerJobPtr job);
+    void enqueueJobs(const QList<WorkerJobPtr> &jobs);
+    void enqueueJobFirst(WorkerJobPtr job);
+    void enqueueJobsFirst(const QList<WorkerJobPtr> &jobs);
     WorkerJobPtr dequeueJob();
 
     void workerFinished(WorkerObject *worker);
@@ -50,16 +58,32 @@ private:
 
     bool checkNewWorkerNeeded() const;
 
+    bool isJobQueued(const WorkerJobPtr &job) const;
+
+    bool addJob(WorkerJobPtr job, QList<WorkerJobPtr> &droppedJobs);
+    void addJobFirst(WorkerJobPtr job);
+    bool takeJob(const WorkerJobPtr &job);
+    void dropExcessJobs(QList<WorkerJobPtr> &droppedJobs);
+
+    void reportDroppedJobs(const QList<WorkerJobPtr> &droppedJobs);
+
+    void wakeWorkers(int jobsCount);
+
     void clearJobQueue();
 
 private:
     volatile bool m_aborted = false;
 
     int m_maxWorkersCount = 0;
+    int m_maxJobsCount = 0;
 
+    int m_idleWorkersCount = 0;
     QList<WorkerObject *> m_workers;
 
+    // Superseded keyed jobs stay in the queue and are skipped on dequeue
+    int m_jobCount = 0;
     QQueue<WorkerJobPtr> m_jobQueue;
+    QHash<WorkerJobKey, WorkerJobPtr> m_keyJobs;
 
     mutable QMutex m_mutex;
     QWaitCondition m_jobWaitCondition;